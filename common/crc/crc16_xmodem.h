@@ -0,0 +1,35 @@
+/*
+ * crc16_xmodem.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Table-driven CRC-16/XMODEM (polynomial 0x1021, no
+ *              reflection, no final XOR), as used by the LPC ISP packets
+ *              in the nRF52 bootloader and by ymodem on the LPC side.
+ *
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Initial value for a new calculation. */
+#define CRC16_XMODEM_INIT 0
+
+/** Continue a CRC calculation over more data.
+
+    @param crc CRC of the data so far, CRC16_XMODEM_INIT to start
+    @param p_data Data to add
+    @param length Number of bytes at p_data
+
+    @return The updated CRC.
+*/
+uint16_t crc16_xmodem_update(uint16_t crc, const uint8_t* p_data, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,11 @@
+set -x
+
+# crc16_xmodem_update() vs the bitwise CRC16 it replaced
+gcc -O2 -Wall -I .. -I ../../../imxrt685/source/zmodem \
+ ../crc16_xmodem.c \
+ ../../../imxrt685/source/zmodem/crctab.c \
+ ./crc16_test.c \
+ && ./a.out || exit 1
+
+# cleanup
+rm ./a.out
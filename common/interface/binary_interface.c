@@ -38,17 +38,25 @@ static void onPacketFunction(void *context, const uint8_t *buffer, size_t size)
     BinaryInterface *bi = (BinaryInterface *)context;
     // initialize reader.
     br_init(&(bi->br), buffer, size);
-    // read command code
-    COMMAND_ERRVAL_TYPE cmd_code = readCC(bi);
 
-    binitf_handler_func handler = NULL;
-    if (cmd_code.error_ == ERROR_NONE && cmd_code.value_ < bi->num_commands)
-    {
-        Command command = bi->commands[cmd_code.value_];
-        handler = command.binitf_handler_f;
-    }
-    if (handler != NULL)
+    // A packet holds one or more commands back to back. Each handler reads
+    // its arguments, leaving the reader at the next command code.
+    while (br_get_bit_index(&(bi->br)) + 8 * sizeof(COMMAND_TYPE) <= br_get_bit_size(&(bi->br)))
     {
+        // read command code
+        COMMAND_ERRVAL_TYPE cmd_code = readCC(bi);
+
+        binitf_handler_func handler = NULL;
+        if (cmd_code.error_ == ERROR_NONE && cmd_code.value_ < bi->num_commands)
+        {
+            Command command = bi->commands[cmd_code.value_];
+            handler = command.binitf_handler_f;
+        }
+        if (handler == NULL)
+        {
+            // The argument size is unknown, so the rest can't be parsed.
+            break;
+        }
         // call handler
         handler(&(bi->br));
     }
@@ -66,6 +74,11 @@ bool handleMessages(BinaryInterface *bi, uint8_t data)
     update(&(bi->pSerial),data);
     return true;
 }
+size_t handleMessagesBuffer(BinaryInterface *bi, const uint8_t *data, size_t size)
+{
+    // Parse Inputs From User, at most one packet per call
+    return update_buffer(&(bi->pSerial), data, size);
+}
 BinaryReader *getReader(BinaryInterface *bi)
 {
     return &(bi->br);
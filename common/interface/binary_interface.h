@@ -40,6 +40,7 @@ typedef struct BinaryInterface
 void bi_init(BinaryInterface *bi, const Command *commands, size_t num_commands);
 bool handleMessagesPolling(BinaryInterface *bi);
 bool handleMessages(BinaryInterface *bi, uint8_t data);
+size_t handleMessagesBuffer(BinaryInterface *bi, const uint8_t *data, size_t size);
 BinaryReader *getReader(BinaryInterface *bi);
 BinaryWriter *getWriter(BinaryInterface *bi);
 void writeCC(BinaryInterface *bi, uint8_t cc);
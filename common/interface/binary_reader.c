@@ -210,8 +210,12 @@ ErrValUINT8 readSTRING(BinaryReader *br, char *xbuf, int xsize)
   }
   else
   {
-    if (read(br, (uint8_t *)xbuf, xsize - 1, (xsize - 1) * 8))
+    // Too long for xbuf: keep the start and skip the rest, so the reader
+    // ends up at the next field either way.
+    if (br->bitIndex_ + str_size * 8 <= br->bitSize_ &&
+        read(br, (uint8_t *)xbuf, xsize - 1, (xsize - 1) * 8))
     {
+      br->bitIndex_ += (str_size - (xsize - 1)) * 8;
       xbuf[xsize - 1] = '\0';
       result.value_ = xsize - 1;
       return result;
@@ -1,7 +1,5 @@
 
 #include "binary_writer.h"
-#include "config.h"
-#include "reentrant_math.h"
 
 void bw_reset(BinaryWriter *bw)
 {
@@ -140,7 +138,7 @@ size_t bw_get_bit_capacity(BinaryWriter *bw)
 
 size_t bw_get_size(BinaryWriter *bw)
 {
-  return rmath_divide_ceil(bw->bitIndex_ , 8);
+    return (bw->bitIndex_ + 7) / 8;
 }
 
 size_t bw_get_capacity(BinaryWriter *bw)
@@ -151,10 +149,10 @@ size_t bw_get_capacity(BinaryWriter *bw)
 bool bw_send(BinaryWriter *bw)
 {
     // TODO: protect this operation with the mutex from above
-    send(bw->pSerial_, bw->buffer_, bw_get_size(bw));
+    bool success = send(bw->pSerial_, bw->buffer_, bw_get_size(bw));
     // reset the buffer
     bw->bitIndex_ = 0;
-    return true;
+    return success;
 }
 
 
@@ -5,18 +5,43 @@
  *      Author: david
  */
 
+#include <string.h>
+
 #include "bit_copy.h"
 
 static size_t min(size_t a, size_t b) {
   return a < b ? a : b;
 }
 
+// Bit by bit version of copyBitsLittleEndian, at most one byte per step.
+static void copyBitsLittleEndianBytewise(uint8_t* dst, const uint8_t* src,
+        size_t numBits,
+        size_t dstTotBitOff, size_t srcTotBitOff) {
+  while(numBits>0){
+    uint8_t dstBitOff = dstTotBitOff%8U;
+    uint8_t srcBitOff = srcTotBitOff%8U;
+    size_t dstByteOff = dstTotBitOff/8U;
+    size_t srcByteOff = srcTotBitOff/8U;
+    uint8_t numBits2Copy = min(numBits,min(8U-dstBitOff,8U-srcBitOff));
+    // copy bits
+    copyBitsHelper(dst+dstByteOff,src+srcByteOff,numBits2Copy,dstBitOff,srcBitOff);
+    // increment
+    dstTotBitOff += numBits2Copy;
+    srcTotBitOff += numBits2Copy;
+    numBits -= numBits2Copy;
+  }
+}
+
 /**
  * Copies 'numBits' from an offset of 'srcTotBitOff' in the 'src' buffer
  * to an offset of 'dstTotBitOff' in the 'dst' buffer. The offsets are
  * counted from the LSB. Each buffer is an array of bytes, with index 0
  * being the LSB and the highest index being the MSB.
  *
+ * Once the destination is byte aligned, whole bytes are copied 32 bits at
+ * a time (memcpy if the source is aligned too). Only the bits before that
+ * and the last partial byte go through copyBitsHelper.
+ *
  * @param dst: Destination buffer
  * @param src: Source buffer
  * @param numBits: Number of bits to copy from src to dst
@@ -26,19 +51,44 @@ static size_t min(size_t a, size_t b) {
 void copyBitsLittleEndian(uint8_t* dst, const uint8_t* src,
         size_t numBits,
         size_t dstTotBitOff, size_t srcTotBitOff) {
-  while(numBits>0){
-    uint8_t dstBitOff = dstTotBitOff%8U;
-    uint8_t srcBitOff = srcTotBitOff%8U;
-    size_t dstByteOff = dstTotBitOff/8U;
-    size_t srcByteOff = srcTotBitOff/8U;
-    uint8_t numBits2Copy = min(numBits,min(8U-dstBitOff,8U-srcBitOff));
-    // copy bits
-    copyBitsHelper(dst+dstByteOff,src+srcByteOff,numBits2Copy,dstBitOff,srcBitOff);
-    // increment
-    dstTotBitOff += numBits2Copy;
-    srcTotBitOff += numBits2Copy;
-    numBits -= numBits2Copy;
+  // bits up to the next byte boundary in dst
+  size_t headBits = min(numBits, (8U - dstTotBitOff%8U)%8U);
+  copyBitsLittleEndianBytewise(dst, src, headBits, dstTotBitOff, srcTotBitOff);
+  dstTotBitOff += headBits;
+  srcTotBitOff += headBits;
+  numBits -= headBits;
+
+  dst += dstTotBitOff/8U;
+  src += srcTotBitOff/8U;
+  uint8_t shift = srcTotBitOff%8U;
+  size_t numBytes = numBits/8U;
+
+  if(shift == 0){
+    memcpy(dst, src, numBytes);
+    dst += numBytes;
+    src += numBytes;
+  }else{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    // Each output word takes its top bits from the byte after the source
+    // word, which is still within the bits being copied.
+    while(numBytes >= 4){
+      uint32_t word;
+      memcpy(&word, src, 4);
+      word = (word >> shift) | ((uint32_t)src[4] << (32U - shift));
+      memcpy(dst, &word, 4);
+      dst += 4;
+      src += 4;
+      numBytes -= 4;
+    }
+#endif
+    while(numBytes > 0){
+      *dst++ = (uint8_t)((src[0] >> shift) | (src[1] << (8U - shift)));
+      src++;
+      numBytes--;
+    }
   }
+
+  copyBitsLittleEndianBytewise(dst, src, numBits%8U, 0, shift);
 }
 
 /**
@@ -103,42 +153,6 @@ void copyBitsHelper(uint8_t *dst, const uint8_t *src,
   *dst |= copiedBits;
 }
 
-#if 0
-void printBits(uint8_t myByte){
- for(uint8_t mask = 0x80; mask; mask >>= 1){
-   if(mask & myByte)
-       Serial.print('1');
-   else
-       Serial.print('0');
- }
-}
-
-void printBytes(uint8_t* myBytes, size_t size, boolean littleEndian){
-  for(size_t s=0; s<size; s++){
-    if(littleEndian){
-      printBits(myBytes[size-s-1]);
-    }else{
-      printBits(myBytes[s]);
-    }
-    Serial.print(" ");
-  }
-}
-#endif
-
-// void reverse(uint8_t* myBytes, size_t size)
-// {
-//     size_t start=0;
-//     size_t end = size;
-//     while (start < end)
-//     {
-//       uint8_t temp = myBytes[start];
-//       myBytes[start] = myBytes[end];
-//       myBytes[end] = temp;
-//       start++;
-//       end--;
-//     }
-// }
-
 void reverse(uint8_t *start, int size) {
     unsigned char *lo = start;
     unsigned char *hi = start + size - 1;
@@ -26,6 +26,8 @@
 //
 // =============================================================================
 
+#include <string.h>
+
 #include "cobs.h"
 
 /// \brief A Consistent Overhead Byte Stuffing (COBS) Encoder.
@@ -56,35 +58,35 @@
 size_t cobs_encode(const uint8_t *source, size_t size, uint8_t *destination)
 {
     size_t read_index = 0;
-    size_t write_index = 1;
-    size_t code_index = 0;
-    uint8_t code = 1;
+    size_t write_index = 0;
 
-    while (read_index < size)
+    // Each block is a code byte followed by up to 254 non-zero bytes, so
+    // find the end of the block with memchr and copy it in one go.
+    for (;;)
     {
-        if (source[read_index] == 0)
+        size_t remaining = size - read_index;
+        size_t max_run = (remaining < 0xFE) ? remaining : 0xFE;
+        const uint8_t *zero = (max_run > 0) ? memchr(&source[read_index], 0, max_run) : NULL;
+        size_t run = (zero != NULL) ? (size_t)(zero - &source[read_index]) : max_run;
+
+        destination[write_index++] = (uint8_t)(run + 1);
+        memcpy(&destination[write_index], &source[read_index], run);
+        write_index += run;
+        read_index += run;
+
+        if (zero != NULL)
         {
-            destination[code_index] = code;
-            code = 1;
-            code_index = write_index++;
+            // The zero is implied by the block ending early
             read_index++;
         }
-        else
+        else if (run < 0xFE)
         {
-            destination[write_index++] = source[read_index++];
-            code++;
-
-            if (code == 0xFF)
-            {
-                destination[code_index] = code;
-                code = 1;
-                code_index = write_index++;
-            }
+            break;
         }
+        // A full block (code 0xFF) is always followed by another one, even at
+        // the end of the data.
     }
 
-    destination[code_index] = code;
-
     return write_index;
 }
 
@@ -94,6 +96,8 @@ size_t cobs_encode(const uint8_t *source, size_t size, uint8_t *destination)
 /// \param destination The target buffer for the decoded bytes.
 /// \returns The number of bytes in the decoded buffer.
 /// \warning destination must have a minimum capacity of size.
+/// \note destination may be the source buffer, decoding never writes ahead
+///     of the bytes it reads.
 size_t cobs_decode(const uint8_t *source, size_t size, uint8_t *destination)
 {
     if (size == 0)
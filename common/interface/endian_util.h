@@ -13,7 +13,6 @@
 #ifndef _ENDIAN_UTIL_H_
 #define _ENDIAN_UTIL_H_
 
-//#include "sdk_common.h"
 #include <limits.h>
 #include <stdint.h>
 
@@ -0,0 +1,145 @@
+#include <string.h>
+
+#include "packet_serial.h"
+
+static void
+handle_packet(PacketSerial *ps) {
+  if (ps->recieve_overflow) {
+    // The frame was cut short, don't hand out a partial packet.
+    ps->recieve_overflow = false;
+    ps->overflow_count++;
+    if (ps->on_error_f) {
+      ps->on_error_f(ps->on_packet_c, PACKET_SERIAL_ERROR_OVERFLOW);
+    }
+  }
+  else {
+    // COBS and SLIP never write ahead of where they read, so decode in place.
+    size_t numDecoded = ps->decode_f(ps->recieve_buffer, ps->recieve_buffer_index,
+        ps->recieve_buffer);
+
+    if (ps->on_packet_f) {
+      ps->on_packet_f(ps->on_packet_c, ps->recieve_buffer, numDecoded);
+    }
+  }
+
+  // reset for additional characters.
+  ps->recieve_buffer_index = 0;
+}
+
+static void
+receive_byte(PacketSerial *ps, uint8_t data) {
+  if (data == ps->packet_marker) {
+    handle_packet(ps);
+  }
+  else if (ps->recieve_buffer_index < PACKET_SERIAL_RX_BUFFER_SIZE) {
+    ps->recieve_buffer[(ps->recieve_buffer_index)++] = data;
+  }
+  else {
+    // Drop the rest of the frame, reported at its marker.
+    ps->recieve_overflow = true;
+  }
+}
+
+static void
+init_packet_serial(PacketSerial *ps, uint8_t packet_marker) {
+  ps->recieve_buffer_index = 0;
+  ps->recieve_overflow = false;
+  ps->overflow_count = 0;
+  ps->packet_marker = packet_marker;
+  ps->on_error_f = NULL;
+}
+
+void
+init_cobs_packet_serial(PacketSerial *ps, uint8_t packet_marker) {
+  ps->encode_f = cobs_encode;
+  ps->decode_f = cobs_decode;
+  ps->get_encoded_buffer_size_f = cobs_getEncodedBufferSize;
+
+  init_packet_serial(ps, packet_marker);
+}
+
+void
+init_slip_packet_serial(PacketSerial *ps, uint8_t packet_marker) {
+  ps->encode_f = slip_encode;
+  ps->decode_f = slip_decode;
+  ps->get_encoded_buffer_size_f = slip_getEncodedBufferSize;
+
+  init_packet_serial(ps, packet_marker);
+}
+
+void
+update_polling(PacketSerial *ps) {
+  if (ps == NULL || ps->serial_available_f == NULL || ps->serial_read_f == NULL) {
+    return;
+  }
+
+  while (ps->serial_available_f() > 0) {
+    receive_byte(ps, ps->serial_read_f());
+  }
+}
+
+void
+update(PacketSerial *ps, uint8_t data) {
+  if (ps == NULL) {
+    return;
+  }
+
+  receive_byte(ps, data);
+}
+
+size_t
+update_buffer(PacketSerial *ps, const uint8_t *data, size_t size) {
+  if (ps == NULL || data == NULL || size == 0) {
+    return 0;
+  }
+
+  const uint8_t *marker = memchr(data, ps->packet_marker, size);
+  size_t length = (marker != NULL) ? (size_t)(marker - data) : size;
+
+  if (marker != NULL && ps->recieve_buffer_index == 0 && !ps->recieve_overflow
+      && length <= PACKET_SERIAL_RX_BUFFER_SIZE) {
+    // The whole frame is here, decode it straight out of data.
+    size_t numDecoded = ps->decode_f(data, length, ps->recieve_buffer);
+    if (ps->on_packet_f) {
+      ps->on_packet_f(ps->on_packet_c, ps->recieve_buffer, numDecoded);
+    }
+    return length + 1;
+  }
+
+  if (length <= PACKET_SERIAL_RX_BUFFER_SIZE - ps->recieve_buffer_index) {
+    memcpy(&ps->recieve_buffer[ps->recieve_buffer_index], data, length);
+    ps->recieve_buffer_index += length;
+  }
+  else {
+    ps->recieve_overflow = true;
+  }
+
+  if (marker == NULL) {
+    return size;
+  }
+
+  handle_packet(ps);
+  return length + 1;
+}
+
+bool
+send(PacketSerial *ps, const uint8_t *buffer, size_t size) {
+  if (ps == NULL || ps->encode_f == NULL || ps->serial_write_buffer_f == NULL
+      || ps->serial_write_f == NULL || buffer == NULL || size == 0) {
+    return false;
+  }
+
+  // Leave room for the packet marker
+  if (ps->get_encoded_buffer_size_f(size) + 1 > sizeof(ps->encode_buffer)) {
+    return false;
+  }
+
+  size_t numEncoded = ps->encode_f(buffer, size, ps->encode_buffer);
+
+  // TODO: figure out a better way to send the packet marker other than stuffing it here.
+  ps->encode_buffer[numEncoded] = ps->packet_marker;
+
+  ps->serial_write_buffer_f((const char*) ps->encode_buffer, numEncoded+1);
+//  ps->serial_write_f(ps->packet_marker);
+  return true;
+}
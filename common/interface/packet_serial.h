@@ -24,18 +24,39 @@
 #ifndef _PACKET_SERIAL_H_
 #define _PACKET_SERIAL_H_
 
-#if 0
-#include "sdk_common.h"
-#else
 #include <stdint.h>
 #include <stddef.h>
 #include <stdbool.h>
-#endif
 
 #include "cobs.h"
 #include "slip.h"
 
+// Largest encoded frame accepted, without the packet marker. Longer frames
+// are dropped and reported to on_error_f. Can be set per build.
+#ifndef PACKET_SERIAL_RX_BUFFER_SIZE
+#define PACKET_SERIAL_RX_BUFFER_SIZE 512
+#endif
+
+// Largest packet send() accepts, before encoding. Can be set per build.
+#ifndef PACKET_SERIAL_TX_BUFFER_SIZE
+#define PACKET_SERIAL_TX_BUFFER_SIZE 256
+#endif
+
+// COBS worst case for the largest packet, plus the packet marker. SLIP
+// needs up to twice the packet size, so it can send about half as much.
+#define PACKET_SERIAL_ENCODE_BUFFER_SIZE \
+  (PACKET_SERIAL_TX_BUFFER_SIZE + PACKET_SERIAL_TX_BUFFER_SIZE / 254 + 2)
+
+// Largest packet sent, also used by callers to size their buffers.
+#define BUFFER_SIZE PACKET_SERIAL_TX_BUFFER_SIZE
+
+typedef enum PacketSerialError
+{
+    PACKET_SERIAL_ERROR_OVERFLOW = 1, // frame didn't fit the receive buffer
+} PacketSerialError;
+
 typedef void (*packet_handler_func)(void* context, const uint8_t *buffer, size_t size);
+typedef void (*packet_error_func)(void* context, PacketSerialError error);
 typedef int (*serial_available_func)(void);
 typedef uint8_t (*serial_read_func)(void);
 typedef size_t (*serial_write_func)(uint8_t val);
@@ -46,19 +67,20 @@ typedef size_t (*encode_func)(const uint8_t *buffer, size_t size, uint8_t *encod
 typedef size_t (*decode_func)(const uint8_t *buffer, size_t size, uint8_t *decoded);
 typedef size_t (*get_encoded_buffer_size_func)(size_t sourceSize);
 
-#define BUFFER_SIZE 256
-
 typedef struct PacketSerial
 {
-    uint8_t recieve_buffer[BUFFER_SIZE];
+    // Frames are decoded in place, the packet handler gets this buffer.
+    uint8_t recieve_buffer[PACKET_SERIAL_RX_BUFFER_SIZE];
     size_t recieve_buffer_index;
+    bool recieve_overflow; // dropping the rest of a frame that didn't fit
+    size_t overflow_count;
     uint8_t packet_marker;
-    uint8_t decode_buffer[BUFFER_SIZE];
-    uint8_t encode_buffer[BUFFER_SIZE];
+    uint8_t encode_buffer[PACKET_SERIAL_ENCODE_BUFFER_SIZE];
 
     // packet handler
-    void * on_packet_c; // context for the call to on_packet_f.
+    void * on_packet_c; // context for the calls to on_packet_f and on_error_f.
     packet_handler_func on_packet_f;
+    packet_error_func on_error_f; // optional
 
     // serial functions
     serial_available_func serial_available_f;
@@ -77,6 +99,10 @@ void init_cobs_packet_serial(PacketSerial *ps, uint8_t packet_marker);
 void init_slip_packet_serial(PacketSerial *ps, uint8_t packet_marker);
 void update_polling(PacketSerial *ps);
 void update(PacketSerial *ps, uint8_t data);
-void send(PacketSerial *ps, const uint8_t *buffer, size_t size);
+// Chunked update(): consumes data up to and including the next packet
+// marker, handling at most one packet. Returns the number of bytes consumed.
+size_t update_buffer(PacketSerial *ps, const uint8_t *data, size_t size);
+// Returns false if the packet is too large to send.
+bool send(PacketSerial *ps, const uint8_t *buffer, size_t size);
 
 #endif //_PACKET_SERIAL_H_
@@ -99,6 +99,8 @@ size_t slip_encode(const uint8_t *buffer, size_t size, uint8_t *encoded)
 /// \param destination The target buffer for the decoded bytes.
 /// \returns The number of bytes in the decoded buffer.
 /// \warning destination must have a minimum capacity of size.
+/// \note destination may be the source buffer, decoding never writes ahead
+///     of the bytes it reads.
 size_t slip_decode(const uint8_t *buffer, size_t size, uint8_t *decoded)
 {
     if (size == 0)
@@ -116,19 +118,20 @@ size_t slip_decode(const uint8_t *buffer, size_t size, uint8_t *decoded)
         }
         else if (buffer[read_index] == ESC)
         {
-            if (buffer[read_index + 1] == ESC_END)
+            if (read_index + 1 < size && buffer[read_index + 1] == ESC_END)
             {
                 decoded[write_index++] = END;
                 read_index += 2;
             }
-            else if (buffer[read_index + 1] == ESC_ESC)
+            else if (read_index + 1 < size && buffer[read_index + 1] == ESC_ESC)
             {
                 decoded[write_index++] = ESC;
                 read_index += 2;
             }
             else
             {
-                // considered a protocol violation
+                // considered a protocol violation, drop the ESC
+                read_index++;
             }
         }
         else
@@ -32,13 +32,9 @@
 #ifndef _SLIP_H_
 #define _SLIP_H_
 
-#if 0
-#include "sdk_common.h"
-#else
 #include <stdint.h>
 #include <stddef.h>
 #include <stdbool.h>
-#endif
 
 /// \brief A Serial Line IP (SLIP) Encoder.
 ///
@@ -0,0 +1,215 @@
+// Host loopback test for the binary interface: one BinaryInterface writes
+// commands, the packets go over a memory "wire" into a second one, fed byte
+// by byte or in chunks.
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "binary_interface.h"
+
+enum {
+  CC_NONE = 0,
+  CC_ECHO = 1,   // string argument, stored whole
+  CC_SHORT = 2,  // string argument, stored truncated to SHORT_LEN
+  CC_UNUSED = 3,
+};
+
+#define SHORT_LEN 8
+#define MAX_RECEIVED 16
+
+static uint8_t wire[4096];
+static size_t wire_len;
+
+static char received[MAX_RECEIVED][BUFFER_SIZE + 1];
+static size_t received_count;
+static size_t error_count;
+
+static size_t serial_write(uint8_t val)
+{
+  assert(wire_len < sizeof(wire));
+  wire[wire_len++] = val;
+  return 1;
+}
+
+static size_t serial_write_buffer(const char *buffer, size_t size)
+{
+  assert(wire_len + size <= sizeof(wire));
+  memcpy(&wire[wire_len], buffer, size);
+  wire_len += size;
+  return size;
+}
+
+static void handle_echo(BinaryReader *r)
+{
+  assert(received_count < MAX_RECEIVED);
+  ErrValUINT8 len = readSTRING(r, received[received_count], BUFFER_SIZE + 1);
+  assert(len.error_ == ERROR_NONE);
+  received_count++;
+}
+
+static void handle_short(BinaryReader *r)
+{
+  char buf[SHORT_LEN + 1];
+  ErrValUINT8 len = readSTRING(r, buf, sizeof(buf));
+  assert(len.error_ == ERROR_NONE);
+  assert(received_count < MAX_RECEIVED);
+  strcpy(received[received_count++], buf);
+}
+
+static void on_error(void *context, PacketSerialError error)
+{
+  assert(error == PACKET_SERIAL_ERROR_OVERFLOW);
+  error_count++;
+}
+
+static Command commands[] = {
+  { CC_NONE, NULL },
+  { CC_ECHO, handle_echo },
+  { CC_SHORT, handle_short },
+  { CC_UNUSED, NULL },
+};
+
+static BinaryInterface tx;
+static BinaryInterface rx;
+
+static void reset(void)
+{
+  memset(&tx, 0, sizeof(tx));
+  memset(&rx, 0, sizeof(rx));
+  tx.pSerial.serial_write_f = serial_write;
+  tx.pSerial.serial_write_buffer_f = serial_write_buffer;
+  bi_init(&tx, commands, sizeof(commands) / sizeof(commands[0]));
+  bi_init(&rx, commands, sizeof(commands) / sizeof(commands[0]));
+  rx.pSerial.on_error_f = on_error;
+
+  wire_len = 0;
+  received_count = 0;
+  error_count = 0;
+}
+
+// Feeds the wire to rx one byte at a time (chunk 0) or in chunks.
+static void deliver(size_t chunk)
+{
+  size_t pos = 0;
+  while (pos < wire_len) {
+    if (chunk == 0) {
+      handleMessages(&rx, wire[pos++]);
+      continue;
+    }
+    size_t end = (wire_len - pos < chunk) ? wire_len : pos + chunk;
+    while (pos < end) {
+      size_t used = handleMessagesBuffer(&rx, &wire[pos], end - pos);
+      assert(used > 0);
+      pos += used;
+    }
+  }
+}
+
+static void write_string(BinaryWriter *bw, uint8_t cc, const char *str)
+{
+  assert(writeUINT8(bw, cc));
+  assert(writeSTRING(bw, (char *)str, strlen(str)));
+}
+
+// Puts a raw packet on the wire, bypassing the writer and its size limit.
+static void put_packet(const uint8_t *packet, size_t size)
+{
+  static uint8_t encoded[4096];
+  size_t n = cobs_encode(packet, size, encoded);
+  serial_write_buffer((const char *)encoded, n);
+  serial_write(0);
+}
+
+static void run(size_t chunk)
+{
+  BinaryWriter *bw = getWriter(&tx);
+  uint8_t packet[1024];
+  size_t len;
+
+  // one command per packet
+  reset();
+  write_string(bw, CC_ECHO, "hello");
+  assert(bw_send(bw));
+  write_string(bw, CC_ECHO, "world");
+  assert(bw_send(bw));
+  deliver(chunk);
+  assert(received_count == 2);
+  assert(strcmp(received[0], "hello") == 0);
+  assert(strcmp(received[1], "world") == 0);
+
+  // several commands in one packet, a truncated string doesn't shift the
+  // commands after it
+  reset();
+  write_string(bw, CC_ECHO, "a");
+  write_string(bw, CC_SHORT, "0123456789abcdef");
+  write_string(bw, CC_ECHO, "after");
+  assert(bw_send(bw));
+  deliver(chunk);
+  assert(received_count == 3);
+  assert(strcmp(received[0], "a") == 0);
+  assert(strcmp(received[1], "01234567") == 0);
+  assert(strcmp(received[2], "after") == 0);
+
+  // an unknown command ends the packet
+  reset();
+  write_string(bw, CC_ECHO, "x");
+  assert(writeUINT8(bw, CC_UNUSED));
+  write_string(bw, CC_ECHO, "y");
+  assert(bw_send(bw));
+  write_string(bw, CC_ECHO, "z");
+  assert(bw_send(bw));
+  deliver(chunk);
+  assert(received_count == 2);
+  assert(strcmp(received[0], "x") == 0);
+  assert(strcmp(received[1], "z") == 0);
+
+  // packets up to the receive buffer size get through, longer ones are
+  // reported and dropped without affecting the next one
+  for (size_t size = 300; size <= PACKET_SERIAL_RX_BUFFER_SIZE + 300; size += 100) {
+    reset();
+    len = 0;
+    while (len + 2 + 100 <= size) {
+      packet[len++] = CC_ECHO;
+      packet[len++] = 100;
+      memset(&packet[len], 'a' + received_count++ % 26, 100);
+      len += 100;
+    }
+    size_t commands_sent = received_count;
+    put_packet(packet, len);
+    write_string(bw, CC_ECHO, "next");
+    assert(bw_send(bw));
+    received_count = 0;
+    deliver(chunk);
+
+    // COBS adds one byte per 254 and no zeros are in the data
+    bool fits = cobs_getEncodedBufferSize(len) <= PACKET_SERIAL_RX_BUFFER_SIZE;
+    assert(error_count == (fits ? 0 : 1));
+    assert(rx.pSerial.overflow_count == error_count);
+    assert(received_count == (fits ? commands_sent : 0) + 1);
+    assert(strcmp(received[received_count - 1], "next") == 0);
+  }
+
+  // the writer can't build a packet larger than send() takes, and send()
+  // refuses packets that don't fit its encode buffer
+  reset();
+  memset(packet, 'q', sizeof(packet));
+  assert(!writeSTRING(bw, (char *)packet, BUFFER_SIZE));
+  assert(!send(&tx.pSerial, packet, PACKET_SERIAL_ENCODE_BUFFER_SIZE));
+  assert(wire_len == 0);
+  assert(send(&tx.pSerial, packet, BUFFER_SIZE));
+  assert(wire_len == cobs_getEncodedBufferSize(BUFFER_SIZE) + 1);
+}
+
+int main(void)
+{
+  static const size_t chunks[] = { 0, 1, 5, 64, sizeof(wire) };
+
+  for (size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+    run(chunks[i]);
+    printf("chunks of %zu: ok\n", chunks[i]);
+  }
+
+  printf("binary_interface_test passed\n");
+  return 0;
+}
@@ -0,0 +1,16 @@
+set -x
+
+# the whole library, as both firmware builds compile it
+LIB="-I .. ../*.c"
+
+# update_buffer() fed in chunks vs update() fed one byte at a time
+gcc -O2 -Wall $LIB ./packet_serial_test.c && ./a.out || exit 1
+
+# two BinaryInterfaces talking over a memory loopback
+gcc -O2 -Wall $LIB ./binary_interface_test.c && ./a.out || exit 1
+
+# random round trips through the codecs, bit_copy and reader/writer
+gcc -O2 -Wall $LIB ./interface_fuzz_test.c && ./a.out || exit 1
+
+# cleanup
+rm ./a.out
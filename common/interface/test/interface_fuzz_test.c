@@ -0,0 +1,338 @@
+// Randomized round-trip test for the interface library: COBS and SLIP
+// encode/decode, copyBitsLittleEndian against a bit by bit reference, and
+// BinaryWriter/BinaryReader with random field sequences. The seed and the
+// number of iterations can be given on the command line to reproduce a
+// failure: interface_fuzz_test [iterations] [seed]
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "binary_reader.h"
+#include "binary_writer.h"
+#include "bit_copy.h"
+#include "cobs.h"
+#include "slip.h"
+
+#define MAX_SIZE 1200
+
+static uint32_t rng_state;
+
+// xorshift32, so runs are the same on every host
+static uint32_t rnd(void)
+{
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+static size_t rnd_below(size_t n)
+{
+  return n ? rnd() % n : 0;
+}
+
+// Random data with a random share of zeros, or runs around the COBS block
+// length, which is where encoders tend to go wrong.
+static size_t fill_random(uint8_t *buf, size_t max)
+{
+  size_t size = rnd_below(max + 1);
+  uint32_t zero_chance = rnd_below(4) == 0 ? 0 : rnd_below(256);
+
+  for (size_t i = 0; i < size; i++) {
+    uint8_t val = rnd();
+    buf[i] = (rnd_below(256) < zero_chance) ? 0 : (val ? val : 1);
+  }
+  if (rnd_below(4) == 0 && size > 0) {
+    // zero right at a block boundary
+    static const size_t at[] = { 253, 254, 255, 508, 509 };
+    size_t i = at[rnd_below(sizeof(at) / sizeof(at[0]))];
+    if (i < size) {
+      buf[i] = 0;
+    }
+  }
+  return size;
+}
+
+// The byte at a time encoder cobs_encode() replaced, as a reference.
+static size_t cobs_encode_reference(const uint8_t *source, size_t size, uint8_t *destination)
+{
+  size_t read_index = 0;
+  size_t write_index = 1;
+  size_t code_index = 0;
+  uint8_t code = 1;
+
+  while (read_index < size) {
+    if (source[read_index] == 0) {
+      destination[code_index] = code;
+      code = 1;
+      code_index = write_index++;
+      read_index++;
+    }
+    else {
+      destination[write_index++] = source[read_index++];
+      code++;
+      if (code == 0xFF) {
+        destination[code_index] = code;
+        code = 1;
+        code_index = write_index++;
+      }
+    }
+  }
+  destination[code_index] = code;
+  return write_index;
+}
+
+static void test_cobs(void)
+{
+  static uint8_t data[MAX_SIZE];
+  static uint8_t encoded[MAX_SIZE + MAX_SIZE / 254 + 1];
+  static uint8_t reference[MAX_SIZE + MAX_SIZE / 254 + 1];
+  static uint8_t decoded[MAX_SIZE + MAX_SIZE / 254 + 1];
+
+  size_t size = fill_random(data, MAX_SIZE);
+  size_t n = cobs_encode(data, size, encoded);
+
+  assert(n <= cobs_getEncodedBufferSize(size));
+  assert(n == cobs_encode_reference(data, size, reference));
+  assert(memcmp(encoded, reference, n) == 0);
+  assert(memchr(encoded, 0, n) == NULL);
+
+  assert(cobs_decode(encoded, n, decoded) == size);
+  assert(memcmp(decoded, data, size) == 0);
+
+  // in place, as PacketSerial does it
+  assert(cobs_decode(encoded, n, encoded) == size);
+  assert(memcmp(encoded, data, size) == 0);
+
+  // garbage must not write past size
+  size = fill_random(data, MAX_SIZE);
+  memset(decoded, 0xA5, sizeof(decoded));
+  n = cobs_decode(data, size, decoded);
+  assert(n <= size);
+  for (size_t i = size; i < sizeof(decoded); i++) {
+    assert(decoded[i] == 0xA5);
+  }
+}
+
+static void test_slip(void)
+{
+  static uint8_t data[MAX_SIZE];
+  static uint8_t encoded[2 * MAX_SIZE + 2];
+  static uint8_t decoded[2 * MAX_SIZE + 2];
+
+  size_t size = fill_random(data, MAX_SIZE);
+  // plenty of END and ESC
+  for (size_t i = 0; i < size; i++) {
+    if (rnd_below(8) == 0) {
+      data[i] = rnd_below(2) ? 0xC0 : 0xDB;
+    }
+  }
+
+  size_t n = slip_encode(data, size, encoded);
+  assert(n <= slip_getEncodedBufferSize(size));
+  assert(slip_decode(encoded, n, decoded) == size);
+  assert(memcmp(decoded, data, size) == 0);
+  assert(slip_decode(encoded, n, encoded) == size);
+  assert(memcmp(encoded, data, size) == 0);
+
+  size = fill_random(data, MAX_SIZE);
+  memset(decoded, 0xA5, sizeof(decoded));
+  n = slip_decode(data, size, decoded);
+  assert(n <= size);
+  for (size_t i = size; i < sizeof(decoded); i++) {
+    assert(decoded[i] == 0xA5);
+  }
+}
+
+static int get_bit(const uint8_t *buf, size_t bit)
+{
+  return (buf[bit / 8] >> (bit % 8)) & 1;
+}
+
+static void set_bit(uint8_t *buf, size_t bit, int val)
+{
+  buf[bit / 8] = (buf[bit / 8] & ~(1U << (bit % 8))) | ((unsigned)val << (bit % 8));
+}
+
+static void test_bit_copy(void)
+{
+  static uint8_t src[MAX_SIZE];
+  static uint8_t dst[MAX_SIZE];
+  static uint8_t expected[MAX_SIZE];
+
+  // mostly short copies like the reader and writer do, some long ones
+  size_t max_bits = rnd_below(4) ? 80 : 8 * (MAX_SIZE - 1);
+  size_t num_bits = rnd_below(max_bits + 1);
+  size_t src_off = rnd_below(8 * MAX_SIZE - num_bits + 1);
+  size_t dst_off = rnd_below(8 * MAX_SIZE - num_bits + 1);
+
+  for (size_t i = 0; i < MAX_SIZE; i++) {
+    src[i] = rnd();
+    dst[i] = rnd();
+  }
+  memcpy(expected, dst, MAX_SIZE);
+  for (size_t i = 0; i < num_bits; i++) {
+    set_bit(expected, dst_off + i, get_bit(src, src_off + i));
+  }
+
+  copyBitsLittleEndian(dst, src, num_bits, dst_off, src_off);
+  assert(memcmp(dst, expected, MAX_SIZE) == 0);
+}
+
+typedef enum {
+  FIELD_UINTX,
+  FIELD_UINT8,
+  FIELD_UINT16,
+  FIELD_UINT32,
+  FIELD_UINT64,
+  FIELD_BOOL_BIT,
+  FIELD_STRING,
+  FIELD_COUNT
+} field_type_t;
+
+typedef struct {
+  field_type_t type;
+  size_t bits;  // FIELD_UINTX
+  uint64_t value;
+  char str[32];
+} field_t;
+
+static size_t random_fields(field_t *fields, size_t max)
+{
+  size_t count = 1 + rnd_below(max);
+
+  for (size_t i = 0; i < count; i++) {
+    field_t *f = &fields[i];
+    f->type = rnd_below(FIELD_COUNT);
+    f->value = ((uint64_t)rnd() << 32) | rnd();
+    switch (f->type) {
+      case FIELD_UINTX:
+        f->bits = 1 + rnd_below(31);
+        f->value &= (1ULL << f->bits) - 1;
+        break;
+      case FIELD_UINT8: f->value &= 0xFF; break;
+      case FIELD_UINT16: f->value &= 0xFFFF; break;
+      case FIELD_UINT32: f->value &= 0xFFFFFFFF; break;
+      case FIELD_UINT64: break;
+      case FIELD_BOOL_BIT: f->value &= 1; break;
+      case FIELD_STRING: {
+        size_t len = rnd_below(sizeof(f->str));
+        for (size_t j = 0; j < len; j++) {
+          f->str[j] = 'a' + rnd_below(26);
+        }
+        f->str[len] = '\0';
+        break;
+      }
+      default: break;
+    }
+  }
+  return count;
+}
+
+static bool write_field(BinaryWriter *bw, const field_t *f)
+{
+  switch (f->type) {
+    case FIELD_UINTX: return writeUINT(bw, f->value, f->bits);
+    case FIELD_UINT8: return writeUINT8(bw, f->value);
+    case FIELD_UINT16: return writeUINT16(bw, f->value);
+    case FIELD_UINT32: return writeUINT32(bw, f->value);
+    case FIELD_UINT64: return writeUINT64(bw, f->value);
+    case FIELD_BOOL_BIT: return writeBOOLasBit(bw, f->value);
+    case FIELD_STRING: return writeCSTRING(bw, (char *)f->str);
+    default: return false;
+  }
+}
+
+static void check_field(BinaryReader *br, const field_t *f)
+{
+  switch (f->type) {
+    case FIELD_UINTX: {
+      ErrValUINT v = readUINTX(br, f->bits);
+      assert(v.error_ == ERROR_NONE && v.value_ == f->value);
+      break;
+    }
+    case FIELD_UINT8: {
+      ErrValUINT8 v = readUINT8(br);
+      assert(v.error_ == ERROR_NONE && v.value_ == f->value);
+      break;
+    }
+    case FIELD_UINT16: {
+      ErrValUINT16 v = readUINT16(br);
+      assert(v.error_ == ERROR_NONE && v.value_ == f->value);
+      break;
+    }
+    case FIELD_UINT32: {
+      ErrValUINT32 v = readUINT32(br);
+      assert(v.error_ == ERROR_NONE && v.value_ == f->value);
+      break;
+    }
+    case FIELD_UINT64: {
+      ErrValUINT64 v = readUINT64(br);
+      assert(v.error_ == ERROR_NONE && v.value_ == f->value);
+      break;
+    }
+    case FIELD_BOOL_BIT: {
+      ErrValBOOL v = readBOOLasBit(br);
+      assert(v.error_ == ERROR_NONE && v.value_ == (bool)f->value);
+      break;
+    }
+    case FIELD_STRING: {
+      char str[sizeof(f->str)];
+      ErrValUINT8 v = readSTRING(br, str, sizeof(str));
+      assert(v.error_ == ERROR_NONE && strcmp(str, f->str) == 0);
+      break;
+    }
+    default:
+      assert(false);
+  }
+}
+
+static void test_reader_writer(void)
+{
+  static uint8_t buffer[256];
+  field_t fields[24];
+  BinaryWriter bw;
+  BinaryReader br;
+  size_t written = 0;
+
+  size_t count = random_fields(fields, sizeof(fields) / sizeof(fields[0]));
+  bw_init(&bw, buffer, sizeof(buffer), NULL);
+  while (written < count) {
+    size_t before = bw_get_bit_size(&bw);
+    if (!write_field(&bw, &fields[written])) {
+      // a failed write leaves the writer as it was
+      assert(bw_get_bit_size(&bw) == before);
+      break;
+    }
+    written++;
+  }
+
+  br_init(&br, buffer, bw_get_size(&bw));
+  for (size_t i = 0; i < written; i++) {
+    check_field(&br, &fields[i]);
+  }
+  // only the padding of the last byte is left
+  assert(bw_get_size(&bw) * 8 - br.bitIndex_ < 8);
+}
+
+int main(int argc, char **argv)
+{
+  unsigned long iterations = (argc > 1) ? strtoul(argv[1], NULL, 0) : 20000;
+  rng_state = (argc > 2) ? strtoul(argv[2], NULL, 0) : 0x1234567;
+  if (rng_state == 0) {
+    rng_state = 1;
+  }
+  printf("interface_fuzz_test: %lu iterations, seed 0x%x\n", iterations, rng_state);
+
+  for (unsigned long i = 0; i < iterations; i++) {
+    test_cobs();
+    test_slip();
+    test_bit_copy();
+    test_reader_writer();
+  }
+
+  printf("interface_fuzz_test passed\n");
+  return 0;
+}
@@ -0,0 +1,169 @@
+// Host test for the packet serial parser: a stream of COBS packets fed to
+// update_buffer() in chunks must produce exactly the packets and overflow
+// errors update() does when fed the same stream one byte at a time.
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "packet_serial.h"
+
+#define STREAM_MAX (64 * 1024)
+#define LOG_MAX    (128 * 1024)
+
+// Received packets, each as a 16-bit length followed by the data. Errors
+// are logged as a length of 0xFFFF.
+typedef struct {
+  uint8_t data[LOG_MAX];
+  size_t len;
+  size_t packets;
+  size_t errors;
+} packet_log_t;
+
+static void on_packet(void *context, const uint8_t *buffer, size_t size)
+{
+  packet_log_t *log = context;
+  assert(log->len + 2 + size <= LOG_MAX);
+  log->data[log->len++] = (uint8_t) size;
+  log->data[log->len++] = (uint8_t)(size >> 8);
+  memcpy(&log->data[log->len], buffer, size);
+  log->len += size;
+  log->packets++;
+}
+
+static void on_error(void *context, PacketSerialError error)
+{
+  packet_log_t *log = context;
+  assert(error == PACKET_SERIAL_ERROR_OVERFLOW);
+  assert(log->len + 2 <= LOG_MAX);
+  log->data[log->len++] = 0xFF;
+  log->data[log->len++] = 0xFF;
+  log->errors++;
+}
+
+static void init(PacketSerial *ps, packet_log_t *log)
+{
+  memset(ps, 0, sizeof(*ps));
+  memset(log, 0, sizeof(*log));
+  init_cobs_packet_serial(ps, 0);
+  ps->on_packet_c = log;
+  ps->on_packet_f = on_packet;
+  ps->on_error_f = on_error;
+}
+
+static uint8_t stream[STREAM_MAX];
+static size_t stream_len;
+static size_t stream_packets;
+static size_t stream_overflows;
+
+// Random packets, including ones with zeros, empty ones and ones too long
+// for the receive buffer.
+static void make_stream(void)
+{
+  uint8_t packet[PACKET_SERIAL_RX_BUFFER_SIZE * 2];
+  uint8_t encoded[PACKET_SERIAL_RX_BUFFER_SIZE * 3];
+
+  stream_len = 0;
+  stream_packets = 0;
+  stream_overflows = 0;
+  while (1) {
+    size_t len;
+    int kind = rand() % 20;
+    if (kind == 0) {
+      len = 0;
+    } else if (kind == 1) {
+      len = PACKET_SERIAL_RX_BUFFER_SIZE - 8 + rand() % PACKET_SERIAL_RX_BUFFER_SIZE;
+    } else {
+      len = 1 + rand() % 200;
+    }
+    for (size_t i = 0; i < len; i++) {
+      packet[i] = (rand() % 4 == 0) ? 0 : (uint8_t) rand();
+    }
+    size_t n = cobs_encode(packet, len, encoded);
+    if (stream_len + n + 1 > STREAM_MAX) {
+      break;
+    }
+    memcpy(&stream[stream_len], encoded, n);
+    stream_len += n;
+    stream[stream_len++] = 0;
+    stream_packets++;
+    if (n > PACKET_SERIAL_RX_BUFFER_SIZE) {
+      stream_overflows++;
+    }
+  }
+}
+
+// Feeds the stream in chunks of 1..max_chunk bytes (random sizes if
+// random_sizes), calling update_buffer() until each chunk is used up.
+static void feed_chunks(PacketSerial *ps, packet_log_t *log, size_t max_chunk,
+    int random_sizes)
+{
+  size_t pos = 0;
+  while (pos < stream_len) {
+    size_t chunk = random_sizes ? 1 + rand() % max_chunk : max_chunk;
+    if (chunk > stream_len - pos) {
+      chunk = stream_len - pos;
+    }
+    size_t off = 0;
+    while (off < chunk) {
+      size_t before = log->packets + log->errors;
+      size_t used = update_buffer(ps, &stream[pos + off], chunk - off);
+      assert(used > 0 && used <= chunk - off);
+      // at most one packet or error per call, and only when ending on a marker
+      size_t after = log->packets + log->errors;
+      assert(after - before <= 1);
+      assert((after != before) == (stream[pos + off + used - 1] == 0));
+      off += used;
+    }
+    pos += chunk;
+  }
+}
+
+int main(void)
+{
+  static PacketSerial ps;
+  static packet_log_t expected;
+  static packet_log_t actual;
+  static const size_t chunk_sizes[] = { 1, 2, 3, 7, 64, 128, 255, 256, 1000, STREAM_MAX };
+
+  srand(1);
+  make_stream();
+
+  init(&ps, &expected);
+  for (size_t i = 0; i < stream_len; i++) {
+    update(&ps, stream[i]);
+  }
+  assert(expected.errors == stream_overflows);
+  assert(expected.packets + expected.errors == stream_packets);
+  assert(ps.overflow_count == stream_overflows);
+  printf("%zu packets, %zu too long, %zu bytes\n", stream_packets,
+         stream_overflows, stream_len);
+
+  for (size_t i = 0; i < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); i++) {
+    for (int random_sizes = 0; random_sizes <= 1; random_sizes++) {
+      init(&ps, &actual);
+      feed_chunks(&ps, &actual, chunk_sizes[i], random_sizes);
+      assert(actual.packets == expected.packets);
+      assert(actual.errors == expected.errors);
+      assert(actual.len == expected.len);
+      assert(memcmp(actual.data, expected.data, expected.len) == 0);
+      printf("chunks of %s%zu: ok\n", random_sizes ? "1.." : "", chunk_sizes[i]);
+    }
+  }
+
+  // a partial packet is kept until its marker arrives
+  init(&ps, &actual);
+  assert(update_buffer(&ps, (const uint8_t *)"\x03\x01", 2) == 2);
+  assert(actual.packets == 0);
+  assert(update_buffer(&ps, (const uint8_t *)"\x02\x00\x05", 3) == 2);
+  assert(actual.packets == 1);
+  assert(actual.data[0] == 2 && actual.data[2] == 1 && actual.data[3] == 2);
+
+  // nothing to do
+  assert(update_buffer(&ps, NULL, 0) == 0);
+  assert(update_buffer(NULL, stream, 1) == 0);
+
+  printf("packet_serial_test passed\n");
+  return 0;
+}
@@ -0,0 +1,35 @@
+/*
+ * nand_layout.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Layout of the external NAND (W25N04KW, 4096 blocks of 64
+ * pages), which the LPC and the nRF52 bootloader share:
+ *
+ *   blocks 0 - 4074     Dhara map (FatFs)                  LPC
+ *   block  4075         Memfault coredump                  LPC
+ *   blocks 4076 - 4094  OTA area, LPC firmware downloads   nRF52 bootloader
+ *   block  4095         Dhara journal hint                 LPC
+ *
+ * Neither side may touch the other's blocks, so change the layout here and
+ * nowhere else.
+ */
+#ifndef NAND_LAYOUT_H
+#define NAND_LAYOUT_H
+
+#define NAND_LAYOUT_BLOCK_COUNT         (4096U)
+#define NAND_LAYOUT_PAGES_PER_BLOCK     (64U)
+
+#define NAND_LAYOUT_HINT_NUM_BLOCKS     (1U)
+#define NAND_LAYOUT_HINT_BLOCK          (NAND_LAYOUT_BLOCK_COUNT - NAND_LAYOUT_HINT_NUM_BLOCKS)
+
+#define NAND_LAYOUT_OTA_NUM_BLOCKS      (19U)
+#define NAND_LAYOUT_OTA_FIRST_BLOCK     (NAND_LAYOUT_HINT_BLOCK - NAND_LAYOUT_OTA_NUM_BLOCKS)
+
+#define NAND_LAYOUT_MEMFAULT_NUM_BLOCKS (1U)
+#define NAND_LAYOUT_MEMFAULT_BLOCK      (NAND_LAYOUT_OTA_FIRST_BLOCK - NAND_LAYOUT_MEMFAULT_NUM_BLOCKS)
+
+// The map takes everything below the Memfault block
+#define NAND_LAYOUT_MAP_NUM_BLOCKS      (NAND_LAYOUT_MEMFAULT_BLOCK)
+
+#endif  // NAND_LAYOUT_H
@@ -265,10 +265,10 @@ static int find_checkblock(struct dhara_journal *j,
 }
 
 static dhara_block_t find_last_checkblock(struct dhara_journal *j,
-					  dhara_block_t first)
+					  dhara_block_t first,
+					  dhara_block_t high)
 {
 	dhara_block_t low = first;
-	dhara_block_t high = j->nand->num_blocks - 1;
 
 	while (low <= high) {
 		const dhara_block_t mid = (low + high) >> 1;
@@ -296,6 +296,35 @@ static dhara_block_t find_last_checkblock(struct dhara_journal *j,
 	return first;
 }
 
+/* Find the last checkpoint-containing block in this epoch, starting from
+ * one known to be in it. Probe blocks at doubling distances until one is
+ * not, then search between the last hit and that miss. This costs reads
+ * in proportion to the log of the distance travelled, rather than of the
+ * chip size.
+ */
+static dhara_block_t find_last_checkblock_from(struct dhara_journal *j,
+					       dhara_block_t start)
+{
+	dhara_block_t low = start;
+	dhara_block_t step = 1;
+
+	for (;;) {
+		const dhara_block_t probe = low + step;
+		dhara_block_t found;
+
+		if (probe >= j->nand->num_blocks)
+			return find_last_checkblock(j, low,
+					j->nand->num_blocks - 1);
+
+		if ((find_checkblock(j, probe, &found, NULL) < 0) ||
+		    (hdr_get_epoch(j->page_buf) != j->epoch))
+			return find_last_checkblock(j, low, probe - 1);
+
+		low = found;
+		step <<= 1;
+	}
+}
+
 /* Test whether a checkpoint group is in a state fit for reprogramming,
  * but allow for the fact that is_free() might not have any way of
  * distinguishing between an unprogrammed page, and a page programmed
@@ -436,21 +465,11 @@ static int find_head(struct dhara_journal *j, dhara_page_t start,
 	return 0;
 }
 
-int dhara_journal_resume(struct dhara_journal *j, dhara_error_t *err)
+static int resume_from(struct dhara_journal *j, dhara_block_t last,
+		       dhara_error_t *err)
 {
-	dhara_block_t first, last;
 	dhara_page_t last_group;
 
-	/* Find the first checkpoint-containing block */
-	if (find_checkblock(j, 0, &first, err) < 0) {
-		reset_journal(j);
-		return -1;
-	}
-
-	/* Find the last checkpoint-containing block in this epoch */
-	j->epoch = hdr_get_epoch(j->page_buf);
-	last = find_last_checkblock(j, first);
-
 	/* Find the last programmed checkpoint group in the block */
 	last_group = find_last_group(j, last);
 
@@ -481,6 +500,51 @@ int dhara_journal_resume(struct dhara_journal *j, dhara_error_t *err)
 	return 0;
 }
 
+int dhara_journal_resume(struct dhara_journal *j, dhara_error_t *err)
+{
+	dhara_block_t first;
+
+	/* Find the first checkpoint-containing block */
+	if (find_checkblock(j, 0, &first, err) < 0) {
+		reset_journal(j);
+		return -1;
+	}
+
+	/* Find the last checkpoint-containing block in this epoch */
+	j->epoch = hdr_get_epoch(j->page_buf);
+	return resume_from(j, find_last_checkblock(j, first,
+					j->nand->num_blocks - 1), err);
+}
+
+int dhara_journal_resume_hint(struct dhara_journal *j, dhara_block_t hint,
+			      dhara_error_t *err)
+{
+	dhara_block_t first;
+	dhara_block_t found;
+
+	/* Find the first checkpoint-containing block */
+	if (find_checkblock(j, 0, &first, err) < 0) {
+		reset_journal(j);
+		return -1;
+	}
+
+	j->epoch = hdr_get_epoch(j->page_buf);
+
+	/* Any checkpoint-containing block of this epoch will do as a
+	 * starting point, since all those from the first one up to it
+	 * belong to the epoch too. If the hint is out of date, fall back
+	 * to searching the whole chip.
+	 */
+	if ((hint < first) || (hint >= j->nand->num_blocks) ||
+	    (find_checkblock(j, hint, &found, NULL) < 0) ||
+	    (found != hint) ||
+	    (hdr_get_epoch(j->page_buf) != j->epoch))
+		return resume_from(j, find_last_checkblock(j, first,
+					j->nand->num_blocks - 1), err);
+
+	return resume_from(j, find_last_checkblock_from(j, hint), err);
+}
+
 /**************************************************************************
  * Public interface
  */
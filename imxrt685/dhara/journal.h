@@ -153,6 +153,15 @@ void dhara_journal_init(struct dhara_journal *j,
  */
 int dhara_journal_resume(struct dhara_journal *j, dhara_error_t *err);
 
+/* Resume, starting the search for the journal head from a block that
+ * held a checkpoint when it was last known, e.g. dhara_journal_root()
+ * saved across a reset. The search then costs O(log D), where D is the
+ * number of blocks written since. If the hint is no longer valid, this
+ * is the same as dhara_journal_resume().
+ */
+int dhara_journal_resume_hint(struct dhara_journal *j, dhara_block_t hint,
+			      dhara_error_t *err);
+
 /* Obtain an upper bound on the number of user pages storable in the
  * journal.
  */
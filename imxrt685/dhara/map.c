@@ -90,6 +90,18 @@ int dhara_map_resume(struct dhara_map *m, dhara_error_t *err)
 	return 0;
 }
 
+int dhara_map_resume_hint(struct dhara_map *m, dhara_block_t hint,
+			  dhara_error_t *err)
+{
+	if (dhara_journal_resume_hint(&m->journal, hint, err) < 0) {
+		m->count = 0;
+		return -1;
+	}
+
+	m->count = ck_get_count(dhara_journal_cookie(&m->journal));
+	return 0;
+}
+
 void dhara_map_clear(struct dhara_map *m)
 {
 	if (m->count) {
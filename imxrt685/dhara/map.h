@@ -51,6 +51,10 @@ void dhara_map_init(struct dhara_map *m, const struct dhara_nand *n,
  */
 int dhara_map_resume(struct dhara_map *m, dhara_error_t *err);
 
+/* As above, see dhara_journal_resume_hint(). */
+int dhara_map_resume_hint(struct dhara_map *m, dhara_block_t hint,
+			  dhara_error_t *err);
+
 /* Clear the map (delete all sectors). */
 void dhara_map_clear(struct dhara_map *m);
 
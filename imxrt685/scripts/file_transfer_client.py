@@ -0,0 +1,254 @@
+#!/usr/bin/env python3
+"""Receive a file from the headband with resume and integrity check.
+
+Reference receiver for source/commands/file_transfer.h. The output file is
+kept when a transfer is interrupted, and running the same command again
+continues from its end. The file is only reported good once its SHA-256
+matches the one the device computed over the whole file.
+
+Usage:
+    file_transfer_client.py --serial /dev/ttyUSB0 <remote> <local>
+    file_transfer_client.py --exec "<command>" <remote> <local>
+
+--serial sends "fs_send <remote> <offset>" to the debug shell (needs
+pyserial). --exec runs <command> <remote> <offset> and talks to it over
+stdin/stdout, this is how the host test drives the device code. Over BLE
+the app sends ble_fs_send and implements the same receiver.
+"""
+
+import argparse
+import hashlib
+import os
+import select
+import shlex
+import struct
+import subprocess
+import sys
+import zlib
+
+START = b"S"
+DATA = b"D"
+END = b"E"
+ACK = b"A"
+NAK = b"N"
+CAN = b"\x18"
+
+START_FMT = "<IIH"  # size, offset, chunk_len
+DATA_FMT = "<IH"    # offset, len
+END_FMT = "<I32s"   # size, sha256
+
+# Seconds without a frame before asking for a resend
+TIMEOUT = 3.0
+# Consecutive timeouts before giving up
+MAX_ERRORS = 5
+
+
+class LinkTimeout(Exception):
+    pass
+
+
+class Aborted(Exception):
+    pass
+
+
+class SerialLink:
+    def __init__(self, port, baud):
+        import serial  # only needed for this link
+        self.port = serial.Serial(port, baud, timeout=TIMEOUT)
+
+    def start(self, remote, offset):
+        self.port.reset_input_buffer()
+        self.port.write(("fs_send %s %d\r\n" % (remote, offset)).encode())
+
+    def read(self, n):
+        data = self.port.read(n)
+        if len(data) < n:
+            raise LinkTimeout()
+        return data
+
+    def write(self, data):
+        self.port.write(data)
+
+    def close(self):
+        self.port.close()
+
+
+class ProcessLink:
+    def __init__(self, command):
+        self.command = shlex.split(command)
+        self.proc = None
+
+    def start(self, remote, offset):
+        self.proc = subprocess.Popen(self.command + [remote, str(offset)],
+                                     stdin=subprocess.PIPE,
+                                     stdout=subprocess.PIPE)
+
+    def read(self, n):
+        out = b""
+        fd = self.proc.stdout.fileno()
+        while len(out) < n:
+            ready, _, _ = select.select([fd], [], [], TIMEOUT)
+            if not ready:
+                raise LinkTimeout()
+            data = os.read(fd, n - len(out))
+            if not data:
+                raise Aborted("link closed")
+            out += data
+        return out
+
+    def write(self, data):
+        try:
+            self.proc.stdin.write(data)
+            self.proc.stdin.flush()
+        except BrokenPipeError:
+            raise Aborted("link closed")
+
+    def close(self):
+        if self.proc:
+            # Let the sender see the last ack, then EOF
+            try:
+                self.proc.stdin.close()
+                self.proc.wait(timeout=2 * TIMEOUT)
+            except (BrokenPipeError, subprocess.TimeoutExpired):
+                self.proc.kill()
+                self.proc.wait()
+
+
+def read_frame(link, chunk_len):
+    """Returns (type, fields, payload), or None for a frame with a bad CRC.
+    Bytes that don't start a frame are skipped."""
+    while True:
+        t = link.read(1)
+        if t == CAN:
+            if link.read(1) == CAN:
+                raise Aborted("device aborted")
+            continue
+        if t == START:
+            fmt = START_FMT
+        elif t == DATA:
+            fmt = DATA_FMT
+        elif t == END:
+            fmt = END_FMT
+        else:
+            continue
+
+        header = link.read(struct.calcsize(fmt))
+        fields = struct.unpack(fmt, header)
+        payload = b""
+        if t == DATA:
+            if fields[1] > chunk_len:
+                return None
+            payload = link.read(fields[1])
+        crc, = struct.unpack("<I", link.read(4))
+        if zlib.crc32(t + header + payload) != crc:
+            return None
+        return t, fields, payload
+
+
+def receive(link, remote, local, restart=False):
+    mode = "wb" if restart or not os.path.exists(local) else "r+b"
+    with open(local, mode) as out:
+        offset = out.seek(0, os.SEEK_END)
+        link.start(remote, offset)
+
+        # Start frame, repeated by the device until acked
+        errors = 0
+        while True:
+            try:
+                frame = read_frame(link, 0)
+            except LinkTimeout:
+                frame = None
+            if frame and frame[0] == START:
+                size, dev_offset, chunk_len = frame[1]
+                break
+            errors += 1
+            if errors >= MAX_ERRORS:
+                raise Aborted("no start frame")
+        if dev_offset != offset or offset > size:
+            raise Aborted("device started at %d, expected %d" % (dev_offset, offset))
+        link.write(ACK + struct.pack("<I", offset))
+
+        expected = offset
+        nak_sent = False
+        errors = 0
+        while True:
+            try:
+                frame = read_frame(link, chunk_len)
+            except LinkTimeout:
+                frame = None
+                nak_sent = False  # the nak may have been lost too
+                errors += 1
+                if errors >= MAX_ERRORS:
+                    raise Aborted("timed out at %d" % expected)
+
+            if frame is None:
+                # Ask once, frames already in flight are dropped below
+                if not nak_sent:
+                    link.write(NAK + struct.pack("<I", expected))
+                    nak_sent = True
+                continue
+
+            t, fields, payload = frame
+            if t == START:
+                # Our ack was lost
+                link.write(ACK + struct.pack("<I", offset))
+            elif t == DATA:
+                frame_offset = fields[0]
+                if frame_offset == expected:
+                    out.write(payload)
+                    out.flush()
+                    expected += len(payload)
+                    nak_sent = False
+                    errors = 0
+                    link.write(ACK + struct.pack("<I", expected))
+                elif frame_offset < expected:
+                    # Resent after a lost ack
+                    link.write(ACK + struct.pack("<I", expected))
+                elif not nak_sent:
+                    link.write(NAK + struct.pack("<I", expected))
+                    nak_sent = True
+            elif t == END:
+                end_size, digest = fields
+                if end_size != size or expected != size:
+                    raise Aborted("end frame at %d of %d" % (expected, size))
+                break
+
+        out.truncate(size)
+        out.flush()
+
+    with open(local, "rb") as f:
+        local_digest = hashlib.sha256(f.read()).digest()
+    if local_digest != digest:
+        link.write(CAN + CAN)
+        raise Aborted("SHA-256 mismatch, rerun with --restart")
+    link.write(ACK + struct.pack("<I", size))
+    return size, size - offset
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    group = parser.add_mutually_exclusive_group(required=True)
+    group.add_argument("--serial", metavar="PORT", help="debug shell UART")
+    group.add_argument("--exec", metavar="COMMAND", help="run a sender process")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--restart", action="store_true",
+                        help="ignore a partial local file")
+    parser.add_argument("remote", help="file on the device")
+    parser.add_argument("local", help="output file")
+    args = parser.parse_args()
+
+    link = SerialLink(args.serial, args.baud) if args.serial else ProcessLink(args.exec)
+    try:
+        size, received = receive(link, args.remote, args.local, args.restart)
+    except Aborted as e:
+        print("%s: %s" % (args.local, e), file=sys.stderr)
+        return 1
+    finally:
+        link.close()
+
+    print("%s: %d bytes, %d received, SHA-256 ok" % (args.local, size, received))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
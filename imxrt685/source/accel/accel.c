@@ -9,6 +9,8 @@
  */
 
 
+#include <stdlib.h>
+
 #include "board_config.h"
 #include "accel.h"
 #if defined(VARIANT_FF3) || defined(VARIANT_FF4)
@@ -27,6 +29,7 @@
 #include "queue.h"
 #include "user_metrics.h"
 #include "ml.h"
+#include "hrm.h"
 
 #if (defined(ENABLE_ACCEL_TASK) && (ENABLE_ACCEL_TASK > 0U))
 
@@ -137,10 +140,17 @@ typedef struct
   ACCEL_SAMPLE_TYPE samples[32];    // sample buffer
   int16_t temperature;
   uint32_t accel_sample_num;
+  ACCEL_SAMPLE_TYPE prev_sample;    // last sample of the previous batch, for motion detection
+  bool prev_sample_valid;
+  bool in_motion;
 } accel_context_t;
 
 static accel_context_t g_context;
 
+// Sample-to-sample change on any axis that counts as motion for PPG gating.
+// ~0.05 g at the 2 g range (16-bit left-justified, 16384 counts/g).
+#define ACCEL_MOTION_DELTA_THRESHOLD (800)
+
 // Global event queue and handler:
 #define ACCEL_EVENT_QUEUE_SIZE 8
 static uint8_t g_event_queue_array[ACCEL_EVENT_QUEUE_SIZE * sizeof(accel_event_t)];
@@ -247,6 +257,31 @@ handle_state_off(const accel_event_t *event)
   }
 }
 
+// Checks the batch for motion and reports changes to the HRM task.
+static void
+accel_update_motion(const ACCEL_SAMPLE_TYPE* samples, uint8_t num_samples)
+{
+  bool in_motion = false;
+  const ACCEL_SAMPLE_TYPE* prev = g_context.prev_sample_valid ? &g_context.prev_sample : &samples[0];
+
+  for (uint8_t i=0; i<num_samples && !in_motion; i++) {
+    in_motion =
+      abs(samples[i].x - prev->x) > ACCEL_MOTION_DELTA_THRESHOLD ||
+      abs(samples[i].y - prev->y) > ACCEL_MOTION_DELTA_THRESHOLD ||
+      abs(samples[i].z - prev->z) > ACCEL_MOTION_DELTA_THRESHOLD;
+    prev = &samples[i];
+  }
+  if (num_samples > 0) {
+    g_context.prev_sample = samples[num_samples-1];
+    g_context.prev_sample_valid = true;
+  }
+
+  if (in_motion != g_context.in_motion) {
+    g_context.in_motion = in_motion;
+    hrm_event_motion(in_motion);
+  }
+}
+
 static void
 handle_state_sample(const accel_event_t *event)
 {
@@ -264,6 +299,9 @@ handle_state_sample(const accel_event_t *event)
       accel_fifo_config_set();
       // reset sample number
       g_context.accel_sample_num = 0;
+      // restart motion detection
+      g_context.prev_sample_valid = false;
+      g_context.in_motion = false;
       break;
 
     case ACCEL_EVENT_ISR_DONE:
@@ -315,6 +353,8 @@ handle_state_sample(const accel_event_t *event)
           
           ml_event_acc_input( g_context.samples);
 
+          accel_update_motion(g_context.samples, num_samples);
+
           // ToDo Send samples to the ML task
 
           // TODO: placeholder until activity calculation figured out
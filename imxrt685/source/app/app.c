@@ -48,6 +48,7 @@
 #include "pmic_pca9420.h"
 #include "memfault_commands.h"
 #include "ymodem.h"
+#include "file_transfer.h"
 
 #if (defined(ENABLE_APP_TASK) && (ENABLE_APP_TASK > 0U))
 
@@ -551,6 +552,7 @@ handle_state_sleep(app_event_t *event)
     	// go to sleep
       if ((interpreter_get_state() == INTERPRETER_STATE_STANDBY) &&
     		  (!ymodem_is_running()) &&
+    		  (!file_transfer_is_running()) &&
 			  (!ble_is_ota_running()))
       {
         stop_sleep_timer();
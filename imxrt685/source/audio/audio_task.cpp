@@ -13,6 +13,7 @@
 #include <audio_task.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <math.h>
 
 #include "fsl_i2s.h"
 #include "fsl_i2s_dma.h"
@@ -32,6 +33,8 @@
 #include "memman_rtos.h"
 #include "settings.h"
 #include "interpreter.h"
+#include "stim_player.h"
+#include "profiler.h"
 
 #if (defined(ENABLE_AUDIO_TASK) && (ENABLE_AUDIO_TASK > 0U))
 
@@ -46,8 +49,6 @@
 #define AUDIO_EVENT_QUEUE_SIZE 50
 #define AUDIO_EVENT_MEMORY_SIZE 600
 
-#define AUDIO_IDLE_2_POWER_OFF_DELAY_MS 10000
-
 static const char *TAG = "audio";   // Logging prefix for this module
 
 #define AUDIO_FG_WAV_CHANNEL 0
@@ -58,17 +59,15 @@ static const char *TAG = "audio";   // Logging prefix for this module
 
 #define AUDIO_DATA_SIZE 18 // 14
 
-AudioMixer5              mixerLeft;
-AudioMixer5              mixerRight;
+// One update() of the graph per block, it must finish within the block.
+#define AUDIO_BLOCK_US ((uint32_t)(AUDIO_BLOCK_SAMPLES*1000000.0/AUDIO_SAMPLE_RATE_EXACT))
 
+// update() runs in construction order, so the sources and fades come before
+// the mixers and the output, or the mixers would mix the previous block.
 #if (defined(AUDIO_ENABLE_FG_WAV) && (AUDIO_ENABLE_FG_WAV > 0U))
 AudioPlayFsWav         wavFG;
 AudioEffectFade          fade_fg_left(false);
 AudioEffectFade          fade_fg_right(false);
-AudioConnection          patchCord1(wavFG, 0, fade_fg_left , 0);
-AudioConnection          patchCord2(wavFG, 1, fade_fg_right, 0);
-AudioConnection          patchCord3(fade_fg_left, 0, mixerLeft , AUDIO_FG_WAV_CHANNEL);
-AudioConnection          patchCord4(fade_fg_right, 0, mixerRight, AUDIO_FG_WAV_CHANNEL);
 static float fgwav_gain = 0;
 #endif
 
@@ -76,10 +75,6 @@ static float fgwav_gain = 0;
 AudioPlayFsWav         wavBG;
 AudioEffectFade          bg_fade_left(false);
 AudioEffectFade          bg_fade_right(false);
-AudioConnection          patchCord5(wavBG, 0, bg_fade_left , 0);
-AudioConnection          patchCord6(wavBG, 1, bg_fade_right, 0);
-AudioConnection          patchCord7(bg_fade_left, 0, mixerLeft , AUDIO_BG_WAV_CHANNEL);
-AudioConnection          patchCord8(bg_fade_right, 0, mixerRight, AUDIO_BG_WAV_CHANNEL);
 static float bg_gain_script   = 0;
 static float bg_gain_computed = 0;
 static bool bg_mute = false;
@@ -88,33 +83,66 @@ static bool bg_mute = false;
 #if (defined(AUDIO_ENABLE_MP3) && (AUDIO_ENABLE_MP3 > 0U))
 AudioEffectFade          fade_mp3_left(false);
 AudioEffectFade          fade_mp3_right(false);
-AudioConnection          patchCord9(mp3output, 0, fade_mp3_left , 0);
-AudioConnection          patchCord10(mp3output, 1, fade_mp3_right, 0);
-AudioConnection          patchCord11(fade_mp3_left, 0, mixerLeft, AUDIO_MP3_CHANNEL);
-AudioConnection          patchCord12(fade_mp3_right, 0, mixerRight, AUDIO_MP3_CHANNEL);
 static float mp3_gain = 0;
 #endif
 
 #if (defined(AUDIO_ENABLE_PINK) && (AUDIO_ENABLE_PINK > 0U))
 AudioSynthNoisePink      pink;
 AudioEffectFade          pink_fade((false));
-AudioConnection          patchCord13(pink, 0, pink_fade , 0);
-AudioConnection          patchCord14(pink_fade , 0, mixerLeft , AUDIO_PINK_CHANNEL);
-AudioConnection          patchCord15(pink_fade , 0, mixerRight, AUDIO_PINK_CHANNEL);
 static float pink_gain_script   = 0;
 static float pink_gain_computed = 0;
 static bool pink_mute = false;
 #endif
 
+#if (defined(ENABLE_STIM_PLAYER) && (ENABLE_STIM_PLAYER > 0U))
+// Pre-rendered stimulus pulse, mixed in by the I2S output (see stim_player.h).
+#define STIM_PULSE_MAX_SAMPLES ((uint32_t)(STIM_PLAYER_MAX_PULSE_MS*AUDIO_SAMPLE_RATE_EXACT/1000) + 1)
+#define STIM_PULSE_SEED (0x5EED41F5)
+static int16_t g_stim_pulse[STIM_PULSE_MAX_SAMPLES];
+#endif
+
 #if (defined(AUDIO_ENABLE_SINE) && (AUDIO_ENABLE_SINE > 0U))
 AudioSynthWaveformSine   sineLow;
 AudioSynthWaveformSine   sineHigh;
-AudioConnection          patchCord16(sineLow , 0, mixerLeft , AUDIO_SINE_CHANNEL);
-AudioConnection          patchCord17(sineHigh , 0, mixerRight, AUDIO_SINE_CHANNEL);
 static float sine_gain = 0;
 #endif
 
+AudioMixer5              mixerLeft;
+AudioMixer5              mixerRight;
 AudioOutputI2S           audioOutput;
+
+#if (defined(AUDIO_ENABLE_FG_WAV) && (AUDIO_ENABLE_FG_WAV > 0U))
+AudioConnection          patchCord1(wavFG, 0, fade_fg_left , 0);
+AudioConnection          patchCord2(wavFG, 1, fade_fg_right, 0);
+AudioConnection          patchCord3(fade_fg_left, 0, mixerLeft , AUDIO_FG_WAV_CHANNEL);
+AudioConnection          patchCord4(fade_fg_right, 0, mixerRight, AUDIO_FG_WAV_CHANNEL);
+#endif
+
+#if (defined(AUDIO_ENABLE_BG_WAV) && (AUDIO_ENABLE_BG_WAV > 0U))
+AudioConnection          patchCord5(wavBG, 0, bg_fade_left , 0);
+AudioConnection          patchCord6(wavBG, 1, bg_fade_right, 0);
+AudioConnection          patchCord7(bg_fade_left, 0, mixerLeft , AUDIO_BG_WAV_CHANNEL);
+AudioConnection          patchCord8(bg_fade_right, 0, mixerRight, AUDIO_BG_WAV_CHANNEL);
+#endif
+
+#if (defined(AUDIO_ENABLE_MP3) && (AUDIO_ENABLE_MP3 > 0U))
+AudioConnection          patchCord9(mp3output, 0, fade_mp3_left , 0);
+AudioConnection          patchCord10(mp3output, 1, fade_mp3_right, 0);
+AudioConnection          patchCord11(fade_mp3_left, 0, mixerLeft, AUDIO_MP3_CHANNEL);
+AudioConnection          patchCord12(fade_mp3_right, 0, mixerRight, AUDIO_MP3_CHANNEL);
+#endif
+
+#if (defined(AUDIO_ENABLE_PINK) && (AUDIO_ENABLE_PINK > 0U))
+AudioConnection          patchCord13(pink, 0, pink_fade , 0);
+AudioConnection          patchCord14(pink_fade , 0, mixerLeft , AUDIO_PINK_CHANNEL);
+AudioConnection          patchCord15(pink_fade , 0, mixerRight, AUDIO_PINK_CHANNEL);
+#endif
+
+#if (defined(AUDIO_ENABLE_SINE) && (AUDIO_ENABLE_SINE > 0U))
+AudioConnection          patchCord16(sineLow , 0, mixerLeft , AUDIO_SINE_CHANNEL);
+AudioConnection          patchCord17(sineHigh , 0, mixerRight, AUDIO_SINE_CHANNEL);
+#endif
+
 AudioConnection          patchCord18(mixerLeft, 0, audioOutput, 0);
 AudioConnection          patchCord19(mixerRight, 0, audioOutput, 1);
 
@@ -211,6 +239,7 @@ typedef struct
   audio_state_t state;
   TimerHandle_t audio_power_off_timer_handle;
   StaticTimer_t audio_power_off_timer_struct;
+  volatile uint32_t power_off_delay_ms;
 
   uint8_t log_volume;
   uint8_t lin_volume;
@@ -509,6 +538,20 @@ void audio_volume_down()
   xQueueSend(g_event_queue, &event, portMAX_DELAY);
 }
 
+void audio_set_power_off_delay(uint32_t delay_ms)
+{
+  ag_context.power_off_delay_ms = delay_ms;
+  // 0 = never, so a power off that is already counting down is cancelled
+  if (delay_ms == 0 && ag_context.audio_power_off_timer_handle != NULL) {
+    xTimerStop(ag_context.audio_power_off_timer_handle, portMAX_DELAY);
+  }
+}
+
+uint32_t audio_get_power_off_delay(void)
+{
+  return ag_context.power_off_delay_ms;
+}
+
 static void audio_power_off_timeout(TimerHandle_t timer_handle){
   audio_event_t event = {.type = AUDIO_EVENT_POWER_OFF_TIMEOUT };
   xQueueSend(g_event_queue, &event, portMAX_DELAY);
@@ -732,6 +775,9 @@ void audio_pink_fadeout(uint32_t dur_ms)
 }
 
 static inline void audio_pink_set_mixer_gain(float gain_script, float gain_computed, audio_mute_t mute){
+  // audio_pink_pulse_from_isr() can unmute at any time, the whole update
+  // is a critical section so a stale gain never overwrites the unmute.
+  taskENTER_CRITICAL();
   // save script gain
   if(gain_script>=0){
     pink_gain_script = gain_script;
@@ -754,12 +800,11 @@ static inline void audio_pink_set_mixer_gain(float gain_script, float gain_compu
   }
   // compute overall gain
   float gain = pink_mute ? 0 : pink_gain_script*pink_gain_computed;
-  // TODO: implement a threadsafe way of protecting these without a full
-  //       critical section.
-//  taskENTER_CRITICAL();
   mixerLeft.gain(AUDIO_PINK_CHANNEL,gain);
   mixerRight.gain(AUDIO_PINK_CHANNEL,gain);
-//  taskEXIT_CRITICAL();
+  // stimulus pulses play at the pink volume, they are the unmuted part
+  stim_player_set_gain(pink_gain_script*pink_gain_computed);
+  taskEXIT_CRITICAL();
 }
 
 void audio_pink_script_volume(float gain){
@@ -778,6 +823,45 @@ void audio_pink_default_volume(){
   audio_pink_set_mixer_gain( 0, 1, MUTE_TRUE);
 }
 
+// Fast path for the stimulus scheduler timer: unmute without going through
+// the event queue. Must run at or below configMAX_SYSCALL_INTERRUPT_PRIORITY
+// so it cannot land inside audio_pink_set_mixer_gain().
+void audio_pink_pulse_from_isr(){
+  pink_mute = false;
+  float gain = pink_gain_script*pink_gain_computed;
+  mixerLeft.gain(AUDIO_PINK_CHANNEL,gain);
+  mixerRight.gain(AUDIO_PINK_CHANNEL,gain);
+}
+
+bool audio_stim_pulse_render(uint32_t duration_ms, uint32_t ramp_ms){
+#if (defined(ENABLE_STIM_PLAYER) && (ENABLE_STIM_PLAYER > 0U))
+  uint32_t len = (uint32_t)(duration_ms*AUDIO_SAMPLE_RATE_EXACT/1000);
+  uint32_t ramp = (uint32_t)(ramp_ms*AUDIO_SAMPLE_RATE_EXACT/1000);
+  if (len == 0 || len > STIM_PULSE_MAX_SAMPLES) {
+    return false;
+  }
+  if (2*ramp > len) {
+    ramp = len/2;
+  }
+
+  // the player must not read the buffer while it is rewritten
+  stim_player_set_pulse(NULL, 0);
+
+  AudioSynthNoisePink::render(g_stim_pulse, len, STIM_PULSE_SEED);
+  // raised cosine on and off ramps
+  for (uint32_t i = 0; i < ramp; i++) {
+    float env = 0.5f*(1.0f - cosf((float)M_PI*(i+0.5f)/ramp));
+    g_stim_pulse[i] = (int16_t)(g_stim_pulse[i]*env);
+    g_stim_pulse[len-1-i] = (int16_t)(g_stim_pulse[len-1-i]*env);
+  }
+
+  stim_player_set_pulse(g_stim_pulse, len);
+  return true;
+#else
+  return false;
+#endif
+}
+
 /*************************************/
 // SINE
 
@@ -793,6 +877,72 @@ void audio_sine_stop()
   xQueueSend(g_event_queue, &event, portMAX_DELAY);
 }
 
+/*************************************/
+// CPU USAGE
+
+typedef struct {
+  const char* name;
+  AudioStream* stream;
+} audio_stage_t;
+
+static const audio_stage_t g_audio_stages[] = {
+#if (defined(AUDIO_ENABLE_FG_WAV) && (AUDIO_ENABLE_FG_WAV > 0U))
+  { "wavFG",          &wavFG },
+  { "fade_fg_left",   &fade_fg_left },
+  { "fade_fg_right",  &fade_fg_right },
+#endif
+#if (defined(AUDIO_ENABLE_BG_WAV) && (AUDIO_ENABLE_BG_WAV > 0U))
+  { "wavBG",          &wavBG },
+  { "bg_fade_left",   &bg_fade_left },
+  { "bg_fade_right",  &bg_fade_right },
+#endif
+#if (defined(AUDIO_ENABLE_MP3) && (AUDIO_ENABLE_MP3 > 0U))
+  { "mp3",            &mp3output },
+  { "fade_mp3_left",  &fade_mp3_left },
+  { "fade_mp3_right", &fade_mp3_right },
+#endif
+#if (defined(AUDIO_ENABLE_PINK) && (AUDIO_ENABLE_PINK > 0U))
+  { "pink",           &pink },
+  { "pink_fade",      &pink_fade },
+#endif
+#if (defined(AUDIO_ENABLE_SINE) && (AUDIO_ENABLE_SINE > 0U))
+  { "sineLow",        &sineLow },
+  { "sineHigh",       &sineHigh },
+#endif
+  { "mixerLeft",      &mixerLeft },
+  { "mixerRight",     &mixerRight },
+  { "audioOutput",    &audioOutput },
+};
+
+// AudioStream counts cpu cycles in units of 16.
+static void print_cpu_stage(const char* name, uint32_t cycles, uint32_t cycles_max){
+  uint32_t last_us = profiler_cycles_to_us(cycles << 4);
+  uint32_t max_us = profiler_cycles_to_us(cycles_max << 4);
+  printf("%-16s %8lu %8lu %5lu%%\n", name, (unsigned long) last_us, (unsigned long) max_us,
+      (unsigned long) (100*max_us/AUDIO_BLOCK_US));
+}
+
+void audio_print_cpu_usage()
+{
+  printf("audio: %u samples per block, %lu us\n", (unsigned) AUDIO_BLOCK_SAMPLES, (unsigned long) AUDIO_BLOCK_US);
+  printf("%-16s %8s %8s %6s\n", "stage", "last_us", "max_us", "max");
+  for (size_t i = 0; i < sizeof(g_audio_stages)/sizeof(g_audio_stages[0]); i++) {
+    const audio_stage_t* stage = &g_audio_stages[i];
+    if (stage->stream->isActive()) {
+      print_cpu_stage(stage->name, stage->stream->cpu_cycles, stage->stream->cpu_cycles_max);
+    }
+  }
+  print_cpu_stage("total", AudioStream::cpu_cycles_total, AudioStream::cpu_cycles_total_max);
+}
+
+void audio_reset_cpu_usage()
+{
+  for (size_t i = 0; i < sizeof(g_audio_stages)/sizeof(g_audio_stages[0]); i++) {
+    g_audio_stages[i].stream->processorUsageMaxReset();
+  }
+  AudioProcessorUsageMaxReset();
+}
+
 /*****************************************************************************/
 // State machine
 
@@ -1089,12 +1239,17 @@ handle_state_standby(audio_event_t *event)
 #if (defined(AUDIO_ENABLE_PINK) && (AUDIO_ENABLE_PINK > 0U))
     case AUDIO_EVENT_PINK_PLAY:
       pink.amplitude(1);
+      stim_player_enable(true);
+      // pulses can come at any time, don't power off between them
+      AudioOutputI2S::hold_awake(true);
 //      mixerLeft.gain(AUDIO_PINK_CHANNEL,gain_pink=1);
 //      mixerRight.gain(AUDIO_PINK_CHANNEL,gain_pink=1);
       break;
 
   case AUDIO_EVENT_PINK_STOP:
       pink.amplitude(0);
+      stim_player_enable(false);
+      AudioOutputI2S::hold_awake(false);
 //      mixerLeft.gain(AUDIO_PINK_CHANNEL,gain_pink=0);
 //      mixerRight.gain(AUDIO_PINK_CHANNEL,gain_pink=0);
       break;
@@ -1165,7 +1320,13 @@ handle_state_standby(audio_event_t *event)
         // That message can take a little while to process before wav_buffer actually starts running.
         // But the way we check whether the wavBG playback is idle only considers whether wav_buffer task is running.
         if ( *(bool*)(event->user_data) ) {
-          xTimerStart(ag_context.audio_power_off_timer_handle, portMAX_DELAY);
+          uint32_t delay_ms = ag_context.power_off_delay_ms;
+          if (delay_ms > 0) {
+            // also starts the timer
+            xTimerChangePeriod(ag_context.audio_power_off_timer_handle, pdMS_TO_TICKS(delay_ms), portMAX_DELAY);
+          } else {
+            xTimerStop(ag_context.audio_power_off_timer_handle, portMAX_DELAY);
+          }
         } else {
           xTimerStop(ag_context.audio_power_off_timer_handle, portMAX_DELAY);
         }
@@ -1245,8 +1406,14 @@ audio_pretask_init(void)
   // Create the event memory
   mm_rtos_init( &g_event_memory, g_event_memory_buf, sizeof(g_event_memory_buf) );
 
+  profiler_set_deadline_us(PROF_AUDIO_UPDATE, AUDIO_BLOCK_US);
+
+  stim_player_init(AUDIO_SAMPLE_RATE_EXACT);
+  audio_stim_pulse_render(STIM_PLAYER_DEFAULT_PULSE_MS, STIM_PLAYER_DEFAULT_RAMP_MS);
+
+  ag_context.power_off_delay_ms = AUDIO_IDLE_2_POWER_OFF_DELAY_MS;
   ag_context.audio_power_off_timer_handle = xTimerCreateStatic("AUDIO_POWER_OFF_TIMER",
-    pdMS_TO_TICKS(AUDIO_IDLE_2_POWER_OFF_DELAY_MS), pdFALSE, NULL,
+    1, pdFALSE, NULL, // period set when started, see AUDIO_EVENT_NOTIFY_STREAM_IDLE
     audio_power_off_timeout, &(ag_context.audio_power_off_timer_struct));
 
   //// Setup the PJRC Audio processing pipeline ////
@@ -1364,6 +1531,8 @@ void audio_task(void *ignored){}
 
 void audio_power_on(){}
 void audio_power_off(){}
+void audio_set_power_off_delay(uint32_t delay_ms){}
+uint32_t audio_get_power_off_delay(void){ return 0; }
 void audio_stop(){}
 void audio_pause(){}
 void audio_unpause(){}
@@ -1401,10 +1570,15 @@ void audio_pink_fadeout(uint32_t dur_ms){}
 void audio_pink_script_volume(float gain){}
 void audio_pink_computed_volume(float gain){}
 void audio_pink_mute(bool mute){}
+void audio_pink_pulse_from_isr(){}
+bool audio_stim_pulse_render(uint32_t duration_ms, uint32_t ramp_ms){ return false; }
 
 void audio_sine_play(){}
 void audio_sine_stop(){}
 
+void audio_print_cpu_usage(){}
+void audio_reset_cpu_usage(){}
+
 void audio_event_notify_stream_idle(bool is_idle){}
 
 #endif // #if (defined(ENABLE_AUDIO_TASK) && (ENABLE_AUDIO_TASK > 0U))
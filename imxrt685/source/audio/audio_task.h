@@ -54,6 +54,12 @@ extern "C" {
 #define AUDIO_ENABLE_I2S_OUTPUT 1
 #endif
 
+// Silence before the I2S output and the amp are powered down, 0 = never.
+// Can be changed at runtime with audio_set_power_off_delay().
+#ifndef AUDIO_IDLE_2_POWER_OFF_DELAY_MS
+#define AUDIO_IDLE_2_POWER_OFF_DELAY_MS 10000
+#endif
+
 // Init called before vTaskStartScheduler() launches our Task in main():
 void audio_pretask_init(void);
 
@@ -76,6 +82,13 @@ void audio_power_on();
  */
 void audio_power_off();
 
+/*
+ * Silence before the audio powers itself off, 0 = never.
+ * Takes effect the next time the graph goes silent.
+ */
+void audio_set_power_off_delay(uint32_t delay_ms);
+uint32_t audio_get_power_off_delay(void);
+
 /*
  * Stop playing any audio source.
  */
@@ -157,6 +170,9 @@ void audio_pink_fadeout(uint32_t dur_ms);
 void audio_pink_script_volume(float gain); // uses critical section to update gain immediately.
 void audio_pink_computed_volume(float gain); // uses critical section to update gain immediately.
 void audio_pink_mute(bool mute); // uses critical section to update gain immediately.
+void audio_pink_pulse_from_isr(); // unmute from a timer ISR, takes effect on the next audio block.
+// Pre-render the stimulus pulse played by stim_player, false if too long.
+bool audio_stim_pulse_render(uint32_t duration_ms, uint32_t ramp_ms);
 void audio_pink_default_volume();
 
 /*
@@ -167,6 +183,12 @@ void audio_pink_default_volume();
 void audio_sine_play();
 void audio_sine_stop();
 
+/*
+ * Per-stage update() time of the audio graph, last and max since reset.
+ */
+void audio_print_cpu_usage();
+void audio_reset_cpu_usage();
+
 
 void audio_event_notify_stream_idle(bool is_idle);
 
@@ -0,0 +1,219 @@
+/*
+ * stim_player.c
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Sample-accurate stimulus pulse player, see stim_player.h.
+ *
+ * Define STIM_PLAYER_HOST to build on the host without FreeRTOS.
+ */
+
+#include <string.h>
+
+#include "stim_player.h"
+
+#if defined(STIM_PLAYER_HOST)
+#define ENABLE_STIM_PLAYER (1U)
+#define STIM_PLAYER_LOCK()
+#define STIM_PLAYER_UNLOCK()
+#else
+#include "config.h"
+#include "FreeRTOS.h"
+#include "task.h"
+// Requests come from the EEG processor, mixing runs in the audio stream task.
+#define STIM_PLAYER_LOCK()   taskENTER_CRITICAL()
+#define STIM_PLAYER_UNLOCK() taskEXIT_CRITICAL()
+#endif
+
+#if (defined(ENABLE_STIM_PLAYER) && (ENABLE_STIM_PLAYER > 0U))
+
+static float g_sample_rate = 44100;
+
+static const int16_t* volatile g_pulse = NULL;
+static volatile uint32_t g_pulse_len = 0;
+
+static volatile int32_t g_gain_q16 = 0;  // 65536 = unity
+static volatile bool g_enabled = false;
+
+static volatile bool g_scheduled = false;
+static volatile uint32_t g_onset_us = 0;
+static volatile bool g_playing = false;
+static volatile bool g_started = false;
+
+// Audio stream task only.
+static uint32_t g_pos = 0;
+
+static stim_player_stats_t g_stats;
+
+static inline int16_t
+saturate16(int32_t val)
+{
+  if (val > INT16_MAX) {
+    return INT16_MAX;
+  }
+  if (val < INT16_MIN) {
+    return INT16_MIN;
+  }
+  return (int16_t) val;
+}
+
+void
+stim_player_init(float sample_rate)
+{
+  STIM_PLAYER_LOCK();
+  g_sample_rate = sample_rate;
+  g_scheduled = false;
+  g_playing = false;
+  g_started = false;
+  STIM_PLAYER_UNLOCK();
+  stim_player_reset_stats();
+}
+
+void
+stim_player_set_pulse(const int16_t* samples, uint32_t len)
+{
+  STIM_PLAYER_LOCK();
+  g_playing = false;
+  g_pulse = samples;
+  g_pulse_len = (samples != NULL) ? len : 0;
+  STIM_PLAYER_UNLOCK();
+}
+
+void
+stim_player_set_gain(float gain)
+{
+  if (gain < 0) {
+    gain = 0;
+  }
+  // the mix saturates anyway, keep the fixed point gain in range
+  if (gain > 256) {
+    gain = 256;
+  }
+  g_gain_q16 = (int32_t)(gain * 65536.0f);
+}
+
+void
+stim_player_enable(bool enable)
+{
+  g_enabled = enable;
+}
+
+void
+stim_player_schedule(uint32_t onset_us)
+{
+  STIM_PLAYER_LOCK();
+  g_onset_us = onset_us;
+  g_scheduled = true;
+  STIM_PLAYER_UNLOCK();
+}
+
+void
+stim_player_cancel(void)
+{
+  STIM_PLAYER_LOCK();
+  g_scheduled = false;
+  STIM_PLAYER_UNLOCK();
+}
+
+bool
+stim_player_busy(void)
+{
+  return g_started || g_playing;
+}
+
+bool
+stim_player_take_started(void)
+{
+  STIM_PLAYER_LOCK();
+  bool started = g_started;
+  g_started = false;
+  STIM_PLAYER_UNLOCK();
+  return started;
+}
+
+void
+stim_player_mix(int16_t* lr, uint32_t frames, uint32_t start_us)
+{
+  uint32_t first = 0;
+
+  STIM_PLAYER_LOCK();
+  if (g_scheduled && !g_playing && g_pulse_len > 0) {
+    int32_t offset_us = (int32_t)(g_onset_us - start_us);
+    uint32_t buffer_us = (uint32_t)(frames * 1e6f / g_sample_rate);
+    if (offset_us < (int32_t) buffer_us) {
+      if (offset_us < 0) {
+        // the buffer holding the onset has already gone out
+        uint32_t late_us = (uint32_t)(-offset_us);
+        g_stats.late_pulses++;
+        if (late_us > g_stats.max_late_us) {
+          g_stats.max_late_us = late_us;
+        }
+      } else {
+        first = (uint32_t)(offset_us * g_sample_rate / 1e6f + 0.5f);
+        if (first >= frames) {
+          first = frames - 1;
+        }
+      }
+      g_scheduled = false;
+      g_playing = true;
+      g_started = true;
+      g_pos = 0;
+      g_stats.pulses++;
+    }
+  }
+  bool playing = g_playing;
+  const int16_t* pulse = g_pulse;
+  uint32_t len = g_pulse_len;
+  STIM_PLAYER_UNLOCK();
+
+  if (!playing) {
+    return;
+  }
+
+  int32_t gain = g_enabled ? g_gain_q16 : 0;
+  uint32_t pos = g_pos;
+  for (uint32_t i = first; i < frames && pos < len; i++, pos++) {
+    int32_t s = (int32_t)(((int64_t) pulse[pos] * gain) >> 16);
+    lr[2*i]   = saturate16(lr[2*i] + s);
+    lr[2*i+1] = saturate16(lr[2*i+1] + s);
+  }
+  g_pos = pos;
+
+  if (pos >= len) {
+    STIM_PLAYER_LOCK();
+    g_playing = false;
+    STIM_PLAYER_UNLOCK();
+  }
+}
+
+void
+stim_player_get_stats(stim_player_stats_t *stats)
+{
+  STIM_PLAYER_LOCK();
+  *stats = g_stats;
+  STIM_PLAYER_UNLOCK();
+}
+
+void
+stim_player_reset_stats(void)
+{
+  STIM_PLAYER_LOCK();
+  memset(&g_stats, 0, sizeof(g_stats));
+  STIM_PLAYER_UNLOCK();
+}
+
+#else /* (defined(ENABLE_STIM_PLAYER) && (ENABLE_STIM_PLAYER > 0U)) */
+
+void stim_player_init(float sample_rate){}
+void stim_player_set_pulse(const int16_t* samples, uint32_t len){}
+void stim_player_set_gain(float gain){}
+void stim_player_enable(bool enable){}
+void stim_player_schedule(uint32_t onset_us){}
+void stim_player_cancel(void){}
+bool stim_player_busy(void){ return false; }
+bool stim_player_take_started(void){ return false; }
+void stim_player_mix(int16_t* lr, uint32_t frames, uint32_t start_us){}
+void stim_player_get_stats(stim_player_stats_t *stats){ memset(stats, 0, sizeof(*stats)); }
+void stim_player_reset_stats(void){}
+
+#endif /* (defined(ENABLE_STIM_PLAYER) && (ENABLE_STIM_PLAYER > 0U)) */
@@ -0,0 +1,72 @@
+/*
+ * stim_player.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Sample-accurate stimulus pulse player.
+ *
+ * A shaped pink noise pulse is rendered into RAM once (see
+ * audio_stim_pulse_render() in audio_task.cpp) and mixed straight into the
+ * I2S DMA buffer by AudioOutputI2S, bypassing the PJRC graph. The stimulus
+ * scheduler asks for a pulse at an absolute micros() time, the player
+ * splices it in at the matching frame of the DMA half that plays at that
+ * time. The only constraint left is that the request must come before that
+ * half is filled, one DMA transfer (AUDIO_BLOCK_SAMPLES frames) ahead.
+ */
+
+#ifndef AUDIO_STIM_PLAYER_H_
+#define AUDIO_STIM_PLAYER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define STIM_PLAYER_MAX_PULSE_MS (100U)
+
+// Rendered at boot, a little shorter than the EEG processor's pulse lockout.
+#define STIM_PLAYER_DEFAULT_PULSE_MS (25U)
+#define STIM_PLAYER_DEFAULT_RAMP_MS  (2U)
+
+typedef struct
+{
+  uint32_t pulses;       // pulses started
+  uint32_t late_pulses;  // requested for a time whose buffer was already filled
+  uint32_t max_late_us;
+} stim_player_stats_t;
+
+void stim_player_init(float sample_rate);
+
+// Mono pulse, played on both channels. The samples must stay valid until
+// replaced, set NULL to stop using them (e.g. while rendering a new pulse).
+void stim_player_set_pulse(const int16_t* samples, uint32_t len);
+
+// Linear gain, and whether the pink noise source is playing at all.
+void stim_player_set_gain(float gain);
+void stim_player_enable(bool enable);
+
+// Start the pulse at onset_us (micros()), replacing a pulse that has not
+// started yet. A time already in the past starts it in the next buffer.
+void stim_player_schedule(uint32_t onset_us);
+void stim_player_cancel(void);
+
+// A pulse has started and is still playing or not yet taken.
+bool stim_player_busy(void);
+
+// True once per started pulse.
+bool stim_player_take_started(void);
+
+// Called by the I2S output with the interleaved L/R frames it just filled
+// and the micros() time the first of them plays.
+void stim_player_mix(int16_t* lr, uint32_t frames, uint32_t start_us);
+
+void stim_player_get_stats(stim_player_stats_t *stats);
+void stim_player_reset_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUDIO_STIM_PLAYER_H_ */
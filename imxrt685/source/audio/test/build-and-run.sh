@@ -0,0 +1,13 @@
+set -x
+
+# Sample-accurate splicing of stimulus pulses into the I2S buffers.
+
+gcc -DSTIM_PLAYER_HOST \
+ -I .. \
+ ../stim_player.c \
+ ./stim_player_test.c \
+ -o stim_player_test && \
+./stim_player_test
+
+# cleanup
+rm ./stim_player_test
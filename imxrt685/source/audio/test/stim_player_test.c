@@ -0,0 +1,186 @@
+/*
+ * stim_player_test.c
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host test for the stimulus pulse player. Pulses are spliced
+ * into simulated I2S buffers, the first pulse sample must land on the frame
+ * matching the requested onset, also across buffers and the micros() wrap.
+ */
+
+#include "stim_player.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define RATE (44117.640625f)
+#define FRAMES (256U)
+#define PULSE_LEN (300U)
+
+static int16_t pulse[PULSE_LEN];
+static int16_t lr[2*FRAMES];
+
+static uint32_t frame_us(uint32_t frames)
+{
+  return (uint32_t)(frames * 1e6f / RATE);
+}
+
+static void clear(void)
+{
+  memset(lr, 0, sizeof(lr));
+}
+
+// First frame holding pulse sample 0, -1 if none.
+static int find_onset(void)
+{
+  for (uint32_t i = 0; i < FRAMES; i++) {
+    if (lr[2*i] == pulse[0]) {
+      return (int) i;
+    }
+  }
+  return -1;
+}
+
+static void setup(void)
+{
+  for (uint32_t i = 0; i < PULSE_LEN; i++) {
+    pulse[i] = (int16_t)(i + 1);
+  }
+  stim_player_init(RATE);
+  stim_player_set_pulse(pulse, PULSE_LEN);
+  stim_player_set_gain(1.0f);
+  stim_player_enable(true);
+}
+
+// Onset inside a buffer lands on the matching frame and runs on into the
+// next buffer.
+static void test_offset(uint32_t start_us)
+{
+  setup();
+  for (uint32_t frame = 0; frame < FRAMES; frame += 37) {
+    uint32_t onset_us = start_us + frame_us(frame) + 1;
+    stim_player_schedule(onset_us);
+
+    // the buffer before the onset is left alone
+    clear();
+    stim_player_mix(lr, FRAMES, start_us - frame_us(FRAMES));
+    assert(find_onset() == -1);
+    assert(!stim_player_busy());
+
+    clear();
+    stim_player_mix(lr, FRAMES, start_us);
+    int onset = find_onset();
+    assert(onset >= (int) frame - 1 && onset <= (int) frame + 1);
+    assert(lr[2*onset+1] == pulse[0]);
+    assert(stim_player_busy());
+    assert(stim_player_take_started());
+    assert(!stim_player_take_started());
+
+    // the rest of the pulse continues in the next buffer
+    uint32_t played = FRAMES - onset;
+    clear();
+    stim_player_mix(lr, FRAMES, start_us + frame_us(FRAMES));
+    assert(lr[0] == pulse[played]);
+    uint32_t left = PULSE_LEN - played;
+    if (left < FRAMES) {
+      assert(lr[2*(left-1)] == pulse[PULSE_LEN-1]);
+      assert(lr[2*left] == 0);
+      assert(!stim_player_busy());
+    } else {
+      assert(stim_player_busy());
+      clear();
+      stim_player_mix(lr, FRAMES, start_us + 2*frame_us(FRAMES));
+      assert(!stim_player_busy());
+    }
+  }
+}
+
+// A request for a buffer already gone out starts at the next buffer.
+static void test_late(void)
+{
+  setup();
+  stim_player_schedule(10000 - 1500);
+  clear();
+  stim_player_mix(lr, FRAMES, 10000);
+  assert(find_onset() == 0);
+
+  stim_player_stats_t stats;
+  stim_player_get_stats(&stats);
+  assert(stats.pulses == 1);
+  assert(stats.late_pulses == 1);
+  assert(stats.max_late_us == 1500);
+}
+
+// Gain scales and saturates, a disabled player still consumes the pulse.
+static void test_gain(void)
+{
+  setup();
+  stim_player_set_gain(0.5f);
+  stim_player_schedule(0);
+  clear();
+  lr[2*9] = 100;
+  stim_player_mix(lr, FRAMES, 0);
+  assert(lr[2*9] == 100 + pulse[9]/2);
+  assert(lr[2*9+1] == pulse[9]/2);
+
+  setup();
+  stim_player_set_gain(200.0f);
+  stim_player_schedule(0);
+  clear();
+  stim_player_mix(lr, FRAMES, 0);
+  assert(lr[2*(FRAMES-1)] == INT16_MAX);
+
+  setup();
+  stim_player_enable(false);
+  stim_player_schedule(0);
+  clear();
+  stim_player_mix(lr, FRAMES, 0);
+  assert(find_onset() == -1);
+  assert(stim_player_take_started());
+  clear();
+  stim_player_mix(lr, FRAMES, frame_us(FRAMES));
+  assert(!stim_player_busy());
+}
+
+// Cancel drops a pulse not started yet, a later request replaces an earlier one.
+static void test_cancel(void)
+{
+  setup();
+  stim_player_schedule(1000);
+  stim_player_cancel();
+  clear();
+  stim_player_mix(lr, FRAMES, 0);
+  assert(find_onset() == -1);
+  assert(!stim_player_take_started());
+
+  stim_player_schedule(1000);
+  stim_player_schedule(frame_us(FRAMES) + 1000);
+  clear();
+  stim_player_mix(lr, FRAMES, 0);
+  assert(find_onset() == -1);
+  clear();
+  stim_player_mix(lr, FRAMES, frame_us(FRAMES));
+  assert(find_onset() == 44);
+
+  // no pulse set, nothing plays
+  setup();
+  stim_player_set_pulse(NULL, 0);
+  stim_player_schedule(0);
+  clear();
+  stim_player_mix(lr, FRAMES, 0);
+  assert(!stim_player_busy());
+}
+
+int main(int argc, char** argv)
+{
+  test_offset(0);
+  test_offset(1234567);
+  test_offset(0xFFFFFFFFU - frame_us(FRAMES) / 2);
+  test_late();
+  test_gain();
+  test_cancel();
+
+  printf("stim_player test passed\n");
+  return 0;
+}
@@ -13,6 +13,8 @@
 #define F_CPU 150000000
 #elif defined(CPU_MIMXRT685SFVKB)
 #define F_CPU 250000000
+#elif defined(AUDIO_HOST)
+#define F_CPU 250000000
 #else
 #error Must define CPU type.
 #endif
@@ -23,6 +25,10 @@
 #define __ARM_ARCH_8M_MAIN__ 1
 #elif defined(CPU_MIMXRT685SFVKB)
 #define __ARM_ARCH_8M_MAIN__ 1
+#elif defined(AUDIO_HOST)
+// Host graph test (audio_pjrc/test), same code paths as the RT685 with the
+// plain C versions of utility/dspinst.h.
+#define __ARM_ARCH_8M_MAIN__ 1
 #else
 #error Must define CPU type.
 #endif
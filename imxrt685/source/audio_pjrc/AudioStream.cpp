@@ -35,6 +35,7 @@
 #include "config.h"
 #include "fsl_common.h"
 #include "critical_section.h"
+#include "profiler.h"
 
 #ifndef AUDIO_ENABLE_CPU_CYCLE_COUNTER
 #define AUDIO_ENABLE_CPU_CYCLE_COUNTER 1U
@@ -326,6 +327,7 @@ AudioStream * AudioStream::first_update = NULL;
 void update_all(void) // AudioStream::update_all()
 {
 	AudioStream *p;
+	PROFILER_SCOPE(AUDIO_UPDATE);
 
 #if (defined(AUDIO_ENABLE_CPU_CYCLE_COUNTER) && (AUDIO_ENABLE_CPU_CYCLE_COUNTER > 0U))
 #if defined(__ARM_ARCH_8M_MAIN__)
@@ -398,3 +400,20 @@ bool AudioStream::is_idle_all_streams(void){
 	}
 	return is_idle;
 }
+
+// True if some destination uses this object's output, a sink with no
+// destinations always does. A destination that is busy (e.g. a fade in
+// progress) uses its input even if its own output is unused, so it is not
+// frozen for lack of blocks. The graph is acyclic, so the recursion ends at
+// the output.
+bool AudioStream::output_used(void)
+{
+	AudioConnection *c;
+
+	if (destination_list == NULL) return true;
+	for (c = destination_list; c; c = c->next_dest) {
+		if (!c->dst.active || !c->dst.is_input_used(c->dest_index)) continue;
+		if (!c->dst.is_idle() || c->dst.output_used()) return true;
+	}
+	return false;
+}
@@ -59,10 +59,17 @@
 #elif defined(__MKL26Z64__)
 #define AUDIO_BLOCK_SAMPLES  64
 #elif defined(__ARM_ARCH_8M_MAIN__)
-#define AUDIO_BLOCK_SAMPLES  512 //128 // 512 causes a crash in mem_rtos_open in audio task
+// Each block is one I2S DMA transfer (see output_i2s.cpp), 256 samples is
+// ~5.8 ms per update. Select another size for the whole build with
+// -DAUDIO_BLOCK_SAMPLES=<n>, every file must see the same value.
+#define AUDIO_BLOCK_SAMPLES  256
 #endif
 #endif
 
+#if (AUDIO_BLOCK_SAMPLES % 16) != 0
+#error AUDIO_BLOCK_SAMPLES must be a multiple of 16
+#endif
+
 #ifndef AUDIO_SAMPLE_RATE_EXACT
 #if defined(__MK20DX128__) || defined(__MK20DX256__) || defined(__MK64FX512__) || defined(__MK66FX1M0__)
 #define AUDIO_SAMPLE_RATE_EXACT 44117.64706 // 48 MHz / 1088, or 96 MHz * 2 / 17 / 256
@@ -163,6 +170,7 @@ public:
 	bool isActive(void) { return active; }
     static void update_all_streams(void);
     static bool is_idle_all_streams(void);
+	bool output_used(void);
 	uint32_t cpu_cycles;
 	uint32_t cpu_cycles_max;
 	static uint32_t cpu_cycles_total;
@@ -189,6 +197,9 @@ private:
 	static bool update_scheduled;
 	virtual void update(void) = 0;
 	virtual bool is_idle(void) = 0;
+	// False if blocks arriving on this input are thrown away, e.g. a zero
+	// gain mixer channel. Lets the sources upstream skip rendering them.
+	virtual bool is_input_used(unsigned int index) { return true; }
 	static AudioStream *first_update; // for update_all
 	AudioStream *next_update; // for update_all
 	static audio_block_t *memory_pool;
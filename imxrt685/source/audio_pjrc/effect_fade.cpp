@@ -63,6 +63,9 @@ void AudioEffectFade::update(void)
 	inc = rate;
 	dir = direction;
 	for (i=0; i < AUDIO_BLOCK_SAMPLES; i++) {
+		// A fade in that ends mid block passes the rest through unscaled, like
+		// the 100% path above, so the output does not depend on the block size.
+		if (pos == 0xFFFFFFFF) break;
 		index = pos >> 24;
 		val1 = fader_table[index];
 		val2 = fader_table[index+1];
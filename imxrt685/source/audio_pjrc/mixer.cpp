@@ -116,6 +116,12 @@ void AudioMixer5::update(void)
 
 	for (channel=0; channel < 5; channel++) {
         int32_t mult = multiplier[channel];
+		if (mult == 0) {
+			// muted channel, drop its block without touching the samples
+			in = receiveReadOnly(channel);
+			if (in) release(in);
+			continue;
+		}
 		if (!out) {
 			out = receiveWritable(channel);
 			if (out) {
@@ -142,6 +148,11 @@ bool AudioMixer5::is_idle(void)
   return true;
 }
 
+bool AudioMixer5::is_input_used(unsigned int index)
+{
+  return index < 5 && multiplier[index] != 0;
+}
+
 #if defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
 
 void AudioMixer5::gain(unsigned int channel, float gain) {
@@ -43,6 +43,7 @@ public:
 	virtual bool is_idle(void);
 	void gain(unsigned int channel, float gain);
 private:
+	virtual bool is_input_used(unsigned int index);
 	int32_t multiplier[5];
 	audio_block_t *inputQueueArray[5];
 
@@ -55,6 +56,7 @@ public:
 	virtual bool is_idle(void);
 	void gain(unsigned int channel, float gain);
 private:
+	virtual bool is_input_used(unsigned int index);
 	int16_t multiplier[5];
 	audio_block_t *inputQueueArray[5];
 #endif
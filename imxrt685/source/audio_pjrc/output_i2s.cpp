@@ -36,6 +36,9 @@
 #include "peripherals.h"
 #include "loglevels.h"
 #include "critical_section.h"
+#include "micro_clock.h"
+#include "stim_player.h"
+#include "profiler.h"
 
 #if defined(__GNUC__) /* GNU Compiler */
 #ifndef __ALIGN_END
@@ -64,12 +67,19 @@ audio_block_t * AudioOutputI2S::block_right_2nd = NULL;
 uint16_t AudioOutputI2S::block_left_offset = 0;
 uint16_t AudioOutputI2S::block_right_offset = 0;
 bool AudioOutputI2S::update_responsibility = false;
+volatile bool AudioOutputI2S::awake_hold = false;
 //DMAChannel AudioOutputI2S::dma(false);
 //DMAMEM __attribute__((aligned(32))) static uint32_t i2s_tx_buffer[AUDIO_BLOCK_SAMPLES];
-__ALIGN_BEGIN uint32_t i2s_tx_buffer[AUDIO_BLOCK_SAMPLES] __ALIGN_END;
+// Ping-pong buffer of interleaved L/R frames, each half is one audio block so
+// the graph runs once per DMA completion, in evenly spaced bursts.
+__ALIGN_BEGIN uint32_t i2s_tx_buffer[2*I2S_TRANSFER_FRAMES] __ALIGN_END;
 static i2s_transfer_t s_TxTransfer1;
 static i2s_transfer_t s_TxTransfer2;
 static volatile bool toggle_i2s_transfer = false;
+// micros() of the last DMA completion, the half refilled after it starts
+// playing one transfer later.
+static volatile uint32_t tx_complete_us = 0;
+#define I2S_TRANSFER_US ((uint32_t)(I2S_TRANSFER_FRAMES*1000000.0/AUDIO_SAMPLE_RATE_EXACT))
 //static volatile unsigned long transfer_counter = 0;
 
 // Interrupt service routine for I2S:
@@ -97,7 +107,7 @@ void AudioOutputI2S::init(void)
 	// Divide the buffer into two for ping-pong DMA to keep the pipe filled.
 	s_TxTransfer1.data     = (uint8_t*) &i2s_tx_buffer[0];
 	s_TxTransfer1.dataSize = sizeof(i2s_tx_buffer)/2;
-	s_TxTransfer2.data     = (uint8_t*) &i2s_tx_buffer[AUDIO_BLOCK_SAMPLES/2];
+	s_TxTransfer2.data     = (uint8_t*) &i2s_tx_buffer[I2S_TRANSFER_FRAMES];
 	s_TxTransfer2.dataSize = sizeof(i2s_tx_buffer)/2;
 
 	I2S_TxTransferCreateHandleDMA(
@@ -110,6 +120,11 @@ void AudioOutputI2S::init(void)
 
 void AudioOutputI2S::begin(void)
 {
+	// Restart from the first half with silence, end() may have stopped the
+	// DMA anywhere.
+	toggle_i2s_transfer = false;
+	memset(i2s_tx_buffer,0,sizeof(i2s_tx_buffer));
+
 	// Kick off transmission, which currently runs continuously until end().
 	I2S_TxTransferSendDMA(AUDIO_I2S_BASE, &AUDIO_I2S_DMA_TX_HANDLE, s_TxTransfer1);
 	I2S_TxTransferSendDMA(AUDIO_I2S_BASE, &AUDIO_I2S_DMA_TX_HANDLE, s_TxTransfer2);
@@ -127,6 +142,7 @@ void AudioOutputI2S::handle_audio_i2s_event()
 	audio_block_t *block;
 //	uint32_t saddr;
 	uint32_t offset;
+	PROFILER_BEGIN(AUDIO_I2S_FILL);
 
 //	saddr = (uint32_t)(dma.CFG->SAR);
 //	dma.clearInterrupt();
@@ -134,13 +150,13 @@ void AudioOutputI2S::handle_audio_i2s_event()
 	if (toggle_i2s_transfer) {
 		// DMA is transmitting the first half of the buffer
 		// so we must fill the second half
-		dest = (int16_t *)&i2s_tx_buffer[AUDIO_BLOCK_SAMPLES/2];
-		end = (int16_t *)&i2s_tx_buffer[AUDIO_BLOCK_SAMPLES];
+		dest = (int16_t *)&i2s_tx_buffer[I2S_TRANSFER_FRAMES];
+		end = (int16_t *)&i2s_tx_buffer[2*I2S_TRANSFER_FRAMES];
 	} else {
 		// DMA is transmitting the second half of the buffer
 		// so we must fill the first half
 		dest = (int16_t *)&i2s_tx_buffer[0];
-		end = (int16_t *)&i2s_tx_buffer[AUDIO_BLOCK_SAMPLES/2];
+		end = (int16_t *)&i2s_tx_buffer[I2S_TRANSFER_FRAMES];
 	}
 
 	// Does the left block have data to send?
@@ -155,7 +171,7 @@ void AudioOutputI2S::handle_audio_i2s_event()
 		} while (dest < end);
 
 		// Advance the position in the source buffer
-		offset += AUDIO_BLOCK_SAMPLES/2;
+		offset += I2S_TRANSFER_FRAMES;
 		if (offset < AUDIO_BLOCK_SAMPLES) {
 			// Continue at offset within source block.
 			AudioOutputI2S::block_left_offset = offset;
@@ -176,7 +192,7 @@ void AudioOutputI2S::handle_audio_i2s_event()
 
 	// Rewind the destination pointer to the beginning of the buffer, except
 	// off by 1 so that the right samples are interleaved.
-	dest -= AUDIO_BLOCK_SAMPLES - 1;
+	dest -= 2*I2S_TRANSFER_FRAMES - 1;
 
 	// Does the right block have data to send?
 	block = AudioOutputI2S::block_right_1st;
@@ -190,7 +206,7 @@ void AudioOutputI2S::handle_audio_i2s_event()
 		} while (dest < end);
 
 		// Advance the position in the source buffer
-		offset += AUDIO_BLOCK_SAMPLES/2;
+		offset += I2S_TRANSFER_FRAMES;
 		if (offset < AUDIO_BLOCK_SAMPLES) {
 			// Continue at offset within source block.
 			AudioOutputI2S::block_right_offset = offset;
@@ -209,6 +225,12 @@ void AudioOutputI2S::handle_audio_i2s_event()
 		} while (dest < end);
 	}
 
+	// Splice in the stimulus pulse at its exact frame.
+	stim_player_mix((int16_t *)&i2s_tx_buffer[toggle_i2s_transfer ? I2S_TRANSFER_FRAMES : 0],
+		I2S_TRANSFER_FRAMES, tx_complete_us + I2S_TRANSFER_US);
+
+	PROFILER_END(AUDIO_I2S_FILL);
+
 	// We have a very short time to get the next I2S buffer out via DMA.
 	// A SysTick (or any other) interrupt here can cause an audio glitch.
 
@@ -229,10 +251,9 @@ void AudioOutputI2S::handle_audio_i2s_event()
 		LOGV("output_i2s","Failed to initiate audio dma: kStatus_SPI_Busy.");
 	}
 
-	if (toggle_i2s_transfer) {
-		// Now that the next chunk of DMA has been shipped off, invoke update_all():
-		if (AudioOutputI2S::update_responsibility) AudioStream::update_all_streams();
-	}
+	// Now that the next chunk of DMA has been shipped off, invoke update_all()
+	// for the block the next completion consumes.
+	if (AudioOutputI2S::update_responsibility) AudioStream::update_all_streams();
 
 	toggle_i2s_transfer = !toggle_i2s_transfer;
 }
@@ -302,8 +323,13 @@ void AudioOutputI2S::update(void)
 
 bool AudioOutputI2S::is_idle(void)
 {
-  // This block has no audio source of its own. It is always ok to sleep.
-  return true;
+  // This block has no audio source of its own. It is ok to sleep unless held.
+  return !awake_hold;
+}
+
+void AudioOutputI2S::hold_awake(bool hold)
+{
+  awake_hold = hold;
 }
 
 
@@ -316,6 +342,7 @@ bool AudioOutputI2S::is_idle(void)
 
 void audio_i2s_isr(I2S_Type *base, i2s_dma_handle_t *handle, status_t completionStatus, void *userData)
 {
+	tx_complete_us = (uint32_t) micros();
 	audio_stream_update_from_isr(completionStatus);
 }
 
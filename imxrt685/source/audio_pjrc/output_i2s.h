@@ -34,6 +34,9 @@
 #include "fsl_i2s.h"
 #include "fsl_i2s_dma.h"
 
+// Frames per I2S DMA transfer, one audio block.
+#define I2S_TRANSFER_FRAMES (AUDIO_BLOCK_SAMPLES)
+
 //typedef uint8_t audio_i2s_buffer_id_t;
 //#define audio_i2s_buffer_id_t uint8_t
 
@@ -46,6 +49,9 @@ public:
 	static void init(void);
 	static void begin(void);
 	static void end(void);
+	// Keep the output from reporting idle while nothing plays, e.g. during a
+	// stimulation session where pulses may come at any time.
+	static void hold_awake(bool hold);
 	friend class AudioInputI2S;
 	friend void audio_i2s_isr(I2S_Type *base, i2s_dma_handle_t *handle, status_t completionStatus, void *userData);
 	static void handle_audio_i2s_event();
@@ -61,6 +67,7 @@ private:
 	static audio_block_t *block_right_2nd;
 	static uint16_t block_left_offset;
 	static uint16_t block_right_offset;
+	static volatile bool awake_hold;
 	audio_block_t *inputQueueArray[2];
 };
 
@@ -38,8 +38,9 @@
 #define WAV_BUFFER_MAX_READ_MSG_LEN    (4*AUDIO_BLOCK_SAMPLES) // bytes
 //
 #define WAV_BUFFER_MAX_WRITE_MSG_LEN    (4*AUDIO_BLOCK_SAMPLES) // bytes
-// The number of audio blocks on the buffer.
-#define WAV_BUFFER_NUM_MSGS    40 // TODO: Determine why Audio task was crashing when this number was 100.
+// The number of audio blocks on the buffer, 40 blocks of 512 samples (~460 ms)
+// whatever the block size.
+#define WAV_BUFFER_NUM_MSGS    (40*512/AUDIO_BLOCK_SAMPLES) // TODO: Determine why Audio task was crashing when this number was 100.
 // The total number of audio bytes to be buffered.
 #define WAV_BUFFER_SIZE_BYTES  WAV_BUFFER_MAX_WRITE_MSG_LEN * WAV_BUFFER_NUM_MSGS // bytes
 #endif
@@ -89,6 +89,8 @@ void AudioSynthNoisePink::update(void)
 
 	gain = level;
 	if (gain == 0) return;
+	// muted or faded out downstream, nobody would hear this block
+	if (!output_used()) return;
 	block = allocate();
 	if (!block) return;
 	p = (uint32_t *)(block->data);
@@ -149,12 +151,36 @@ void AudioSynthNoisePink::update(void)
 	release(block);
 }
 
+void AudioSynthNoisePink::render(int16_t *out, uint32_t len, int32_t seed)
+{
+	// update() steps through these masks for each group of 16 samples,
+	// the first one comes from pnmask[]
+	static const int32_t masks[16] = {
+		0, 0x0800, 0x0400, 0x0800, 0x0200, 0x0800, 0x0400, 0x0800,
+		0x0100, 0x0800, 0x0400, 0x0800, 0x0200, 0x0800, 0x0400, 0x0800
+	};
+	int32_t inc, dec, accu, bit, lfsr, out_val;
+	int32_t taps = 0x46000001;
+	uint8_t ncnt = 0;
+
+	lfsr = seed;
+	accu = 0;
+	inc  = 0x0CCC;
+	dec  = 0x0CCC;
+	for (uint32_t i = 0; i < len; i++) {
+		int32_t mask = (i & 15) ? masks[i & 15] : pnmask[ncnt++];
+		PINT_FILT(mask, out_val);
+		// signed_multiply_32x16b() at full gain keeps the low 16 bits
+		out[i] = (int16_t)out_val;
+	}
+}
+
 bool AudioSynthNoisePink::is_idle(void)
 {
   AUDIO_ENTER_CRITICAL();
   bool is_idle = (level == 0);
   AUDIO_EXIT_CRITICAL();
-  return is_idle;
+  return is_idle || !output_used();
 }
 
 void AudioSynthNoisePink::amplitude(float n) {
@@ -43,6 +43,8 @@ public:
 	virtual void update(void);
 	virtual bool is_idle(void);
 	void amplitude(float n);
+	// Same generator at full amplitude into a plain buffer, outside the graph.
+	static void render(int16_t *out, uint32_t len, int32_t seed);
 private:
 	static const uint8_t pnmask[256];
 	static const int32_t pfira[64];
@@ -45,7 +45,8 @@ void AudioSynthWaveformSine::update(void)
 	uint32_t i, ph, inc, index, scale;
 	int32_t val1, val2;
 
-	if (magnitude) {
+	// silent, or muted downstream: only keep the phase running
+	if (magnitude && output_used()) {
 		block = allocate();
 		if (block) {
 			ph = phase_accumulator;
@@ -78,7 +79,7 @@ bool AudioSynthWaveformSine::is_idle(void)
 	AUDIO_ENTER_CRITICAL();
 	bool is_idle = (magnitude == 0);
 	AUDIO_EXIT_CRITICAL();
-	return is_idle;
+	return is_idle || !output_used();
 }
 
 void AudioSynthWaveformSine::frequency(float freq) {
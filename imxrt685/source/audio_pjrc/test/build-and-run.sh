@@ -0,0 +1,41 @@
+set -x
+
+# Runs the audio update() graph on the host for several AUDIO_BLOCK_SAMPLES,
+# the mixer output must not depend on the block size.
+
+SRC=../..
+
+gcc -c -DPROFILER_HOST \
+ ../data_waveforms.c \
+ $SRC/utils/profiler.c \
+ -I $SRC/utils || exit 1
+
+for BLOCK in 512 256 128 64; do
+  g++ -std=gnu++11 -DAUDIO_HOST -DPROFILER_HOST \
+   -DAUDIO_BLOCK_SAMPLES=$BLOCK \
+   -DAUDIO_ENABLE_CPU_CYCLE_COUNTER=0 \
+   -I shim \
+   -I .. \
+   -I $SRC/audio \
+   -I $SRC/utils \
+   -I $SRC/../CMSIS \
+   -I $SRC/../CMSIS/DSP/Include \
+   ./graph_test.cpp \
+   ../AudioStream.cpp \
+   ../mixer.cpp \
+   ../synth_pinknoise.cpp \
+   ../synth_sine.cpp \
+   ../effect_fade.cpp \
+   data_waveforms.o \
+   profiler.o \
+   -o graph_test_$BLOCK && \
+  ./graph_test_$BLOCK graph_$BLOCK.raw || exit 1
+done
+
+for BLOCK in 256 128 64; do
+  cmp graph_512.raw graph_$BLOCK.raw || exit 1
+done
+echo "graph output identical for all block sizes"
+
+# cleanup
+rm ./*.o ./graph_test_* ./graph_*.raw
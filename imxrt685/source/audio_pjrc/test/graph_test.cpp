@@ -0,0 +1,160 @@
+/*
+ * graph_test.cpp
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host test of the audio update() graph. Runs pink noise and
+ * sine sources through fades and the mixers like audio_task.cpp, with gain
+ * and fade changes along the way, and writes the mixer output as
+ * interleaved 16 bit L/R to a file. build-and-run.sh builds it for several
+ * AUDIO_BLOCK_SAMPLES and checks the outputs are identical.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "AudioStream.h"
+#include "synth_pinknoise.h"
+#include "synth_sine.h"
+#include "effect_fade.h"
+#include "mixer.h"
+
+// Gain and fade changes land on block boundaries, so they happen at multiples
+// of the largest block size under test.
+#define EVENT_SAMPLES (512U)
+#define NUM_EVENTS (160U) // see build-and-run.sh
+
+#define PINK_CHANNEL 3
+#define SINE_CHANNEL 4
+
+// Collects the mixer output, last in update() order like AudioOutputI2S.
+class AudioCapture : public AudioStream
+{
+public:
+  AudioCapture(void) : AudioStream(2, inputQueueArray) {}
+  virtual void update(void) {
+    audio_block_t *left = receiveReadOnly(0);
+    audio_block_t *right = receiveReadOnly(1);
+    for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+      int16_t frame[2] = {
+        left ? left->data[i] : (int16_t) 0,
+        right ? right->data[i] : (int16_t) 0,
+      };
+      fwrite(frame, sizeof(frame), 1, out);
+      if (frame[0] != 0 || frame[1] != 0) {
+        nonzero++;
+      }
+    }
+    if (left) release(left);
+    if (right) release(right);
+  }
+  virtual bool is_idle(void) { return true; }
+  FILE *out = NULL;
+  uint32_t nonzero = 0;
+private:
+  audio_block_t *inputQueueArray[2];
+};
+
+// Same construction order as audio_task.cpp, which sets the update() order:
+// sources and fades, then the mixers, then the output.
+AudioSynthNoisePink      pink;
+AudioEffectFade          pink_fade(false);
+AudioSynthWaveformSine   sineLow;
+AudioSynthWaveformSine   sineHigh;
+AudioMixer5              mixerLeft;
+AudioMixer5              mixerRight;
+AudioCapture             capture;
+AudioConnection          patchCord1(pink, 0, pink_fade, 0);
+AudioConnection          patchCord2(pink_fade, 0, mixerLeft, PINK_CHANNEL);
+AudioConnection          patchCord3(pink_fade, 0, mixerRight, PINK_CHANNEL);
+AudioConnection          patchCord4(sineLow, 0, mixerLeft, SINE_CHANNEL);
+AudioConnection          patchCord5(sineHigh, 0, mixerRight, SINE_CHANNEL);
+AudioConnection          patchCord6(mixerLeft, 0, capture, 0);
+AudioConnection          patchCord7(mixerRight, 0, capture, 1);
+
+// Host version of the audio critical section, there is only one thread.
+extern "C" {
+void matched_rtos_semaphore_take(){}
+void matched_rtos_semaphore_give(){}
+}
+
+static void apply_event(uint32_t n)
+{
+  switch (n) {
+    case 0:
+      pink.amplitude(0.5f);
+      pink_fade.fadeIn(100);
+      sineLow.frequency(440);
+      sineLow.amplitude(0.3f);
+      sineHigh.frequency(880);
+      sineHigh.amplitude(0.3f);
+      mixerLeft.gain(PINK_CHANNEL, 0.8f);
+      mixerRight.gain(PINK_CHANNEL, 0.8f);
+      mixerLeft.gain(SINE_CHANNEL, 0.5f);
+      mixerRight.gain(SINE_CHANNEL, 0.5f);
+      break;
+    case 40:
+      pink_fade.fadeOut(50);
+      break;
+    case 60:
+      // a gain above unity saturates in the mixer
+      mixerRight.gain(SINE_CHANNEL, 3.0f);
+      break;
+    case 80:
+      // sineLow only feeds this channel, it stops rendering
+      mixerLeft.gain(SINE_CHANNEL, 0);
+      break;
+    case 100:
+      pink_fade.fadeIn(20);
+      break;
+    case 120:
+      sineHigh.amplitude(0);
+      break;
+    case 130:
+      // muted, pink stops rendering while still playing
+      mixerLeft.gain(PINK_CHANNEL, 0);
+      mixerRight.gain(PINK_CHANNEL, 0);
+      break;
+    case 140:
+      pink.amplitude(0);
+      break;
+    case 150:
+      sineLow.amplitude(0);
+      break;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <output file>\n", argv[0]);
+    return 1;
+  }
+  capture.out = fopen(argv[1], "wb");
+  assert(capture.out);
+
+  AudioMemory(18);
+
+  for (uint32_t n = 0; n < NUM_EVENTS; n++) {
+    apply_event(n);
+    for (uint32_t i = 0; i < EVENT_SAMPLES/AUDIO_BLOCK_SAMPLES; i++) {
+      AudioStream::update_all_streams();
+    }
+  }
+  fclose(capture.out);
+
+  // the graph produced sound, and gave back every block once all sources
+  // went quiet
+  assert(capture.nonzero > NUM_EVENTS*EVENT_SAMPLES/2);
+  assert(AudioMemoryUsage() == 0);
+  // zero gain mixer inputs are not rendered upstream
+  assert(!pink.output_used());
+  assert(!sineLow.output_used());
+  assert(sineHigh.output_used());
+
+  printf("graph test, %u samples per block: %u frames, max %u blocks in use\n",
+      (unsigned) AUDIO_BLOCK_SAMPLES, (unsigned) (NUM_EVENTS*EVENT_SAMPLES),
+      (unsigned) AudioMemoryUsageMax());
+  return 0;
+}
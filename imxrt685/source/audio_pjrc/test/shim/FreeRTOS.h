@@ -0,0 +1,28 @@
+/*
+ * FreeRTOS.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host graph test shim. Only what the audio graph objects and
+ * the headers they pull in need to compile; there is no scheduler on the host.
+ */
+
+#ifndef AUDIO_TEST_SHIM_FREERTOS_H_
+#define AUDIO_TEST_SHIM_FREERTOS_H_
+
+#include <assert.h>
+#include <stdint.h>
+
+typedef unsigned long TickType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef void* TaskHandle_t;
+typedef void* SemaphoreHandle_t;
+
+#define pdTRUE  (1)
+#define pdFALSE (0)
+#define portMAX_DELAY ((TickType_t) 0xffffffffUL)
+
+#define configASSERT(x) assert(x)
+
+#endif /* AUDIO_TEST_SHIM_FREERTOS_H_ */
@@ -0,0 +1,13 @@
+/*
+ * config.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host graph test shim for config/config.h. The graph objects
+ * under test do not depend on any firmware configuration.
+ */
+
+#ifndef AUDIO_TEST_SHIM_CONFIG_H_
+#define AUDIO_TEST_SHIM_CONFIG_H_
+
+#endif /* AUDIO_TEST_SHIM_CONFIG_H_ */
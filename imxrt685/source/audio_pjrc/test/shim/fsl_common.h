@@ -0,0 +1,16 @@
+/*
+ * fsl_common.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host graph test shim for the MCUXpresso SDK common header.
+ */
+
+#ifndef AUDIO_TEST_SHIM_FSL_COMMON_H_
+#define AUDIO_TEST_SHIM_FSL_COMMON_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#endif /* AUDIO_TEST_SHIM_FSL_COMMON_H_ */
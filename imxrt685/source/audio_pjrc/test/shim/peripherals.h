@@ -0,0 +1,15 @@
+/*
+ * peripherals.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host graph test shim, AudioStream.h includes the board
+ * peripherals for the I2S output.
+ */
+
+#ifndef AUDIO_TEST_SHIM_PERIPHERALS_H_
+#define AUDIO_TEST_SHIM_PERIPHERALS_H_
+
+#include "fsl_common.h"
+
+#endif /* AUDIO_TEST_SHIM_PERIPHERALS_H_ */
@@ -0,0 +1,14 @@
+/*
+ * portmacro.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host graph test shim, see FreeRTOS.h.
+ */
+
+#ifndef AUDIO_TEST_SHIM_PORTMACRO_H_
+#define AUDIO_TEST_SHIM_PORTMACRO_H_
+
+#include "FreeRTOS.h"
+
+#endif /* AUDIO_TEST_SHIM_PORTMACRO_H_ */
@@ -30,6 +30,10 @@
 #include <stdint.h>
 #include "AudioCompat.h"
 
+#if defined(AUDIO_HOST)
+#include "dspinst_host.h"
+#else
+
 // computes limit((val >> rshift), 2**bits)
 static inline int32_t signed_saturate_rshift(int32_t val, int bits, int rshift) __attribute__((always_inline, unused));
 static inline int32_t signed_saturate_rshift(int32_t val, int bits, int rshift)
@@ -369,4 +373,6 @@ static inline int32_t FRACMUL_SHL(int32_t x, int32_t y, int z)
     return t;
 }
 
+#endif // AUDIO_HOST
+
 #endif
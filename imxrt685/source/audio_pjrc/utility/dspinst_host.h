@@ -0,0 +1,99 @@
+/*
+ * dspinst_host.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Plain C versions of the dspinst.h helpers used by the audio
+ * graph objects, for the host graph test (audio_pjrc/test). Results match the
+ * Cortex-M DSP instructions bit for bit.
+ */
+
+#ifndef dspinst_host_h_
+#define dspinst_host_h_
+
+#include <stdint.h>
+
+static inline int32_t dspinst_host_sat(int64_t val, int bits)
+{
+	int64_t max = ((int64_t)1 << (bits - 1)) - 1;
+	int64_t min = -((int64_t)1 << (bits - 1));
+	if (val > max) return (int32_t)max;
+	if (val < min) return (int32_t)min;
+	return (int32_t)val;
+}
+
+// computes limit((val >> rshift), 2**bits)
+static inline int32_t signed_saturate_rshift(int32_t val, int bits, int rshift)
+{
+	return dspinst_host_sat(val >> rshift, bits);
+}
+
+// computes limit(val, 2**bits)
+static inline int16_t saturate16(int32_t val)
+{
+	return (int16_t)dspinst_host_sat(val, 16);
+}
+
+// computes ((a[31:0] * b[15:0]) >> 16)
+static inline int32_t signed_multiply_32x16b(int32_t a, uint32_t b)
+{
+	return (int32_t)(((int64_t)a * (int16_t)(b & 0xFFFF)) >> 16);
+}
+
+// computes ((a[31:0] * b[31:16]) >> 16)
+static inline int32_t signed_multiply_32x16t(int32_t a, uint32_t b)
+{
+	return (int32_t)(((int64_t)a * (int16_t)(b >> 16)) >> 16);
+}
+
+// computes (((int64_t)a[31:0] * (int64_t)b[31:0]) >> 32)
+static inline int32_t multiply_32x32_rshift32(int32_t a, int32_t b)
+{
+	return (int32_t)(((int64_t)a * b) >> 32);
+}
+
+// computes (((int64_t)a[31:0] * (int64_t)b[31:0] + 0x8000000) >> 32)
+static inline int32_t multiply_32x32_rshift32_rounded(int32_t a, int32_t b)
+{
+	return (int32_t)(((int64_t)a * b + 0x80000000LL) >> 32);
+}
+
+// computes sum + (((int64_t)a[31:0] * (int64_t)b[31:0] + 0x8000000) >> 32)
+static inline int32_t multiply_accumulate_32x32_rshift32_rounded(int32_t sum, int32_t a, int32_t b)
+{
+	return (int32_t)((((int64_t)sum << 32) + (int64_t)a * b + 0x80000000LL) >> 32);
+}
+
+// computes sum - (((int64_t)a[31:0] * (int64_t)b[31:0] + 0x8000000) >> 32)
+static inline int32_t multiply_subtract_32x32_rshift32_rounded(int32_t sum, int32_t a, int32_t b)
+{
+	return (int32_t)((((int64_t)sum << 32) - (int64_t)a * b + 0x80000000LL) >> 32);
+}
+
+// computes (a[31:16] | (b[31:16] >> 16))
+static inline uint32_t pack_16t_16t(int32_t a, int32_t b)
+{
+	return ((uint32_t)a & 0xFFFF0000) | ((uint32_t)b >> 16);
+}
+
+// computes (a[31:16] | b[15:0])
+static inline uint32_t pack_16t_16b(int32_t a, int32_t b)
+{
+	return ((uint32_t)a & 0xFFFF0000) | ((uint32_t)b & 0x0000FFFF);
+}
+
+// computes ((a[15:0] << 16) | b[15:0])
+static inline uint32_t pack_16b_16b(int32_t a, int32_t b)
+{
+	return ((uint32_t)a << 16) | ((uint32_t)b & 0x0000FFFF);
+}
+
+// computes (((a[31:16] + b[31:16]) << 16) | (a[15:0 + b[15:0]))  (saturates)
+static inline uint32_t signed_add_16_and_16(uint32_t a, uint32_t b)
+{
+	int32_t lo = dspinst_host_sat((int16_t)(a & 0xFFFF) + (int16_t)(b & 0xFFFF), 16);
+	int32_t hi = dspinst_host_sat((int16_t)(a >> 16) + (int16_t)(b >> 16), 16);
+	return pack_16b_16b(hi, lo);
+}
+
+#endif
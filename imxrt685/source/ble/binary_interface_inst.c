@@ -96,6 +96,12 @@ size_t serial_write_buffer(const char *buffer, size_t size){
   return size;
 }
 
+static void handle_packet_error(void *context, PacketSerialError error)
+{
+  LOGE(TAG, "Dropped packet longer than %d bytes (error %d)",
+    PACKET_SERIAL_RX_BUFFER_SIZE, (int)error);
+}
+
 static const Command bin_itf_commands[] = {
     {CC_NONE    , NULL},
     {CC_UNUSED1  , NULL},
@@ -115,6 +121,7 @@ void bin_itf_init()
     bin_itf.pSerial.serial_write_buffer_f = serial_write_buffer;
 
     bi_init( &bin_itf, bin_itf_commands, sizeof(bin_itf_commands)/sizeof(bin_itf_commands[0]) );
+    bin_itf.pSerial.on_error_f = handle_packet_error;
 }
 
 
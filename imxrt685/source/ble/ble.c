@@ -22,6 +22,7 @@
 #include "settings.h"
 #include "fs_commands.h"
 #include "fatfs_utils.h"
+#include "file_transfer.h"
 #include "memfault/metrics/metrics.h"
 
 #if (defined(ENABLE_BLE_TASK) && (ENABLE_BLE_TASK > 0U))
@@ -1340,6 +1341,7 @@ handle_ble_ota_started(ble_event_t *event)
 
 	// tell syncs to stop
 	ymodem_end_session();
+	file_transfer_end_session();
 
 	// set OTA flag to true to prevent Sleeping
 	g_ble_context.ota = true;
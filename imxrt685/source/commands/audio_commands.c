@@ -7,12 +7,15 @@
  * Author:  David Wang
  */
 
+#include <stdio.h>
 #include "audio_commands.h"
 #include "loglevels.h"
 #include "command_helpers.h"
 #include "interpreter.h"
 #include "erp.h"
+#include "erp_average.h"
 #include "settings.h"
+#include "stim_player.h"
 
 static const char *TAG = "audio_commands"; // Logging prefix for this module
 
@@ -325,6 +328,41 @@ void audio_pink_volume_command(int argc, char **argv){
   }
 }
 
+void audio_stim_pulse_command(int argc, char **argv){
+  CHK_ARGC(3,3);
+
+  uint32_t duration_ms = 0;
+  uint32_t ramp_ms = 0;
+  bool success = true;
+  success &= parse_uint32_arg_min_max(argv[0], argv[1], 1, STIM_PLAYER_MAX_PULSE_MS, &duration_ms);
+  success &= parse_uint32_arg_max(argv[0], argv[2], duration_ms/2, &ramp_ms);
+
+  if(success){
+    if (!audio_stim_pulse_render(duration_ms, ramp_ms)) {
+      printf("stim pulse not rendered, set ENABLE_STIM_PLAYER in config.h\n");
+    }
+  }
+}
+
+void audio_cpu_command(int argc, char **argv){
+  audio_print_cpu_usage();
+}
+
+void audio_cpu_reset_command(int argc, char **argv){
+  audio_reset_cpu_usage();
+}
+
+void audio_power_off_delay_command(int argc, char **argv){
+  CHK_ARGC(1,2); // allow 0 or 1 arguments
+
+  uint32_t delay_ms = 0;
+  if(argc==2 && parse_uint32_arg(argv[0], argv[1], &delay_ms)){
+    audio_set_power_off_delay(delay_ms);
+  }
+  printf("audio power off after %lu ms of silence (0 = never)\n",
+      (unsigned long) audio_get_power_off_delay());
+}
+
 
 void audio_mp3_play_command(int argc, char **argv)
 {
@@ -418,3 +456,10 @@ void erp_stop_command(int argc, char **argv)
 
   erp_event_stop();
 }
+
+void erp_report_command(int argc, char **argv)
+{
+  CHK_ARGC(1,1);
+
+  erp_average_report();
+}
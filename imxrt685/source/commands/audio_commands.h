@@ -50,6 +50,10 @@ void audio_pink_fade_out_command(int argc, char **argv);
 void audio_pink_mute_command(int argc, char **argv);
 void audio_pink_unmute_command(int argc, char **argv);
 void audio_pink_volume_command(int argc, char **argv);
+void audio_stim_pulse_command(int argc, char **argv);
+void audio_cpu_command(int argc, char **argv);
+void audio_cpu_reset_command(int argc, char **argv);
+void audio_power_off_delay_command(int argc, char **argv);
 
 void audio_play_test_command(int argc, char **argv);
 void audio_stop_test_command(int argc, char **argv);
@@ -58,6 +62,7 @@ void audio_info_command(int argc, char **argv);
 
 void erp_start_command(int argc, char **argv);
 void erp_stop_command(int argc, char **argv);
+void erp_report_command(int argc, char **argv);
 
 #ifdef __cplusplus
 }
@@ -11,6 +11,7 @@
  */
 #include <ble_shell.h>
 #include <ymodem.h>
+#include <file_transfer.h>
 #include <stdbool.h>
 #include <stdio.h>
 
@@ -225,3 +226,22 @@ ble_fs_ymodem_send_command(int argc, char *argv[])
   }
 
 }
+
+void
+ble_fs_send_command(int argc, char *argv[])
+{
+  // stop therapy
+  interpreter_event_stop_script(false);
+
+  CHK_ARGC(2, 3);
+
+  const char* name = argv[1];
+  uint32_t offset = 0;
+
+  // The receiver passes the size of its partial copy to resume
+  if (argc == 3 && !parse_uint32_arg(argv[0], argv[2], &offset)) {
+    return;
+  }
+
+  file_transfer_send(&ble_interface, name, offset);
+}
@@ -22,6 +22,7 @@ void ble_fs_mkdir_command(int argc, char *argv[]);
 void ble_fs_mv_command(int argc, char *argv[]);
 void ble_fs_ymodem_recv_command(int argc, char **argv);
 void ble_fs_ymodem_send_command(int argc, char **argv);
+void ble_fs_send_command(int argc, char **argv);
 
 #ifdef __cplusplus
 }
@@ -9,6 +9,7 @@
 #include "task.h"
 #include "command_helpers.h"
 #include "ymodem.h"
+#include "file_transfer.h"
 #include "eeg_reader.h"
 
 #include "ble.h"
@@ -106,6 +107,7 @@ therapy_command(int argc, char **argv)
     // This is possible via BLE only since the command to start therapy
     // can arrive via its own characteristic, bypassing the UART service.
     ymodem_end_session();
+    file_transfer_end_session();
     ble_therapy_command(therapy);
   }
 }
@@ -42,6 +42,7 @@
 #include "pmic_commands.h"
 #include "ml.h"
 #include "memfault_commands.h"
+#include "profiler_commands.h"
 #include "adc_commands.h"
 
 // This one needs to be defined after the declaration of shell_commands:
@@ -136,6 +137,7 @@ const shell_command_t commands[] = {
     { P_ALL, "nand_unlock", nand_unlock_command, "Unlock SPI Flash ID for writes" },
     { P_ALL, "nand_mux_select", nand_mux_select_command, "Flash MUX select"},
     { P_ALL, "nand_read_page", nand_read_page_command, "Read SPI Flash page" },
+    { P_ALL, "nand_read_pages", nand_read_pages_command, "Compare and time page by page and continuous reads: <page_addr> <count>" },
     { P_ALL, "nand_write_page", nand_write_page_command, "Write SPI Flash page with test data" },
     { P_ALL, "nand_check_block", nand_check_block_command, "Check flash for a specific bad blocks" },
     { P_ALL, "nand_check_blocks", nand_check_blocks_command, "Check flash for bad blocks" },
@@ -156,6 +158,7 @@ const shell_command_t commands[] = {
     { P_ALL, "dhara_write_read", dhara_write_read_command, "Perform a write/read test via dhara" },
     { P_ALL, "dhara_sync", dhara_sync_command, "Commit pending changes to disk" },
     { P_ALL, "dhara_clear", dhara_clear_command, "Delete all logical sectors" },
+    { P_ALL, "dhara_wear", dhara_wear_command, "Show NAND wear statistics, or the erase count of one block, args: [block]" },
 #endif // DHARA_COMMANDS_H
 
 #if (defined(ENABLE_DHARA_PPSTRESS) && (ENABLE_DHARA_PPSTRESS > 0U))
@@ -188,6 +191,8 @@ const shell_command_t commands[] = {
     { P_ALL, "eeg_info", eeg_info_command, "Print out verbose log-level info on the EEG to debug console" },
     { P_ALL, "eeg_sqw", eeg_sqw_command, "EEG square wave, args: freq (0-100) duty cycle (0-100)" },
     { P_ALL, "eeg_gain?", eeg_get_gain_command, "Prints the EEG gain." },
+    { P_SHELL, "stim_sched_stats", stim_sched_stats_command, "Print the stimulus scheduler pulse timing statistics" },
+    { P_SHELL, "stim_sched_reset", stim_sched_reset_command, "Clear the stimulus scheduler statistics" },
 
     // Heart rate monitor commands:
 	{ P_ALL, "hrm_on", hrm_on, "Turn on heart rate monitor" },
@@ -261,10 +266,12 @@ const shell_command_t commands[] = {
     { P_ALL, "fs_cp", fs_cp_command, "cp <oldpath> <newpath>" },
     { P_ALL, "fs_cat", fs_cat_command, "cat <filename>" },
     { P_ALL, "fs_info", fs_info_command, "Show filesystem info" },
+    { P_ALL, "fs_sync_policy", fs_sync_policy_command, "Show or set the default file sync policy and writer stats, args: [<sync_bytes> <sync_ms>]" },
     { P_ALL, "fs_ymodem_recv", fs_ymodem_recv_command, "Receive file via ymodem" },
     { P_ALL, "fs_ymodem_send", fs_ymodem_send_command, "Send file via ymodem" },
     { P_ALL, "fs_ymodem_recv_test", fs_ymodem_recv_test_command, "Ymodem expects a file with 'abc...z', 100 times." },
     { P_ALL, "fs_ymodem_send_test", fs_ymodem_send_test_command, "Ymodem sends a file with 'abc...z', 100 times." },
+    { P_ALL, "fs_send", fs_send_command, "Send file with resume and integrity check, args: <filename> [offset]" },
     { P_ALL, "fs_zmodem_recv", fs_zmodem_recv_command, "Receive file via Zmodem" },
     { P_ALL, "fs_zmodem_send", fs_zmodem_send_command, "Send file via Zmodem" },
     { P_ALL, "fs_zmodem_send_test", fs_zmodem_send_test_command, "Zmodem sends a file with 'abc...z', 100 times." },
@@ -341,6 +348,10 @@ const shell_command_t commands[] = {
     { P_ALL, "audio_pink_mute",     audio_pink_mute_command, "Mute pink audio" },
     { P_ALL, "audio_pink_unmute",   audio_pink_unmute_command, "Unmute pink audio" },
     { P_ALL, "audio_pink_volume",   audio_pink_volume_command, "Pink audio volume" },
+    { P_SHELL, "audio_stim_pulse",  audio_stim_pulse_command, "Render the stimulus pulse, args: duration_ms_int ramp_ms_int" },
+    { P_SHELL, "audio_cpu",         audio_cpu_command, "Print the update() time of each audio graph stage" },
+    { P_SHELL, "audio_cpu_reset",   audio_cpu_reset_command, "Clear the audio graph max update() times" },
+    { P_SHELL, "audio_power_off_delay", audio_power_off_delay_command, "Get or set the silence (ms) before audio powers off, 0 = never" },
 
     { P_ALL, "audio_play_test", audio_play_test_command, "Play test sine wave, right channel has higher freq than left." },
     { P_ALL, "audio_stop_test", audio_stop_test_command, "Stop test sine wave" },
@@ -351,6 +362,7 @@ const shell_command_t commands[] = {
     // Audio ERP Test
     { P_ALL, "erp_start", erp_start_command, "Start the audio ERP experiment, 5 args: <num_trials> <pulse_dur_ms> <isi_ms> <jitter_ms> <volume>"},
     { P_ALL, "erp_stop", erp_stop_command, "Stop the audio ERP experiment."},
+    { P_ALL, "erp_report", erp_report_command, "Print the averaged ERP waveform: offset_ms, then mean and std (uV) per channel."},
 
     // Included commands:
     { P_ALL, "help", shell_help, .description = "List commands with descriptions"  },
@@ -439,6 +451,7 @@ const shell_command_t commands[] = {
     { P_BLE, "ble_fs_mv", ble_fs_mv_command, "mv <oldpath> <newpath>" },
     { P_BLE, "ble_fs_ymodem_recv", ble_fs_ymodem_recv_command, "Receive file via ymodem" },
     { P_BLE, "ble_fs_ymodem_send", ble_fs_ymodem_send_command, "Send file via ymodem" },
+    { P_BLE, "ble_fs_send", ble_fs_send_command, "Send file with resume and integrity check, args: <filename> [offset]" },
     { P_BLE, "ble_filehash_sha256", ble_filehash_sha256_command, "print sha256 hash (32 characters) for the specific file or print 'error #', 1 arg: [filepath]"},
 
     { P_BLE, "ble_uffs_ls", ble_fs_ls_command, "(DEPRECATED) ls <path>" },
@@ -477,6 +490,10 @@ const shell_command_t commands[] = {
 	// ADC Tests
 	{P_SHELL, "adc_read", adc_read_command, "ADC Read Test"},
 
+    // Stage profiling
+    { P_SHELL, "profile_dump", profile_dump_command, "Print per-stage cycle statistics and histograms" },
+    { P_SHELL, "profile_reset", profile_reset_command, "Clear the per-stage cycle statistics" },
+
     // Misc low level tests
 #if (defined(ENABLE_STREAM_MEMORY_TEST_COMMANDS) && (ENABLE_STREAM_MEMORY_TEST_COMMANDS > 0U))
     { P_ALL, "stream_memory_test", stream_memory_test_command, "Runs Test for Streaming Memory" },
@@ -17,6 +17,7 @@
 
 #include "command_helpers.h"
 #include "dhara_utils.h"
+#include "dhara_wear.h"
 #include "map.h"
 #include "nand.h"
 
@@ -182,6 +183,37 @@ void dhara_sync_command(int argc, char **argv) {
   }
 }
 
+void dhara_wear_command(int argc, char **argv) {
+  CHK_ARGC(1, 2);
+
+  struct dhara_map *map = dhara_get_my_map();
+  dhara_wear_stats_t stats;
+  dhara_wear_get_stats(&stats);
+
+  if (argc == 2) {
+    // erase count of one block
+    uint32_t block = 0;
+    if (parse_uint32_arg(argv[0], argv[1], &block)) {
+      printf("block %lu: %lu erases\n", (unsigned long) block,
+          (unsigned long) dhara_wear_block_erases(block));
+    }
+    return;
+  }
+
+  printf("erases:             %lu (max %lu per block)\n",
+      (unsigned long) stats.erases, (unsigned long) stats.max_block_erases);
+  printf("erase failures:     %lu\n", (unsigned long) stats.erase_failures);
+  printf("bad blocks marked:  %lu\n", (unsigned long) stats.bad_blocks_marked);
+  printf("bad blocks in map:  %lu\n", (unsigned long) map->journal.bb_current);
+  printf("ECC warnings:       %lu\n", (unsigned long) stats.ecc_warnings);
+  printf("relocations:        %lu\n", (unsigned long) stats.relocations);
+  printf("idle GC pages:      %lu\n", (unsigned long) stats.idle_gc_pages);
+  printf("journal: %lu of %lu pages, %lu sectors live\n",
+      (unsigned long) dhara_journal_size(&map->journal),
+      (unsigned long) dhara_map_capacity(map),
+      (unsigned long) dhara_map_size(map));
+}
+
 void dhara_clear_command(int argc, char **argv) {
   struct dhara_map *map = dhara_get_my_map();
   dhara_map_clear(map);
@@ -19,6 +19,7 @@ extern "C" {
 void dhara_write_read_command(int argc, char **argv);
 void dhara_sync_command(int argc, char **argv);
 void dhara_clear_command(int argc, char **argv);
+void dhara_wear_command(int argc, char **argv);
 
 #ifdef __cplusplus
 }
@@ -7,10 +7,12 @@
  * Author:  David Wang
  */
 
+#include <stdio.h>
 #include "eeg_commands.h"
 #include "loglevels.h"
 #include "command_helpers.h"
 #include "eeg_sqw.h"
+#include "stim_scheduler.h"
 
 void eeg_on_command(int argc, char **argv)
 {
@@ -66,5 +68,14 @@ void eeg_get_gain_command(int argc, char **argv) {
   LOGV("data_log_eeg_gain","%f", gain);
 }
 
+void stim_sched_stats_command(int argc, char **argv) {
+  stim_scheduler_print_stats();
+}
+
+void stim_sched_reset_command(int argc, char **argv) {
+  stim_scheduler_reset_stats();
+  printf("stim scheduler stats cleared\n");
+}
+
 
 
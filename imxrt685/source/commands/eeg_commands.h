@@ -27,6 +27,8 @@ void eeg_gain_command(int argc, char **argv);
 void eeg_info_command(int argc, char **argv);
 void eeg_sqw_command(int argc, char **argv);
 void eeg_get_gain_command(int argc, char **argv);
+void stim_sched_stats_command(int argc, char **argv);
+void stim_sched_reset_command(int argc, char **argv);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,326 @@
+/*
+ * file_transfer.c
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Resumable file transfer for log offload, see file_transfer.h.
+ *
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ff.h"
+#include "crctab.h"
+#include "sha256.h"
+#include "file_transfer.h"
+
+// WARNING: Debug log output in a UART transfer stream will break the protocol.
+
+static bool g_cancel_flag = false;
+static bool g_running = false;
+
+// Header bytes of each frame, including the type byte
+#define START_HEADER_SIZE (1 + 4 + 4 + 2)
+#define DATA_HEADER_SIZE  (1 + 4 + 2)
+#define END_HEADER_SIZE   (1 + 4)
+
+typedef struct {
+  const ymodem_interface* interface;
+  uint32_t crc;
+} frame_writer_t;
+
+/* CRC-32 (zlib), one lookup per byte in the zmodem crc32tab (poly 0xEDB88320) */
+static uint32_t
+crc32_update(uint32_t crc, const uint8_t *buf, size_t count)
+{
+  while (count--) {
+    crc = UPDCRC32(*buf++, crc);
+  }
+  return crc;
+}
+
+static void
+put_le32(uint8_t *p, uint32_t val)
+{
+  p[0] = val;
+  p[1] = val >> 8;
+  p[2] = val >> 16;
+  p[3] = val >> 24;
+}
+
+static uint32_t
+get_le32(const uint8_t *p)
+{
+  return (uint32_t)p[0] |
+    ((uint32_t)p[1] << 8) |
+    ((uint32_t)p[2] << 16) |
+    ((uint32_t)p[3] << 24);
+}
+
+static void
+frame_put(frame_writer_t *w, const uint8_t *data, size_t len)
+{
+  w->crc = crc32_update(w->crc, data, len);
+  for (size_t i = 0; i < len; i++) {
+    w->interface->putcharagg(data[i]);
+  }
+}
+
+static void
+frame_begin(frame_writer_t *w, const ymodem_interface* interface,
+  const uint8_t *header, size_t len)
+{
+  w->interface = interface;
+  w->crc = 0xFFFFFFFF;
+  frame_put(w, header, len);
+}
+
+static void
+frame_end(frame_writer_t *w)
+{
+  uint8_t trailer[4];
+
+  put_le32(trailer, w->crc ^ 0xFFFFFFFF);
+  for (size_t i = 0; i < sizeof(trailer); i++) {
+    w->interface->putcharagg(trailer[i]);
+  }
+  w->interface->flush();
+}
+
+static void
+send_start(const ymodem_interface* interface, uint32_t size, uint32_t offset)
+{
+  frame_writer_t w;
+  uint8_t header[START_HEADER_SIZE];
+
+  header[0] = FILE_TRANSFER_START;
+  put_le32(&header[1], size);
+  put_le32(&header[5], offset);
+  header[9] = FILE_TRANSFER_CHUNK_SIZE & 0xFF;
+  header[10] = FILE_TRANSFER_CHUNK_SIZE >> 8;
+
+  frame_begin(&w, interface, header, sizeof(header));
+  frame_end(&w);
+}
+
+static void
+send_data(const ymodem_interface* interface, uint32_t offset,
+  const uint8_t *data, uint16_t len)
+{
+  frame_writer_t w;
+  uint8_t header[DATA_HEADER_SIZE];
+
+  header[0] = FILE_TRANSFER_DATA;
+  put_le32(&header[1], offset);
+  header[5] = len & 0xFF;
+  header[6] = len >> 8;
+
+  frame_begin(&w, interface, header, sizeof(header));
+  frame_put(&w, data, len);
+  frame_end(&w);
+}
+
+static void
+send_end(const ymodem_interface* interface, uint32_t size,
+  const uint8_t digest[SHA256_DIGEST_SIZE])
+{
+  frame_writer_t w;
+  uint8_t header[END_HEADER_SIZE];
+
+  header[0] = FILE_TRANSFER_END;
+  put_le32(&header[1], size);
+
+  frame_begin(&w, interface, header, sizeof(header));
+  frame_put(&w, digest, SHA256_DIGEST_SIZE);
+  frame_end(&w);
+}
+
+// Wait for the next ack or nak from the host.
+// Returns its type and offset, 0 on timeout, or -1 if the host aborted.
+static int
+get_reply(const ymodem_interface* interface, uint32_t *offset)
+{
+  int ch;
+
+  while ((ch = interface->getchar(FILE_TRANSFER_TIMEOUT)) >= 0) {
+    if (ch == YMODEM_CAN) {
+      if (interface->getchar(FILE_TRANSFER_TIMEOUT) == YMODEM_CAN) {
+        return -1;
+      }
+    } else if (ch == FILE_TRANSFER_ACK || ch == FILE_TRANSFER_NAK) {
+      uint8_t buf[4];
+      for (size_t i = 0; i < sizeof(buf); i++) {
+        int c = interface->getchar(FILE_TRANSFER_TIMEOUT);
+        if (c < 0) {
+          return 0;
+        }
+        buf[i] = c;
+      }
+      *offset = get_le32(buf);
+      return ch;
+    }
+    // Anything else is noise, e.g. the echo of the command line.
+  }
+
+  return 0;
+}
+
+static int
+send_file(const ymodem_interface* interface, FIL *file, uint32_t size,
+  uint32_t offset)
+{
+  uint8_t data[FILE_TRANSFER_CHUNK_SIZE];
+  uint8_t digest[SHA256_DIGEST_SIZE];
+  sha256_t sha;
+  uint32_t hashed = 0;  // bytes [0, hashed) went into sha
+  uint32_t sent;        // next byte to send, also the file position
+  uint32_t acked;       // bytes [0, acked) are with the host
+  uint32_t reply;
+  UINT bytes_read;
+  int errors;
+  int type;
+
+  // The hash covers the whole file, so on resume the part the host
+  // already has is hashed here first. Reading it locally is much faster
+  // than sending it again.
+  sha256_init(&sha);
+  while (hashed < offset) {
+    UINT len = (offset - hashed < sizeof(data)) ? offset - hashed : sizeof(data);
+    if (f_read(file, data, len, &bytes_read) != FR_OK || bytes_read != len) {
+      return -1;
+    }
+    sha256_update(&sha, data, len);
+    hashed += len;
+    if (g_cancel_flag) {
+      return -1;
+    }
+  }
+
+  errors = 0;
+  for (;;) {
+    send_start(interface, size, offset);
+    type = get_reply(interface, &reply);
+    if (type == FILE_TRANSFER_ACK && reply == offset) {
+      break;
+    }
+    if (type < 0 || g_cancel_flag || ++errors >= FILE_TRANSFER_MAX_ERRORS) {
+      return -1;
+    }
+  }
+
+  sent = offset;
+  acked = offset;
+  errors = 0;
+  while (acked < size) {
+    // Keep up to FILE_TRANSFER_WINDOW frames in flight
+    while (sent < size && sent - acked < FILE_TRANSFER_WINDOW*FILE_TRANSFER_CHUNK_SIZE) {
+      UINT len = (size - sent < sizeof(data)) ? size - sent : sizeof(data);
+      if (f_read(file, data, len, &bytes_read) != FR_OK || bytes_read != len) {
+        return -1;
+      }
+      // Resent chunks are already hashed
+      if (sent + len > hashed) {
+        uint32_t skip = hashed - sent;
+        sha256_update(&sha, data + skip, len - skip);
+        hashed = sent + len;
+      }
+      send_data(interface, sent, data, len);
+      sent += len;
+    }
+
+    if (g_cancel_flag) {
+      return -1;
+    }
+
+    type = get_reply(interface, &reply);
+    if (type < 0) {
+      return -1;
+    }
+    if (type == FILE_TRANSFER_ACK) {
+      if (reply > acked && reply <= sent) {
+        acked = reply;
+        errors = 0;
+      }
+      continue;
+    }
+
+    // Timeout or nak: go back to where the host needs data
+    if (++errors >= FILE_TRANSFER_MAX_ERRORS) {
+      return -1;
+    }
+    if (type == FILE_TRANSFER_NAK && reply >= acked && reply <= sent) {
+      acked = reply;
+    }
+    if (f_lseek(file, acked) != FR_OK) {
+      return -1;
+    }
+    sent = acked;
+  }
+
+  sha256_final(&sha, digest);
+
+  errors = 0;
+  for (;;) {
+    send_end(interface, size, digest);
+    type = get_reply(interface, &reply);
+    if (type == FILE_TRANSFER_ACK && reply == size) {
+      break;
+    }
+    if (type < 0 || g_cancel_flag || ++errors >= FILE_TRANSFER_MAX_ERRORS) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+void
+file_transfer_end_session(void)
+{
+  // Checked between frames. It is cleared upon starting a new transfer.
+  g_cancel_flag = true;
+  g_running = false;
+}
+
+int
+file_transfer_send(const ymodem_interface* interface, const char *filename,
+  uint32_t offset)
+{
+  // Add "/" prefix to make filename a path
+  char fs_filename[FILE_NAME_LENGTH] = { '/', '\0' };
+  strncat(fs_filename, filename, sizeof(fs_filename) - 2); // '/' + NULL
+
+  FILINFO finfo;
+  FIL file;
+  int ret;
+
+  g_cancel_flag = false;
+
+  if (f_stat(fs_filename, &finfo) != FR_OK || offset > finfo.fsize) {
+    return -1;
+  }
+  if (f_open(&file, fs_filename, FA_READ) != FR_OK) {
+    return -1;
+  }
+
+  g_running = true;
+  ret = send_file(interface, &file, finfo.fsize, offset);
+  g_running = false;
+  f_close(&file);
+
+  if (ret < 0) {
+    // Tell the host to stop waiting
+    interface->putchar(YMODEM_CAN);
+    interface->putchar(YMODEM_CAN);
+    interface->flush();
+  }
+  return ret;
+}
+
+bool
+file_transfer_is_running(void)
+{
+  return g_running;
+}
@@ -0,0 +1,73 @@
+/*
+ * file_transfer.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Resumable file transfer for log offload.
+ *
+ * Sends one file over a ymodem_interface, starting at any byte offset, so an
+ * interrupted transfer continues where it stopped instead of starting over.
+ * Every frame carries a CRC32 and the last one carries the SHA-256 of the
+ * whole file, which the receiver checks against the bytes it stored.
+ *
+ * Device to host frames, all values little-endian:
+ *
+ *   'S' u32 size, u32 offset, u16 chunk_len, crc32   start
+ *   'D' u32 offset, u16 len, len bytes, crc32        data
+ *   'E' u32 size, sha256[32], crc32                  end
+ *
+ * The crc32 covers the frame from its type byte. Host to device:
+ *
+ *   'A' u32 offset     all bytes before offset were received
+ *   'N' u32 offset     resend from offset (bad or missing frame)
+ *   CAN CAN            abort
+ *
+ * The start frame is repeated until the host acks it with the start offset.
+ * Up to FILE_TRANSFER_WINDOW data frames are sent ahead of the last ack, and
+ * the transfer completes when the host acks the end frame with the size.
+ * scripts/file_transfer_client.py is the reference receiver.
+ */
+
+#ifndef FILE_TRANSFER_H
+#define FILE_TRANSFER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ymodem.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Frame types
+#define FILE_TRANSFER_START   ('S')
+#define FILE_TRANSFER_DATA    ('D')
+#define FILE_TRANSFER_END     ('E')
+#define FILE_TRANSFER_ACK     ('A')
+#define FILE_TRANSFER_NAK     ('N')
+
+// Data bytes per frame
+#define FILE_TRANSFER_CHUNK_SIZE (1024)
+// Data frames in flight before waiting for an ack
+#define FILE_TRANSFER_WINDOW     (4)
+// Time to wait for an ack, in ms
+#define FILE_TRANSFER_TIMEOUT    (5000)
+// Consecutive timeouts or resends before giving up
+#define FILE_TRANSFER_MAX_ERRORS (5)
+
+// Send filename starting at offset.
+// Returns 0 once the host acked the whole file, -1 otherwise.
+int file_transfer_send(const ymodem_interface* interface, const char *filename,
+  uint32_t offset);
+
+// Terminate an ongoing transfer. Like ymodem_end_session(), this takes
+// effect at the next frame or ack timeout.
+void file_transfer_end_session(void);
+bool file_transfer_is_running(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // FILE_TRANSFER_H
@@ -16,6 +16,7 @@
 
 #include "ff.h"
 #include "fatfs_utils.h"
+#include "fatfs_writer.h"
 
 #include "board_config.h"
 #include "command_helpers.h"
@@ -23,6 +24,7 @@
 #include "interpreter.h"
 #include "utils.h"
 #include "ymodem.h"
+#include "file_transfer.h"
 #include "syscalls.h"
 
 #include "../zmodem/zmodem_transfer.h"
@@ -586,6 +588,34 @@ fs_info_command(int argc, char *argv[])
   printf("Free bytes              %lu\n", fre_bytes);
 }
 
+void
+fs_sync_policy_command(int argc, char *argv[])
+{
+  CHK_ARGC(1, 3);
+
+  fatfs_sync_policy_t policy;
+  fatfs_writer_get_default_policy(&policy);
+  if (argc == 3) {
+    if (!parse_uint32_arg(argv[0], argv[1], &policy.sync_bytes) ||
+        !parse_uint32_arg(argv[0], argv[2], &policy.sync_ms)) {
+      return;
+    }
+    fatfs_writer_set_default_policy(&policy);
+    fatfs_writer_reset_stats();
+  }
+  else if (argc == 2) {
+    printf("usage: %s [<sync_bytes> <sync_ms>]\n", argv[0]);
+    return;
+  }
+
+  fatfs_writer_stats_t stats;
+  fatfs_writer_get_stats(&stats);
+  printf("sync every %lu bytes / %lu ms (0 = no limit)\n",
+      (unsigned long) policy.sync_bytes, (unsigned long) policy.sync_ms);
+  printf("writes: %lu, syncs: %lu, bytes: %lu\n", (unsigned long) stats.writes,
+      (unsigned long) stats.syncs, (unsigned long) stats.bytes);
+}
+
 void
 fs_ymodem_recv_command(int argc, char *argv[])
 {
@@ -642,6 +672,35 @@ fs_ymodem_send_command(int argc, char *argv[])
   }
 }
 
+void
+fs_send_command(int argc, char *argv[])
+{
+  // stop therapy
+  interpreter_event_stop_script(false);
+
+  CHK_ARGC(2, 3);
+
+  const char* name = argv[1];
+  uint32_t offset = 0;
+
+  // The receiver passes the size of its partial copy to resume
+  if (argc == 3 && !parse_uint32_arg(argv[0], argv[2], &offset)) {
+    return;
+  }
+
+  uint32_t saved_write_loc = syscalls_get_write_loc();
+  uint32_t saved_read_loc = syscalls_get_read_loc();
+
+  int ret = file_transfer_send(&uart_interface, name, offset);
+
+  syscalls_set_write_loc(saved_write_loc);
+  syscalls_set_read_loc(saved_read_loc);
+
+  if (ret < 0) {
+    printf("Error: file transfer failed!\n");
+  }
+}
+
 void
 fs_ymodem_recv_test_command(int argc, char *argv[])
 {
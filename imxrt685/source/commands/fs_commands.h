@@ -27,10 +27,12 @@ void fs_mkdir_command(int argc, char *argv[]);
 void fs_cp_command(int argc, char **argv);
 void fs_cat_command(int argc, char **argv);
 void fs_info_command(int argc, char **argv);
+void fs_sync_policy_command(int argc, char **argv);
 void fs_ymodem_recv_command(int argc, char **argv);
 void fs_ymodem_send_command(int argc, char **argv);
 void fs_ymodem_recv_test_command(int argc, char **argv);
 void fs_ymodem_send_test_command(int argc, char **argv);
+void fs_send_command(int argc, char **argv);
 
 void fs_zmodem_send_command(int argc, char *argv[]);
 void fs_zmodem_recv_command(int argc, char *argv[]);
@@ -1473,6 +1473,72 @@ nand_test_complete_command(int argc, char **argv)
   nand_test_internal(max_iterations, 0, mark_bad_block!=0);
 }
 
+// Read count pages with nand_read_pages() page by page and in Continuous
+// Read Mode, compare the data and time both.
+void
+nand_read_pages_command(int argc, char **argv)
+{
+  CHK_ARGC(3, 3);
+
+  uint32_t address;
+  if (!parse_uint32_arg_max(argv[0], argv[1], NAND_PAGE_ADDR_MAX, &address)) {
+    return;
+  }
+
+  uint32_t count;
+  if (!parse_uint32_arg_min_max(argv[0], argv[2], 1, NAND_READ_PAGES_MAX, &count)) {
+    return;
+  }
+
+  const int repeat = 32;
+  size_t size = count * NAND_PAGE_SIZE;
+  uint8_t* expected = malloc(size);
+  uint8_t* data = malloc(size);
+  if (expected == NULL || data == NULL) {
+    printf("Unable to allocate data buffers!\n");
+    goto nand_read_pages_exit;
+  }
+
+  bool sequential = nand_sequential_read_enabled();
+  int status = 0;
+  for (int pass = 0; pass < 2 && status >= 0; pass++) {
+    uint8_t* buf = (pass == 0) ? expected : data;
+    memset(buf, 0, size);
+    nand_sequential_read_enable(pass == 1);
+
+    TickType_t t0 = xTaskGetTickCount();
+    for (int i = 0; i < repeat && status >= 0; i++) {
+      status = nand_read_pages(&g_nand_handle, address, count, buf);
+    }
+    uint32_t delta_ms = portTICK_PERIOD_MS*(xTaskGetTickCount() - t0);
+
+    printf("%s: status %d, %lu KB in %lu ms\n",
+      (pass == 0) ? "Page by page" : "Continuous",
+      status, (repeat*size)/1024, delta_ms);
+  }
+  nand_sequential_read_enable(sequential);
+
+  if (status < 0) {
+    printf("Flash read pages error: %d\n", status);
+  }
+  else if (memcmp(expected, data, size) != 0) {
+    for (size_t i = 0; i < size; i++) {
+      if (expected[i] != data[i]) {
+        printf("Failed, data mismatch at page %u offset %u\n",
+          (unsigned)(i / NAND_PAGE_SIZE), (unsigned)(i % NAND_PAGE_SIZE));
+        break;
+      }
+    }
+  }
+  else {
+    printf("Success, data comparison passed.\n");
+  }
+
+nand_read_pages_exit:
+  free(expected);
+  free(data);
+}
+
 void
 nand_test_speed_command(int argc, char **argv)
 {
@@ -29,6 +29,7 @@ void nand_copy_pages_command(int argc, char **argv);
 void nand_unlock_command(int argc, char **argv);
 void nand_mux_select_command(int argc, char **argv);
 void nand_read_page_command(int argc, char **argv);
+void nand_read_pages_command(int argc, char **argv);
 void nand_write_page_command(int argc, char **argv);
 void nand_check_block_command(int argc, char **argv);
 void nand_check_blocks_command(int argc, char **argv);
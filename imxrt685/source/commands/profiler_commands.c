@@ -0,0 +1,19 @@
+/*
+ * profiler_commands.c
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ */
+
+#include <stdio.h>
+#include "profiler_commands.h"
+#include "profiler.h"
+
+void profile_dump_command(int argc, char **argv){
+  profiler_dump();
+}
+
+void profile_reset_command(int argc, char **argv){
+  profiler_reset();
+  printf("profiler stats cleared\n");
+}
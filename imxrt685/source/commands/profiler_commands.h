@@ -0,0 +1,22 @@
+/*
+ * profiler_commands.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ */
+
+#ifndef COMMANDS_PROFILER_COMMANDS_H_
+#define COMMANDS_PROFILER_COMMANDS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void profile_dump_command(int argc, char **argv);
+void profile_reset_command(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COMMANDS_PROFILER_COMMANDS_H_ */
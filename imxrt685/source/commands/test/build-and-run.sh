@@ -0,0 +1,33 @@
+set -x
+
+# file_transfer.c against a stdio FatFs, driven by the reference client
+gcc -O2 -I . -I .. -I ../../zmodem -I ../../sha256 \
+ ../file_transfer.c \
+ ../../zmodem/crctab.c \
+ ../../sha256/sha256.c \
+ ./file_transfer_test.c \
+ -o ft_sender || exit 1
+
+CLIENT="python3 ../../../scripts/file_transfer_client.py --exec ./ft_sender"
+
+# not a multiple of the chunk size
+head -c 300001 /dev/urandom > ft_log.bin
+
+# clean transfer
+$CLIENT --restart ft_log.bin ft_out.bin && cmp ft_log.bin ft_out.bin || exit 1
+
+# a corrupted frame is resent
+FT_CORRUPT_AT=50000 $CLIENT --restart ft_log.bin ft_out.bin && cmp ft_log.bin ft_out.bin || exit 1
+
+# a dropped link leaves a partial copy, the next run resumes from it
+FT_CUT_AT=120000 $CLIENT --restart ft_log.bin ft_out.bin && exit 1
+[ $(stat -c %s ft_out.bin) -lt 300001 ] || exit 1
+$CLIENT ft_log.bin ft_out.bin && cmp ft_log.bin ft_out.bin || exit 1
+
+# a damaged partial copy fails the hash check
+truncate -s 200000 ft_out.bin
+printf 'X' | dd of=ft_out.bin bs=1 seek=1000 conv=notrunc
+$CLIENT ft_log.bin ft_out.bin && exit 1
+
+# cleanup
+rm ./ft_sender ./ft_log.bin ./ft_out.bin
@@ -0,0 +1,81 @@
+/*
+ * ff.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host stand-in for the FatFs calls used by file_transfer.c,
+ * backed by stdio. Paths are relative to the working directory.
+ */
+
+#ifndef FF_H
+#define FF_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/stat.h>
+
+typedef unsigned int UINT;
+typedef uint32_t FSIZE_t;
+
+typedef enum {
+  FR_OK = 0,
+  FR_DISK_ERR,
+  FR_NO_FILE,
+} FRESULT;
+
+typedef struct {
+  FILE *fp;
+} FIL;
+
+typedef struct {
+  FSIZE_t fsize;
+} FILINFO;
+
+#define FA_READ 0x01
+
+static inline const char *
+host_path(const char *path)
+{
+  return (path[0] == '/') ? path + 1 : path;
+}
+
+static inline FRESULT
+f_stat(const char *path, FILINFO *fno)
+{
+  struct stat st;
+  if (stat(host_path(path), &st)) {
+    return FR_NO_FILE;
+  }
+  fno->fsize = st.st_size;
+  return FR_OK;
+}
+
+static inline FRESULT
+f_open(FIL *fp, const char *path, int mode)
+{
+  (void)mode;
+  fp->fp = fopen(host_path(path), "rb");
+  return fp->fp ? FR_OK : FR_NO_FILE;
+}
+
+static inline FRESULT
+f_read(FIL *fp, void *buff, UINT btr, UINT *br)
+{
+  *br = fread(buff, 1, btr, fp->fp);
+  return ferror(fp->fp) ? FR_DISK_ERR : FR_OK;
+}
+
+static inline FRESULT
+f_lseek(FIL *fp, FSIZE_t ofs)
+{
+  return fseek(fp->fp, ofs, SEEK_SET) ? FR_DISK_ERR : FR_OK;
+}
+
+static inline FRESULT
+f_close(FIL *fp)
+{
+  fclose(fp->fp);
+  return FR_OK;
+}
+
+#endif  // FF_H
@@ -0,0 +1,86 @@
+/*
+ * file_transfer_test.c
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Runs file_transfer_send() over stdin/stdout, so that
+ * scripts/file_transfer_client.py can receive from it like from the
+ * debug shell.
+ *
+ * Usage: file_transfer_test <filename> <offset>
+ *
+ * FT_CORRUPT_AT=n flips a bit in output byte n, and FT_CUT_AT=n exits
+ * after n output bytes, to simulate a noisy and a dropped link.
+ */
+
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "file_transfer.h"
+
+static long g_out_count = 0;
+static long g_corrupt_at = -1;
+static long g_cut_at = -1;
+
+static int
+host_getchar(int timeout_ms)
+{
+  struct pollfd pfd = { .fd = STDIN_FILENO, .events = POLLIN };
+  unsigned char c;
+
+  if (poll(&pfd, 1, timeout_ms) <= 0 || read(STDIN_FILENO, &c, 1) != 1) {
+    return -1;
+  }
+  return c;
+}
+
+static int
+host_putchar(int c)
+{
+  if (g_out_count == g_cut_at) {
+    fflush(stdout);
+    exit(2);
+  }
+  if (g_out_count == g_corrupt_at) {
+    c ^= 0x10;
+  }
+  g_out_count++;
+  return putchar(c);
+}
+
+static int
+host_flush(void)
+{
+  return fflush(stdout);
+}
+
+static const ymodem_interface host_interface = {
+  .getchar = host_getchar,
+  .putchar = host_putchar,
+  .putcharagg = host_putchar,
+  .flush = host_flush,
+};
+
+static long
+env_long(const char *name)
+{
+  const char *val = getenv(name);
+  return val ? atol(val) : -1;
+}
+
+int
+main(int argc, char **argv)
+{
+  if (argc != 3) {
+    fprintf(stderr, "usage: %s <filename> <offset>\n", argv[0]);
+    return 1;
+  }
+
+  g_corrupt_at = env_long("FT_CORRUPT_AT");
+  g_cut_at = env_long("FT_CUT_AT");
+
+  int ret = file_transfer_send(&host_interface, argv[1], strtoul(argv[2], NULL, 0));
+  return ret ? 1 : 0;
+}
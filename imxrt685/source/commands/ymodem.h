@@ -22,7 +22,7 @@
 #if !defined(_YMODEM_H)
 #define _YMODEM_H
 
-/* Comment this out if you don't plan to use extra CRC32 - removes ~1K */
+/* Uncomment to print the CRC32 of received files (uses the zmodem crc32tab) */
 //#define WITH_CRC32
 
 #define PACKET_SEQNO_INDEX      (1)
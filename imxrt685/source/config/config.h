@@ -122,6 +122,11 @@
 #define USE_NAND_GD5F4GQ6_2KPAGE (0U)
 #define USE_NAND_W25N04KW        (1U)
 
+// Read runs of consecutive NAND pages in the W25N04KW's Continuous Read Mode
+// instead of page by page. Check with nand_read_pages on the hardware before
+// enabling, a wrong dummy cycle count reads shifted data.
+#define ENABLE_NAND_SEQUENTIAL_READ (0U)
+
 // Config which amp to use
 #define USE_SSM2518 (0U)
 #define USE_SSM2529 (1U)
@@ -144,6 +149,17 @@
 // Note: In practice, with an FFT size of 128, it doesn't make a difference whether event or interrupt is used.
 #define ENABLE_POWERQUAD_INTERRUPT (0U)
 
+// Enable the phase-locked stimulus scheduler (eeg_reader/stim_scheduler.c).
+// 0U - pulses start on the first ECHT sample inside the target phase window
+// 1U - pulses start from a micro clock alarm at the predicted phase crossing
+// Keep eeg_reader/replay/shim/config.h in sync.
+#define ENABLE_STIM_SCHEDULER (0U)
+
+// Play stimulus pulses from a pre-rendered buffer spliced into the I2S DMA
+// buffer at the scheduled frame, instead of unmuting the pink noise graph.
+// Needs ENABLE_STIM_SCHEDULER.
+#define ENABLE_STIM_PLAYER (0U)
+
 // Enable NO COPY wav buffer
 #define ENABLE_NO_COPY_WAV_BUFFER (1U)
 
@@ -186,6 +202,10 @@
 // Enable memory unit tests
 #define ENABLE_STREAM_MEMORY_TEST_COMMANDS (0U)
 
+// Enable the DWT cycle counter stage profiler, see utils/profiler.h.
+// Results are printed with the "profile_dump" shell command.
+#define ENABLE_PROFILER (1U)
+
 // Compile the a FreeRTOS task to test for noise (i.e. periodic spi flash r/w).
 // 0U - do NOT include/compile
 // 1U - include/compile
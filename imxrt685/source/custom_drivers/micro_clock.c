@@ -21,6 +21,7 @@
 #define CTIMER            CTIMER0
 #define CTIMER_CLK_SRC    kSFRO_to_CTIMER0
 #define CTIMER_MATCH      kCTIMER_Match_0
+#define CTIMER_ALARM_MATCH kCTIMER_Match_1
 #define CTIMER_CLK_FREQ   (16000000U)
 #define CTIMER_IRQn       CTIMER0_IRQn
 #define CTIMER_INT_PRIO   MICRO_CLOCK_NVIC_PRIORITY // must be equal to or below min FreeRTOS priority.
@@ -29,15 +30,16 @@
 #if (CTIMER_CLK_FREQ < MICRO_CLOCK_TICK_FREQ)
 #error The clock frequency driving CTIMER0 must be equal to or greater than 1Mhz.
 #endif
+#define MICRO_CLOCK_TICKS_PER_US (CTIMER_CLK_FREQ / MICRO_CLOCK_TICK_FREQ)
 
 /*******************************************************************************
  * Prototypes
  ******************************************************************************/
 
-static void ctimer_overflow_callback(uint32_t flags);
+static void ctimer_callback(uint32_t flags);
 
 /* Array of function pointers for callback for each channel */
-ctimer_callback_t ctimer_callback_table[] = {ctimer_overflow_callback};
+ctimer_callback_t ctimer_callback_table[] = {ctimer_callback};
 
 /*******************************************************************************
  * Variables
@@ -48,13 +50,29 @@ static ctimer_match_config_t g_match_config;
 static ctimer_config_t g_ctimer_config;
 static uint64_t g_total_micros = 0;
 
+/* Match Configuration for Channel 1, one-shot alarm on the same counter */
+static ctimer_match_config_t g_alarm_config;
+static volatile micro_clock_alarm_cb_t g_alarm_cb = NULL;
+
 /*******************************************************************************
  * Code
  ******************************************************************************/
 
-static void ctimer_overflow_callback(uint32_t flags)
+static void ctimer_callback(uint32_t flags)
 {
-  g_total_micros += (((uint64_t)0xFFFFFFFF) * MICRO_CLOCK_TICK_FREQ) / CTIMER_CLK_FREQ;
+  if (flags & kCTIMER_Match0Flag) {
+    g_total_micros += (((uint64_t)0xFFFFFFFF) * MICRO_CLOCK_TICK_FREQ) / CTIMER_CLK_FREQ;
+  }
+
+  if (flags & kCTIMER_Match1Flag) {
+    // one-shot, the counter keeps running so stop the next match interrupting
+    CTIMER_DisableInterrupts(CTIMER, kCTIMER_Match1InterruptEnable);
+    micro_clock_alarm_cb_t cb = g_alarm_cb;
+    g_alarm_cb = NULL;
+    if (cb != NULL) {
+      cb();
+    }
+  }
 }
 
 
@@ -83,6 +101,14 @@ void init_micro_clock(void){
 
   CTIMER_SetupMatch(CTIMER, CTIMER_MATCH, &g_match_config);
 
+  /* Configuration 1 - alarm, match value and interrupt set when armed */
+  g_alarm_config.enableCounterReset = false;
+  g_alarm_config.enableCounterStop  = false;
+  g_alarm_config.matchValue         = 0;
+  g_alarm_config.outControl         = kCTIMER_Output_NoAction;
+  g_alarm_config.outPinInitState    = false;
+  g_alarm_config.enableInterrupt    = true;
+
   CTIMER_StartTimer(CTIMER);
 }
 
@@ -106,4 +132,28 @@ uint64_t millis(void){
 }
 
 
+bool micro_clock_alarm_arm(uint32_t delay_us, micro_clock_alarm_cb_t cb){
+  if (delay_us < MICRO_CLOCK_ALARM_MIN_US || delay_us > MICRO_CLOCK_ALARM_MAX_US) {
+    return false;
+  }
+
+  NVIC_DisableIRQ(CTIMER_IRQn);
+  g_alarm_cb = cb;
+  g_alarm_config.matchValue = CTIMER_GetTimerCountValue(CTIMER) + delay_us * MICRO_CLOCK_TICKS_PER_US;
+  // also clears a stale match flag and re-enables the IRQ
+  CTIMER_SetupMatch(CTIMER, CTIMER_ALARM_MATCH, &g_alarm_config);
+  NVIC_EnableIRQ(CTIMER_IRQn);
+  return true;
+}
+
+
+void micro_clock_alarm_cancel(void){
+  NVIC_DisableIRQ(CTIMER_IRQn);
+  CTIMER_DisableInterrupts(CTIMER, kCTIMER_Match1InterruptEnable);
+  CTIMER_ClearStatusFlags(CTIMER, kCTIMER_Match1Flag);
+  g_alarm_cb = NULL;
+  NVIC_EnableIRQ(CTIMER_IRQn);
+}
+
+
 
@@ -9,11 +9,20 @@
 #define CUSTOM_DRIVERS_MICRO_CLOCK_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// Shortest alarm that can be armed without racing the counter past the match.
+#define MICRO_CLOCK_ALARM_MIN_US (10U)
+// Longest alarm, well inside one wrap of the 32 bit counter.
+#define MICRO_CLOCK_ALARM_MAX_US (1000000U)
+
+// Called from the timer interrupt (MICRO_CLOCK_NVIC_PRIORITY).
+typedef void (*micro_clock_alarm_cb_t)(void);
+
 void init_micro_clock(void);
 
 void deinit_micro_clock(void);
@@ -22,6 +31,12 @@ uint64_t micros(void);
 
 uint64_t millis(void);
 
+// One-shot callback delay_us from now, replacing any pending alarm. Returns
+// false, without arming, if delay_us is outside MICRO_CLOCK_ALARM_MIN_US..MAX_US.
+bool micro_clock_alarm_arm(uint32_t delay_us, micro_clock_alarm_cb_t cb);
+
+void micro_clock_alarm_cancel(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -18,6 +18,7 @@
 
 #include "nand_W25N04KW.h"
 #include "nand_platform.h"
+#include "nand_wait.h"
 
 // Set the log level for this file
 #define LOG_LEVEL_MODULE  LOG_WARN
@@ -40,6 +41,13 @@ static const char* TAG = "nand";
  */
 DMA_ALLOCATE_DATA_TRANSFER_BUFFER(static uint32_t nand_read_buff[(NAND_PAGE_PLUS_SPARE_SIZE >> 2)], sizeof(uint32_t)) = {0};
 
+// Whether nand_read_pages() uses Continuous Read Mode.
+#if (defined(ENABLE_NAND_SEQUENTIAL_READ) && (ENABLE_NAND_SEQUENTIAL_READ > 0U))
+static bool g_sequential_read = true;
+#else
+static bool g_sequential_read = false;
+#endif
+
 /* RESET_NOW - reset NAND immediately.
  * ENABLE_RESET and ACTIVATE RESET are used together.
  * ENABLE_RESET first, followed by ACTIVATE_RESET.*/
@@ -59,10 +67,11 @@ DMA_ALLOCATE_DATA_TRANSFER_BUFFER(static uint32_t nand_read_buff[(NAND_PAGE_PLUS
 #define NAND_CMD_LUT_SEQ_IDX_FAST_READ_QUADIO 13
 #define NAND_CMD_LUT_SEQ_IDX_POWER_DOWN       14
 #define NAND_CMD_LUT_SEQ_IDX_POWER_UP         15
+#define NAND_CMD_LUT_SEQ_IDX_CONTINUOUS_READ  16
 
 
 /* LUT for the W25N04KW NAND Flash*/
-#define NAND_FLEXSPI_LUT_LENGTH 64
+#define NAND_FLEXSPI_LUT_LENGTH 68
 
 const uint32_t NAND_FLEXSPI_LUT[NAND_FLEXSPI_LUT_LENGTH] = {
     /* Device Reset (FFh) */
@@ -147,6 +156,13 @@ const uint32_t NAND_FLEXSPI_LUT[NAND_FLEXSPI_LUT_LENGTH] = {
 	[4 * NAND_CMD_LUT_SEQ_IDX_POWER_UP] =
 	FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0xAB, kFLEXSPI_Command_STOP, kFLEXSPI_1PAD, 0),
 
+	/* Fast Read Quad Output (6Bh), Continuous Read Mode (BUF=0): no column
+	   address, 4 dummy bytes, then pages stream out until CS goes high. */
+	[4 * NAND_CMD_LUT_SEQ_IDX_CONTINUOUS_READ] =
+	FLEXSPI_LUT_SEQ(kFLEXSPI_Command_SDR, kFLEXSPI_1PAD, 0x6B, kFLEXSPI_Command_DUMMY_SDR, kFLEXSPI_4PAD, 0x20), //32
+	[4 * NAND_CMD_LUT_SEQ_IDX_CONTINUOUS_READ + 1] =
+	FLEXSPI_LUT_SEQ(kFLEXSPI_Command_READ_SDR, kFLEXSPI_4PAD, 0x00, kFLEXSPI_Command_STOP, kFLEXSPI_1PAD, 0),
+
 };
 
 /** Convert 24-bit page address (in a uint32_t) to 3-byte MSB-first array.
@@ -348,7 +364,7 @@ nand_init(){
   int status = 0;
 
   // Update LUT
-  FLEXSPI_UpdateLUT(FLEXSPI, 0, NAND_FLEXSPI_LUT, 64);
+  FLEXSPI_UpdateLUT(FLEXSPI, 0, NAND_FLEXSPI_LUT, NAND_FLEXSPI_LUT_LENGTH);
 
   FLEXSPI_SoftwareReset(FLEXSPI);
 
@@ -543,6 +559,41 @@ nand_get_status_reg(
   return status;
 }
 
+typedef struct {
+  nand_user_data_t *user_data;
+  nand_status_reg_t status_reg;
+} nand_wait_ctx_t;
+
+static int
+nand_poll_busy(void *ctx, bool *busy)
+{
+  nand_wait_ctx_t *wait = (nand_wait_ctx_t *)ctx;
+
+  // Check OIP (Operation In Progress) bit
+  int status = nand_get_status_reg(wait->user_data, &wait->status_reg);
+  if (status != kStatus_Success) {
+    return (status < 0) ? status : NAND_IO_ERR;
+  }
+  *busy = wait->status_reg.busy;
+  return NAND_NO_ERR;
+}
+
+/** Wait for the operation in progress, sleeping for most of it. */
+static int
+nand_wait_not_busy(
+  nand_user_data_t *user_data,
+  uint32_t typ_us,
+  uint32_t max_us,
+  nand_status_reg_t *status_reg
+  )
+{
+  nand_wait_ctx_t wait = { .user_data = user_data };
+
+  int status = nand_wait_ready(typ_us, max_us, nand_poll_busy, &wait);
+  *status_reg = wait.status_reg;
+  return status;
+}
+
 /** Unlock flash. */
 int
 nand_unlock(nand_user_data_t *user_data)
@@ -645,6 +696,160 @@ nand_read_page(
   return status;
 }
 
+/** Set the BUF bit: 1 is Buffer Read Mode (one page, read from a column
+    address), 0 is Continuous Read Mode. */
+static int
+nand_set_buffer_mode(nand_user_data_t *user_data, bool buf)
+{
+  nand_configuration_reg_t configuration_reg;
+  int status = nand_get_feature_reg(user_data,
+      FEATURE_REG_CONFIGURATION, &configuration_reg.raw);
+  if (status != 0 || configuration_reg.buf == buf) {
+    return status;
+  }
+
+  configuration_reg.buf = buf;
+  return nand_set_feature_reg(user_data,
+      FEATURE_REG_CONFIGURATION, configuration_reg.raw);
+}
+
+/** Read count pages in Continuous Read Mode.
+
+    After the Page Data Read of the first page the chip keeps reading the
+    next page into its buffer while the current one is clocked out, so the
+    array reads of all but the first page overlap the transfer. Only the
+    main area of each page is output.
+ */
+static int
+nand_continuous_read(
+  nand_user_data_t *user_data,
+  uint32_t page_addr,
+  uint32_t count,
+  uint8_t* p_data
+  )
+{
+  int status;
+  int restore_status;
+  int ecc_status;
+  nand_status_reg_t status_reg;
+  flexspi_transfer_t flashXfer;
+
+  status = nand_set_buffer_mode(user_data, false);
+  if (status != 0) {
+    LOGE(TAG, "nand_continuous_read(0x%lx): BUF=0 error: %d", page_addr, status);
+    status = NAND_IO_ERR;
+    goto nand_continuous_read_exit;
+  }
+
+  ecc_status = nand_read_page_into_cache(user_data, page_addr);
+  if (ecc_status < 0 && ecc_status != NAND_ECC_FAIL) {
+    LOGE(TAG, "nand_continuous_read(0x%lx): nand_read_page_into_cache: %d", page_addr, ecc_status);
+    status = ecc_status;
+    goto nand_continuous_read_exit;
+  }
+
+  flashXfer.deviceAddress = 0;
+  flashXfer.port = kFLEXSPI_PortA1;
+  flashXfer.cmdType = kFLEXSPI_Read;
+  flashXfer.SeqNumber = 1;
+  flashXfer.seqIndex = NAND_CMD_LUT_SEQ_IDX_CONTINUOUS_READ;
+  flashXfer.data = (uint32_t*) p_data;
+  flashXfer.dataSize = count * NAND_PAGE_SIZE;
+
+  status = FLEXSPI_TransferBlocking(NAND_FLEXSPI_PERIPHERAL, &flashXfer);
+  if (status != kStatus_Success) {
+    LOGE(TAG, "nand_continuous_read(0x%lx, %lu): transfer error: %d", page_addr, count, status);
+    status = NAND_IO_ERR;
+    goto nand_continuous_read_exit;
+  }
+
+  // Raising CS ends the read, the chip may still be finishing the page
+  // after the last one. The ECC bits then hold the worst result of all the
+  // pages read.
+  status = nand_wait_not_busy(user_data, NAND_READ_TYP_US, NAND_READ_MAX_US, &status_reg);
+  if (status < 0) {
+    LOGE(TAG, "nand_continuous_read(0x%lx): nand_wait_not_busy() error: %d", page_addr, status);
+    goto nand_continuous_read_exit;
+  }
+
+  status = nand_ecc_result(status_reg);
+  if (ecc_status == NAND_ECC_FAIL || status == NAND_ECC_FAIL) {
+    status = NAND_ECC_FAIL;
+  } else if (ecc_status == NAND_ECC_OK) {
+    status = NAND_ECC_OK;
+  }
+
+nand_continuous_read_exit:
+  // Every other read depends on Buffer Read Mode.
+  restore_status = nand_set_buffer_mode(user_data, true);
+  if (restore_status != 0) {
+    LOGE(TAG, "nand_continuous_read(0x%lx): BUF=1 error: %d", page_addr, restore_status);
+    if (status >= 0) {
+      status = NAND_IO_ERR;
+    }
+  }
+  return status;
+}
+
+void
+nand_sequential_read_enable(bool enable)
+{
+  g_sequential_read = enable;
+}
+
+bool
+nand_sequential_read_enabled(void)
+{
+  return g_sequential_read;
+}
+
+/** Read consecutive flash pages. */
+int
+nand_read_pages(
+  nand_user_data_t *user_data,
+  uint32_t page_addr,
+  uint32_t count,
+  uint8_t* p_data
+  )
+{
+  int result = NAND_NO_ERR;
+  uint32_t page_mask = (1 << user_data->chipinfo->block_addr_offset) - 1;
+
+  LOGV(TAG, "nand_read_pages: pg_addr 0x%lX, count %lu, p_data %p", page_addr, count, p_data);
+
+  while (count > 0) {
+    int status;
+    uint32_t n;
+
+    if (g_sequential_read) {
+      // One transfer never leaves the block
+      n = (page_mask + 1) - (page_addr & page_mask);
+      n = (count < n) ? count : n;
+      n = (NAND_READ_PAGES_MAX < n) ? NAND_READ_PAGES_MAX : n;
+      status = nand_continuous_read(user_data, page_addr, n, p_data);
+    } else {
+      n = 1;
+      status = nand_read_page(user_data,
+        page_addr >> user_data->chipinfo->block_addr_offset, page_addr & page_mask,
+        0, p_data, NAND_PAGE_SIZE);
+    }
+
+    if (status == NAND_ECC_FAIL) {
+      result = NAND_ECC_FAIL;
+    } else if (status < 0) {
+      return status;
+    } else if (status == NAND_ECC_OK && result == NAND_NO_ERR) {
+      result = NAND_ECC_OK;
+    }
+
+    page_addr += n;
+    count -= n;
+    p_data += n * NAND_PAGE_SIZE;
+  }
+
+  return result;
+}
+
 /** Write flash page. */
 int
 nand_write_page(
@@ -833,19 +1038,9 @@ nand_read_page_into_cache(
   }
 
   // Wait for internal cache read to complete
-  while(true) {
-    // Check OIP (Operation In Progress) bit
-    status = nand_get_status_reg(user_data, &status_reg);
-    if(status == kStatus_Success){
-      if(status_reg.busy == 0){
-        break;
-      }
-    }
-    // We are still waiting for the flash chip to be ready.
-    nand_platform_yield_delay(0);   // 0 means just yield; this should take <1 ms (80 usecs)
-  };
+  status = nand_wait_not_busy(user_data, NAND_READ_TYP_US, NAND_READ_MAX_US, &status_reg);
   if (status < 0) {
-    LOGE(TAG, "nand_read_page_into_cache(): _is_device_ready() error: %d", status);
+    LOGE(TAG, "nand_read_page_into_cache(): nand_wait_not_busy() error: %d", status);
     return status;
   }
 
@@ -924,20 +1119,9 @@ int nand_program_page_cache(
   }
 
   // Wait for program execution to complete
-  while(true) {
-    // Check OIP (Operation In Progress) bit
-    status = nand_get_status_reg(user_data, &status_reg);
-    if(status == kStatus_Success){
-      if(status_reg.busy == 0){
-        break;
-      }
-    }
-    // TODO: Handle other bad status
-    // We are still waiting for the flash chip to be ready.
-    nand_platform_yield_delay(0);   // 0 means just yield; this should take <1 ms (80 usecs)
-  };
+  status = nand_wait_not_busy(user_data, NAND_PROGRAM_TYP_US, NAND_PROGRAM_MAX_US, &status_reg);
   if (status < 0) {
-    LOGE(TAG, "nand_write_page(): _is_device_ready() error: %d", status);
+    LOGE(TAG, "nand_program_page_cache(): nand_wait_not_busy() error: %d", status);
     return status;
   }
 
@@ -1051,23 +1235,11 @@ nand_erase_block(
     return status;
   }
 
-  /* Wait for erase block to complete (could take up to 5 ms--wait in
+  /* Wait for erase block to complete (could take up to 10 ms--sleep in
      between checks). */
-
-  // "Typical: 3 ms, max: 5 ms". Minimize SPI bus traffic by sleeping the first 2 ms.
-  nand_platform_yield_delay(2);
-
-  do {
-    // Check OIP (Operation In Progress) bit
-    status = nand_get_status_reg(user_data, &status_reg);
-    if (status == NAND_NO_ERR && status_reg.busy == 1) {
-      // We are still waiting for the flash chip to be ready.
-      nand_platform_yield_delay(1);
-    }
-  } while (status == NAND_NO_ERR && status_reg.busy == 1);
-
+  status = nand_wait_not_busy(user_data, NAND_ERASE_TYP_US, NAND_ERASE_MAX_US, &status_reg);
   if (status < 0) {
-    LOGE(TAG, "nand_erase_block(): _get_status_reg() error: %d", status);
+    LOGE(TAG, "nand_erase_block(): nand_wait_not_busy() error: %d", status);
     return status;
   }
 
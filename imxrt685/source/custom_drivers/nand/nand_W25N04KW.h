@@ -92,8 +92,12 @@ typedef struct nand_user_data {
 #define NAND_ECC_FAIL		-2		//!< ECC failed
 #define NAND_BAD_BLK		-3		//!< bad block
 #define NAND_CRC_ERR		-4		//!< CRC failed
+#define NAND_TIMEOUT_ERR	-5		//!< still busy long after the datasheet maximum
 #define NAND_UNKNOWN_ERR	-100	//!< unkown error?
 
+// Pages per nand_read_pages() transfer, FlexSPI IP transfers are < 64 KB.
+#define NAND_READ_PAGES_MAX 16
+
 // Feature registers
 typedef enum {
   FEATURE_REG_PROTECTION = 0xA0,
@@ -259,6 +263,42 @@ nand_read_page(
   uint16_t data_len
   );
 
+/** Read consecutive flash pages, main area only.
+
+    With sequential reads enabled (ENABLE_NAND_SEQUENTIAL_READ) the pages
+    are streamed in Continuous Read Mode, up to NAND_READ_PAGES_MAX and one
+    block per transfer, so the chip reads each page from the array while
+    the previous one is transferred. Otherwise the pages are read one by
+    one.
+
+    The result covers all the pages: if any of them had corrected or
+    uncorrectable bit errors the caller has to read them one by one to find
+    out which.
+
+    @param user_data Platform/user data handle
+    @param page_addr 24-bit page address of the first page
+    @param count Number of pages
+    @param[out] p_data Data buffer, count * NAND_PAGE_SIZE bytes
+
+    @return NAND_NO_ERR, NAND_ECC_OK, NAND_ECC_FAIL or other error (<0)
+*/
+int
+nand_read_pages(
+  nand_user_data_t *user_data,
+  uint32_t page_addr,
+  uint32_t count,
+  uint8_t* p_data
+  );
+
+/** Switch nand_read_pages() between Continuous Read Mode and page by page
+    reads, for testing. Defaults to ENABLE_NAND_SEQUENTIAL_READ.
+*/
+void
+nand_sequential_read_enable(bool enable);
+
+bool
+nand_sequential_read_enabled(void);
+
 /** Write flash page.
 
     Note that (page_offset + data_len) must be less than
@@ -59,4 +59,12 @@
 /** Number of bit errors that can be corrected by this NAND chip */
 #define NAND_ECC_MAX_CORRECTED_BIT_COUNT 7
 
+/** Operation times from the datasheet, typical and maximum (us). */
+#define NAND_READ_TYP_US    25     // tRD, page to cache, ECC on
+#define NAND_READ_MAX_US    60
+#define NAND_PROGRAM_TYP_US 250    // tPP
+#define NAND_PROGRAM_MAX_US 700
+#define NAND_ERASE_TYP_US   2000   // tBE
+#define NAND_ERASE_MAX_US   10000
+
 #endif  // NAND_GD5F4GQ6_H
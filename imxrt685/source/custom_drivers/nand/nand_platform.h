@@ -20,6 +20,9 @@ extern "C" {
 // Delay for delay_ms (delay_ms may be zero for a simple thread yield).
 void nand_platform_yield_delay(int delay_ms);
 
+// Shortest nand_platform_wait_us() (nand_wait.h) that sleeps instead of spinning.
+#define NAND_PLATFORM_SLEEP_MIN_US (1000U)
+
 // Return 0 if command and response completed succesfully, or <0 error code
 int nand_platform_command_response(
   uint8_t* p_command,
@@ -7,6 +7,7 @@
 
 #include "nand.h"
 #include "nand_platform.h"
+#include "nand_wait.h"
 #include "util_delay.h"
 
 // HAL
@@ -15,6 +16,7 @@
 
 // FreeRTOS
 #include "FreeRTOS.h"
+#include "task.h"
 
 // Create a reference struct to use for the chipnfo.
 // This is externed via nand.h, but could also be returned by a getter().
@@ -238,6 +240,19 @@ void nand_platform_yield_delay(int delay_ms) {
 	util_delay_ms(delay_ms);
 }
 
+// Waits of a millisecond or more sleep, for at least one tick, so the other
+// tasks run during an erase; the 5 ms tick is too coarse for anything
+// shorter, which spins. Spin before the scheduler starts (dhara_pretask_init).
+void nand_platform_wait_us(uint32_t us) {
+	if (us >= NAND_PLATFORM_SLEEP_MIN_US && xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+		TickType_t ticks = pdMS_TO_TICKS(us / 1000);
+		vTaskDelay((ticks > 0) ? ticks : 1);
+	}
+	else {
+		SDK_DelayAtLeastUs(us, SystemCoreClock);
+	}
+}
+
 
 // Return 0 if command and response completed succesfully, or <0 error code
 int nand_platform_command_response(
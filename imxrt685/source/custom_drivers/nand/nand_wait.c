@@ -0,0 +1,67 @@
+/*
+ * nand_wait.c
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Wait for a NAND operation to complete, see nand_wait.h.
+ */
+
+#include <string.h>
+
+#include "nand_wait.h"
+
+// Only the task holding the filesystem lock talks to the chip.
+static nand_wait_stats_t g_stats;
+
+int
+nand_wait_ready(uint32_t typ_us, uint32_t max_us, nand_wait_poll_t poll, void* ctx)
+{
+  uint32_t waited_us = typ_us;
+  uint32_t step_us = typ_us / 4;
+  if (step_us < NAND_WAIT_MIN_POLL_US) {
+    step_us = NAND_WAIT_MIN_POLL_US;
+  }
+
+  g_stats.waits++;
+  nand_platform_wait_us(typ_us);
+
+  while (true) {
+    bool busy = true;
+    int status = poll(ctx, &busy);
+    g_stats.polls++;
+    if (status < 0) {
+      return status;
+    }
+    if (!busy) {
+      break;
+    }
+    if (waited_us >= NAND_WAIT_TIMEOUT_FACTOR * max_us) {
+      g_stats.timeouts++;
+      return NAND_WAIT_TIMEOUT_ERR;
+    }
+
+    nand_platform_wait_us(step_us);
+    waited_us += step_us;
+    step_us *= 2;
+    if (step_us > NAND_WAIT_MAX_POLL_US) {
+      step_us = NAND_WAIT_MAX_POLL_US;
+    }
+  }
+
+  if (waited_us > g_stats.max_wait_us) {
+    g_stats.max_wait_us = waited_us;
+  }
+  return 0;
+}
+
+void
+nand_wait_get_stats(nand_wait_stats_t* stats)
+{
+  *stats = g_stats;
+}
+
+void
+nand_wait_reset_stats(void)
+{
+  memset(&g_stats, 0, sizeof(g_stats));
+}
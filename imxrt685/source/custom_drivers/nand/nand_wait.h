@@ -0,0 +1,60 @@
+/*
+ * nand_wait.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Wait for a NAND operation (page read, program, block erase)
+ * to complete.
+ *
+ * The chip has no ready interrupt, only the OIP (busy) bit of the status
+ * register. Instead of reading it back to back over SPI, the wait first
+ * sleeps for the typical time of the operation from the datasheet, then
+ * polls with an exponential backoff, and gives up at NAND_WAIT_TIMEOUT_FACTOR
+ * times the maximum time. Waits long enough to sleep on let the EEG and
+ * audio tasks run meanwhile, see nand_platform_wait_us().
+ *
+ * No RTOS or SDK dependencies, so test/ can run it against a fake chip.
+ */
+#ifndef NAND_WAIT_H
+#define NAND_WAIT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Same value as NAND_TIMEOUT_ERR.
+#define NAND_WAIT_TIMEOUT_ERR (-5)
+
+#define NAND_WAIT_TIMEOUT_FACTOR (4U)
+#define NAND_WAIT_MIN_POLL_US    (10U)
+#define NAND_WAIT_MAX_POLL_US    (1000U)
+
+// Read the busy bit, <0 on a bus error.
+typedef int (*nand_wait_poll_t)(void* ctx, bool* busy);
+
+typedef struct
+{
+  uint32_t waits;
+  uint32_t polls;
+  uint32_t timeouts;
+  uint32_t max_wait_us;  // nominal, from the sleeps requested
+} nand_wait_stats_t;
+
+// 0 once the chip is ready, the poll's error, or NAND_WAIT_TIMEOUT_ERR.
+int nand_wait_ready(uint32_t typ_us, uint32_t max_us, nand_wait_poll_t poll, void* ctx);
+
+void nand_wait_get_stats(nand_wait_stats_t* stats);
+void nand_wait_reset_stats(void);
+
+// Implemented by the platform: sleep if us is long enough for the
+// scheduler, otherwise spin without using the SPI bus.
+void nand_platform_wait_us(uint32_t us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // NAND_WAIT_H
@@ -0,0 +1,10 @@
+set -x
+
+# nand_wait_ready() against a fake chip with datasheet latencies
+gcc -I .. \
+ ../nand_wait.c \
+ ./nand_wait_test.c \
+ && ./a.out || exit 1
+
+# cleanup
+rm ./a.out
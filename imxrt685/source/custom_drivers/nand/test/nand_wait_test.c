@@ -0,0 +1,146 @@
+/*
+ * nand_wait_test.c
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host test of nand_wait_ready() against a fake chip that is
+ * busy for a given time after each operation. The fake clock models the
+ * 5 ms FreeRTOS tick: platform waits of NAND_PLATFORM_SLEEP_MIN_US or more
+ * sleep until a tick boundary, shorter ones spin, and every status read
+ * costs SPI bus time.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "nand_wait.h"
+#include "nand_W25N04KW_config.h"
+
+#define TICK_US      (5000U)
+#define SLEEP_MIN_US (1000U)  // NAND_PLATFORM_SLEEP_MIN_US
+#define POLL_BUS_US  (4U)     // 1 B status read at the SPI clock
+
+typedef struct {
+  uint32_t now_us;
+  uint32_t slept_us;  // other tasks ran
+  uint32_t spun_us;   // CPU busy waiting
+  uint32_t bus_us;    // SPI bus used for polls
+} fake_clock_t;
+
+static fake_clock_t g_clock;
+
+typedef struct {
+  uint32_t ready_us;  // absolute, UINT32_MAX never
+  int error;
+} fake_chip_t;
+
+void
+nand_platform_wait_us(uint32_t us)
+{
+  if (us >= SLEEP_MIN_US) {
+    // vTaskDelay(n) wakes on the n-th tick from now
+    uint32_t ticks = (us / 1000) * 1000 / TICK_US;
+    if (ticks == 0) {
+      ticks = 1;
+    }
+    uint32_t wake_us = (g_clock.now_us / TICK_US + ticks) * TICK_US;
+    g_clock.slept_us += wake_us - g_clock.now_us;
+    g_clock.now_us = wake_us;
+  }
+  else {
+    g_clock.spun_us += us;
+    g_clock.now_us += us;
+  }
+}
+
+static int
+fake_poll(void* ctx, bool* busy)
+{
+  fake_chip_t* chip = (fake_chip_t*) ctx;
+  g_clock.now_us += POLL_BUS_US;
+  g_clock.bus_us += POLL_BUS_US;
+  if (chip->error < 0) {
+    return chip->error;
+  }
+  *busy = g_clock.now_us < chip->ready_us;
+  return 0;
+}
+
+// Start an operation taking latency_us at start_us, wait for it.
+static int
+run(uint32_t start_us, uint32_t latency_us, uint32_t typ_us, uint32_t max_us,
+    nand_wait_stats_t* stats)
+{
+  memset(&g_clock, 0, sizeof(g_clock));
+  g_clock.now_us = start_us;
+  fake_chip_t chip = { .ready_us = start_us + latency_us, .error = 0 };
+  if (latency_us == UINT32_MAX) {
+    chip.ready_us = UINT32_MAX;
+  }
+
+  nand_wait_reset_stats();
+  int status = nand_wait_ready(typ_us, max_us, fake_poll, &chip);
+  nand_wait_get_stats(stats);
+  return status;
+}
+
+static void
+check_op(const char* name, uint32_t typ_us, uint32_t max_us,
+    uint32_t max_polls, uint32_t max_late_us)
+{
+  // from much faster than typical to the maximum, and at different
+  // phases of the tick
+  for (uint32_t latency = typ_us / 2; latency <= max_us; latency += typ_us / 4) {
+    for (uint32_t phase = 0; phase < TICK_US; phase += 1250) {
+      nand_wait_stats_t stats;
+      int status = run(phase, latency, typ_us, max_us, &stats);
+      uint32_t late_us = g_clock.now_us - phase - latency;
+
+      assert(status == 0);
+      assert(g_clock.now_us >= phase + latency);
+      if (latency <= typ_us) {
+        assert(stats.polls <= max_polls);
+      }
+      assert(late_us <= max_late_us);
+    }
+  }
+
+  // a typical operation, compared with back to back status reads
+  nand_wait_stats_t stats;
+  run(0, typ_us, typ_us, max_us, &stats);
+  printf("%-8s typ %5u us: %u polls, %5u us bus, %5u us spun, %5u us slept"
+      " (back to back: %u polls)\n", name, typ_us, stats.polls, g_clock.bus_us,
+      g_clock.spun_us, g_clock.slept_us, typ_us / POLL_BUS_US);
+}
+
+int main(void)
+{
+  nand_wait_stats_t stats;
+
+  // reads and programs are shorter than a tick and spin, but poll a
+  // handful of times instead of continuously
+  check_op("read", NAND_READ_TYP_US, NAND_READ_MAX_US, 1, NAND_READ_MAX_US);
+  check_op("program", NAND_PROGRAM_TYP_US, NAND_PROGRAM_MAX_US, 1, NAND_PROGRAM_MAX_US);
+
+  // erases sleep, the task gives up the CPU for most of the erase; a sleep
+  // that starts late in a tick wakes early and polls a couple more times
+  check_op("erase", NAND_ERASE_TYP_US, NAND_ERASE_MAX_US, 3, TICK_US + NAND_WAIT_MAX_POLL_US);
+  run(0, NAND_ERASE_TYP_US, NAND_ERASE_TYP_US, NAND_ERASE_MAX_US, &stats);
+  assert(g_clock.slept_us >= NAND_ERASE_TYP_US);
+  assert(g_clock.spun_us == 0);
+
+  // a chip that never gets ready times out
+  assert(run(0, UINT32_MAX, NAND_PROGRAM_TYP_US, NAND_PROGRAM_MAX_US, &stats) == NAND_WAIT_TIMEOUT_ERR);
+  assert(stats.timeouts == 1);
+  assert(g_clock.now_us >= NAND_WAIT_TIMEOUT_FACTOR * NAND_PROGRAM_MAX_US);
+  assert(g_clock.now_us <= NAND_WAIT_TIMEOUT_FACTOR * NAND_PROGRAM_MAX_US + 2 * TICK_US);
+
+  // a bus error is returned as is
+  memset(&g_clock, 0, sizeof(g_clock));
+  fake_chip_t broken = { .ready_us = 0, .error = -1 };
+  assert(nand_wait_ready(NAND_READ_TYP_US, NAND_READ_MAX_US, fake_poll, &broken) == -1);
+
+  printf("nand_wait_test passed\n");
+  return 0;
+}
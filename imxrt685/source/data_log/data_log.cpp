@@ -47,6 +47,7 @@ extern "C" {
 #endif
 
 #include "heatshrink_encoder.h"
+#include "profiler.h"
 #include "compression.h"
 
 #ifdef __cplusplus
@@ -360,7 +361,7 @@ static bool open_data_log(){
 
 }
 
-void user_metrics_log_open(FIL *file)
+bool user_metrics_log_open(FIL *file, uint32_t *log_uid)
 {
   char log_fnum_buf[15];
   size_t datalog_uid = 0;
@@ -389,10 +390,7 @@ void user_metrics_log_open(FIL *file)
 
     log_fsize = str_append2(log_fname, log_fsize, "usermetrics_");    // log file name
     log_fsize = str_append2(log_fname, log_fsize, log_fnum_buf);      // log file number
-    log_fsize = str_append2(log_fname, log_fsize, ".json");            // log file suffix
-
-    // close the previous log file
-    f_close(file);
+    log_fsize = str_append2(log_fname, log_fsize, ".bin");            // log file suffix, see user_metrics_record.h
 
     // ensure the folder exists
     f_mkdir(USER_METRICS_DIR_PATH);
@@ -400,18 +398,12 @@ void user_metrics_log_open(FIL *file)
     FRESULT result = f_open(file, log_fname, FA_CREATE_NEW | FA_WRITE);
     if(result){
         LOGE(TAG, "f_open() for %s returned %u\n", log_fname, result);
-        break;
+        return false;
     }
     else{
-      // // create csv header
-      // f_printf(file, "Timestamp, Hypnogram, Bpm, Activity\n");
-      // f_sync(file);
-
-      // create json header
-      int version = 0;
-      f_printf(file, "{\"log_uuid\": %d,\"version\":%d,\"user_metrics\": [\n", datalog_uid, version);
-  	  f_sync(file);
-      break;
+      // the caller writes the header record
+      *log_uid = datalog_uid;
+      return true;
     }
   }
 }
@@ -517,13 +509,17 @@ void data_log_compress_abort() {
  * Called to write general data to the data log
  */
 void data_log_write(const uint8_t *scratch, uint32_t scratch_size){
+  PROFILER_SCOPE(DATA_LOG_WRITE);
+
   // encode into COBS
+  PROFILER_BEGIN(DATA_LOG_COBS);
 #if (defined(CONFIG_DATALOG_USE_COBSR_RLE0) && (CONFIG_DATALOG_USE_COBSR_RLE0 > 0U))
   cobsr_encode_result result = cobsr_rle0_encode(&(g_data_log_context.dst_scratch[0]), DST_SCRATCH_BUFFER_SIZE, scratch, scratch_size);
   size_t dst_size = result.out_len;
 #else
   size_t dst_size = COBS::encode(scratch, scratch_size, &(g_data_log_context.dst_scratch[0]));
 #endif
+  PROFILER_END(DATA_LOG_COBS);
 
 //  LOGV(TAG,"data_log_write, scratch_size: %lu, cobs_dst_size: %u", scratch_size, dst_size);
 
@@ -539,6 +535,7 @@ void data_log_write(const uint8_t *scratch, uint32_t scratch_size){
   size_t count = 0;
   uint32_t sunk = 0;
   uint32_t polled = 0;
+  PROFILER_BEGIN(DATA_LOG_HEATSHRINK);
   while (sunk < input_size) {
       //ASSERT(heatshrink_encoder_sink(&hse, &input[sunk], input_size - sunk, &count) >= 0);
       heatshrink_encoder_sink(&(g_data_log_context.hse), &input[sunk], input_size - sunk, &count);
@@ -550,10 +547,13 @@ void data_log_write(const uint8_t *scratch, uint32_t scratch_size){
           polled += count;
       } while (pres == HSER_POLL_MORE);
   }
+  PROFILER_END(DATA_LOG_HEATSHRINK);
 
   if(polled > 0){
     UINT bytes_written;
+    PROFILER_BEGIN(DATA_LOG_F_WRITE);
     f_write_nowait(&g_data_log_context.open_log_file, &(comp[0]), polled, &bytes_written);
+    PROFILER_END(DATA_LOG_F_WRITE);
     // TODO: What happens if f_write fails?
   }
 }
@@ -33,7 +33,8 @@ void data_log_task(void *ignored);
 
 void data_log_open();
 void data_log_close();
-void user_metrics_log_open(FIL *file);
+// Creates a new user metrics log file, log_uid is set for its header.
+bool user_metrics_log_open(FIL *file, uint32_t *log_uid);
 
 bool getLogFileUID(char* uid, size_t uid_size);
 bool setLogFileUID(char* uid);
@@ -69,6 +70,9 @@ void data_log_mic(unsigned long mic_sample_number, int32_t mic);
 // log skin temp sensor
 void data_log_skin_temp(unsigned long temp_sample_number, uint8_t* temp_bytes);
 
+// log heart beat-to-beat interval, sample number is the PPG sample of the beat
+void data_log_hr_ibi(unsigned long ppg_sample_number, uint16_t ibi_ms);
+
 // log commands
 void data_log_command(char* line);
 
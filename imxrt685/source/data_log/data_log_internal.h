@@ -74,6 +74,10 @@ typedef struct
 #define ENABLE_DATA_LOG_STREAM_TEMP (0U) // (0U)
 #endif
 
+#ifndef ENABLE_DATA_LOG_STREAM_HR
+#define ENABLE_DATA_LOG_STREAM_HR (0U)
+#endif
+
 #ifndef ENABLE_DATA_LOG_STREAM_PULSE
 #define ENABLE_DATA_LOG_STREAM_PULSE (0U)
 #endif
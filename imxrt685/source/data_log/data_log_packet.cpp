@@ -34,6 +34,7 @@ const char* data_log_packet_str(data_log_packet_t type)
         case DLPT_INST_AMP_COMP_FRAME: return "DLPT_INST_AMP_COMP_FRAME";
         case DLPT_INST_PHS_COMP_HEADER: return "DLPT_INST_PHS_COMP_HEADER";
         case DLPT_INST_PHS_COMP_FRAME: return "DLPT_INST_PHS_COMP_FRAME";
+        case DLPT_HR_IBI: return "DLPT_HR_IBI";
     }
 
     return "unknown";
@@ -66,6 +66,7 @@ typedef enum data_log_packet_t{
   DLPT_INST_AMP_COMP_FRAME=28,
   DLPT_INST_PHS_COMP_HEADER=29,
   DLPT_INST_PHS_COMP_FRAME=30,
+  DLPT_HR_IBI=31,
 } data_log_packet_t;
 
 #define SAMPLE_NUMBER_SIZE sizeof(unsigned long)
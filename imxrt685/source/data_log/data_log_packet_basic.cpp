@@ -301,6 +301,26 @@ void data_log_skin_temp(unsigned long temp_sample_number, uint8_t* temp_bytes){
 #undef TEMP_BUFFER_SIZE
 }
 
+void data_log_hr_ibi(unsigned long ppg_sample_number, uint16_t ibi_ms){
+#if (defined(ENABLE_DATA_LOG_STREAM_HR) && (ENABLE_DATA_LOG_STREAM_HR > 0U))
+  LOGV("data_log_hr_ibi","%lu %u", (unsigned long) ppg_sample_number, (unsigned int) ibi_ms);
+#endif
+
+#define HR_IBI_BUFFER_SIZE (PACKET_TYPE_SIZE + SAMPLE_NUMBER_SIZE + sizeof(ibi_ms))
+  uint8_t* scratch = (uint8_t*) dl_malloc_if_file_ready(HR_IBI_BUFFER_SIZE);
+  if(scratch==NULL) {return;}
+  DLBuffer dlbuf(scratch, HR_IBI_BUFFER_SIZE);
+  // copy packet type
+  dlbuf.add(DLPT_HR_IBI);
+  // copy sample number
+  dlbuf.add(&ppg_sample_number, SAMPLE_NUMBER_SIZE);
+  // copy data
+  dlbuf.add(&ibi_ms, sizeof(ibi_ms));
+  // send
+  send_data(&dlbuf, portMAX_DELAY);
+#undef HR_IBI_BUFFER_SIZE
+}
+
 /*
  * Basic Packets with Sample Numbers
  */
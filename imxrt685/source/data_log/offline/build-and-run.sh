@@ -5,9 +5,9 @@ gcc -c \
  data_log_parse.c \
  cobs_stream.c \
  ../../heatshrink/heatshrink_decoder.c \
- ../../interface/cobs.c \
+ ../../../../common/interface/cobs.c \
  -I ../../heatshrink/ \
- -I ../../interface/ \
+ -I ../../../../common/interface/ \
  -I ../../compression/ \
  -I ../../data_log/ \
  -DDL_PARSER_OFFLINE=1 \
@@ -3,8 +3,10 @@
 #include "data_log.h"
 #include "eeg_datatypes.h"
 #include "loglevels.h"
+#include "data_log_parse.h"
 
 #include <stdbool.h>
+#include <string.h>
 
 // Forward declaration
 static void cobs_decode_cb(const uint8_t* buf, size_t bufsz);
@@ -34,6 +36,9 @@ static heatshrink_decoder hsd;
 // Stop requested flag
 static bool g_parse_stop_flag = false;
 
+// EEG sample callback
+static data_log_parse_eeg_cb_t g_eeg_cb = NULL;
+
 // Returns the enum as a string. Helpful for logs.
 static const char* data_log_packet_str(data_log_packet_t type)
 {
@@ -72,16 +77,37 @@ static void cobs_decode_cb(const uint8_t* buf, size_t bufsz)
     data_log_packet_t type = buf[0];
     LOGI("cobs decode cb. type=%d (%s), len=%zu\n", type, data_log_packet_str(type), bufsz);
 
-    if (type == DLPT_EEG_DATA_PACKED) {
+    if (type == DLPT_EEG_DATA) {
+        // type, sample number, then the channels as int32
+        if (bufsz < 1 + sizeof(uint32_t) + MAX_NUM_EEG_CHANNELS*sizeof(int32_t)) {
+            LOGE("short DLPT_EEG_DATA packet, len=%zu\n", bufsz);
+            return;
+        }
+        uint32_t sample_num;
+        int32_t eeg_sample[MAX_NUM_EEG_CHANNELS];
+        memcpy(&sample_num, &buf[1], sizeof(sample_num));
+        memcpy(eeg_sample, &buf[1 + sizeof(sample_num)], sizeof(eeg_sample));
+        if (g_eeg_cb) {
+            g_eeg_cb(sample_num, eeg_sample);
+        }
+    }
+    else if (type == DLPT_EEG_DATA_PACKED) {
         uint32_t idx = 1; // start at the sample num offset
         uint32_t sample_num = *(uint32_t*)&buf[idx];
         idx += sizeof(sample_num);
         int32_t eeg_sample[MAX_NUM_EEG_CHANNELS];
         LOGI("  sample_num=%u\n", sample_num);
 
+        // A packet holds up to EEG_PACK_NUM_SAMPLES_TO_SEND consecutive samples,
+        // it is sent early when the firmware sees a gap in the sample numbers.
+        uint32_t num_samples = (bufsz - idx) / (MAX_NUM_EEG_CHANNELS*3);
+        if (num_samples > EEG_PACK_NUM_SAMPLES_TO_SEND) {
+            num_samples = EEG_PACK_NUM_SAMPLES_TO_SEND;
+        }
+
         // Actual samples start at index 5
         // Pull out the 3 EEG channels for each of the samples
-        for (uint32_t i=0; i<EEG_PACK_NUM_SAMPLES_TO_SEND; i++) {
+        for (uint32_t i=0; i<num_samples; i++) {
             for (uint32_t j=0; j<MAX_NUM_EEG_CHANNELS; j++, idx+=3) {
                 // Each channel is encoded as 3 bytes
                 // See this line in data_log_eeg():
@@ -99,6 +125,10 @@ static void cobs_decode_cb(const uint8_t* buf, size_t bufsz)
                 eeg_sample[0], eeg_sample[1], eeg_sample[2]
             );
 
+            if (g_eeg_cb) {
+                g_eeg_cb(sample_num + i, eeg_sample);
+            }
+
             // TODO_COMPRESSION:
             // Call compress_frame() on the data and save bytes to the file.
             // Then COBS encode and heatshrink encode
@@ -228,6 +258,11 @@ void data_log_parse(const char* fn)
 }
 #endif
 
+void data_log_parse_set_eeg_cb(data_log_parse_eeg_cb_t cb)
+{
+    g_eeg_cb = cb;
+}
+
 void data_log_parse_stop(void)
 {
     // Set the flag to stop. The main processing loop checks this on each
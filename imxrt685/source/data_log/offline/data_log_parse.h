@@ -1,8 +1,25 @@
 #pragma once
 
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Called for every EEG sample recovered from DLPT_EEG_DATA and
+// DLPT_EEG_DATA_PACKED packets. eeg holds MAX_NUM_EEG_CHANNELS values.
+typedef void (*data_log_parse_eeg_cb_t)(unsigned long sample_number, const int32_t* eeg);
+
+// Register the EEG sample callback, NULL to disable.
+void data_log_parse_set_eeg_cb(data_log_parse_eeg_cb_t cb);
+
 // Parse a data log file at the given path, and re-encode it with compressed
 // EEG samples.
 void data_log_parse(const char* fn);
 
 // Stop an ongoing procedure
 void data_log_parse_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
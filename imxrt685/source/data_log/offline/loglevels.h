@@ -5,5 +5,9 @@
 #include <stdio.h>
 
 #define LOGE(...)   printf(__VA_ARGS__)
+#if (defined(DL_PARSER_QUIET) && (DL_PARSER_QUIET > 0U))
+#define LOGI(...)
+#else
 #define LOGI(...)   printf(__VA_ARGS__)
+#endif
 #define LOGD(...)
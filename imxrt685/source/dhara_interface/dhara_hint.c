@@ -0,0 +1,166 @@
+/*
+ * dhara_hint.c
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Journal position hint, see dhara_hint.h.
+ */
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "dhara_hint.h"
+#include "dhara_wear.h"
+
+// Set the log level for this file
+#define LOG_LEVEL_MODULE  LOG_WARN
+#include "loglevels.h"
+
+/// Logging prefix
+static const char* TAG = "dhara_hint";
+
+#define DHARA_HINT_MAGIC (0x544E4948UL)  // "HINT"
+
+typedef struct
+{
+  uint32_t magic;
+  uint32_t seq;
+  uint32_t root;   // dhara_journal_root() after a sync
+  uint32_t crc;    // CRC-32 of the fields above
+} dhara_hint_record_t;
+
+// Cleared if the hint block is bad or can't be erased.
+static bool g_enabled = false;
+// NAND_PAGES_PER_BLOCK: erase before the next record.
+static uint32_t g_next_page = NAND_PAGES_PER_BLOCK;
+static uint32_t g_seq = 0;
+static dhara_block_t g_saved_block = DHARA_BLOCK_NONE;
+
+// CRC-32 (IEEE), a record is too short for a table to pay off.
+static uint32_t
+crc32(const uint8_t *buf, size_t len)
+{
+  uint32_t crc = 0xFFFFFFFFUL;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= buf[i];
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 1) ? ((crc >> 1) ^ 0xEDB88320UL) : (crc >> 1);
+    }
+  }
+  return ~crc;
+}
+
+// Pages after the last record are erased, all 0xFF.
+static bool
+page_erased(nand_user_data_t *user_data, uint32_t page, dhara_hint_record_t *rec)
+{
+  int status = nand_read_page(user_data, DHARA_HINT_BLOCK, page, 0,
+      (uint8_t *)rec, sizeof(*rec));
+  if (status != NAND_NO_ERR && status != NAND_ECC_OK) {
+    return false;
+  }
+  return rec->magic == 0xFFFFFFFFUL && rec->seq == 0xFFFFFFFFUL &&
+      rec->root == 0xFFFFFFFFUL && rec->crc == 0xFFFFFFFFUL;
+}
+
+static bool
+record_valid(const dhara_hint_record_t *rec)
+{
+  return rec->magic == DHARA_HINT_MAGIC &&
+      rec->crc == crc32((const uint8_t *)rec, offsetof(dhara_hint_record_t, crc));
+}
+
+dhara_block_t
+dhara_hint_load(const struct dhara_nand *nand)
+{
+  nand_user_data_t *user_data = (nand_user_data_t *)nand->user_data;
+  dhara_hint_record_t rec;
+  bool good = false;
+
+  int status = nand_block_status(user_data,
+      nand_block_page_to_page_addr(DHARA_HINT_BLOCK, 0, user_data->chipinfo->block_addr_offset),
+      &good);
+  if (status != NAND_NO_ERR || !good) {
+    LOGW(TAG, "hint block %d is bad, resuming without hints", DHARA_HINT_BLOCK);
+    g_enabled = false;
+    return DHARA_BLOCK_NONE;
+  }
+  g_enabled = true;
+
+  // Records are programmed in page order, find the first erased page.
+  uint32_t low = 0;
+  uint32_t high = NAND_PAGES_PER_BLOCK;
+  while (low < high) {
+    uint32_t mid = (low + high) / 2;
+    if (page_erased(user_data, mid, &rec)) {
+      high = mid;
+    } else {
+      low = mid + 1;
+    }
+  }
+  g_next_page = low;
+
+  // A reset while programming the last record tears it, try the one
+  // before too.
+  for (uint32_t page = low; page > 0 && low - page < 2; page--) {
+    status = nand_read_page(user_data, DHARA_HINT_BLOCK, page - 1, 0,
+        (uint8_t *)&rec, sizeof(rec));
+    if ((status == NAND_NO_ERR || status == NAND_ECC_OK) && record_valid(&rec)) {
+      g_seq = rec.seq;
+      g_saved_block = rec.root >> nand->log2_ppb;
+      LOGI(TAG, "hint %lu: root 0x%lx, block %lu", rec.seq, rec.root, g_saved_block);
+      return g_saved_block;
+    }
+  }
+
+  LOGI(TAG, "no valid hint (next page %lu)", g_next_page);
+  return DHARA_BLOCK_NONE;
+}
+
+void
+dhara_hint_update(const struct dhara_map *map)
+{
+  const struct dhara_nand *nand = map->journal.nand;
+  nand_user_data_t *user_data = (nand_user_data_t *)nand->user_data;
+  dhara_page_t root = dhara_journal_root(&map->journal);
+  int status;
+
+  if (!g_enabled || root == DHARA_PAGE_NONE) {
+    return;
+  }
+
+  // Moved on less than DHARA_HINT_MIN_BLOCKS, and not wrapped around.
+  dhara_block_t block = root >> nand->log2_ppb;
+  if (g_saved_block != DHARA_BLOCK_NONE && block >= g_saved_block &&
+      block < g_saved_block + DHARA_HINT_MIN_BLOCKS) {
+    return;
+  }
+
+  if (g_next_page >= NAND_PAGES_PER_BLOCK) {
+    status = nand_erase_block(user_data,
+        nand_block_page_to_page_addr(DHARA_HINT_BLOCK, 0, user_data->chipinfo->block_addr_offset));
+    dhara_wear_note_erase(DHARA_HINT_BLOCK, status == NAND_NO_ERR);
+    if (status != NAND_NO_ERR) {
+      LOGE(TAG, "nand_erase_block(%d) error: %d, no more hints", DHARA_HINT_BLOCK, status);
+      g_enabled = false;
+      return;
+    }
+    g_next_page = 0;
+  }
+
+  dhara_hint_record_t rec = {
+    .magic = DHARA_HINT_MAGIC,
+    .seq = ++g_seq,
+    .root = root,
+  };
+  rec.crc = crc32((const uint8_t *)&rec, offsetof(dhara_hint_record_t, crc));
+
+  // A failed program still uses up the page.
+  status = nand_write_page(user_data, DHARA_HINT_BLOCK, g_next_page++, 0,
+      (uint8_t *)&rec, sizeof(rec));
+  if (status != NAND_NO_ERR) {
+    LOGE(TAG, "nand_write_page(%d.%lu) error: %d", DHARA_HINT_BLOCK, g_next_page - 1, status);
+    return;
+  }
+  g_saved_block = block;
+}
@@ -0,0 +1,45 @@
+/*
+ * dhara_hint.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Journal position hint, so boot doesn't search the whole
+ * NAND for the Dhara journal head.
+ *
+ * The block holding the journal root is saved to DHARA_HINT_BLOCK, outside
+ * the Dhara map, each time it has moved DHARA_HINT_MIN_BLOCKS on. Records
+ * are programmed to consecutive pages and the block is erased when full,
+ * about as often as a block of the map. A missing, torn or out of date
+ * hint only costs the full search (see dhara_map_resume_hint()).
+ */
+#ifndef DHARA_HINT_H
+#define DHARA_HINT_H
+
+#include "map.h"
+#include "nand.h"
+#include "nand_layout.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The last block of the chip, see common/nand/nand_layout.h.
+#define DHARA_HINT_BLOCK (NAND_LAYOUT_HINT_BLOCK)
+
+// Resuming from a hint this far behind the root takes ~2*log2() more
+// probes than from an exact one.
+#define DHARA_HINT_MIN_BLOCKS (16U)
+
+// Block to pass to dhara_map_resume_hint(), DHARA_BLOCK_NONE if there is
+// no valid hint.
+dhara_block_t dhara_hint_load(const struct dhara_nand *nand);
+
+// Save the root block if it has moved on enough. Call with the filesystem
+// locked, right after a successful dhara_map_sync().
+void dhara_hint_update(const struct dhara_map *map);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // DHARA_HINT_H
@@ -14,11 +14,13 @@
 #include "nand.h"
 #include "dhara_metadata_cache.h"
 #include "dhara_utils.h"
+#include "dhara_wear.h"
 #include <string.h>
 
 // Set the log level for this file
 #define LOG_LEVEL_MODULE  LOG_WARN
 #include "loglevels.h"
+#include "profiler.h"
 
 /// Logging prefix
 static const char* TAG = "dhara_nand";
@@ -68,6 +70,7 @@ void dhara_nand_mark_bad(const struct dhara_nand *nand, dhara_block_t block)
   int status;
 
   LOGI(TAG, "dhara_nand_mark_bad: block %lu", block);
+  dhara_wear_note_bad(block);
 
   // The block holds 64 pages, of NAND_PAGE_SIZE (2048) + 127 bytes of
   // "spare" (metadata, incl. ECC bits).
@@ -123,13 +126,17 @@ int dhara_nand_erase(const struct dhara_nand *nand, dhara_block_t block,
   if (!((user_data->layout_page_addr ^ page_addr) & ~mask))
       user_data->layout_page_addr = DHARA_PAGE_NONE;
 
+  PROFILER_BEGIN(NAND_ERASE);
   status = nand_erase_block(user_data, page_addr);
+  PROFILER_END(NAND_ERASE);
   if (status != NAND_NO_ERR) {
     LOGE(TAG, "dhara_nand_erase: block %d: "
       "nand_erase_block() error: %d", (int)block, status);
+    dhara_wear_note_erase(block, false);
     dhara_set_error(err, DHARA_E_BAD_BLOCK);
     return -1;
   }
+  dhara_wear_note_erase(block, true);
 
   *err = DHARA_E_NONE;
   return 0;
@@ -197,7 +204,9 @@ int dhara_nand_prog(const struct dhara_nand *nand, dhara_page_t page_addr,
 
   LOGV(TAG, "dhara_nand_prog: block %d, page %d, data_size %d", (int)block, (int)page, (int)data_size);
 
+  PROFILER_BEGIN(NAND_PROG);
   status = nand_write_page(user_data, block, page, page_offset, layout_buffer, layout_size);
+  PROFILER_END(NAND_PROG);
   if (status != NAND_NO_ERR) {
     LOGE(TAG, "dhara_nand_prog: blk %d, pg %d data: "
       "nand_write_page() error: %d", (int)block, (int)page, status);
@@ -313,7 +322,9 @@ int dhara_nand_read(const struct dhara_nand *nand, dhara_page_t page_addr,
   if (length == DHARA_META_SIZE)
   {
     int page_offset = 0;
+    PROFILER_BEGIN(NAND_READ);
     status = nand_read_page(user_data, block, page, page_offset, layout_buffer, layout_size_bytes);
+    PROFILER_END(NAND_READ);
     // NAND_ECC_OK means some bits were corrected, maybe this block is going bad.
     if (status != NAND_NO_ERR && status != NAND_ECC_OK) {
       LOGE(TAG, "dhara_nand_read: %d.%d: data: "
@@ -329,7 +340,9 @@ int dhara_nand_read(const struct dhara_nand *nand, dhara_page_t page_addr,
   } else {
 
     // Just do a normal NAND read directly into the supplies buffer
+    PROFILER_BEGIN(NAND_READ);
     status = nand_read_page(user_data, block, page, offset, data, length);
+    PROFILER_END(NAND_READ);
     // NAND_ECC_OK means some bits were corrected, maybe this block is going bad.
     if (status != NAND_NO_ERR && status != NAND_ECC_OK) {
       LOGE(TAG, "dhara_nand_read: %d.%d: data: "
@@ -350,6 +363,7 @@ int dhara_nand_read(const struct dhara_nand *nand, dhara_page_t page_addr,
   // read by the higher-level system.
   if (status == NAND_ECC_OK) {
     dhara_set_error(err, DHARA_E_ECC_WARNING);
+    dhara_wear_note_ecc_warning();
     LOGD(TAG, "dhara_nand_read: %d.%d: ECC warning", (int)block, (int)page);
 
     // Recovery state doesn't actually get stored until we return, but
@@ -365,6 +379,41 @@ int dhara_nand_read(const struct dhara_nand *nand, dhara_page_t page_addr,
 }
 
 
+/* Read count whole pages, consecutive within one block. Not part of the
+ * Dhara NAND interface, disk_read() uses it for runs of sectors. Returns 0
+ * on success or -1 if any of the pages had an ECC error or warning, the
+ * caller then reads them one by one through the journal, which relocates
+ * the block if needed.
+ */
+int dhara_nand_read_pages(const struct dhara_nand *nand, dhara_page_t page_addr,
+			  size_t count, uint8_t *data,
+			  dhara_error_t *err)
+{
+  nand_user_data_t *user_data = (nand_user_data_t *)nand->user_data;
+
+  uint32_t block;
+  uint32_t page;
+  dhara_page_addr_to_block_page(nand, page_addr, &block, &page);
+
+  LOGV(TAG, "dhara_nand_read_pages: block %d, page %d, count %d", (int)block, (int)page, (int)count);
+
+  PROFILER_BEGIN(NAND_READ);
+  int status = nand_read_pages(user_data,
+    nand_block_page_to_page_addr(block, page, user_data->chipinfo->block_addr_offset),
+    count, data);
+  PROFILER_END(NAND_READ);
+  if (status == NAND_NO_ERR) {
+    dhara_set_error(err, DHARA_E_NONE);
+    return 0;
+  }
+
+  LOGD(TAG, "dhara_nand_read_pages: %d.%d+%d: nand_read_pages() status: %d",
+    (int)block, (int)page, (int)count, status);
+  dhara_set_error(err, (status == NAND_ECC_OK) ? DHARA_E_ECC_WARNING : DHARA_E_ECC);
+  return -1;
+}
+
+
 /* Read a page from one location and reprogram it in another location.
  * This might be done using the chip's internal buffers, but it must use
  * ECC.
@@ -391,6 +440,7 @@ int dhara_nand_copy(const struct dhara_nand *nand,
     if (status == NAND_ECC_OK) {
       ret = -1;
       dhara_set_error(err, DHARA_E_ECC_WARNING);
+      dhara_wear_note_ecc_warning();
     }
     
   } else {
@@ -410,6 +460,7 @@ int dhara_nand_copy(const struct dhara_nand *nand,
     if (status == NAND_ECC_OK) {
       ret = -1;
       dhara_set_error(err, DHARA_E_ECC_WARNING);
+      dhara_wear_note_ecc_warning();
     } else if (status != NAND_NO_ERR) {
       dhara_set_error(err, DHARA_E_ECC);
       LOGE(TAG, "dhara_nand_copy: %d.%d: data: "
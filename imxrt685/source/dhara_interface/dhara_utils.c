@@ -10,16 +10,22 @@
  *
  */
 
+#include <assert.h>
 #include <stdatomic.h>
 #include "nand.h"
+#include "nand_layout.h"
 #include "loglevels.h"
 
 #include "dhara_utils.h"
 #include "dhara_metadata_cache.h"
+#include "dhara_wear.h"
+#include "dhara_hint.h"
 
 #define DHARA_GC_RATIO 4
-#define OTA_NUM_BLOCKS 20
-#define MEMFAULT_NUM_BLOCKS 1
+// After the map: the Memfault coredump block, OTA, then DHARA_HINT_BLOCK,
+// see common/nand/nand_layout.h.
+static_assert(NAND_LAYOUT_BLOCK_COUNT == NAND_BLOCK_COUNT, "nand_layout.h doesn't match the NAND");
+static_assert(NAND_LAYOUT_PAGES_PER_BLOCK == NAND_PAGES_PER_BLOCK, "nand_layout.h doesn't match the NAND");
 
 static uint8_t layout_buffer[NAND_PAGE_PLUS_SPARE_SIZE];
 
@@ -40,7 +46,7 @@ const struct dhara_nand g_dhara_nand = {
 
   .log2_page_size = NAND_PAGE_SIZE_LOG2,
   .log2_ppb = NAND_PAGES_PER_BLOCK_LOG2,
-  .num_blocks = NAND_BLOCK_COUNT - (OTA_NUM_BLOCKS + MEMFAULT_NUM_BLOCKS)
+  .num_blocks = NAND_LAYOUT_MAP_NUM_BLOCKS
 };
 
 /// Logging prefix
@@ -81,7 +87,10 @@ dhara_pretask_init(void)
   dhara_metadata_cache_init();
   dhara_map_init(&g_dhara_map, &g_dhara_nand, (uint8_t *)dhara_page_buffer, DHARA_GC_RATIO);
 
-  status = dhara_map_resume(&g_dhara_map, &err);
+  // Start looking for the journal head where it was last seen.
+  dhara_block_t hint = dhara_hint_load(&g_dhara_nand);
+
+  status = dhara_map_resume_hint(&g_dhara_map, hint, &err);
   if (status == -1) {
     LOGI(TAG, "dhara_map_resume: no journal found (err: %d); initialized an empty map", (int)err);
 
@@ -90,9 +99,13 @@ dhara_pretask_init(void)
     if (status != 0) {
       LOGE(TAG, "dhara_map_sync: %d (err: %d)", status, (int)err);
     }
+    else {
+      dhara_hint_update(&g_dhara_map);
+    }
     
   } else {
-    LOGI(TAG, "dhara_map_resume: success");
+    LOGI(TAG, "dhara_map_resume: success (hint block %lu, root 0x%lx)",
+        hint, dhara_journal_root(&g_dhara_map.journal));
   }
 
 }
@@ -107,6 +120,39 @@ uint16_t dhara_map_sector_size_bytes(struct dhara_map *map)
   return (1 << map->journal.nand->log2_page_size);
 }
 
+int dhara_idle_gc(struct dhara_map *map, dhara_error_t *err)
+{
+  dhara_page_t capacity = dhara_map_capacity(map);
+  dhara_page_t size = dhara_journal_size(&map->journal);
+
+  // The journal can't shrink below the live sectors, leave a block of slack
+  // so it doesn't keep copying them around.
+  dhara_page_t target = (capacity > DHARA_IDLE_GC_HEADROOM_PAGES) ?
+      (capacity - DHARA_IDLE_GC_HEADROOM_PAGES) : 0;
+  if (target < dhara_map_size(map) + NAND_PAGES_PER_BLOCK) {
+    target = dhara_map_size(map) + NAND_PAGES_PER_BLOCK;
+  }
+  if (size <= target) {
+    return 0;
+  }
+
+  for (int i = 0; i < DHARA_IDLE_GC_STEPS; i++) {
+    if (dhara_map_gc(map, err) < 0) {
+      return -1;
+    }
+  }
+  dhara_wear_note_idle_gc(DHARA_IDLE_GC_STEPS);
+
+  // Collected pages are only released by the next checkpoint.
+  if (dhara_map_sync(map, err) < 0) {
+    return -1;
+  }
+  dhara_hint_update(map);
+
+  dhara_page_t new_size = dhara_journal_size(&map->journal);
+  return (new_size < size && new_size > target) ? 1 : 0;
+}
+
 // It would be nice to make the recovery hint an extern and inline these
 // functions, but mixing C11 atomics with C++ code is not so easy
 static atomic_int dhara__recovery_hint;
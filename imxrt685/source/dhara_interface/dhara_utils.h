@@ -25,6 +25,32 @@ struct dhara_map *dhara_get_my_map(void);
 
 uint16_t dhara_map_sector_size_bytes(struct dhara_map *map);
 
+// Read count whole pages, consecutive within one block, in one go (see
+// nand_read_pages()). -1 if any of them needs ECC, read those through
+// dhara_journal_nand_read() instead.
+int dhara_nand_read_pages(const struct dhara_nand *nand, dhara_page_t page_addr,
+			  size_t count, uint8_t *data,
+			  dhara_error_t *err);
+
+// Background garbage collection.
+//
+// Once the journal is full, every write first collects DHARA_GC_RATIO + 1
+// pages, which is slow and lands on whoever is writing. Collecting while
+// the device is idle keeps DHARA_IDLE_GC_HEADROOM_PAGES free so that a
+// night of logging never gets there.
+#ifndef DHARA_IDLE_GC_HEADROOM_PAGES
+#define DHARA_IDLE_GC_HEADROOM_PAGES (128*NAND_PAGES_PER_BLOCK)  // 16 MB
+#endif
+
+// Pages collected per dhara_idle_gc() call, one block.
+#define DHARA_IDLE_GC_STEPS (NAND_PAGES_PER_BLOCK)
+
+// Collect up to DHARA_IDLE_GC_STEPS pages and sync the map. Call with the
+// filesystem locked. Returns 1 if there is more to collect, 0 if the
+// headroom is reached or collecting freed nothing (the map is mostly live
+// data), -1 on error.
+int dhara_idle_gc(struct dhara_map *map, dhara_error_t *err);
+
 // Pre-emptive recovery hint.
 //
 // This is a polled event variable with two operations:
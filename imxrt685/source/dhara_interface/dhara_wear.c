@@ -0,0 +1,208 @@
+/*
+ * dhara_wear.c
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: NAND wear statistics, see dhara_wear.h.
+ *
+ * The note functions are called from the Dhara map and NAND interface,
+ * which only run with the filesystem locked, so the counts need no lock of
+ * their own.
+ */
+
+#include <string.h>
+
+#include "dhara_wear.h"
+#include "nand.h"
+#include "ff.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Set the log level for this file
+#define LOG_LEVEL_MODULE  LOG_WARN
+#include "loglevels.h"
+
+/// Logging prefix
+static const char* TAG = "dhara_wear";
+
+#define DHARA_WEAR_MAGIC   (0x52414557UL)  // "WEAR"
+#define DHARA_WEAR_VERSION (1U)
+
+typedef struct
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t block_count;
+  dhara_wear_stats_t stats;
+} dhara_wear_header_t;
+
+static dhara_wear_stats_t g_stats;
+static uint32_t g_block_erases[NAND_BLOCK_COUNT];
+static bool g_dirty = false;
+// Don't overwrite the saved counts with the ones since boot if they could
+// not be read.
+static bool g_loaded = false;
+
+void dhara_wear_note_erase(dhara_block_t block, bool ok)
+{
+  if (!ok) {
+    g_stats.erase_failures++;
+  }
+  else if (block < NAND_BLOCK_COUNT) {
+    g_stats.erases++;
+    g_block_erases[block]++;
+    if (g_block_erases[block] > g_stats.max_block_erases) {
+      g_stats.max_block_erases = g_block_erases[block];
+    }
+  }
+  g_dirty = true;
+}
+
+void dhara_wear_note_bad(dhara_block_t block)
+{
+  g_stats.bad_blocks_marked++;
+  g_dirty = true;
+}
+
+void dhara_wear_note_ecc_warning(void)
+{
+  g_stats.ecc_warnings++;
+  g_dirty = true;
+}
+
+void dhara_wear_note_relocation(void)
+{
+  g_stats.relocations++;
+  g_dirty = true;
+}
+
+void dhara_wear_note_idle_gc(uint32_t pages)
+{
+  g_stats.idle_gc_pages += pages;
+  g_dirty = true;
+}
+
+uint32_t dhara_wear_block_erases(dhara_block_t block)
+{
+  return (block < NAND_BLOCK_COUNT) ? g_block_erases[block] : 0;
+}
+
+void dhara_wear_get_stats(dhara_wear_stats_t* stats)
+{
+  taskENTER_CRITICAL();
+  *stats = g_stats;
+  taskEXIT_CRITICAL();
+}
+
+bool dhara_wear_dirty(void)
+{
+  return g_dirty;
+}
+
+int dhara_wear_load(void)
+{
+  FIL file;
+  UINT bytes_read;
+  dhara_wear_header_t header;
+  // read in pieces, the counts are too big for a task stack
+  uint32_t counts[64];
+  FRESULT result;
+
+  if (g_loaded) {
+    return 0;
+  }
+
+  result = f_open(&file, DHARA_WEAR_FILE, FA_READ);
+  if (result == FR_NO_FILE) {
+    LOGI(TAG, "no %s, starting from zero", DHARA_WEAR_FILE);
+    g_loaded = true;
+    return 0;
+  }
+  if (result != FR_OK) {
+    LOGE(TAG, "f_open(%s) error: %d", DHARA_WEAR_FILE, result);
+    return -1;
+  }
+
+  result = f_read(&file, &header, sizeof(header), &bytes_read);
+  if (result != FR_OK || bytes_read != sizeof(header) ||
+      header.magic != DHARA_WEAR_MAGIC || header.version != DHARA_WEAR_VERSION ||
+      header.block_count != NAND_BLOCK_COUNT) {
+    LOGE(TAG, "%s is invalid, starting from zero", DHARA_WEAR_FILE);
+    f_close(&file);
+    g_loaded = true;
+    g_dirty = true;
+    return 0;
+  }
+
+  taskENTER_CRITICAL();
+  g_stats.erases += header.stats.erases;
+  g_stats.erase_failures += header.stats.erase_failures;
+  g_stats.bad_blocks_marked += header.stats.bad_blocks_marked;
+  g_stats.ecc_warnings += header.stats.ecc_warnings;
+  g_stats.relocations += header.stats.relocations;
+  g_stats.idle_gc_pages += header.stats.idle_gc_pages;
+  taskEXIT_CRITICAL();
+
+  for (uint32_t block = 0; block < NAND_BLOCK_COUNT; block += 64) {
+    result = f_read(&file, counts, sizeof(counts), &bytes_read);
+    if (result != FR_OK || bytes_read != sizeof(counts)) {
+      LOGE(TAG, "f_read(%s) error: %d", DHARA_WEAR_FILE, result);
+      break;
+    }
+    taskENTER_CRITICAL();
+    for (uint32_t i = 0; i < 64; i++) {
+      g_block_erases[block + i] += counts[i];
+      if (g_block_erases[block + i] > g_stats.max_block_erases) {
+        g_stats.max_block_erases = g_block_erases[block + i];
+      }
+    }
+    taskEXIT_CRITICAL();
+  }
+
+  f_close(&file);
+  g_loaded = true;
+  return 0;
+}
+
+int dhara_wear_save(void)
+{
+  FIL file;
+  UINT bytes_written;
+  dhara_wear_header_t header;
+  FRESULT result;
+
+  if (!g_loaded) {
+    return -1;
+  }
+
+  result = f_open(&file, DHARA_WEAR_FILE, FA_CREATE_ALWAYS | FA_WRITE);
+  if (result != FR_OK) {
+    LOGE(TAG, "f_open(%s) error: %d", DHARA_WEAR_FILE, result);
+    return -1;
+  }
+
+  // Cleared first, erases caused by this save mark it dirty again.
+  g_dirty = false;
+
+  header.magic = DHARA_WEAR_MAGIC;
+  header.version = DHARA_WEAR_VERSION;
+  header.block_count = NAND_BLOCK_COUNT;
+  dhara_wear_get_stats(&header.stats);
+
+  result = f_write(&file, &header, sizeof(header), &bytes_written);
+  if (result == FR_OK) {
+    result = f_write(&file, g_block_erases, sizeof(g_block_erases), &bytes_written);
+  }
+  FRESULT close_result = f_close(&file);
+  if (result == FR_OK) {
+    result = close_result;
+  }
+
+  if (result != FR_OK) {
+    LOGE(TAG, "saving %s error: %d", DHARA_WEAR_FILE, result);
+    g_dirty = true;
+    return -1;
+  }
+  return 0;
+}
@@ -0,0 +1,63 @@
+/*
+ * dhara_wear.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: NAND wear statistics, kept by the Dhara NAND interface.
+ *
+ * Counts every block erase (per block), erase failures, blocks marked bad,
+ * reads that needed ECC correction and blocks relocated before they
+ * failed. The counts are saved to DHARA_WEAR_FILE by the fatfs writer task
+ * while the device is idle, so they cover the life of the flash, not just
+ * the current boot.
+ */
+#ifndef DHARA_WEAR_H
+#define DHARA_WEAR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "dhara_nand.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DHARA_WEAR_FILE "/dhara_wear.bin"
+
+typedef struct
+{
+  uint32_t erases;             // all blocks
+  uint32_t erase_failures;
+  uint32_t bad_blocks_marked;
+  uint32_t ecc_warnings;       // reads with corrected bit errors
+  uint32_t relocations;        // blocks moved by preemptive recovery
+  uint32_t idle_gc_pages;      // pages collected in the background
+  uint32_t max_block_erases;   // most worn block
+} dhara_wear_stats_t;
+
+// Called by dhara_nand.c.
+void dhara_wear_note_erase(dhara_block_t block, bool ok);
+void dhara_wear_note_bad(dhara_block_t block);
+void dhara_wear_note_ecc_warning(void);
+
+// Called by the background maintenance.
+void dhara_wear_note_relocation(void);
+void dhara_wear_note_idle_gc(uint32_t pages);
+
+uint32_t dhara_wear_block_erases(dhara_block_t block);
+void dhara_wear_get_stats(dhara_wear_stats_t* stats);
+
+// Counts changed since the last load or save.
+bool dhara_wear_dirty(void);
+
+// Add the counts saved in DHARA_WEAR_FILE to the ones since boot, or save
+// them. Use with the filesystem mounted. 0 on success.
+int dhara_wear_load(void);
+int dhara_wear_save(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // DHARA_WEAR_H
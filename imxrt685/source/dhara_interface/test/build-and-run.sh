@@ -0,0 +1,12 @@
+set -x
+
+# dhara_map_resume() vs dhara_map_resume_hint() on a simulated NAND
+gcc -O2 -I ../../../dhara \
+ ../../../dhara/error.c \
+ ../../../dhara/journal.c \
+ ../../../dhara/map.c \
+ ./dhara_resume_test.c \
+ && ./a.out || exit 1
+
+# cleanup
+rm ./a.out
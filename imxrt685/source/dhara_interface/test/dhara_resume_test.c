@@ -0,0 +1,245 @@
+/*
+ * dhara_resume_test.c
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host test and benchmark of dhara_map_resume() against
+ * dhara_map_resume_hint() on a simulated NAND. The map is filled to a
+ * given level and then overwritten at random until the journal has
+ * wrapped, as on a device that has been logging for a while. Every resume
+ * must find the same journal state; the page reads each one takes stand
+ * in for the boot time.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "map.h"
+
+// Same page and block size as the W25N04KW, fewer blocks.
+#define SIM_LOG2_PAGE_SIZE 11
+#define SIM_LOG2_PPB       6
+#define SIM_NUM_BLOCKS     512
+#define SIM_PAGE_SIZE      (1 << SIM_LOG2_PAGE_SIZE)
+#define SIM_NUM_PAGES      (SIM_NUM_BLOCKS << SIM_LOG2_PPB)
+
+// Blocks written between saved hints, DHARA_HINT_MIN_BLOCKS
+#define HINT_MIN_BLOCKS 16
+
+typedef struct {
+  uint8_t* pages[SIM_NUM_PAGES];  // NULL if erased
+  uint8_t bad[SIM_NUM_BLOCKS];
+  uint32_t reads;                 // page reads, including free checks
+} sim_nand_t;
+
+static sim_nand_t g_sim;
+
+static const struct dhara_nand g_nand = {
+  .log2_page_size = SIM_LOG2_PAGE_SIZE,
+  .log2_ppb = SIM_LOG2_PPB,
+  .num_blocks = SIM_NUM_BLOCKS,
+};
+
+int
+dhara_nand_is_bad(const struct dhara_nand *n, dhara_block_t b)
+{
+  g_sim.reads++;
+  return g_sim.bad[b];
+}
+
+void
+dhara_nand_mark_bad(const struct dhara_nand *n, dhara_block_t b)
+{
+  g_sim.bad[b] = 1;
+}
+
+int
+dhara_nand_erase(const struct dhara_nand *n, dhara_block_t b, dhara_error_t *err)
+{
+  if (g_sim.bad[b]) {
+    dhara_set_error(err, DHARA_E_BAD_BLOCK);
+    return -1;
+  }
+  for (int i = 0; i < (1 << SIM_LOG2_PPB); i++) {
+    free(g_sim.pages[(b << SIM_LOG2_PPB) + i]);
+    g_sim.pages[(b << SIM_LOG2_PPB) + i] = NULL;
+  }
+  return 0;
+}
+
+int
+dhara_nand_prog(const struct dhara_nand *n, dhara_page_t p, const uint8_t *data,
+    dhara_error_t *err)
+{
+  if (g_sim.bad[p >> SIM_LOG2_PPB]) {
+    dhara_set_error(err, DHARA_E_BAD_BLOCK);
+    return -1;
+  }
+  assert(g_sim.pages[p] == NULL);
+  g_sim.pages[p] = malloc(SIM_PAGE_SIZE);
+  assert(g_sim.pages[p] != NULL);
+  memcpy(g_sim.pages[p], data, SIM_PAGE_SIZE);
+  return 0;
+}
+
+int
+dhara_nand_is_free(const struct dhara_nand *n, dhara_page_t p)
+{
+  g_sim.reads++;
+  return g_sim.pages[p] == NULL;
+}
+
+int
+dhara_nand_read(const struct dhara_nand *n, dhara_page_t p, size_t offset,
+    size_t length, uint8_t *data, dhara_error_t *err)
+{
+  g_sim.reads++;
+  if (g_sim.pages[p] == NULL) {
+    memset(data, 0xff, length);
+  } else {
+    memcpy(data, g_sim.pages[p] + offset, length);
+  }
+  return 0;
+}
+
+int
+dhara_nand_copy(const struct dhara_nand *n, dhara_page_t src, dhara_page_t dst,
+    dhara_error_t *err)
+{
+  uint8_t buf[SIM_PAGE_SIZE];
+
+  if (dhara_nand_read(n, src, 0, SIM_PAGE_SIZE, buf, err) < 0) {
+    return -1;
+  }
+  return dhara_nand_prog(n, dst, buf, err);
+}
+
+static void
+sim_reset(void)
+{
+  for (int i = 0; i < SIM_NUM_PAGES; i++) {
+    free(g_sim.pages[i]);
+  }
+  memset(&g_sim, 0, sizeof(g_sim));
+
+  // A few factory bad blocks, one a run long enough to need retries
+  g_sim.bad[3] = 1;
+  g_sim.bad[200] = 1;
+  g_sim.bad[201] = 1;
+  g_sim.bad[202] = 1;
+  g_sim.bad[400] = 1;
+}
+
+static void
+assert_same_state(const struct dhara_map* a, const struct dhara_map* b)
+{
+  assert(a->count == b->count);
+  assert(a->journal.epoch == b->journal.epoch);
+  assert(a->journal.head == b->journal.head);
+  assert(a->journal.tail == b->journal.tail);
+  assert(a->journal.root == b->journal.root);
+  assert(a->journal.bb_current == b->journal.bb_current);
+  assert(a->journal.bb_last == b->journal.bb_last);
+}
+
+static uint32_t
+resume_reads(struct dhara_map* m, uint8_t* page_buf, dhara_block_t hint)
+{
+  dhara_error_t err;
+  int status;
+
+  dhara_map_init(m, &g_nand, page_buf, 4);
+  g_sim.reads = 0;
+  if (hint == DHARA_BLOCK_NONE) {
+    status = dhara_map_resume(m, &err);
+  } else {
+    status = dhara_map_resume_hint(m, hint, &err);
+  }
+  assert(status == 0);
+  return g_sim.reads;
+}
+
+static void
+run_fill_level(int percent)
+{
+  static uint8_t page_buf[SIM_PAGE_SIZE];
+  static uint8_t full_buf[SIM_PAGE_SIZE];
+  static uint8_t data[SIM_PAGE_SIZE];
+  struct dhara_map m;
+  struct dhara_map full;
+  dhara_error_t err;
+
+  sim_reset();
+  dhara_map_init(&m, &g_nand, page_buf, 4);
+  dhara_map_resume(&m, &err);
+
+  dhara_sector_t sectors = (dhara_sector_t)((uint64_t)dhara_map_capacity(&m) * percent / 100);
+  if (sectors == 0) {
+    sectors = 1;
+  }
+
+  // Fill, then overwrite until the journal has wrapped at least once.
+  // Save a hint the way the firmware does: after a sync, once the root
+  // is HINT_MIN_BLOCKS on from the last one.
+  dhara_block_t hint = DHARA_BLOCK_NONE;
+  dhara_block_t last_root_block = 0;
+  uint32_t writes = sectors + 2 * SIM_NUM_PAGES;
+  srand(percent);
+  for (uint32_t i = 0; i < writes; i++) {
+    dhara_sector_t s = (i < sectors) ? i : (dhara_sector_t)(rand() % sectors);
+    memset(data, (uint8_t)i, sizeof(data));
+    assert(dhara_map_write(&m, s, data, &err) == 0);
+
+    if (i % 16 == 15) {
+      assert(dhara_map_sync(&m, &err) == 0);
+      dhara_block_t root_block = dhara_journal_root(&m.journal) >> SIM_LOG2_PPB;
+      if (hint == DHARA_BLOCK_NONE || root_block < hint ||
+          root_block >= hint + HINT_MIN_BLOCKS) {
+        hint = root_block;
+      }
+      last_root_block = root_block;
+    }
+  }
+  assert(dhara_map_sync(&m, &err) == 0);
+  assert(m.journal.epoch > 0);
+  (void) last_root_block;
+
+  uint32_t full_reads = resume_reads(&full, full_buf, DHARA_BLOCK_NONE);
+  uint32_t hint_reads = resume_reads(&m, page_buf, hint);
+  assert_same_state(&full, &m);
+
+  uint32_t fresh_reads = resume_reads(&m, page_buf,
+      dhara_journal_root(&full.journal) >> SIM_LOG2_PPB);
+  assert_same_state(&full, &m);
+
+  // Hints that are no use fall back to the full search
+  uint32_t bad_reads = resume_reads(&m, page_buf, 201);
+  assert_same_state(&full, &m);
+  resume_reads(&m, page_buf, SIM_NUM_BLOCKS + 1);
+  assert_same_state(&full, &m);
+  resume_reads(&m, page_buf, (dhara_journal_root(&full.journal) >> SIM_LOG2_PPB) + 1);
+  assert_same_state(&full, &m);
+
+  printf("%3d%% full: resume %3u reads, hint %3u (%u blocks behind), "
+      "fresh hint %3u, bad hint %3u\n", percent, full_reads, hint_reads,
+      (unsigned)((full.journal.root >> SIM_LOG2_PPB) - hint), fresh_reads, bad_reads);
+
+  assert(hint_reads < full_reads);
+  assert(fresh_reads < full_reads);
+}
+
+int
+main(void)
+{
+  int levels[] = { 10, 25, 50, 75, 90 };
+
+  for (size_t i = 0; i < sizeof(levels) / sizeof(levels[0]); i++) {
+    run_fill_level(levels[i]);
+  }
+  sim_reset();
+
+  printf("Success\n");
+  return 0;
+}
@@ -33,4 +33,10 @@
 #define EEG_SCALAR_UV (1000000.0*EEG_SCALAR_V)
 #endif
 
+// Electrode quality thresholds on the instantaneous RMS (uV).
+// Used by EEGQualityTest and by the ERP averager for artifact rejection.
+#define EEG_QUALITY_NO_SIGNAL_UV   (1.0f)   // supposed to be 1.1220184543f
+#define EEG_QUALITY_WEAK_SIGNAL_UV (5.0f)   // supposed to be 1.77827941004f
+#define EEG_QUALITY_ARTIFACT_UV    (500.0f)
+
 #endif /* EEG_READER_EEG_CONSTANTS_H_ */
@@ -72,6 +72,11 @@ void ads_decode_sample(uint8_t* data, size_t data_len, ads129x_sample *sample);
 
 void ads_decode_frontal_sample(uint8_t* data, size_t data_len, ads129x_frontal_sample *sample);
 
+// Convert one channel from 24bit to 32bit 2's complement, see ads_decode_sample().
+static inline int32_t ads_decode_channel(const uint8_t* data){
+  return ((int32_t)(((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8))) >> 8;
+}
+
 void eeg_channel_config_reset(eeg_channel_config_t *config);
 
 void eeg_channel_config_add(eeg_channel_config_t *config, char* name, eeg_channel_t channel_number );
@@ -79,5 +79,25 @@ void eeg_filters_filter(eeg_filters_context_t *context, ads129x_frontal_sample *
   }
 }
 
+void eeg_filters_filter_block(eeg_filters_context_t *context, ads129x_frontal_sample *samples, size_t n){
+  bool enable_line = context->enable_line_filters;
+  bool enable_az = context->enable_az_filters;
+  FILT_TYPE x[EEG_FILTERS_BLOCK_SIZE];
+  FILT_TYPE scratch[EEG_FILTERS_BLOCK_SIZE];
 
-
+  while(n > 0){
+    size_t len = (n < EEG_FILTERS_BLOCK_SIZE) ? n : EEG_FILTERS_BLOCK_SIZE;
+    // channel-major, each channel's filter state stays hot for the whole block
+    for(size_t i=0; i<MAX_NUM_EEG_FILTERS; i++){
+      for(size_t j=0; j<len; j++){
+        x[j] = samples[j].eeg_channels[i];
+      }
+      context->filters[i].filter_block(x, scratch, len, enable_line, enable_az);
+      for(size_t j=0; j<len; j++){
+        samples[j].eeg_channels[i] = x[j];
+      }
+    }
+    samples += len;
+    n -= len;
+  }
+}
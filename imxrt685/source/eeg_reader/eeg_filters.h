@@ -25,6 +25,9 @@ extern "C" {
 #define FILT_TYPE float
 #define MAX_FILT_ORDER 14
 
+// Samples per channel filtered at a time by eeg_filters_filter_block().
+#define EEG_FILTERS_BLOCK_SIZE 16
+
 
 typedef struct
 {
@@ -39,6 +42,8 @@ void eeg_filters_enable_az_filter(eeg_filters_context_t *context, bool enable);
 void eeg_filters_config_line_filter(eeg_filters_context_t *context, int order, double cutOffFreq,  double sampFreq=250, bool resetCache = true);
 void eeg_filters_config_az_filter(eeg_filters_context_t *context, int order, double cutOffFreq, double sampFreq=250, bool resetCache = true);
 void eeg_filters_filter(eeg_filters_context_t *context, ads129x_frontal_sample *sample);
+// Filter n consecutive samples in place, same result as eeg_filters_filter() on each.
+void eeg_filters_filter_block(eeg_filters_context_t *context, ads129x_frontal_sample *samples, size_t n);
 
 #ifdef __cplusplus
 }
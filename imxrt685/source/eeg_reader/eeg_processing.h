@@ -32,6 +32,8 @@
 #include "HistoryVar.h"
 #include "eeg_constants.h"
 #include "ml.h"
+#include "profiler.h"
+#include "stim_scheduler.h"
 
 //static const char *TAG = "eeg_proc";  // Logging prefix for this module
 
@@ -157,6 +159,9 @@ public:
     echt0.setCntrl(fft_size, filter_order, center_freq, low_freq, high_freq, input_scale, sample_freq);
     echt1.setCntrl(fft_size, filter_order, center_freq, low_freq, high_freq, input_scale, sample_freq);
     echt2.setCntrl(fft_size, filter_order, center_freq, low_freq, high_freq, input_scale, sample_freq);
+#if (defined(ENABLE_STIM_SCHEDULER) && (ENABLE_STIM_SCHEDULER > 0U))
+    stim_scheduler_config(center_freq, low_freq, high_freq);
+#endif
   }
 
   void echt_set_channel(eeg_channel_t channel_number){
@@ -170,6 +175,11 @@ public:
 
   void echt_enable(bool enable){
     enable_echt = enable;
+#if (defined(ENABLE_STIM_SCHEDULER) && (ENABLE_STIM_SCHEDULER > 0U))
+    if (!enable) {
+      stim_scheduler_cancel();
+    }
+#endif
   }
 
   void echt_set_min_max_phase(float min_rad, float max_rad){
@@ -431,11 +441,35 @@ public:
 
 public:
   void process(ads129x_frontal_sample* f_sample){
+    PROFILER_SCOPE(EEG_PROCESS);
+
 #if (defined(ENABLE_EEG_FILTERS) && (ENABLE_EEG_FILTERS > 0U))
     // filter the EEG data
+    PROFILER_BEGIN(EEG_FILTERS);
     eeg_filters_filter( &filters, f_sample);
+    PROFILER_END(EEG_FILTERS);
 #endif //ENABLE_EEG_FILTERS
 
+    process_filtered(f_sample);
+  }
+
+  // Process n consecutive samples, same result as calling process() on each.
+  // The filters run across the whole block; logging, RMS, quality and the
+  // ECHT/stimulus decision still run sample by sample, in order.
+  void process_block(ads129x_frontal_sample* f_samples, size_t n){
+    PROFILER_SCOPE(EEG_PROCESS_BLOCK);
+
+#if (defined(ENABLE_EEG_FILTERS) && (ENABLE_EEG_FILTERS > 0U))
+    eeg_filters_filter_block( &filters, f_samples, n);
+#endif //ENABLE_EEG_FILTERS
+
+    for(size_t i=0; i<n; i++){
+      process_filtered(&f_samples[i]);
+    }
+  }
+
+private:
+  void process_filtered(ads129x_frontal_sample* f_sample){
     data_log_eeg( f_sample );
 
     // send ML input data
@@ -454,12 +488,17 @@ public:
       data_log_stimulus_amplitude(f_sample->eeg_sample_number,stim_amp.get());
     }
 
+    PROFILER_BEGIN(EEG_RMS);
     compute_instRMS(f_sample->eeg_channels);
+    PROFILER_END(EEG_RMS);
 
+    PROFILER_BEGIN(EEG_QUALITY);
     eegtest.run( f_sample, instRMS );
+    PROFILER_END(EEG_QUALITY);
 
     // compute ECHT
   #if (defined(ECHT_ENABLE) && (ECHT_ENABLE > 0U))
+    PROFILER_BEGIN(EEG_ECHT);
     // always add data to echt, so it is primed when we turn it on.
     // add the sample to the ecHT algorithm
     echt0.addData( f_sample->eeg_channels[0] );
@@ -562,6 +601,32 @@ public:
 
       triggered_sample_count++;
 
+#if (defined(ENABLE_STIM_SCHEDULER) && (ENABLE_STIM_SCHEDULER > 0U))
+      // eeg_sample_number is micros() at DRDY
+      if(echt_chnum.changed()){
+        stim_scheduler_restart();
+      }
+      stim_scheduler_add_phase(f_sample->eeg_sample_number, inst_phs);
+
+      // the scheduler starts the pulse at the predicted start phase (alarm
+      // unmute, or the stim player splice), log it and end it here
+      if ( stim_scheduler_take_pulse() ) {
+        pink_is_playing = true;
+        triggered_sample_count = 0;
+        data_log_pulse(f_sample->eeg_sample_number, true);
+      }else if ( triggered_sample_count > triggered_sample_count_reset ) {
+        if(pink_is_playing){
+          pink_is_playing = false;
+          audio_pink_mute(true);
+          data_log_pulse(f_sample->eeg_sample_number, false);
+        }
+      }
+
+      if (!pink_is_playing){
+        stim_scheduler_arm(pulse_start_phase + pulse_phase_offset, pulse_stop_phase - pulse_start_phase);
+      }
+#else
+
         //  LOGV(TAG, "%d %d", pulse_trig_prev, pulse_trig_curr);
         // TODO: Replace the gating of audio with a mixer-style volume control
         if ( pulse_trig.F2T() ) {
@@ -585,9 +650,11 @@ public:
             data_log_pulse(f_sample->eeg_sample_number, false);
           }
         }
+#endif // ENABLE_STIM_SCHEDULER
 
     } //  if(enable_echt)
 
+    PROFILER_END(EEG_ECHT);
   #endif
   }
 
@@ -30,7 +30,10 @@
 
 #include "data_log.h"
 #include "erp.h"
+#include "erp_average.h"
 #include "memman_rtos.h"
+#include "profiler.h"
+#include "spsc_ring.h"
 
 
 #if (defined(ENABLE_EEG_PROCESSOR_TASK) && (ENABLE_EEG_PROCESSOR_TASK > 0U))
@@ -38,6 +41,16 @@
 #define EEG_PROCESSOR_EVENT_QUEUE_SIZE (100) // 100
 #define EEG_PROCESSOR_EVENT_MEMORY_SIZE (1000)
 
+// EEG samples are handed over from the DRDY ISR through a lock-free ring.
+// The task is woken once every EEG_PROCESSOR_SAMPLES_PER_WAKEUP samples and
+// drains everything in the ring, passing the samples to
+// EEGProcessing::process_block() in batches. Must be a power of two,
+// 64 samples = 256 ms.
+#define EEG_PROCESSOR_SAMPLE_RING_SIZE (64)
+#ifndef EEG_PROCESSOR_SAMPLES_PER_WAKEUP
+#define EEG_PROCESSOR_SAMPLES_PER_WAKEUP (1U)
+#endif
+
 static const char *TAG = "eeg_processor";  // Logging prefix for this module
 
 //
@@ -145,8 +158,15 @@ static mm_rtos_t g_event_memory;
 
 #define PROC_MALLOC(X) ((X*)mm_rtos_malloc(&g_event_memory,sizeof(X),portMAX_DELAY))
 
+// ISR to task sample ring
+static ads129x_frontal_sample g_sample_ring_buf[EEG_PROCESSOR_SAMPLE_RING_SIZE];
+static spsc_ring_t g_sample_ring;
+static uint32_t g_samples_since_wakeup = 0;     // ISR only
+static volatile bool g_wakeup_pending = false;  // set by the ISR, cleared by the task
+static uint32_t g_reported_overruns = 0;
 
-static void eeg_processor_receive_eeg_data(void* data);
+static void eeg_processor_receive_eeg_samples(void);
+static void eeg_processor_receive_eeg_data(ads129x_frontal_sample* f_samples, size_t n);
 
 
 // For logging and debug:
@@ -367,7 +387,7 @@ handle_event(eeg_processor_event_t *event)
   // handle stateless events
   switch (event->type) {
   case EEG_PROCESSOR_EVENT_EEG_MSG_AVAIL:
-    eeg_processor_receive_eeg_data(event->user_data);
+    eeg_processor_receive_eeg_samples();
     return;
 
   case EEG_PROCESSOR_EVENT_INIT:
@@ -501,6 +521,9 @@ eeg_processor_pretask_init(void)
   // Create the event memory
   mm_rtos_init( &g_event_memory, g_event_memory_buf, sizeof(g_event_memory_buf) );
 
+  // Create the sample ring
+  spsc_ring_init(&g_sample_ring, EEG_PROCESSOR_SAMPLE_RING_SIZE);
+
   // Design filters
   g_eeg_processor_context.eegp.filters_init();
 
@@ -530,6 +553,9 @@ task_init()
   // Any post-scheduler init goes here.
   g_eeg_processor_task_handle = xTaskGetCurrentTaskHandle();
 
+  // A batch has as many sample periods to finish as it holds samples.
+  profiler_set_deadline_us(PROF_EEG_PROCESSOR, PROFILER_EEG_DEADLINE_US*EEG_PROCESSOR_SAMPLES_PER_WAKEUP);
+
   LOGV(TAG, "Task launched. Entering event loop.");
 }
 
@@ -557,57 +583,70 @@ eeg_processor_task(void *ignored)
   }
 }
 
-uint8_t* eeg_processor_send_eeg_data_open_from_isr(size_t data_len, BaseType_t *pxHigherPriorityTaskWoken){
-  configASSERT(data_len == EEG_MSG_LEN);
-  uint8_t* malloc_data = NULL;
-  if (g_eeg_processor_task_handle != NULL){
-    malloc_data = ((uint8_t*) mm_rtos_malloc_from_isr(&g_event_memory,EEG_MSG_LEN,pxHigherPriorityTaskWoken));
+ads129x_frontal_sample* eeg_processor_eeg_sample_open_from_isr(void){
+  if (g_eeg_processor_task_handle == NULL){
+    return NULL;
   }
-  return malloc_data;
+  int32_t slot = spsc_ring_write_slot(&g_sample_ring);
+  return (slot < 0) ? NULL : &g_sample_ring_buf[slot];
 }
 
-void eeg_processor_send_eeg_data_close_from_isr(uint8_t* data, size_t data_len, BaseType_t *pxHigherPriorityTaskWoken) {
-  configASSERT(data_len == EEG_MSG_LEN);
-  if( data != NULL ){
-    eeg_processor_event_t event = {.type = EEG_PROCESSOR_EVENT_EEG_MSG_AVAIL, .user_data = data};
-    xQueueSendFromISR(g_event_queue, &event, pxHigherPriorityTaskWoken);
+void eeg_processor_eeg_sample_close_from_isr(BaseType_t *pxHigherPriorityTaskWoken){
+  spsc_ring_write_commit(&g_sample_ring);
+
+  // One wakeup event at a time, the task drains the whole ring per event.
+  if (++g_samples_since_wakeup >= EEG_PROCESSOR_SAMPLES_PER_WAKEUP && !g_wakeup_pending){
+    g_samples_since_wakeup = 0;
+    g_wakeup_pending = true;
+    eeg_processor_event_t event = {.type = EEG_PROCESSOR_EVENT_EEG_MSG_AVAIL, .user_data = NULL};
+    if (xQueueSendFromISR(g_event_queue, &event, pxHigherPriorityTaskWoken) != pdPASS){
+      g_wakeup_pending = false;
+    }
   }
 }
 
-static void eeg_processor_receive_eeg_data(void* data) {
-  uint8_t* eegRxData = (uint8_t*) data;
+static void eeg_processor_receive_eeg_samples(void) {
+  // Clear before draining, a sample committed after this sends a new event.
+  g_wakeup_pending = false;
 
-  if (data == NULL) {
-    return;
+  int32_t slot;
+  uint32_t n;
+  while ((n = spsc_ring_read_span(&g_sample_ring, &slot)) > 0) {
+    eeg_processor_receive_eeg_data(&g_sample_ring_buf[slot], n);
+    spsc_ring_read_release_n(&g_sample_ring, n);
   }
 
-#if (defined(USE_3CHANNEL_EEG) && (USE_3CHANNEL_EEG > 0U))
-  ads129x_frontal_sample f_sample;
-  ads_decode_frontal_sample(eegRxData, EEG_MSG_LEN, &f_sample);
-#else
-  ads129x_frontal_sample f_sample;
-  {
-    ads129x_sample sample;
-    ads_decode_sample(eegRxData, sizeof( eegRxData ), &sample);
-    // rearrange sampled data relative to electrodes
-//    f_sample.timestamp_ms = sample.timestamp_ms;
-    f_sample.eeg_sample_number = sample.eeg_sample_number;
-//    f_sample.status = sample.status;
-    f_sample.eeg_channels[EEG_FP1] = sample.eeg_channels[EEG_CH2]; // fp1
-    f_sample.eeg_channels[EEG_FPZ] = sample.eeg_channels[EEG_CH4]; // fpz
-    f_sample.eeg_channels[EEG_FP2] = sample.eeg_channels[EEG_CH1]; // fp2
-
-//    eeg_quality_compute( &sample );
+  uint32_t overruns = g_sample_ring.overruns;
+  if (overruns != g_reported_overruns) {
+    LOGW(TAG, "EEG sample ring overrun, %lu samples dropped (%lu total)",
+        (unsigned long)(overruns - g_reported_overruns), (unsigned long) overruns);
+    g_reported_overruns = overruns;
   }
-#endif
+}
+
+uint32_t eeg_processor_get_sample_overruns(void){
+  return g_sample_ring.overruns;
+}
+
+static void eeg_processor_receive_eeg_data(ads129x_frontal_sample* f_samples, size_t n) {
+  PROFILER_SCOPE(EEG_PROCESSOR);
 
 #if 1
-  g_eeg_processor_context.eegp.process(&f_sample);
+  if (n == 1) {
+    g_eeg_processor_context.eegp.process(f_samples);
+  } else {
+    g_eeg_processor_context.eegp.process_block(f_samples, n);
+  }
 #else
-  data_log_eeg(f_sample);
+  for (size_t i = 0; i < n; i++) {
+    data_log_eeg(&f_samples[i]);
+  }
 #endif
 
-  erp_set_eeg_sample_number(f_sample.eeg_sample_number);
+  for (size_t i = 0; i < n; i++) {
+    erp_average_add_sample(&f_samples[i]);
+  }
+  erp_set_eeg_sample_number(f_samples[n-1].eeg_sample_number);
 }
 
 #else /*  (defined(ENABLE_EEG_PROCESSOR_TASK) && (ENABLE_EEG_PROCESSOR_TASK > 0U)) */
@@ -615,15 +654,9 @@ static void eeg_processor_receive_eeg_data(void* data) {
 void eeg_processor_pretask_init(void){}
 void eeg_processor_task(void *ignored){}
 
-static uint8_t eeg_data[EEG_MSG_LEN] = {0};
-uint8_t* eeg_processor_send_eeg_data_open_from_isr(size_t data_len, BaseType_t *pxHigherPriorityTaskWoken){
-	configASSERT(data_len == EEG_MSG_LEN);
-	return eeg_data;
-}
-
-void eeg_processor_send_eeg_data_close_from_isr(uint8_t* data, size_t data_len, BaseType_t *pxHigherPriorityTaskWoken){
-	configASSERT(data_len == EEG_MSG_LEN);
-}
+ads129x_frontal_sample* eeg_processor_eeg_sample_open_from_isr(void){ return NULL; }
+void eeg_processor_eeg_sample_close_from_isr(BaseType_t *pxHigherPriorityTaskWoken){}
+uint32_t eeg_processor_get_sample_overruns(void){ return 0; }
 
 void eeg_processor_init(void){}
 
@@ -33,8 +33,12 @@ void eeg_processor_pretask_init(void);
 
 void eeg_processor_task(void *ignored);
 
-uint8_t* eeg_processor_send_eeg_data_open_from_isr(size_t data_len, BaseType_t *pxHigherPriorityTaskWoken);
-void eeg_processor_send_eeg_data_close_from_isr(uint8_t* data, size_t data_len, BaseType_t *pxHigherPriorityTaskWoken);
+// Called from the EEG DRDY ISR. open returns the next free sample slot, or
+// NULL if the ring is full (counted as an overrun) or the task is not running.
+// A non-NULL slot must be filled and handed over with close.
+ads129x_frontal_sample* eeg_processor_eeg_sample_open_from_isr(void);
+void eeg_processor_eeg_sample_close_from_isr(BaseType_t *pxHigherPriorityTaskWoken);
+uint32_t eeg_processor_get_sample_overruns(void);
 
 void eeg_processor_init(void);
 
@@ -73,11 +73,11 @@ private:
       // float eeg_scaled = eeg[i]*EEG_SCALAR;
 
       uint8_t ei = electrode_index[i];
-      if (instRMS[i] < 1.0f){ /*supposed to be 1.1220184543f*/
+      if (instRMS[i] < EEG_QUALITY_NO_SIGNAL_UV){
         electrode_quality[ei] = ELECTRODE_QUALITY_NO_SIGNAL;
-      } else if ( instRMS[i] < 5.0f) { /*supposed to be 1.77827941004f*/
+      } else if ( instRMS[i] < EEG_QUALITY_WEAK_SIGNAL_UV) {
         electrode_quality[ei] = ELECTRODE_QUALITY_WEAK_SIGNAL;
-      } else if ( instRMS[i] <= 500.0f) {
+      } else if ( instRMS[i] <= EEG_QUALITY_ARTIFACT_UV) {
         electrode_quality[ei] = ELECTRODE_QUALITY_GOOD_SIGNAL;
       } else {
         electrode_quality[ei] = ELECTRODE_QUALITY_ARTIFACT;
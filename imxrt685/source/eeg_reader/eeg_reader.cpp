@@ -620,18 +620,34 @@ static void eeg_spi_rx_complete_isr(SPI_Type *base, spi_master_handle_t *handle,
 
 static void arrange_and_send_eeg_channels_from_isr(BaseType_t *pxHigherPriorityTaskWoken){
   BaseType_t xHigherPriorityTaskWoken1 = pdFALSE;
-  BaseType_t xHigherPriorityTaskWoken2 = pdFALSE;
   BaseType_t xHigherPriorityTaskWoken3 = pdFALSE;
   BaseType_t xHigherPriorityTaskWoken4 = pdFALSE;
   uint32_t eeg_sample_num = 0;
 
-  // decode
+  // skip timestamp, copy off sample number
+  memcpy(&eeg_sample_num,g_spi_bytes+4,SAMPLE_NUMBER_SIZE_IN_BYTES);
+
 #if (defined(ENABLE_EEG_PROCESSOR_TASK) && (ENABLE_EEG_PROCESSOR_TASK > 0U))
-  uint8_t* buffer = eeg_processor_send_eeg_data_open_from_isr(EEG_MSG_LEN, &xHigherPriorityTaskWoken1);
+  // decode straight into the processor's sample ring
+  ads129x_frontal_sample* f_sample = eeg_processor_eeg_sample_open_from_isr();
+  if(f_sample != NULL){
+    // skip timestamp, sample number and status
+    const uint8_t* channels = g_spi_bytes + 4 + 4 + 3;
+    f_sample->eeg_sample_number = eeg_sample_num;
+#if defined(VARIANT_FF2)
+    f_sample->eeg_channels[EEG_FP1] = ads_decode_channel(channels+EEG_CH2*3);
+    f_sample->eeg_channels[EEG_FPZ] = ads_decode_channel(channels+EEG_CH4*3);
+    f_sample->eeg_channels[EEG_FP2] = ads_decode_channel(channels+EEG_CH1*3);
+#elif defined(VARIANT_FF3) || defined(VARIANT_FF4)
+    f_sample->eeg_channels[EEG_FP1] = ads_decode_channel(channels+EEG_CH2*3);
+    f_sample->eeg_channels[EEG_FPZ] = ads_decode_channel(channels+EEG_CH1*3);
+    f_sample->eeg_channels[EEG_FP2] = ads_decode_channel(channels+EEG_CH3*3);
+#endif
+    eeg_processor_eeg_sample_close_from_isr(&xHigherPriorityTaskWoken1);
+  }
 #else
   eeg_reader_event_t event = {.type = EEG_READER_EVENT_EEG_SAMPLE};
   static uint8_t* buffer = event.data.eeg_buffer;
-#endif
   if(buffer != NULL){
     size_t src_offset = 0;
     size_t dst_offset = 0;
@@ -639,7 +655,6 @@ static void arrange_and_send_eeg_channels_from_isr(BaseType_t *pxHigherPriorityT
     src_offset += 4;
     // copy off sample number
     memcpy(buffer+dst_offset,g_spi_bytes+src_offset,SAMPLE_NUMBER_SIZE_IN_BYTES);
-    memcpy(&eeg_sample_num,g_spi_bytes+src_offset,SAMPLE_NUMBER_SIZE_IN_BYTES);
     src_offset += 4;
     dst_offset += 4;
     // skip status
@@ -666,12 +681,9 @@ static void arrange_and_send_eeg_channels_from_isr(BaseType_t *pxHigherPriorityT
     dst_offset += 3;
 #endif
 
-#if (defined(ENABLE_EEG_PROCESSOR_TASK) && (ENABLE_EEG_PROCESSOR_TASK > 0U))
-    eeg_processor_send_eeg_data_close_from_isr( buffer , EEG_MSG_LEN , &xHigherPriorityTaskWoken2 );
-#else
     xQueueSendFromISR(g_event_queue, &event, &xHigherPriorityTaskWoken3);
-#endif
   }
+#endif
 
   // Send skin temperature
 #if defined(VARIANT_FF3) || defined(VARIANT_FF4)
@@ -697,7 +709,7 @@ static void arrange_and_send_eeg_channels_from_isr(BaseType_t *pxHigherPriorityT
   }
 #endif
 
-  *pxHigherPriorityTaskWoken = xHigherPriorityTaskWoken1 || xHigherPriorityTaskWoken2 || xHigherPriorityTaskWoken3 || xHigherPriorityTaskWoken4;
+  *pxHigherPriorityTaskWoken = xHigherPriorityTaskWoken1 || xHigherPriorityTaskWoken3 || xHigherPriorityTaskWoken4;
 }
 
 void handle_skin_temp_sample(eeg_reader_event_t *event) {
@@ -0,0 +1,61 @@
+# Build the EEG replay tool on the host and run it on a data log file:
+#   ./build-and-run.sh <data log file> [eeg_replay options] > replay.csv
+# The board variant defaults to VARIANT_FF4, see imxrt685/makefile.defs.
+# Current data logs are COBSR/RLE0 framed, set COBS_MODE=PLAIN for the older
+# sample logs used by data_log/offline.
+set -x
+
+SRC=../..
+VARIANT=${VARIANT:-VARIANT_FF4}
+COBS_MODE=${COBS_MODE:-RLE0}
+
+# data log parser, built with its own offline headers
+gcc -c \
+ $SRC/data_log/offline/data_log_parse.c \
+ $SRC/data_log/offline/cobs_stream.c \
+ $SRC/heatshrink/heatshrink_decoder.c \
+ $SRC/../../common/interface/cobs.c \
+ -I $SRC/heatshrink/ \
+ -I $SRC/../../common/interface/ \
+ -I $SRC/compression/ \
+ -I $SRC/data_log/offline/ \
+ -DDL_PARSER_OFFLINE=1 \
+ -DDL_PARSER_QUIET=1 \
+ -DCOBS_MODE_$COBS_MODE=1 && \
+gcc -c -O2 -D$VARIANT -DPROFILER_HOST \
+ shim/powerquad_shim.c \
+ $SRC/signal_processing/iir.c \
+ $SRC/utils/fast_math.c \
+ $SRC/utils/profiler.c \
+ -I shim \
+ -I $SRC/signal_processing \
+ -I $SRC/utils \
+ -I $SRC/../CMSIS \
+ -I $SRC/../CMSIS/DSP/Include && \
+g++ -c -O2 -D$VARIANT -DPROFILER_HOST \
+ eeg_replay.cpp \
+ shim/firmware_stubs.cpp \
+ $SRC/compression/COBSR.cpp \
+ $SRC/compression/COBSR_RLE0.cpp \
+ $SRC/eeg_reader/eeg_filters.cpp \
+ $SRC/signal_processing/math_util.cpp \
+ -I . \
+ -I shim \
+ -I $SRC/compression \
+ -I $SRC/eeg_reader \
+ -I $SRC/signal_processing \
+ -I $SRC/utils \
+ -I $SRC/ble \
+ -I $SRC/interpreter \
+ -I $SRC/audio \
+ -I $SRC/data_log \
+ -I $SRC/config \
+ -I $SRC/../fatfs \
+ -I $SRC/../CMSIS \
+ -I $SRC/../CMSIS/DSP/Include && \
+g++ -o eeg_replay *.o -lm && \
+rm *.o && \
+./eeg_replay "${@:2}" "$1"
+
+# cleanup
+rm ./eeg_replay
@@ -0,0 +1,198 @@
+/*
+ * eeg_replay.cpp
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Replays raw EEG from a data log file through the firmware
+ * EEG processing chain (EEGProcessing, same filters, ECHT and stimulus
+ * logic) on the host. The processor is configured the way
+ * eeg_processor_pretask_init() and the default therapy script configure it.
+ *
+ * Output is one CSV line per sample on stdout:
+ *   sample_number, filtered fp1/fpz/fp2 (counts), echt_channel,
+ *   inst_amp, inst_phs (rad), stim_on, stim_amp, pink_muted, pulse, process_us
+ *
+ * Usage: eeg_replay [options] <data log file>
+ *   -c <hz>        ECHT center frequency (default 10)
+ *   -p <min,max>   stimulation phase window in degrees (default 134,224)
+ *   -n             disable the alpha/channel switch (default enabled, 5 10 1 2 6)
+ *   -e             run with ECHT stopped (filters, RMS and quality only)
+ *   -b <n>         process blocks of n samples with process_block() (default 1,
+ *                  process() per sample); process_us is the block time / n
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "eeg_processing.h"
+#include "eeg_replay.h"
+#include "../../data_log/offline/data_log_parse.h" // not data_log/data_log_parse.h
+
+static EEGProcessing g_eegp;
+
+static ads129x_frontal_sample g_block[EEG_REPLAY_MAX_BLOCK];
+static size_t g_block_len = 0;
+static size_t g_block_size = 1;
+
+static unsigned long g_num_samples = 0;
+static double g_total_us = 0;
+static double g_max_us = 0;
+
+static double
+now_us(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void
+process_block(void)
+{
+  if (g_block_len == 0) {
+    return;
+  }
+
+  eeg_replay_begin_block();
+
+  double start_us = now_us();
+  if (g_block_size == 1) {
+    g_eegp.process(&g_block[0]);
+  } else {
+    g_eegp.process_block(g_block, g_block_len);
+  }
+  double process_us = (now_us() - start_us) / g_block_len;
+
+  for (size_t i = 0; i < g_block_len; i++) {
+    const ads129x_frontal_sample* f_sample = &g_block[i];
+    const eeg_replay_frame_t* frame = &g_replay_frames[i];
+
+    g_num_samples++;
+    g_total_us += process_us;
+    if (process_us > g_max_us) {
+      g_max_us = process_us;
+    }
+
+    printf("%lu,%ld,%ld,%ld,%u,", f_sample->eeg_sample_number,
+        (long) f_sample->eeg_channels[EEG_FP1],
+        (long) f_sample->eeg_channels[EEG_FPZ],
+        (long) f_sample->eeg_channels[EEG_FP2],
+        (unsigned) frame->echt_channel);
+    if (frame->echt_valid) {
+      printf("%f,%f,", frame->inst_amp, frame->inst_phs);
+    } else {
+      printf(",,");
+    }
+    printf("%d,%f,%d,%d,%.1f\n",
+        frame->stim_on,
+        frame->stim_amp,
+        frame->pink_muted,
+        frame->pulse,
+        process_us);
+  }
+  g_block_len = 0;
+}
+
+static void
+replay_sample(unsigned long sample_number, const int32_t* eeg)
+{
+  ads129x_frontal_sample* f_sample = &g_block[g_block_len++];
+  memset(f_sample, 0, sizeof(*f_sample));
+  f_sample->eeg_sample_number = sample_number;
+  for (uint8_t i = 0; i < MAX_NUM_EEG_CHANNELS; i++) {
+    f_sample->eeg_channels[i] = eeg[i];
+  }
+
+  if (g_block_len == g_block_size) {
+    process_block();
+  }
+}
+
+static void
+usage(const char* name)
+{
+  fprintf(stderr, "usage: %s [-c center_hz] [-p min_deg,max_deg] [-n] [-e] [-b block_size] <data log file>\n", name);
+}
+
+int main(int argc, char** argv)
+{
+  float center_freq = 10;
+  float min_phase_deg = 134;
+  float max_phase_deg = 224;
+  bool alpha_switch = true;
+  bool echt = true;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "c:p:neb:")) != -1) {
+    switch (opt) {
+      case 'c':
+        center_freq = atof(optarg);
+        break;
+      case 'p':
+        if (sscanf(optarg, "%f,%f", &min_phase_deg, &max_phase_deg) != 2) {
+          usage(argv[0]);
+          return 1;
+        }
+        break;
+      case 'n':
+        alpha_switch = false;
+        break;
+      case 'e':
+        echt = false;
+        break;
+      case 'b':
+        g_block_size = atoi(optarg);
+        if (g_block_size < 1 || g_block_size > EEG_REPLAY_MAX_BLOCK) {
+          usage(argv[0]);
+          return 1;
+        }
+        break;
+      default:
+        usage(argv[0]);
+        return 1;
+    }
+  }
+  if (optind >= argc) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  // eeg_processor_pretask_init()
+  g_eegp.filters_init();
+
+  // echt_config_simple, see eeg_processor_config_echt_simple()
+  int fft_size = 128;
+  int filter_order = 2;
+  float low_freq = center_freq-(center_freq/4);
+  float high_freq = center_freq+(center_freq/4);
+  float input_scale = -1;
+  float sample_freq = 250;
+  g_eegp.echt_config(fft_size, filter_order, center_freq, low_freq, high_freq, input_scale, sample_freq);
+  g_eegp.echt_set_init_channel(EEG_FP1);
+
+  // therapy_enable_alpha_switch / therapy_config_alpha_switch
+  g_eegp.channel_switch_enable(alpha_switch);
+  g_eegp.set_params(5, 10, 1, 2, 6);
+
+  // echt_set_min_max_phase / echt_start
+  double deg2rad_multiplier = 0.01745329251;
+  g_eegp.echt_set_min_max_phase(min_phase_deg*deg2rad_multiplier, max_phase_deg*deg2rad_multiplier);
+  g_eegp.echt_enable(echt);
+
+  printf("sample_number,fp1,fpz,fp2,echt_channel,inst_amp,inst_phs,stim_on,stim_amp,pink_muted,pulse,process_us\n");
+
+  data_log_parse_set_eeg_cb(replay_sample);
+  data_log_parse(argv[optind]);
+  process_block();
+
+  if (g_num_samples > 0) {
+    fprintf(stderr, "%lu samples, process mean %.1f us, max %.1f us\n",
+        g_num_samples, g_total_us / g_num_samples, g_max_us);
+  } else {
+    fprintf(stderr, "no EEG samples found in %s\n", argv[optind]);
+  }
+  return 0;
+}
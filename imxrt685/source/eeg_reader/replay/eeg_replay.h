@@ -0,0 +1,45 @@
+/*
+ * eeg_replay.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: State captured from the firmware hooks (data log, audio)
+ * that EEGProcessing::process() calls while replaying a sample.
+ *
+ * Each call to data_log_eeg() starts the frame of the next sample, so one
+ * EEGProcessing::process_block() call fills one frame per sample.
+ */
+
+#ifndef EEG_REPLAY_H_
+#define EEG_REPLAY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define EEG_REPLAY_MAX_BLOCK (64)
+
+typedef struct {
+  // set by data_log_inst_amp_phs(), only while ECHT is running
+  bool echt_valid;
+  float inst_amp;
+  float inst_phs;
+
+  // last values logged by the firmware
+  uint8_t echt_channel;
+  bool stim_on;
+  float stim_amp;
+  float pink_volume;
+  bool pink_muted;
+
+  // data_log_pulse() this sample: 1 start, 0 stop, -1 none
+  int pulse;
+} eeg_replay_frame_t;
+
+// Frames of the samples processed since eeg_replay_begin_block().
+extern eeg_replay_frame_t g_replay_frames[EEG_REPLAY_MAX_BLOCK];
+extern size_t g_replay_num_frames;
+
+void eeg_replay_begin_block(void);
+
+#endif /* EEG_REPLAY_H_ */
@@ -0,0 +1,27 @@
+/*
+ * FreeRTOS.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host replay shim. Only what the EEG processing chain and the
+ * headers it pulls in need to compile; there is no scheduler on the host.
+ */
+
+#ifndef EEG_REPLAY_SHIM_FREERTOS_H_
+#define EEG_REPLAY_SHIM_FREERTOS_H_
+
+#include <assert.h>
+#include <stdint.h>
+
+typedef unsigned long TickType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef void* TaskHandle_t;
+
+#define pdTRUE  (1)
+#define pdFALSE (0)
+#define portMAX_DELAY ((TickType_t) 0xffffffffUL)
+
+#define configASSERT(x) assert(x)
+
+#endif /* EEG_REPLAY_SHIM_FREERTOS_H_ */
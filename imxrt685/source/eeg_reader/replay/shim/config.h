@@ -0,0 +1,22 @@
+/*
+ * config.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host replay shim for config/config.h. The EEG processing
+ * chain depends on the board variant, which build-and-run.sh passes on the
+ * command line the same way makefile.defs does for the firmware, and on the
+ * feature flags below, which must match config/config.h.
+ */
+
+#ifndef EEG_REPLAY_SHIM_CONFIG_H_
+#define EEG_REPLAY_SHIM_CONFIG_H_
+
+#if !defined(VARIANT_FF2) && !defined(VARIANT_FF3) && !defined(VARIANT_FF4)
+#error "Define the board variant, e.g. -DVARIANT_FF4"
+#endif
+
+// Same default as config/config.h.
+#define ENABLE_STIM_SCHEDULER (0U)
+
+#endif /* EEG_REPLAY_SHIM_CONFIG_H_ */
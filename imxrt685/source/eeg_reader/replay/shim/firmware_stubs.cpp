@@ -0,0 +1,86 @@
+/*
+ * firmware_stubs.cpp
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host replacements for the firmware functions the EEG
+ * processing chain calls. Stimulus decisions and ECHT outputs are captured
+ * into g_replay_frames instead of being logged or sent to the audio task.
+ */
+
+#include "data_log.h"
+#include "audio_task.h"
+#include "ble.h"
+#include "interpreter.h"
+#include "ml.h"
+#include "eeg_replay.h"
+
+// Matches the state EEGProcessing::init() starts from
+static eeg_replay_frame_t g_last_frame = {
+  false, 0, 0,      // echt_valid, inst_amp, inst_phs
+  0, true, 1,       // echt_channel, stim_on, stim_amp
+  1, true,          // pink_volume, pink_muted
+  -1,               // pulse
+};
+
+eeg_replay_frame_t g_replay_frames[EEG_REPLAY_MAX_BLOCK];
+size_t g_replay_num_frames = 0;
+
+// Frame of the sample being processed
+static eeg_replay_frame_t* g_frame = &g_last_frame;
+
+void eeg_replay_begin_block(void){
+  if (g_replay_num_frames > 0) {
+    g_last_frame = g_replay_frames[g_replay_num_frames-1];
+  }
+  g_replay_num_frames = 0;
+  g_frame = &g_last_frame;
+}
+
+// Called once per sample, before any of the hooks below.
+void data_log_eeg(ads129x_frontal_sample *f_sample){
+  if (g_replay_num_frames >= EEG_REPLAY_MAX_BLOCK) {
+    return;
+  }
+  eeg_replay_frame_t* frame = &g_replay_frames[g_replay_num_frames++];
+  *frame = *g_frame;
+  frame->echt_valid = false;
+  frame->pulse = -1;
+  g_frame = frame;
+}
+
+void data_log_inst_amp_phs(unsigned long eeg_sample_number, float instAmp, float instPhs){
+  g_frame->echt_valid = true;
+  g_frame->inst_amp = instAmp;
+  g_frame->inst_phs = instPhs;
+}
+
+void data_log_pulse(unsigned long eeg_sample_number, bool pulse){
+  g_frame->pulse = pulse ? 1 : 0;
+}
+
+void data_log_echt_channel(unsigned long eeg_sample_number, uint8_t echt_channel_number){
+  g_frame->echt_channel = echt_channel_number;
+}
+
+void data_log_stimulus_switch(unsigned long eeg_sample_number, bool stim_on){
+  g_frame->stim_on = stim_on;
+}
+
+void data_log_stimulus_amplitude(unsigned long eeg_sample_number, float stim_amp){
+  g_frame->stim_amp = stim_amp;
+}
+
+void audio_pink_computed_volume(float gain){
+  g_frame->pink_volume = gain;
+}
+
+void audio_pink_mute(bool mute){
+  g_frame->pink_muted = mute;
+}
+
+void ml_event_eeg_input(ads129x_frontal_sample* f_sample){}
+
+void ble_electrode_quality_update(uint8_t qualities[ELECTRODE_NUM]){}
+
+void interpreter_event_blink_detected(){}
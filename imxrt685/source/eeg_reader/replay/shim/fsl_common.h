@@ -0,0 +1,16 @@
+/*
+ * fsl_common.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host replay shim for the MCUXpresso SDK common header.
+ */
+
+#ifndef EEG_REPLAY_SHIM_FSL_COMMON_H_
+#define EEG_REPLAY_SHIM_FSL_COMMON_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#endif /* EEG_REPLAY_SHIM_FSL_COMMON_H_ */
@@ -0,0 +1,14 @@
+/*
+ * fsl_pint.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host replay shim, ads129x.h includes the pin interrupt driver.
+ */
+
+#ifndef EEG_REPLAY_SHIM_FSL_PINT_H_
+#define EEG_REPLAY_SHIM_FSL_PINT_H_
+
+#include "fsl_common.h"
+
+#endif /* EEG_REPLAY_SHIM_FSL_PINT_H_ */
@@ -0,0 +1,25 @@
+/*
+ * ml.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host replay shim. The real ml.h pulls in the Glow model
+ * bundle, the replay only needs the EEG input hook.
+ */
+
+#ifndef EEG_REPLAY_SHIM_ML_H_
+#define EEG_REPLAY_SHIM_ML_H_
+
+#include "eeg_datatypes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void ml_event_eeg_input(ads129x_frontal_sample* f_sample);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EEG_REPLAY_SHIM_ML_H_ */
@@ -0,0 +1,14 @@
+/*
+ * portmacro.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host replay shim, see FreeRTOS.h.
+ */
+
+#ifndef EEG_REPLAY_SHIM_PORTMACRO_H_
+#define EEG_REPLAY_SHIM_PORTMACRO_H_
+
+#include "FreeRTOS.h"
+
+#endif /* EEG_REPLAY_SHIM_PORTMACRO_H_ */
@@ -0,0 +1,97 @@
+/*
+ * powerquad_shim.c
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host replacement for signal_processing/powerquad_helper.c
+ * and the CMSIS-DSP RFFT init the ECHT calls.
+ *
+ * PQ_TransformRFFT in 32-bit fixed point returns the transform scaled by
+ * 1/fftLenReal as fftLenReal interleaved (re, im) bins, bin 0 first. This
+ * computes the same layout in double precision and rounds to the nearest
+ * integer, so results match the target to within the engine's internal
+ * rounding.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "powerquad_helper.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+arm_status arm_rfft_init_q31(arm_rfft_instance_q31 *S, uint32_t fftLenReal, uint32_t ifftFlagR, uint32_t bitReverseFlag)
+{
+  S->fftLenReal = fftLenReal;
+  S->ifftFlagR = (uint8_t) ifftFlagR;
+  S->bitReverseFlagR = (uint8_t) bitReverseFlag;
+  return ARM_MATH_SUCCESS;
+}
+
+static q31_t round_q31(double x)
+{
+  if (x >= 2147483647.0) {
+    return INT32_MAX;
+  }
+  if (x <= -2147483648.0) {
+    return INT32_MIN;
+  }
+  return (q31_t) lround(x);
+}
+
+void pqhelper_arm_rfft_q31(const arm_rfft_instance_q31 *S, q31_t *pSrc, q31_t *pDst)
+{
+  uint32_t n = S->fftLenReal;
+  double *re = malloc(n * sizeof(double));
+  double *im = malloc(n * sizeof(double));
+  if (re == NULL || im == NULL) {
+    free(re);
+    free(im);
+    return;
+  }
+
+  // bit-reversed copy, then an in-place radix-2 FFT (all ECHT sizes are powers of 2)
+  uint32_t bits = 0;
+  while ((1U << bits) < n) {
+    bits++;
+  }
+  for (uint32_t i = 0; i < n; i++) {
+    uint32_t r = 0;
+    for (uint32_t b = 0; b < bits; b++) {
+      r |= ((i >> b) & 1U) << (bits - 1 - b);
+    }
+    re[r] = pSrc[i];
+    im[r] = 0;
+  }
+
+  for (uint32_t len = 2; len <= n; len <<= 1) {
+    double ang = -2.0 * M_PI / len;
+    for (uint32_t i = 0; i < n; i += len) {
+      for (uint32_t j = 0; j < len / 2; j++) {
+        double wr = cos(ang * j);
+        double wi = sin(ang * j);
+        uint32_t a = i + j;
+        uint32_t b = i + j + len / 2;
+        double tr = re[b] * wr - im[b] * wi;
+        double ti = re[b] * wi + im[b] * wr;
+        re[b] = re[a] - tr;
+        im[b] = im[a] - ti;
+        re[a] += tr;
+        im[a] += ti;
+      }
+    }
+  }
+
+  for (uint32_t k = 0; k < n; k++) {
+    pDst[2*k] = round_q31(re[k] / n);
+    pDst[2*k+1] = round_q31(im[k] / n);
+  }
+
+  free(re);
+  free(im);
+}
+
+void pqhelper_init()
+{
+}
@@ -0,0 +1,16 @@
+/*
+ * semphr.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host replay shim, see FreeRTOS.h.
+ */
+
+#ifndef EEG_REPLAY_SHIM_SEMPHR_H_
+#define EEG_REPLAY_SHIM_SEMPHR_H_
+
+#include "FreeRTOS.h"
+
+typedef void* SemaphoreHandle_t;
+
+#endif /* EEG_REPLAY_SHIM_SEMPHR_H_ */
@@ -0,0 +1,14 @@
+/*
+ * task.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host replay shim, see FreeRTOS.h.
+ */
+
+#ifndef EEG_REPLAY_SHIM_TASK_H_
+#define EEG_REPLAY_SHIM_TASK_H_
+
+#include "FreeRTOS.h"
+
+#endif /* EEG_REPLAY_SHIM_TASK_H_ */
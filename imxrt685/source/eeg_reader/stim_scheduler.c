@@ -0,0 +1,249 @@
+/*
+ * stim_scheduler.c
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Phase-locked stimulus scheduler, see stim_scheduler.h.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "stim_scheduler.h"
+#include "config.h"
+
+#if (defined(ENABLE_STIM_SCHEDULER) && (ENABLE_STIM_SCHEDULER > 0U))
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "micro_clock.h"
+#include "audio_task.h"
+#include "phase_predictor.h"
+#if (defined(ENABLE_STIM_PLAYER) && (ENABLE_STIM_PLAYER > 0U))
+#include "stim_player.h"
+#endif
+
+// Only touched by the EEG processor task.
+static phase_predictor_t g_predictor;
+
+// Shared with the alarm ISR, updated inside critical sections on the task
+// side (the micro clock IRQ is below configMAX_SYSCALL_INTERRUPT_PRIORITY).
+static volatile bool g_armed = false;
+static volatile bool g_pulse_pending = false;
+static volatile uint32_t g_target_us = 0;
+static stim_scheduler_stats_t g_stats;
+
+void
+stim_scheduler_config(float center_hz, float low_hz, float high_hz)
+{
+  stim_scheduler_cancel();
+  phase_predictor_init(&g_predictor, center_hz, low_hz, high_hz);
+}
+
+void
+stim_scheduler_restart(void)
+{
+  phase_predictor_reset(&g_predictor);
+}
+
+void
+stim_scheduler_add_phase(uint32_t sample_us, float inst_phs)
+{
+  phase_predictor_update(&g_predictor, sample_us, inst_phs);
+}
+
+#if (defined(ENABLE_STIM_PLAYER) && (ENABLE_STIM_PLAYER > 0U))
+
+// The player splices the pulse into the I2S buffer that plays at the
+// predicted crossing, no alarm needed.
+void
+stim_scheduler_arm(float target_phs, float window_rad)
+{
+  taskENTER_CRITICAL();
+  // a pulse still playing or not picked up yet, don't start another
+  if (stim_player_busy()) {
+    taskEXIT_CRITICAL();
+    return;
+  }
+
+  uint32_t now_us = (uint32_t) micros();
+  uint32_t delay_us = 0;
+  phase_predict_action_t action = phase_predictor_schedule(&g_predictor, now_us,
+      target_phs, window_rad, STIM_SCHEDULER_HORIZON_US, &delay_us);
+
+  if (action == PHASE_PREDICT_ARM) {
+    g_target_us = now_us + delay_us;
+    g_armed = true;
+    stim_player_schedule(g_target_us);
+  } else if (action == PHASE_PREDICT_NOW) {
+    // keep an earlier request, it is closer to the crossing
+    if (!g_armed) {
+      g_armed = true;
+      stim_player_schedule(now_us);
+      g_stats.late_pulses++;
+    }
+  } else if (g_armed) {
+    stim_player_cancel();
+    g_armed = false;
+  }
+  taskEXIT_CRITICAL();
+}
+
+void
+stim_scheduler_cancel(void)
+{
+  taskENTER_CRITICAL();
+  stim_player_cancel();
+  g_armed = false;
+  taskEXIT_CRITICAL();
+}
+
+bool
+stim_scheduler_take_pulse(void)
+{
+  taskENTER_CRITICAL();
+  bool pulse = stim_player_take_started();
+  if (pulse) {
+    g_armed = false;
+  }
+  taskEXIT_CRITICAL();
+  return pulse;
+}
+
+#else /* (defined(ENABLE_STIM_PLAYER) && (ENABLE_STIM_PLAYER > 0U)) */
+
+static void
+stim_scheduler_alarm_isr(void)
+{
+  if (!g_armed || g_pulse_pending) {
+    return;
+  }
+  audio_pink_pulse_from_isr();
+  g_armed = false;
+  g_pulse_pending = true;
+
+  uint32_t late_us = (uint32_t) micros() - g_target_us;
+  g_stats.timer_pulses++;
+  g_stats.total_isr_late_us += late_us;
+  if (late_us > g_stats.max_isr_late_us) {
+    g_stats.max_isr_late_us = late_us;
+  }
+}
+
+void
+stim_scheduler_arm(float target_phs, float window_rad)
+{
+  taskENTER_CRITICAL();
+  // a pulse the processor has not picked up yet, don't start another
+  if (g_pulse_pending) {
+    taskEXIT_CRITICAL();
+    return;
+  }
+
+  uint32_t now_us = (uint32_t) micros();
+  uint32_t delay_us = 0;
+  phase_predict_action_t action = phase_predictor_schedule(&g_predictor, now_us,
+      target_phs, window_rad, STIM_SCHEDULER_HORIZON_US, &delay_us);
+
+  if (action == PHASE_PREDICT_ARM) {
+    g_target_us = now_us + delay_us;
+    g_armed = true;
+    if (!micro_clock_alarm_arm(delay_us, stim_scheduler_alarm_isr)) {
+      // too close to arm, start it now
+      action = PHASE_PREDICT_NOW;
+    }
+  }
+
+  if (action == PHASE_PREDICT_NOW) {
+    micro_clock_alarm_cancel();
+    audio_pink_pulse_from_isr();
+    g_armed = false;
+    g_pulse_pending = true;
+    g_stats.late_pulses++;
+  } else if (action == PHASE_PREDICT_WAIT && g_armed) {
+    micro_clock_alarm_cancel();
+    g_armed = false;
+  }
+  taskEXIT_CRITICAL();
+}
+
+void
+stim_scheduler_cancel(void)
+{
+  taskENTER_CRITICAL();
+  micro_clock_alarm_cancel();
+  g_armed = false;
+  taskEXIT_CRITICAL();
+}
+
+bool
+stim_scheduler_take_pulse(void)
+{
+  taskENTER_CRITICAL();
+  bool pulse = g_pulse_pending;
+  g_pulse_pending = false;
+  taskEXIT_CRITICAL();
+  return pulse;
+}
+
+#endif /* (defined(ENABLE_STIM_PLAYER) && (ENABLE_STIM_PLAYER > 0U)) */
+
+void
+stim_scheduler_get_stats(stim_scheduler_stats_t *stats)
+{
+  taskENTER_CRITICAL();
+  *stats = g_stats;
+  taskEXIT_CRITICAL();
+}
+
+void
+stim_scheduler_reset_stats(void)
+{
+  taskENTER_CRITICAL();
+  memset(&g_stats, 0, sizeof(g_stats));
+  taskEXIT_CRITICAL();
+#if (defined(ENABLE_STIM_PLAYER) && (ENABLE_STIM_PLAYER > 0U))
+  stim_player_reset_stats();
+#endif
+}
+
+void
+stim_scheduler_print_stats(void)
+{
+  stim_scheduler_stats_t stats;
+  stim_scheduler_get_stats(&stats);
+
+  float freq_hz = g_predictor.rad_per_us * 1e6f / PHASE_PREDICTOR_2PI;
+  uint32_t mean_late_us = (stats.timer_pulses > 0) ?
+      (uint32_t)(stats.total_isr_late_us / stats.timer_pulses) : 0;
+
+  printf("stim_scheduler: %.2f Hz phase estimate\n", freq_hz);
+  printf("  timer pulses %lu, ISR late mean %lu us, max %lu us\n",
+      (unsigned long) stats.timer_pulses,
+      (unsigned long) mean_late_us,
+      (unsigned long) stats.max_isr_late_us);
+  printf("  late pulses %lu\n", (unsigned long) stats.late_pulses);
+
+#if (defined(ENABLE_STIM_PLAYER) && (ENABLE_STIM_PLAYER > 0U))
+  stim_player_stats_t player_stats;
+  stim_player_get_stats(&player_stats);
+  printf("  player pulses %lu, spliced late %lu, max %lu us\n",
+      (unsigned long) player_stats.pulses,
+      (unsigned long) player_stats.late_pulses,
+      (unsigned long) player_stats.max_late_us);
+#endif
+}
+
+#else /* (defined(ENABLE_STIM_SCHEDULER) && (ENABLE_STIM_SCHEDULER > 0U)) */
+
+void stim_scheduler_config(float center_hz, float low_hz, float high_hz){}
+void stim_scheduler_restart(void){}
+void stim_scheduler_add_phase(uint32_t sample_us, float inst_phs){}
+void stim_scheduler_arm(float target_phs, float window_rad){}
+void stim_scheduler_cancel(void){}
+bool stim_scheduler_take_pulse(void){ return false; }
+void stim_scheduler_get_stats(stim_scheduler_stats_t *stats){ memset(stats, 0, sizeof(*stats)); }
+void stim_scheduler_reset_stats(void){}
+void stim_scheduler_print_stats(void){ printf("stim scheduler disabled, set ENABLE_STIM_SCHEDULER in config.h\n"); }
+
+#endif /* (defined(ENABLE_STIM_SCHEDULER) && (ENABLE_STIM_SCHEDULER > 0U)) */
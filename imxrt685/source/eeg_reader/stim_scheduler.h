@@ -0,0 +1,75 @@
+/*
+ * stim_scheduler.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Phase-locked stimulus scheduler.
+ *
+ * Instead of starting a pulse on the first ECHT sample inside the target
+ * phase window (quantised to the 4 ms sample grid, plus the processing
+ * latency), the EEG processor feeds every ECHT phase to the scheduler, which
+ * extrapolates the phase to the present (signal_processing/phase_predictor.h)
+ * and arms a micro clock alarm for the predicted target crossing. The alarm
+ * ISR unmutes the pink noise directly with audio_pink_pulse_from_isr(). The
+ * processor picks the pulse up with stim_scheduler_take_pulse() on its next
+ * sample to log it and to end it, the pulse end stays on the sample grid.
+ *
+ * With ENABLE_STIM_PLAYER the alarm is not used, the crossing time is handed
+ * to the stimulus player (audio/stim_player.h) which splices a pre-rendered
+ * pulse into the I2S buffer at the matching frame.
+ */
+
+#ifndef EEG_READER_STIM_SCHEDULER_H_
+#define EEG_READER_STIM_SCHEDULER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Only crossings this close are armed, later ones wait for a fresher phase.
+// Must cover the time to the next ECHT sample (sample period times samples
+// per wakeup) plus the processing latency, or crossings in between fire late.
+#ifndef STIM_SCHEDULER_HORIZON_US
+#define STIM_SCHEDULER_HORIZON_US (12000U)
+#endif
+
+typedef struct
+{
+  uint32_t timer_pulses;     // pulses started by the alarm
+  uint32_t late_pulses;      // crossing already passed, started by the EEG processor
+  uint32_t max_isr_late_us;  // alarm ISR entry after the predicted crossing
+  uint64_t total_isr_late_us;
+} stim_scheduler_stats_t;
+
+// Passband of the ECHT filter, bounds the phase velocity estimate.
+void stim_scheduler_config(float center_hz, float low_hz, float high_hz);
+
+// Drop the phase history, e.g. when the ECHT channel changes.
+void stim_scheduler_restart(void);
+
+// Phase (rad) of the ECHT output for the sample taken at sample_us (micros()).
+void stim_scheduler_add_phase(uint32_t sample_us, float inst_phs);
+
+// Arm, re-arm or cancel the alarm for the next crossing of target_phs.
+// A crossing missed by less than window_rad starts the pulse immediately.
+// Call after stim_scheduler_add_phase() while no pulse is playing.
+void stim_scheduler_arm(float target_phs, float window_rad);
+
+// Cancel a pending alarm, a pulse already started is still reported.
+void stim_scheduler_cancel(void);
+
+// True once per started pulse.
+bool stim_scheduler_take_pulse(void);
+
+void stim_scheduler_get_stats(stim_scheduler_stats_t *stats);
+void stim_scheduler_reset_stats(void);
+void stim_scheduler_print_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EEG_READER_STIM_SCHEDULER_H_ */
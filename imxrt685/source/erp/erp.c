@@ -16,6 +16,7 @@
 
 #include "loglevels.h"
 #include "erp.h"
+#include "erp_average.h"
 #include "data_log.h"
 
 #if (defined(ENABLE_ERP_TASK) && (ENABLE_ERP_TASK > 0U))
@@ -281,6 +282,8 @@ handle_state_running(erp_event_t *event) {
     g_erp_context.erp_count = 0;
     g_erp_context.sample_number = 0;
 
+    erp_average_start();
+
 //    audio_set_volume(g_erp_context.erp_volume);
     audio_pink_default_volume();
     audio_pink_script_volume(g_erp_context.erp_volume/255.0f);
@@ -296,6 +299,8 @@ handle_state_running(erp_event_t *event) {
     audio_pink_mute(false);
     // log the pulse
     data_log_pulse(g_erp_context.sample_number, true);
+    // time-lock the evoked response average to the same sample
+    erp_average_mark_onset(g_erp_context.sample_number);
     // wait for pulse duration
     restart_pulse_timer(g_erp_context.erp_pulse_dur_ms);
     break;
@@ -326,6 +331,10 @@ handle_state_running(erp_event_t *event) {
     audio_pink_fadeout(0);
     audio_pink_default_volume();
 
+    // report the averaged evoked response
+    erp_average_stop();
+    erp_average_report();
+
     // STOP THE ERP
     set_state(ERP_STATE_STANDBY);
     break;
@@ -0,0 +1,307 @@
+/*
+ * erp_average.c
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: On-device ERP averaging.
+ *
+ * The EEG processor task pushes every filtered sample into a per-channel
+ * epoch ring. The ERP task reports stimulus onsets as EEG sample numbers,
+ * which are the micros() timestamps of the samples. Samples are counted
+ * here, and each onset is converted to that count once using the sample
+ * period. Once the ring holds ERP_AVERAGE_POST_SAMPLES after an onset, the
+ * epoch is baseline corrected, checked against the electrode quality
+ * thresholds and folded into a running mean/variance (Welford) across
+ * trials.
+ */
+
+#include <string.h>
+#include <math.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "config.h"
+#include "loglevels.h"
+#include "eeg_constants.h"
+#include "erp_average.h"
+
+#if (defined(ENABLE_ERP_TASK) && (ENABLE_ERP_TASK > 0U))
+
+static const char *TAG = "erp_avg"; // Logging prefix for this module
+
+typedef struct
+{
+  // written by the ERP task, consumed by the EEG processor task
+  volatile bool reset_requested;
+  volatile bool running;
+  unsigned long onsets[ERP_AVERAGE_MAX_PENDING_ONSETS];
+  size_t onset_head;
+  size_t onset_count;
+  bool head_resolved;        // head_index is valid for the oldest onset
+  uint32_t head_index;       // sample_index of the oldest onset
+
+  // epoch ring (uV), owned by the EEG processor task
+  float ring[ERP_AVERAGE_EPOCH_LEN][MAX_NUM_EEG_CHANNELS];
+  size_t ring_index;         // next write position
+  size_t ring_count;         // contiguous samples held, saturates at EPOCH_LEN
+  uint32_t sample_index;     // samples received, the newest one is sample_index - 1
+  uint32_t last_sample_number;
+
+  // running statistics
+  uint32_t n;
+  float mean[ERP_AVERAGE_EPOCH_LEN][MAX_NUM_EEG_CHANNELS];
+  float m2[ERP_AVERAGE_EPOCH_LEN][MAX_NUM_EEG_CHANNELS];
+
+  erp_average_stats_t stats;
+} erp_average_context_t;
+
+static erp_average_context_t g_erp_avg;
+
+static void
+reset_stats(void)
+{
+  g_erp_avg.onset_head = 0;
+  g_erp_avg.onset_count = 0;
+  g_erp_avg.head_resolved = false;
+  g_erp_avg.ring_index = 0;
+  g_erp_avg.ring_count = 0;
+  g_erp_avg.n = 0;
+  memset(g_erp_avg.mean, 0, sizeof(g_erp_avg.mean));
+  memset(g_erp_avg.m2, 0, sizeof(g_erp_avg.m2));
+  memset(&g_erp_avg.stats, 0, sizeof(g_erp_avg.stats));
+}
+
+void
+erp_average_start(void)
+{
+  taskENTER_CRITICAL();
+  g_erp_avg.reset_requested = true;
+  g_erp_avg.running = true;
+  taskEXIT_CRITICAL();
+}
+
+void
+erp_average_stop(void)
+{
+  taskENTER_CRITICAL();
+  g_erp_avg.running = false;
+  taskEXIT_CRITICAL();
+}
+
+void
+erp_average_mark_onset(unsigned long onset_sample_number)
+{
+  bool overflow = false;
+
+  taskENTER_CRITICAL();
+  if (g_erp_avg.onset_count < ERP_AVERAGE_MAX_PENDING_ONSETS) {
+    size_t tail = (g_erp_avg.onset_head + g_erp_avg.onset_count) % ERP_AVERAGE_MAX_PENDING_ONSETS;
+    g_erp_avg.onsets[tail] = onset_sample_number;
+    g_erp_avg.onset_count++;
+  } else {
+    overflow = true;
+    g_erp_avg.stats.num_dropped++;
+  }
+  g_erp_avg.stats.num_onsets++;
+  taskEXIT_CRITICAL();
+
+  if (overflow) {
+    LOGW(TAG, "Too many pending onsets, dropped onset at sample %lu", onset_sample_number);
+  }
+}
+
+// Returns the ring slot holding the given epoch offset (0 = oldest pre-stimulus sample).
+static inline size_t
+ring_slot(size_t epoch_offset)
+{
+  // ring_index points one past the newest sample, which is the last sample of the epoch
+  return (g_erp_avg.ring_index + epoch_offset) % ERP_AVERAGE_EPOCH_LEN;
+}
+
+static void
+accumulate_epoch(void)
+{
+  float baseline[MAX_NUM_EEG_CHANNELS] = {0};
+  float mean_abs[MAX_NUM_EEG_CHANNELS] = {0};
+  float peak_abs[MAX_NUM_EEG_CHANNELS] = {0};
+
+  // baseline is the mean of the pre-stimulus window
+  for (size_t i = 0; i < ERP_AVERAGE_PRE_SAMPLES; i++) {
+    float *x = g_erp_avg.ring[ring_slot(i)];
+    for (uint8_t ch = 0; ch < MAX_NUM_EEG_CHANNELS; ch++) {
+      baseline[ch] += x[ch];
+    }
+  }
+  for (uint8_t ch = 0; ch < MAX_NUM_EEG_CHANNELS; ch++) {
+    baseline[ch] /= ERP_AVERAGE_PRE_SAMPLES;
+  }
+
+  // artifact rejection uses the same thresholds as the electrode quality test
+  for (size_t i = 0; i < ERP_AVERAGE_EPOCH_LEN; i++) {
+    float *x = g_erp_avg.ring[ring_slot(i)];
+    for (uint8_t ch = 0; ch < MAX_NUM_EEG_CHANNELS; ch++) {
+      float a = fabsf(x[ch] - baseline[ch]);
+      mean_abs[ch] += a;
+      if (a > peak_abs[ch]) {
+        peak_abs[ch] = a;
+      }
+    }
+  }
+  for (uint8_t ch = 0; ch < MAX_NUM_EEG_CHANNELS; ch++) {
+    mean_abs[ch] /= ERP_AVERAGE_EPOCH_LEN;
+    if (!isfinite(mean_abs[ch]) || mean_abs[ch] < EEG_QUALITY_NO_SIGNAL_UV) {
+      g_erp_avg.stats.num_no_signal++;
+      return;
+    }
+    if (peak_abs[ch] > EEG_QUALITY_ARTIFACT_UV) {
+      g_erp_avg.stats.num_artifact++;
+      return;
+    }
+  }
+
+  // Welford update, one short critical section per row so a concurrent
+  // erp_average_report() always reads a consistent mean/m2 pair.
+  uint32_t n = g_erp_avg.n + 1;
+  for (size_t i = 0; i < ERP_AVERAGE_EPOCH_LEN; i++) {
+    float *x = g_erp_avg.ring[ring_slot(i)];
+    taskENTER_CRITICAL();
+    for (uint8_t ch = 0; ch < MAX_NUM_EEG_CHANNELS; ch++) {
+      float v = x[ch] - baseline[ch];
+      float delta = v - g_erp_avg.mean[i][ch];
+      g_erp_avg.mean[i][ch] += delta / n;
+      g_erp_avg.m2[i][ch] += delta * (v - g_erp_avg.mean[i][ch]);
+    }
+    taskEXIT_CRITICAL();
+  }
+  g_erp_avg.n = n;
+  g_erp_avg.stats.num_accepted++;
+
+  LOGD(TAG, "Epoch %lu accepted", (unsigned long) n);
+}
+
+void
+erp_average_add_sample(ads129x_frontal_sample *f_sample)
+{
+  if (g_erp_avg.reset_requested) {
+    taskENTER_CRITICAL();
+    g_erp_avg.reset_requested = false;
+    reset_stats();
+    taskEXIT_CRITICAL();
+  }
+
+  // Keep filling the ring while idle so the first onset has its baseline.
+  // The timestamps wrap at 32 bits, so all differences are taken as uint32_t.
+  uint32_t snum = (uint32_t) f_sample->eeg_sample_number;
+  if (g_erp_avg.ring_count > 0 &&
+      (uint32_t)(snum - g_erp_avg.last_sample_number) > ERP_AVERAGE_SAMPLE_PERIOD_US * 3 / 2) {
+    // Sample gap: the ring no longer holds a contiguous epoch.
+    g_erp_avg.ring_count = 0;
+  }
+  g_erp_avg.last_sample_number = snum;
+  g_erp_avg.sample_index++;
+
+  float *x = g_erp_avg.ring[g_erp_avg.ring_index];
+  for (uint8_t ch = 0; ch < MAX_NUM_EEG_CHANNELS; ch++) {
+    x[ch] = f_sample->eeg_channels[ch] * EEG_SCALAR_UV;
+  }
+  g_erp_avg.ring_index = (g_erp_avg.ring_index + 1) % ERP_AVERAGE_EPOCH_LEN;
+  if (g_erp_avg.ring_count < ERP_AVERAGE_EPOCH_LEN) {
+    g_erp_avg.ring_count++;
+  }
+
+  if (!g_erp_avg.running || g_erp_avg.onset_count == 0) {
+    return;
+  }
+
+  // Onsets are reported in order, so only the oldest can be complete.
+  if (!g_erp_avg.head_resolved) {
+    taskENTER_CRITICAL();
+    uint32_t onset = (uint32_t) g_erp_avg.onsets[g_erp_avg.onset_head];
+    taskEXIT_CRITICAL();
+
+    // Convert the onset timestamp to a sample index once, rounding away the
+    // DRDY timing jitter. Later samples are then counted, not timed.
+    uint32_t elapsed_us = snum - onset;
+    uint32_t elapsed = (elapsed_us + ERP_AVERAGE_SAMPLE_PERIOD_US / 2) / ERP_AVERAGE_SAMPLE_PERIOD_US;
+    g_erp_avg.head_index = (g_erp_avg.sample_index - 1) - elapsed;
+    g_erp_avg.head_resolved = true;
+  }
+
+  // Unsigned difference stays correct across sample index wraparound.
+  uint32_t since_onset = (g_erp_avg.sample_index - 1) - g_erp_avg.head_index;
+  if (since_onset < ERP_AVERAGE_POST_SAMPLES - 1) {
+    return;
+  }
+
+  if (since_onset == ERP_AVERAGE_POST_SAMPLES - 1 && g_erp_avg.ring_count == ERP_AVERAGE_EPOCH_LEN) {
+    accumulate_epoch();
+  } else {
+    // Missed the epoch end (sample gap or onset before the ring filled).
+    g_erp_avg.stats.num_dropped++;
+  }
+
+  taskENTER_CRITICAL();
+  g_erp_avg.onset_head = (g_erp_avg.onset_head + 1) % ERP_AVERAGE_MAX_PENDING_ONSETS;
+  g_erp_avg.onset_count--;
+  g_erp_avg.head_resolved = false;
+  taskEXIT_CRITICAL();
+}
+
+void
+erp_average_get_stats(erp_average_stats_t *stats)
+{
+  taskENTER_CRITICAL();
+  *stats = g_erp_avg.stats;
+  taskEXIT_CRITICAL();
+}
+
+void
+erp_average_report(void)
+{
+  erp_average_stats_t stats;
+  erp_average_get_stats(&stats);
+
+  LOGI(TAG, "onsets %lu, accepted %lu, artifact %lu, no signal %lu, dropped %lu",
+      (unsigned long) stats.num_onsets, (unsigned long) stats.num_accepted,
+      (unsigned long) stats.num_artifact, (unsigned long) stats.num_no_signal,
+      (unsigned long) stats.num_dropped);
+
+  if (stats.num_accepted == 0) {
+    return;
+  }
+
+  // One line per epoch sample: offset_ms, then mean and std (uV) per channel
+  for (size_t i = 0; i < ERP_AVERAGE_EPOCH_LEN; i++) {
+    float mean[MAX_NUM_EEG_CHANNELS];
+    float std[MAX_NUM_EEG_CHANNELS];
+    uint32_t n;
+
+    taskENTER_CRITICAL();
+    n = g_erp_avg.n;
+    for (uint8_t ch = 0; ch < MAX_NUM_EEG_CHANNELS; ch++) {
+      mean[ch] = g_erp_avg.mean[i][ch];
+      std[ch] = (n > 1) ? g_erp_avg.m2[i][ch] / (n - 1) : 0;
+    }
+    taskEXIT_CRITICAL();
+
+    for (uint8_t ch = 0; ch < MAX_NUM_EEG_CHANNELS; ch++) {
+      std[ch] = sqrtf(std[ch]);
+    }
+
+    long offset_ms = ((long) i - (long) ERP_AVERAGE_PRE_SAMPLES) * 1000 / (long) ERP_AVERAGE_SAMPLE_RATE_HZ;
+    LOGI(TAG, "%ld %f %f %f %f %f %f", offset_ms,
+        mean[0], std[0], mean[1], std[1], mean[2], std[2]);
+  }
+}
+
+#else /* (defined(ENABLE_ERP_TASK) && (ENABLE_ERP_TASK > 0U)) */
+
+void erp_average_start(void){}
+void erp_average_stop(void){}
+void erp_average_mark_onset(unsigned long onset_sample_number){}
+void erp_average_add_sample(ads129x_frontal_sample *f_sample){}
+void erp_average_report(void){}
+void erp_average_get_stats(erp_average_stats_t *stats){ memset(stats, 0, sizeof(*stats)); }
+
+#endif /* (defined(ENABLE_ERP_TASK) && (ENABLE_ERP_TASK > 0U)) */
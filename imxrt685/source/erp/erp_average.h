@@ -0,0 +1,61 @@
+/*
+ * erp_average.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: On-device ERP averaging. Keeps a per-channel ring of recent
+ * EEG samples, cuts an epoch around every stimulus onset reported by the ERP
+ * task and maintains a running mean and variance across accepted trials.
+ */
+
+#ifndef ERP_ERP_AVERAGE_H_
+#define ERP_ERP_AVERAGE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "eeg_datatypes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ERP_AVERAGE_SAMPLE_RATE_HZ (250U)
+// EEG sample numbers are the micros() timestamps taken at DRDY, so samples
+// arrive this far apart
+#define ERP_AVERAGE_SAMPLE_PERIOD_US (1000000UL / ERP_AVERAGE_SAMPLE_RATE_HZ)
+
+// Epoch window around the stimulus onset
+#define ERP_AVERAGE_PRE_SAMPLES  (25U)  // 100 ms of pre-stimulus baseline
+#define ERP_AVERAGE_POST_SAMPLES (125U) // 500 ms of post-stimulus response
+#define ERP_AVERAGE_EPOCH_LEN    (ERP_AVERAGE_PRE_SAMPLES + ERP_AVERAGE_POST_SAMPLES)
+
+// Maximum number of onsets waiting for their post-stimulus samples
+#define ERP_AVERAGE_MAX_PENDING_ONSETS (4U)
+
+typedef struct {
+  uint32_t num_onsets;     // onsets reported by the ERP task
+  uint32_t num_accepted;   // epochs averaged
+  uint32_t num_artifact;   // epochs rejected for exceeding the artifact threshold
+  uint32_t num_no_signal;  // epochs rejected for a flat/disconnected channel
+  uint32_t num_dropped;    // epochs lost to sample gaps or pending-onset overflow
+} erp_average_stats_t;
+
+// Called from the ERP task
+void erp_average_start(void);
+void erp_average_stop(void);
+// onset_sample_number is the eeg_sample_number (us timestamp) of the sample
+// the pulse was played at.
+void erp_average_mark_onset(unsigned long onset_sample_number);
+
+// Called from the EEG processor task with each filtered sample
+void erp_average_add_sample(ads129x_frontal_sample *f_sample);
+
+// Print the averaged waveform (mean and standard deviation in uV per channel)
+void erp_average_report(void);
+void erp_average_get_stats(erp_average_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ERP_ERP_AVERAGE_H_ */
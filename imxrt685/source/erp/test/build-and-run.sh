@@ -0,0 +1,14 @@
+set -x
+
+# ERP epochs cut from samples numbered by their micros() timestamps.
+
+gcc -DVARIANT_FF4 \
+ -I shim \
+ -I .. \
+ -I ../../eeg_reader \
+ ./erp_average_test.c \
+ -o erp_average_test -lm && \
+./erp_average_test
+
+# cleanup
+rm ./erp_average_test
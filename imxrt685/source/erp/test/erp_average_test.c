@@ -0,0 +1,120 @@
+// Host test for the ERP averager, fed the way the device feeds it: the EEG
+// sample number of each sample is its micros() timestamp, about 4000 us
+// apart with DRDY jitter, and the ERP task marks each onset with the sample
+// number it last saw. The timestamps start just before the 32-bit wrap.
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Built in so the test can check the averaged waveform itself.
+#include "../erp_average.c"
+
+// Evoked response: RESPONSE_UV on all channels, RESPONSE_DELAY samples
+// after the onset sample, for RESPONSE_LEN samples.
+#define RESPONSE_UV    (40.0f)
+#define RESPONSE_DELAY (75U)
+#define RESPONSE_LEN   (10U)
+
+#define ONSET_INTERVAL (300U) // samples per trial
+
+static uint32_t g_time_us = 0xFFFF0000UL;
+
+// Delivers one sample and returns its sample number.
+static uint32_t
+feed(float offset_uv)
+{
+  ads129x_frontal_sample s;
+  uint32_t snum = g_time_us;
+
+  s.eeg_sample_number = snum;
+  for (uint8_t ch = 0; ch < MAX_NUM_EEG_CHANNELS; ch++) {
+    float noise_uv = ((rand() % 2001) - 1000) / 100.0f; // +/-10 uV
+    s.eeg_channels[ch] = (int32_t) lroundf((noise_uv + offset_uv) / EEG_SCALAR_UV);
+  }
+  erp_average_add_sample(&s);
+
+  // +/-500 us of jitter around the nominal sample period
+  g_time_us += ERP_AVERAGE_SAMPLE_PERIOD_US + (rand() % 1001) - 500;
+  return snum;
+}
+
+// Runs num_trials trials. In trial gap_trial, gap_samples samples are lost
+// shortly after the onset, as with a missed DRDY.
+static void
+run_trials(unsigned num_trials, unsigned gap_trial, unsigned gap_samples)
+{
+  for (unsigned t = 0; t < num_trials; t++) {
+    // the ERP task plays the pulse right after this sample arrived
+    erp_average_mark_onset(feed(0.0f));
+
+    for (unsigned i = 1; i < ONSET_INTERVAL; i++) {
+      if (t == gap_trial && i == 50) {
+        g_time_us += gap_samples * ERP_AVERAGE_SAMPLE_PERIOD_US;
+      }
+      bool in_response = (i >= RESPONSE_DELAY && i < RESPONSE_DELAY + RESPONSE_LEN);
+      feed(in_response ? RESPONSE_UV : 0.0f);
+    }
+  }
+}
+
+static void
+test_average(void)
+{
+  erp_average_stats_t stats;
+
+  erp_average_start();
+  // baseline before the first onset
+  for (unsigned i = 0; i < ERP_AVERAGE_PRE_SAMPLES; i++) {
+    feed(0.0f);
+  }
+  run_trials(16, ~0U, 0);
+
+  erp_average_get_stats(&stats);
+  printf("onsets %u, accepted %u, dropped %u\n", (unsigned) stats.num_onsets,
+      (unsigned) stats.num_accepted, (unsigned) stats.num_dropped);
+  assert(stats.num_onsets == 16);
+  assert(stats.num_accepted == 16);
+  assert(stats.num_dropped == 0);
+  assert(stats.num_artifact == 0 && stats.num_no_signal == 0);
+
+  // The response shows up at its delay after the onset and nowhere else.
+  for (size_t i = 0; i < ERP_AVERAGE_EPOCH_LEN; i++) {
+    bool in_response = (i >= ERP_AVERAGE_PRE_SAMPLES + RESPONSE_DELAY &&
+                        i < ERP_AVERAGE_PRE_SAMPLES + RESPONSE_DELAY + RESPONSE_LEN);
+    for (uint8_t ch = 0; ch < MAX_NUM_EEG_CHANNELS; ch++) {
+      float expected = in_response ? RESPONSE_UV : 0.0f;
+      assert(fabsf(g_erp_avg.mean[i][ch] - expected) < 8.0f);
+    }
+  }
+}
+
+static void
+test_gap(void)
+{
+  erp_average_stats_t stats;
+
+  erp_average_start();
+  for (unsigned i = 0; i < ERP_AVERAGE_PRE_SAMPLES; i++) {
+    feed(0.0f);
+  }
+  run_trials(5, 2, 10);
+
+  erp_average_get_stats(&stats);
+  printf("onsets %u, accepted %u, dropped %u\n", (unsigned) stats.num_onsets,
+      (unsigned) stats.num_accepted, (unsigned) stats.num_dropped);
+  assert(stats.num_onsets == 5);
+  assert(stats.num_accepted == 4);
+  assert(stats.num_dropped == 1);
+}
+
+int
+main(void)
+{
+  srand(1);
+  test_average();
+  test_gap();
+  printf("erp_average_test passed\n");
+  return 0;
+}
@@ -0,0 +1,16 @@
+/*
+ * FreeRTOS.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host test shim. The ERP averager runs in a single thread on
+ * the host, so there is nothing to lock.
+ */
+
+#ifndef ERP_TEST_SHIM_FREERTOS_H_
+#define ERP_TEST_SHIM_FREERTOS_H_
+
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+
+#endif /* ERP_TEST_SHIM_FREERTOS_H_ */
@@ -0,0 +1,15 @@
+/*
+ * config.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host test shim for config/config.h. The board variant is
+ * passed on the command line by build-and-run.sh.
+ */
+
+#ifndef ERP_TEST_SHIM_CONFIG_H_
+#define ERP_TEST_SHIM_CONFIG_H_
+
+#define ENABLE_ERP_TASK (1U)
+
+#endif /* ERP_TEST_SHIM_CONFIG_H_ */
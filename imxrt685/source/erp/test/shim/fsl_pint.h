@@ -0,0 +1,15 @@
+/*
+ * fsl_pint.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host test shim, ads129x.h includes it for the DRDY pin.
+ */
+
+#ifndef ERP_TEST_SHIM_FSL_PINT_H_
+#define ERP_TEST_SHIM_FSL_PINT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#endif /* ERP_TEST_SHIM_FSL_PINT_H_ */
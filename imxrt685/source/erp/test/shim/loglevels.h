@@ -0,0 +1,22 @@
+/*
+ * loglevels.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host test shim for utils/loglevels.h, prints to stdout.
+ */
+
+#ifndef ERP_TEST_SHIM_LOGLEVELS_H_
+#define ERP_TEST_SHIM_LOGLEVELS_H_
+
+#include <stdio.h>
+
+#define LOG_HOST(tag, format, ...) printf("%s: " format "\n", tag, ##__VA_ARGS__)
+
+#define LOGE( tag, format, ... ) LOG_HOST(tag, format, ##__VA_ARGS__)
+#define LOGW( tag, format, ... ) LOG_HOST(tag, format, ##__VA_ARGS__)
+#define LOGI( tag, format, ... ) LOG_HOST(tag, format, ##__VA_ARGS__)
+#define LOGD( tag, format, ... )
+#define LOGV( tag, format, ... )
+
+#endif /* ERP_TEST_SHIM_LOGLEVELS_H_ */
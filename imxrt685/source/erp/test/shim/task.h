@@ -0,0 +1,14 @@
+/*
+ * task.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host test shim, see FreeRTOS.h.
+ */
+
+#ifndef ERP_TEST_SHIM_TASK_H_
+#define ERP_TEST_SHIM_TASK_H_
+
+#include "FreeRTOS.h"
+
+#endif /* ERP_TEST_SHIM_TASK_H_ */
@@ -14,6 +14,7 @@
 #include "ff.h"
 #include "diskio.h"
 #include "dhara_utils.h"
+#include "dhara_hint.h"
 
 // Set the log level for this file
 #define LOG_LEVEL_MODULE  LOG_WARN
@@ -21,6 +22,10 @@
 
 static const char *TAG = "dhara_diskio";  // Logging prefix for this module
 
+// Sectors disk_read() looks up at a time. Runs of them stored in
+// consecutive pages are read from the NAND in one go.
+#define DISK_READ_BATCH 16
+
 DSTATUS disk_initialize(BYTE drive_number)
 {
   LOGD(TAG, "disk_initialize(): drive %d", (int)drive_number);
@@ -38,22 +43,61 @@ DRESULT disk_read(BYTE drive_number, BYTE *buf, DWORD start, UINT sector_count)
 
   int result;
   dhara_error_t err;
-  
+  dhara_page_t pages[DISK_READ_BATCH];
+
   struct dhara_map *map = dhara_get_my_map();
+  const struct dhara_nand *nand = map->journal.nand;
   uint16_t sector_size = dhara_map_sector_size_bytes(map);
 
-  // Read all the requested sectors:
-  for (int index = 0; index < sector_count; index++) {
+  while (sector_count > 0) {
+    UINT batch = (sector_count < DISK_READ_BATCH) ? sector_count : DISK_READ_BATCH;
+
+    // Find where each sector is. Sectors never written read as erased.
+    for (UINT index = 0; index < batch; index++) {
+      result = dhara_map_find(map, (dhara_sector_t)(start + index), &pages[index], &err);
+      if (result != 0) {
+        if (err != DHARA_E_NOT_FOUND) {
+          LOGE(TAG, "disk_read(): err: %d, drive %d, sector %d", (int)err, (int)drive_number, (int)(start + index));
+          return RES_ERROR;
+        }
+        pages[index] = DHARA_PAGE_NONE;
+      }
+    }
 
-    result = dhara_map_read(map, (dhara_sector_t)start, buf, &err);
-    if (result != 0) {
-      LOGE(TAG, "disk_read(): err: %d, drive %d, sector %d, index %d", (int)err, (int)drive_number, (int)start, index);
-      return RES_ERROR;
+    // Read runs of sectors that are consecutive pages of one block together
+    for (UINT index = 0; index < batch; ) {
+      UINT run = 1;
+
+      if (pages[index] == DHARA_PAGE_NONE) {
+        memset(buf, 0xFF, sector_size);
+      } else {
+        while (index + run < batch &&
+               pages[index + run] == pages[index] + run &&
+               (pages[index + run] >> nand->log2_ppb) == (pages[index] >> nand->log2_ppb)) {
+          run++;
+        }
+
+        // One page, or some page of the run needs ECC: read them through
+        // the journal, which relocates blocks that are going bad.
+        if (run == 1 || dhara_nand_read_pages(nand, pages[index], run, buf, &err) != 0) {
+          for (UINT i = 0; i < run; i++) {
+            result = dhara_journal_nand_read(&map->journal, pages[index + i], 0,
+                sector_size, buf + i * sector_size, &err);
+            if (result != 0) {
+              LOGE(TAG, "disk_read(): err: %d, drive %d, sector %d", (int)err, (int)drive_number, (int)(start + index + i));
+              return RES_ERROR;
+            }
+          }
+        }
+      }
+
+      // Advance the buffer pointer and the batch index:
+      index += run;
+      buf += run * sector_size;
     }
-    
-    // Advance the buffer pointer and the sector address:
-    start += 1;
-    buf += sector_size;
+
+    start += batch;
+    sector_count -= batch;
   }
 
   return RES_OK;
@@ -116,6 +160,9 @@ DRESULT disk_ioctl(BYTE drive_number, BYTE cmd, void *buf)
         LOGE(TAG, "disk_ioctl(): dhara_map_sync() returned %d, err: %d", status, (int)err);
         result = RES_ERROR;
       }
+      else {
+        dhara_hint_update(map);
+      }
       break;
 
     case GET_BLOCK_SIZE:
@@ -8,12 +8,16 @@
  * Description: FreeRTOS Task dedicated to waiting on StreamBuffered slow flash FatFS writes
  */
 
+#include <string.h>
+
 #include "fatfs_writer.h"
 #include "fatfs_utils.h"
 #include "dhara_utils.h"
+#include "dhara_wear.h"
 
 #include "FreeRTOS.h"
 #include "stream_buffer.h"
+#include "semphr.h"
 #include "task.h"
 
 #include "config.h"
@@ -28,21 +32,32 @@ static_assert(FF_MAX_SS >= NAND_PAGE_SIZE, "FatFS must be configured with a sect
 
 static const char* TAG = "fatfs_writer";  // Logging prefix for this module
 
-// One flash page is 4K.
-#define FATFS_NOWAIT_STREAM_BUFFER_SIZE (NAND_PAGE_SIZE)
+// The default stream holds two NAND pages, so one can be written whole
+// while the next fills.
+#define FATFS_NOWAIT_STREAM_BUFFER_SIZE (2*NAND_PAGE_SIZE)
 #define FATFS_FSYNC_FLUSH_TIMEOUT_MS 1000
-#define FATFS_FSYNC_FLUSH_DELAY_MS 10
+
+static fatfs_sync_policy_t g_default_policy = {
+  .sync_bytes = FATFS_SYNC_BYTES_DEFAULT,
+  .sync_ms = FATFS_SYNC_MS_DEFAULT,
+};
 
 #if (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
-static uint8_t g_stream_buffer_array[FATFS_NOWAIT_STREAM_BUFFER_SIZE];
-static StaticStreamBuffer_t g_stream_buffer_struct;
-static StreamBufferHandle_t g_stream_buffer_handle;
+static uint8_t g_stream_buffer_array[FATFS_STREAM_STORAGE_SIZE(FATFS_NOWAIT_STREAM_BUFFER_SIZE)];
+static fatfs_stream_t g_default_stream;
+
+// Registered streams, changed in critical sections.
+static fatfs_stream_t* g_streams = NULL;
+static TaskHandle_t g_writer_task_handle = NULL;
 
-static FRESULT last_result = FR_OK;  // Returned on the next call
+static volatile bool g_charging = false;
 
-static FIL* g_current_file_pointer;
+// Writer task only, except reset.
+static fatfs_writer_stats_t g_stats;
 #endif // (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
 
+#if !(defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
+// Used when the writer task is disabled.
 static FRESULT f_delayed_sync(FIL* fp, UINT bw)
 {
   static uint32_t g_bytes_written_since_sync = 0;
@@ -55,71 +70,239 @@ static FRESULT f_delayed_sync(FIL* fp, UINT bw)
   //   Performing f_sync function in certain interval can minimize the risk of data loss due to a sudden blackout, wrong media removal or unrecoverable disk error.
   //   http://elm-chan.org/fsw/ff/doc/sync.html
   g_bytes_written_since_sync += bw;
-  if (g_bytes_written_since_sync > (NAND_PAGE_SIZE*2)) {
-    // Note that we do not call f_sync_wait() here because it waits for the 
-    // writer task to completely drain the streaming buffer.
-    // This function is being called from the writer task, so the buffer
-    // will not drain. Instead, just sync whatever bytes have been written.
+  if (g_bytes_written_since_sync > g_default_policy.sync_bytes) {
     result = f_sync(fp);
     g_bytes_written_since_sync = 0;
   }
 
   return result;
 }
+#endif // !(defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
 
-FRESULT f_write_nowait(FIL* fp, const void* buff, UINT btw, UINT* bw)
-{
 #if (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
-  // Only one task may write at a time, so this g_current_file_pointer
-  // should (normally) remain consistent during a given session of writes.
-  // We re-assign it to g_current_file_pointer every time just to keep the API
-  // simple and mirror the f_write() args.
 
-  // TODO: check the assumption above that the file pointer is not changed 
-  //       while we are still writing the previous buffer.
-  //       Alternatively: convert to a message buf + circular buf to remove 
-  //       the need for this assumption.
-  g_current_file_pointer = fp;
+static void wake_writer(void)
+{
+  if (g_writer_task_handle != NULL) {
+    xTaskNotifyGive(g_writer_task_handle);
+  }
+}
+
+static fatfs_stream_t* find_stream(FIL* fp)
+{
+  fatfs_stream_t* stream;
+
+  taskENTER_CRITICAL();
+  for (stream = g_streams; stream != NULL; stream = stream->next) {
+    if (stream->fp == fp) {
+      break;
+    }
+  }
+  taskEXIT_CRITICAL();
+  return stream;
+}
+
+static void stream_init(fatfs_stream_t* stream, FIL* fp, uint8_t* storage,
+    size_t size, const fatfs_sync_policy_t* policy)
+{
+  stream->fp = fp;
+  stream->policy = *policy;
+  stream->chunk = (size >= 2*NAND_PAGE_SIZE) ? NAND_PAGE_SIZE : size/2;
+  stream->unsynced_bytes = 0;
+  stream->pending = false;
+  stream->pending_since = 0;
+  stream->flush_requested = false;
+  stream->last_result = FR_OK;
+  stream->buffer = xStreamBufferCreateStatic(size, 1, storage, &stream->buffer_struct);
+  stream->flushed = xSemaphoreCreateBinaryStatic(&stream->flushed_struct);
+}
+
+static void stream_register(fatfs_stream_t* stream)
+{
+  taskENTER_CRITICAL();
+  stream->next = g_streams;
+  g_streams = stream;
+  taskEXIT_CRITICAL();
+}
+
+static void stream_unregister(fatfs_stream_t* stream)
+{
+  taskENTER_CRITICAL();
+  for (fatfs_stream_t** p = &g_streams; *p != NULL; p = &(*p)->next) {
+    if (*p == stream) {
+      *p = stream->next;
+      break;
+    }
+  }
+  taskEXIT_CRITICAL();
+}
+
+#endif // (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
 
+void fatfs_stream_open(fatfs_stream_t* stream, FIL* fp, uint8_t* storage,
+    size_t size, const fatfs_sync_policy_t* policy)
+{
+#if (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
+  stream_init(stream, fp, storage, size, policy);
+  stream_register(stream);
+#else // (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
+  stream->fp = fp;
+  stream->policy = *policy;
+  stream->unsynced_bytes = 0;
+  stream->last_result = FR_OK;
+#endif // (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
+}
+
+FRESULT fatfs_stream_write(fatfs_stream_t* stream, const void* buff, UINT btw, UINT* bw)
+{
+#if (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
   // xStreamBufferSend() returns the the number of bytes written (*bw output).
   // FatFS's f_write() only returns less than bytes_to_write (btw) if the disk
   // is full; here it is based on the stream buffer, so the meaning of
   // (less than btw) is changed. It now means the StreamBuffer is full.
-  //
-  *bw = (UINT)xStreamBufferSend(g_stream_buffer_handle, buff, btw, portMAX_DELAY);
+  const uint8_t* data = (const uint8_t*)buff;
+  size_t sent = xStreamBufferSend(stream->buffer, data, btw, 0);
+  while (sent < btw) {
+    // The writer only drains whole chunks and sleeps until it is woken, so
+    // wake it before blocking on a full buffer or neither side would move.
+    // It leaves less than a chunk behind, so a chunk always fits again.
+    wake_writer();
+    size_t len = btw - sent;
+    if (len > stream->chunk) {
+      len = stream->chunk;
+    }
+    sent += xStreamBufferSend(stream->buffer, data + sent, len, portMAX_DELAY);
+  }
+  *bw = (UINT)sent;
+
+  // Wake the writer for a full chunk, or for the first bytes so it can
+  // start the sync timer.
+  size_t available = xStreamBufferBytesAvailable(stream->buffer);
+  if (available >= stream->chunk || (available == *bw && stream->policy.sync_ms > 0)) {
+    wake_writer();
+  }
 
   // We return the result of the last call to f_write(), so that the writing
   // task has a chance to see than something when wrong during its streaming.
-  return last_result;
+  return stream->last_result;
 #else // (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
   // Task disabled, call write directly.
-  FRESULT result = f_write(fp, buff, btw, bw);
-  f_delayed_sync(fp, *bw);
+  FRESULT result = f_write(stream->fp, buff, btw, bw);
+  stream->unsynced_bytes += *bw;
+  if (result == FR_OK && stream->policy.sync_bytes > 0 &&
+      stream->unsynced_bytes >= stream->policy.sync_bytes) {
+    result = f_sync(stream->fp);
+    stream->unsynced_bytes = 0;
+  }
   return result;
 #endif // (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
 }
 
-FRESULT f_sync_wait(FIL* fp)
+FRESULT fatfs_stream_sync(fatfs_stream_t* stream)
+{
+#if (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
+  LOGV(TAG, "fatfs_stream_sync(): Flushing StreamBuffer");
+  // drop a completion left over from a flush that timed out
+  xSemaphoreTake(stream->flushed, 0);
+  stream->flush_requested = true;
+  wake_writer();
+
+  if (xSemaphoreTake(stream->flushed, pdMS_TO_TICKS(FATFS_FSYNC_FLUSH_TIMEOUT_MS)) != pdTRUE) {
+    LOGE(TAG, "fatfs_stream_sync(): Could not flush StreamBuffer in %u ms", FATFS_FSYNC_FLUSH_TIMEOUT_MS);
+    return FR_DISK_ERR;
+  }
+  return stream->last_result;
+#else // (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
+  stream->unsynced_bytes = 0;
+  return f_sync(stream->fp);  // f_sync() is a blocking call and will sync FatFS buffers to disk
+#endif // (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
+}
+
+FRESULT fatfs_stream_close(fatfs_stream_t* stream)
+{
+  FRESULT result = fatfs_stream_sync(stream);
+#if (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
+  stream_unregister(stream);
+#endif // (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
+  return result;
+}
+
+void fatfs_writer_set_default_policy(const fatfs_sync_policy_t* policy)
 {
+  taskENTER_CRITICAL();
+  g_default_policy = *policy;
 #if (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
-  uint32_t time0_ms = (uint32_t)xTaskGetTickCount();
-  uint32_t delta_t = 0;
+  g_default_stream.policy = *policy;
+#endif // (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
+  taskEXIT_CRITICAL();
+}
 
-  BaseType_t buffer_is_empty = xStreamBufferIsEmpty(g_stream_buffer_handle);
+void fatfs_writer_get_default_policy(fatfs_sync_policy_t* policy)
+{
+  taskENTER_CRITICAL();
+  *policy = g_default_policy;
+  taskEXIT_CRITICAL();
+}
 
-  LOGV(TAG, "f_sync_wait(): Flushing StreamBuffer");
-  while (buffer_is_empty != pdTRUE && delta_t < FATFS_FSYNC_FLUSH_TIMEOUT_MS) {
-    vTaskDelay(10 / portTICK_PERIOD_MS);
+void fatfs_writer_get_stats(fatfs_writer_stats_t* stats)
+{
+#if (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
+  taskENTER_CRITICAL();
+  *stats = g_stats;
+  taskEXIT_CRITICAL();
+#else // (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
+  memset(stats, 0, sizeof(*stats));
+#endif // (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
+}
 
-    buffer_is_empty = xStreamBufferIsEmpty(g_stream_buffer_handle);
-    delta_t = (uint32_t)xTaskGetTickCount() - time0_ms;
-  }
+#if !(defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
+void fatfs_writer_set_charging(bool charging)
+{
+}
+#endif // !(defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
 
-  if (buffer_is_empty != pdTRUE) {
-    LOGE(TAG, "f_sync_wait(): Could not flush StreamBuffer in %u ms", FATFS_FSYNC_FLUSH_TIMEOUT_MS);
-    return FR_DISK_ERR;
+void fatfs_writer_reset_stats(void)
+{
+#if (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
+  taskENTER_CRITICAL();
+  memset(&g_stats, 0, sizeof(g_stats));
+  taskEXIT_CRITICAL();
+#endif // (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
+}
+
+FRESULT f_write_nowait(FIL* fp, const void* buff, UINT btw, UINT* bw)
+{
+#if (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
+  fatfs_stream_t* stream = find_stream(fp);
+  if (stream == NULL) {
+    // Hand the default stream over to this file once the previous one has
+    // been written out, it used to be written to the wrong file.
+    stream = &g_default_stream;
+    if (stream->fp != fp) {
+      if (stream->fp != NULL) {
+        fatfs_stream_sync(stream);
+      }
+      // errors on the previous file don't carry over to this one
+      stream->last_result = FR_OK;
+    }
+    stream->fp = fp;
   }
+  return fatfs_stream_write(stream, buff, btw, bw);
+#else // (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
+  // Task disabled, call write directly.
+  FRESULT result = f_write(fp, buff, btw, bw);
+  f_delayed_sync(fp, *bw);
+  return result;
+#endif // (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
+}
 
+FRESULT f_sync_wait(FIL* fp)
+{
+#if (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
+  fatfs_stream_t* stream = find_stream(fp);
+  if (stream != NULL) {
+    return fatfs_stream_sync(stream);
+  }
   LOGV(TAG, "f_sync_wait(): Flushing FatFS internal buffer to disk");
   return f_sync(fp);  // f_sync() is a blocking call and will sync FatFS buffers to disk
 #else // (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
@@ -131,14 +314,11 @@ FRESULT f_sync_wait(FIL* fp)
 void fatfs_writer_pretask_init(void)
 {
 #if (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
-  static const size_t FATFS_STREAM_TRIGGER_LEVEL_BYTES = 1;
-
   // Any pre-scheduler init goes here.
-  g_stream_buffer_handle = xStreamBufferCreateStatic(
-      sizeof(g_stream_buffer_array),
-      FATFS_STREAM_TRIGGER_LEVEL_BYTES,
-      g_stream_buffer_array,
-      &(g_stream_buffer_struct) );
+  // The default stream is registered with no file, f_write_nowait() binds it.
+  stream_init(&g_default_stream, NULL, g_stream_buffer_array,
+      FATFS_NOWAIT_STREAM_BUFFER_SIZE, &g_default_policy);
+  stream_register(&g_default_stream);
 #endif // (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
 }
 
@@ -161,6 +341,7 @@ static void try_relocate(void)
     LOGE(TAG, "dhara_map_preemptive_recover() error: %d", err);
   } else if (status) {
     LOGW(TAG, "dhara_map_preemptive_recover() relocated a failing block");
+    dhara_wear_note_relocation();
 
     // This may not be the last block -- try again on the next writeback
     // cycle.
@@ -171,30 +352,214 @@ static void try_relocate(void)
 }
 #endif // (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
 
-void fatfs_writer_task(void* ignored)
-{
 #if (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
-  size_t byte_count;
-  UINT bytes_written;
-  static uint8_t buffer[FF_MIN_SS];  // f_write() up to one FatFS sector at a time
+// f_write() up to one FatFS sector (one NAND page) at a time
+static uint8_t g_write_buffer[FF_MIN_SS];
 
-  while (1) {
-    // Wait for another task to write to us:
-    byte_count = xStreamBufferReceive(g_stream_buffer_handle, buffer, sizeof(buffer), portMAX_DELAY);
+// Write whole chunks, and the rest if a sync is due or flush is set. True
+// if it needs a sync.
+static bool write_stream(fatfs_stream_t* stream, bool flush, TickType_t now)
+{
+  size_t available = xStreamBufferBytesAvailable(stream->buffer);
+
+  if (available > 0 && !stream->pending) {
+    stream->pending = true;
+    stream->pending_since = now;
+  }
+  bool sync_due = flush || (stream->pending && stream->policy.sync_ms > 0 &&
+      (now - stream->pending_since) >= pdMS_TO_TICKS(stream->policy.sync_ms));
+
+  while (available > 0) {
+    // End each write on a page boundary of the file, so FatFS writes the
+    // following pages whole and straight to the Dhara map, rather than
+    // through its sector buffer with a read-modify-write.
+    size_t len = stream->chunk;
+    if (len == NAND_PAGE_SIZE) {
+      len -= (size_t)(f_tell(stream->fp) % NAND_PAGE_SIZE);
+    }
+    if (available < len) {
+      if (!sync_due) {
+        break;
+      }
+      len = available;
+    }
+    len = xStreamBufferReceive(stream->buffer, g_write_buffer, len, 0);
 
     // Got some bytes. Write them, with a potential blocking delay:
-    last_result = f_write(g_current_file_pointer, buffer, byte_count, &bytes_written);
+    UINT bytes_written = 0;
+    FRESULT result = f_write(stream->fp, g_write_buffer, len, &bytes_written);
+    if (FR_OK != result || bytes_written < len) {
+      LOGW(TAG, "f_write() error %u", result);
+    }
+    stream->last_result = result;
+    stream->unsynced_bytes += len;
+    available -= len;
+    g_stats.writes++;
+    g_stats.bytes += len;
+  }
 
-    if (FR_OK != last_result || bytes_written < byte_count) {
-      LOGW(TAG, "f_write() error %u", last_result);
+  if (stream->policy.sync_bytes > 0 && stream->unsynced_bytes >= stream->policy.sync_bytes) {
+    sync_due = true;
+  }
+  return sync_due;
+}
+
+// flush: the flush request seen by write_stream(), a request made since
+// then is completed on the next pass, once its data is written too.
+static void sync_stream(fatfs_stream_t* stream, bool flush, TickType_t now)
+{
+  if (stream->unsynced_bytes > 0) {
+    FRESULT result = f_sync(stream->fp);
+    if (FR_OK != result) {
+      LOGW(TAG, "f_sync() error %u", result);
     }
+    stream->last_result = result;
+    stream->unsynced_bytes = 0;
+    g_stats.syncs++;
+  }
+  // anything that arrived meanwhile starts a new sync period
+  stream->pending = xStreamBufferBytesAvailable(stream->buffer) > 0;
+  stream->pending_since = now;
+  if (flush) {
+    stream->flush_requested = false;
+    xSemaphoreGive(stream->flushed);
+  }
+}
 
-    // Sync the file system periodically
-    f_delayed_sync(g_current_file_pointer, byte_count);
+// One pass over all streams. Returns how long the writer may sleep, *busy
+// is set if any stream has data that is not yet synced.
+static TickType_t service_streams(bool* busy)
+{
+  TickType_t now = xTaskGetTickCount();
+  TickType_t wait = portMAX_DELAY;
+  bool any_sync = false;
+  fatfs_stream_t* stream;
+
+  // Streams are only added at the head, a stream registered during the pass
+  // is picked up on the next one.
+  taskENTER_CRITICAL();
+  fatfs_stream_t* first = g_streams;
+  taskEXIT_CRITICAL();
+
+  for (stream = first; stream != NULL; stream = stream->next) {
+    if (stream->fp == NULL) {
+      continue;
+    }
+    bool flush = stream->flush_requested;
+    if (write_stream(stream, flush, now)) {
+      sync_stream(stream, flush, now);
+      any_sync = true;
+    }
+  }
 
-    if (dhara_recovery_hint_take()) {
-      try_relocate();
+  // Coalesce syncs: once the FAT and directory are being written anyway, sync
+  // the other streams with unsynced data in the same pass instead of each
+  // starting its own later.
+  for (stream = first; stream != NULL; stream = stream->next) {
+    if (stream->fp == NULL) {
+      continue;
+    }
+    if (any_sync && stream->unsynced_bytes > 0) {
+      sync_stream(stream, false, now);
+    }
+    if (stream->pending || stream->unsynced_bytes > 0) {
+      *busy = true;
     }
+    if (stream->pending && stream->policy.sync_ms > 0) {
+      TickType_t elapsed = now - stream->pending_since;
+      TickType_t period = pdMS_TO_TICKS(stream->policy.sync_ms);
+      TickType_t left = (elapsed < period) ? (period - elapsed) : 0;
+      if (left < wait) {
+        wait = left;
+      }
+    }
+  }
+  return wait;
+}
+
+// Flash maintenance, only while idle. Returns true if there is more to do.
+static bool maintenance(TickType_t now)
+{
+  static TickType_t last_save = 0;
+  static bool saved_once = false;
+  dhara_error_t err;
+  int status;
+
+  if (dhara_recovery_hint_take()) {
+    try_relocate();
+    // try_relocate() sets the hint again if there may be more
+    return true;
+  }
+
+  if (!fatfs_lock()) {
+    LOGE(TAG, "fatfs_lock() timed out");
+    return false;
+  }
+  status = dhara_idle_gc(dhara_get_my_map(), &err);
+  fatfs_unlock();
+
+  if (status < 0) {
+    LOGE(TAG, "dhara_idle_gc() error: %d", err);
+  }
+  if (status > 0) {
+    return true;
+  }
+
+  if (dhara_wear_dirty() &&
+      (!saved_once || (now - last_save) >= pdMS_TO_TICKS(FATFS_WEAR_SAVE_PERIOD_MS))) {
+    dhara_wear_save();
+    last_save = now;
+    saved_once = true;
+  }
+  return false;
+}
+
+void fatfs_writer_set_charging(bool charging)
+{
+  g_charging = charging;
+  wake_writer();
+}
+#endif // (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
+
+void fatfs_writer_task(void* ignored)
+{
+#if (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
+  TickType_t last_busy = xTaskGetTickCount();
+  bool maintenance_done = false;
+
+  g_writer_task_handle = xTaskGetCurrentTaskHandle();
+
+  dhara_wear_load();
+
+  while (1) {
+    bool busy = false;
+    TickType_t wait = service_streams(&busy);
+    TickType_t now = xTaskGetTickCount();
+
+    if (busy) {
+      last_busy = now;
+      maintenance_done = false;
+    }
+    else if (!maintenance_done) {
+      // Garbage collection and relocation are left for when nothing is
+      // being logged, so they don't add to the write latency of a session.
+      TickType_t idle = now - last_busy;
+      TickType_t idle_wait = pdMS_TO_TICKS(FATFS_MAINTENANCE_IDLE_MS);
+      if (g_charging || idle >= idle_wait) {
+        if (maintenance(now)) {
+          wait = 1;  // let other tasks at the filesystem, then go on
+        } else {
+          maintenance_done = true;
+        }
+      }
+      else if (idle_wait - idle < wait) {
+        wait = idle_wait - idle;
+      }
+    }
+
+    // Wait for another task to write to us, for the next sync deadline, or
+    // for the device to become idle:
+    ulTaskNotifyTake(pdTRUE, wait);
   }  // while(1)
 #endif // (defined(ENABLE_FS_WRITER_TASK) && (ENABLE_FS_WRITER_TASK > 0U))
 }
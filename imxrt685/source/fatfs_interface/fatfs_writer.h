@@ -11,7 +11,11 @@
 #define FATFS_WRITER_H
 
 #include <stddef.h>
+#include <stdbool.h>
 #include "ff.h"
+#include "FreeRTOS.h"
+#include "stream_buffer.h"
+#include "semphr.h"
 
 #ifdef __cplusplus
 extern "C"{
@@ -29,11 +33,85 @@ extern "C"{
 // to the calling task. This allows it to continue sampling on a sub-240 ms tick
 // into the RAM-based StreamBuffer.
 //
-// This assumes only one task is calling f_write_nowait() at a time.
+// Each open file gets its own stream (fatfs_stream_t), with its own buffer
+// and sync policy. The writer task serves all of them: it writes whole NAND
+// pages as they fill up, the remainder only when a sync is due, and does
+// the syncs due at the end of each pass together. Only one task may write
+// to a given stream.
 //
-// It uses a full 4K byte array to buffer up to one sector, so it consumes
-// a lot of RAM and should be disabled if not used.
+// Each f_sync() rewrites the FAT and the directory entry, so the sync policy
+// sets the trade-off: data lost on a power failure is bounded by sync_bytes
+// and sync_ms, whichever comes first, while syncing less often saves flash
+// writes and wear.
 
+typedef struct
+{
+  uint32_t sync_bytes;  // f_sync() once this many bytes are written, 0 = no limit
+  uint32_t sync_ms;     // or once the oldest unsynced byte is this old, 0 = no limit
+} fatfs_sync_policy_t;
+
+// Policy of the default stream, see f_write_nowait(). Up to 32 KB or
+// 30 s of data at risk, a few syncs per minute at data log rates.
+#ifndef FATFS_SYNC_BYTES_DEFAULT
+#define FATFS_SYNC_BYTES_DEFAULT (32*1024U)
+#endif
+#ifndef FATFS_SYNC_MS_DEFAULT
+#define FATFS_SYNC_MS_DEFAULT (30*1000U)
+#endif
+
+typedef struct
+{
+  uint32_t writes;  // f_write() calls
+  uint32_t syncs;   // f_sync() calls
+  uint32_t bytes;
+} fatfs_writer_stats_t;
+
+// Storage passed to fatfs_stream_open() for a buffer of n bytes.
+#define FATFS_STREAM_STORAGE_SIZE(n) ((n) + 1)
+
+// Owned by the caller and must persist (static) while the stream is open.
+// The fields are private to fatfs_writer.c.
+typedef struct fatfs_stream
+{
+  FIL* fp;
+  fatfs_sync_policy_t policy;
+  size_t chunk;  // bytes per f_write(), a NAND page or half the buffer
+  StreamBufferHandle_t buffer;
+  StaticStreamBuffer_t buffer_struct;
+
+  // writer task only
+  uint32_t unsynced_bytes;
+  bool pending;  // buffered or unsynced data, since pending_since
+  TickType_t pending_since;
+
+  volatile bool flush_requested;
+  volatile FRESULT last_result;
+  SemaphoreHandle_t flushed;  // given when a requested flush is done
+  StaticSemaphore_t flushed_struct;
+  struct fatfs_stream* next;
+} fatfs_stream_t;
+
+// Register a stream for fp, which must already be open. storage must hold
+// FATFS_STREAM_STORAGE_SIZE(size) bytes. Use a size of at least two NAND
+// pages to get whole page writes.
+void fatfs_stream_open(fatfs_stream_t* stream, FIL* fp, uint8_t* storage,
+    size_t size, const fatfs_sync_policy_t* policy);
+
+// Non-blocking unless the buffer is full. Returns the result of the last
+// f_write() or f_sync() on this stream, *bw is the number of bytes buffered.
+FRESULT fatfs_stream_write(fatfs_stream_t* stream, const void* buff, UINT btw, UINT* bw);
+
+// Block until the buffer is written and synced.
+FRESULT fatfs_stream_sync(fatfs_stream_t* stream);
+
+// Sync and unregister the stream. The caller then closes the file.
+FRESULT fatfs_stream_close(fatfs_stream_t* stream);
+
+//
+// The f_write() like functions below use the stream registered for fp, or
+// a default stream for files that don't have their own. The default stream
+// serves one file at a time, switching it to another file first waits for
+// the previous one to be written.
 //
 // This non-blocking function returns the result of the *previous* internal call
 // to f_write(), so that the calling task that repeatedly calls this function
@@ -53,6 +131,21 @@ FRESULT f_write_nowait(FIL* fp, const void* buff, UINT btw, UINT* bw);
 // This should be called before calling f_close(fp) if using f_write_nowait().
 FRESULT f_sync_wait(FIL* fp);
 
+// Change the policy of the default stream, takes effect on its next write.
+void fatfs_writer_set_default_policy(const fatfs_sync_policy_t* policy);
+void fatfs_writer_get_default_policy(fatfs_sync_policy_t* policy);
+
+void fatfs_writer_get_stats(fatfs_writer_stats_t* stats);
+void fatfs_writer_reset_stats(void);
+
+// Flash maintenance (Dhara garbage collection, relocation of failing blocks,
+// saving the wear statistics) runs in the writer task once no stream has
+// had data for FATFS_MAINTENANCE_IDLE_MS, or right away while charging.
+#define FATFS_MAINTENANCE_IDLE_MS (10*1000U)
+#define FATFS_WEAR_SAVE_PERIOD_MS (60*60*1000U)
+
+void fatfs_writer_set_charging(bool charging);
+
 // Launch this dedicated writer task in main.c:
 void fatfs_writer_pretask_init(void);
 void fatfs_writer_task(void* ignored);
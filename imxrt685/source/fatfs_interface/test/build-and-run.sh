@@ -0,0 +1,14 @@
+set -x
+
+# fatfs_writer.c on a pthread FreeRTOS shim, writing to RAM files
+gcc -O2 -Wall -pthread \
+ -I shim \
+ -I .. \
+ ../fatfs_writer.c \
+ ./shim/freertos_shim.c \
+ ./fatfs_writer_test.c \
+ -o fatfs_writer_test && \
+./fatfs_writer_test || exit 1
+
+# cleanup
+rm ./fatfs_writer_test
@@ -0,0 +1,191 @@
+// Host test for the fatfs writer task: the task runs in its own thread on
+// a pthread FreeRTOS shim and writes to RAM files (shim/ff.h) with a
+// simulated flash delay, so senders fill their stream buffers.
+//
+// - records larger than the free space of the default stream, with no sync
+//   deadline to wake the writer, used to block the sender forever
+// - a user metrics stream and the data log write at the same time
+// - the default stream moves from one file to the next
+// - with the default policy, and with the policies fs_sync_policy can set,
+//   a blocked sender does not wait for the sync deadline
+//
+// A hang is a failure, SIGALRM ends the test.
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "fatfs_writer.h"
+#include "fatfs_utils.h"
+#include "nand.h"
+#include "task.h"
+
+unsigned ff_write_delay_us = 0;
+
+// nothing else uses the filesystem
+int fatfs_lock(void) { return 1; }
+void fatfs_unlock(void) {}
+
+// data_log.cpp writes up to HSE_SCRATCH_BUFFER_SIZE bytes at a time
+#define DATA_LOG_RECORD_SIZE 2554
+#define METRICS_RECORD_SIZE 12
+#define METRICS_BATCH_SIZE (42*METRICS_RECORD_SIZE)
+
+static uint8_t pattern(uint8_t id, size_t offset)
+{
+  return (uint8_t)(id + offset*7 + offset/251);
+}
+
+// Write records of record_size bytes until total bytes are written.
+static void write_records(FIL* fp, fatfs_stream_t* stream, uint8_t id,
+    size_t record_size, size_t total)
+{
+  uint8_t record[DATA_LOG_RECORD_SIZE];
+  size_t offset = 0;
+
+  while (offset < total) {
+    size_t len = (total - offset < record_size) ? total - offset : record_size;
+    for (size_t i = 0; i < len; i++) {
+      record[i] = pattern(id, offset + i);
+    }
+    UINT bw = 0;
+    FRESULT result = (stream != NULL) ?
+        fatfs_stream_write(stream, record, len, &bw) :
+        f_write_nowait(fp, record, len, &bw);
+    assert(result == FR_OK);
+    assert(bw == len);
+    offset += len;
+  }
+}
+
+static void check_file(const FIL* fp, uint8_t id, size_t total)
+{
+  assert(fp->size == total);
+  assert(fp->synced == total);
+  for (size_t i = 0; i < total; i++) {
+    assert(fp->data[i] == pattern(id, i));
+  }
+}
+
+static void* writer_thread(void* arg)
+{
+  fatfs_writer_task(arg);
+  return NULL;
+}
+
+static void test_large_records(void)
+{
+  static FIL log;
+  const size_t total = 400*DATA_LOG_RECORD_SIZE + 100;
+
+  // syncs by size only, nothing else wakes the writer
+  fatfs_sync_policy_t policy = { .sync_bytes = 2*NAND_PAGE_SIZE, .sync_ms = 0 };
+  fatfs_writer_set_default_policy(&policy);
+
+  write_records(&log, NULL, 1, DATA_LOG_RECORD_SIZE, total);
+  assert(f_sync_wait(&log) == FR_OK);
+  check_file(&log, 1, total);
+  assert(log.syncs >= total/(2*NAND_PAGE_SIZE));
+  printf("large records: %u bytes, %u syncs: ok\n", (unsigned) log.size, log.syncs);
+}
+
+static fatfs_stream_t g_metrics_stream;
+static uint8_t g_metrics_storage[FATFS_STREAM_STORAGE_SIZE(2*METRICS_BATCH_SIZE)];
+static FIL g_metrics_log;
+#define METRICS_TOTAL (2000*METRICS_RECORD_SIZE)
+
+static void* metrics_thread(void* arg)
+{
+  (void)arg;
+  write_records(&g_metrics_log, &g_metrics_stream, 2, METRICS_RECORD_SIZE, METRICS_TOTAL);
+  return NULL;
+}
+
+static void test_streams(void)
+{
+  static FIL log;
+  const size_t total = 100*DATA_LOG_RECORD_SIZE;
+  pthread_t thread;
+
+  // the user metrics policy: a sync per batch, or after five minutes
+  fatfs_sync_policy_t policy = { .sync_bytes = METRICS_BATCH_SIZE, .sync_ms = 5*60*1000 };
+  fatfs_stream_open(&g_metrics_stream, &g_metrics_log, g_metrics_storage,
+      2*METRICS_BATCH_SIZE, &policy);
+
+  pthread_create(&thread, NULL, metrics_thread, NULL);
+  write_records(&log, NULL, 3, DATA_LOG_RECORD_SIZE, total);
+  pthread_join(thread, NULL);
+
+  assert(fatfs_stream_close(&g_metrics_stream) == FR_OK);
+  assert(f_sync_wait(&log) == FR_OK);
+  check_file(&g_metrics_log, 2, METRICS_TOTAL);
+  check_file(&log, 3, total);
+  // synced as batches fill, one pass writes at most the two in the buffer
+  assert(g_metrics_log.syncs >= METRICS_TOTAL/(2*METRICS_BATCH_SIZE));
+  printf("streams: %u syncs for %u metrics bytes: ok\n",
+      g_metrics_log.syncs, (unsigned) g_metrics_log.size);
+}
+
+static void test_rebind(void)
+{
+  static FIL first;
+  static FIL second;
+
+  write_records(&first, NULL, 4, 1000, 3000);
+  // the tail of the first file must not end up in the second
+  write_records(&second, NULL, 5, 1000, 5000);
+  assert(f_sync_wait(&second) == FR_OK);
+  check_file(&first, 4, 3000);
+  check_file(&second, 5, 5000);
+  printf("rebind: ok\n");
+}
+
+// Policies fs_sync_policy sets through fatfs_writer_set_default_policy()
+static void test_policies(void)
+{
+  static const fatfs_sync_policy_t policies[] = {
+    { FATFS_SYNC_BYTES_DEFAULT, FATFS_SYNC_MS_DEFAULT },
+    { FATFS_SYNC_BYTES_DEFAULT, 0 },
+    { 0, FATFS_SYNC_MS_DEFAULT },
+  };
+  static FIL logs[sizeof(policies)/sizeof(policies[0])];
+  const size_t total = 100*DATA_LOG_RECORD_SIZE;
+
+  for (size_t i = 0; i < sizeof(logs)/sizeof(logs[0]); i++) {
+    fatfs_writer_set_default_policy(&policies[i]);
+    TickType_t start = xTaskGetTickCount();
+    write_records(&logs[i], NULL, 6 + i, DATA_LOG_RECORD_SIZE, total);
+    TickType_t elapsed = xTaskGetTickCount() - start;
+    assert(f_sync_wait(&logs[i]) == FR_OK);
+    check_file(&logs[i], 6 + i, total);
+    // the writer drains the buffer as the sender fills it, well before
+    // FATFS_SYNC_MS_DEFAULT
+    assert(elapsed < pdMS_TO_TICKS(FATFS_SYNC_MS_DEFAULT/10));
+    printf("policy %u bytes / %u ms: %u ms: ok\n", (unsigned) policies[i].sync_bytes,
+        (unsigned) policies[i].sync_ms, (unsigned) elapsed);
+  }
+}
+
+int main(void)
+{
+  pthread_t thread;
+
+  alarm(60);
+  xTaskGetTickCount();
+  // slower than the senders, so their buffers fill up
+  ff_write_delay_us = 200;
+
+  fatfs_writer_pretask_init();
+  pthread_create(&thread, NULL, writer_thread, NULL);
+
+  test_large_records();
+  test_streams();
+  test_rebind();
+  test_policies();
+
+  printf("fatfs_writer_test passed\n");
+  return 0;
+}
@@ -0,0 +1,30 @@
+/*
+ * FreeRTOS.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host test shim. The kernel calls used by fatfs_writer.c,
+ * implemented on pthreads in freertos_shim.c. One tick is one millisecond.
+ */
+
+#ifndef FATFS_TEST_SHIM_FREERTOS_H_
+#define FATFS_TEST_SHIM_FREERTOS_H_
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef long BaseType_t;
+
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFUL)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define pdTRUE  (1)
+#define pdFALSE (0)
+
+void shim_enter_critical(void);
+void shim_exit_critical(void);
+#define taskENTER_CRITICAL() shim_enter_critical()
+#define taskEXIT_CRITICAL()  shim_exit_critical()
+
+#endif /* FATFS_TEST_SHIM_FREERTOS_H_ */
@@ -0,0 +1,14 @@
+/*
+ * config.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host test shim for config/config.h.
+ */
+
+#ifndef FATFS_TEST_SHIM_CONFIG_H_
+#define FATFS_TEST_SHIM_CONFIG_H_
+
+#define ENABLE_FS_WRITER_TASK (1U)
+
+#endif /* FATFS_TEST_SHIM_CONFIG_H_ */
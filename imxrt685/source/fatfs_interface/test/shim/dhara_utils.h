@@ -0,0 +1,23 @@
+/*
+ * dhara_utils.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host test shim, a map that never needs maintenance.
+ */
+
+#ifndef FATFS_TEST_SHIM_DHARA_UTILS_H_
+#define FATFS_TEST_SHIM_DHARA_UTILS_H_
+
+#include <stdbool.h>
+
+typedef int dhara_error_t;
+struct dhara_map;
+
+static inline struct dhara_map* dhara_get_my_map(void) { return NULL; }
+static inline int dhara_map_preemptive_recover(struct dhara_map* map, dhara_error_t* err) { return 0; }
+static inline int dhara_idle_gc(struct dhara_map* map, dhara_error_t* err) { return 0; }
+static inline void dhara_recovery_hint_set(void) {}
+static inline bool dhara_recovery_hint_take(void) { return false; }
+
+#endif /* FATFS_TEST_SHIM_DHARA_UTILS_H_ */
@@ -0,0 +1,19 @@
+/*
+ * dhara_wear.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host test shim, no wear statistics.
+ */
+
+#ifndef FATFS_TEST_SHIM_DHARA_WEAR_H_
+#define FATFS_TEST_SHIM_DHARA_WEAR_H_
+
+#include <stdbool.h>
+
+static inline void dhara_wear_load(void) {}
+static inline void dhara_wear_save(void) {}
+static inline bool dhara_wear_dirty(void) { return false; }
+static inline void dhara_wear_note_relocation(void) {}
+
+#endif /* FATFS_TEST_SHIM_DHARA_WEAR_H_ */
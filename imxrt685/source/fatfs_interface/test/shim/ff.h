@@ -0,0 +1,63 @@
+/*
+ * ff.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host test shim. A FIL is a growing RAM buffer; f_write()
+ * sleeps for ff_write_delay_us to stand in for a slow flash write.
+ */
+
+#ifndef FATFS_TEST_SHIM_FF_H_
+#define FATFS_TEST_SHIM_FF_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef unsigned int UINT;
+typedef uint32_t DWORD;
+typedef uint32_t FSIZE_t;
+
+typedef enum {
+  FR_OK = 0,
+  FR_DISK_ERR,
+} FRESULT;
+
+typedef struct {
+  uint8_t* data;
+  size_t size;
+  size_t cap;
+  size_t synced;   // size at the last f_sync()
+  unsigned syncs;
+} FIL;
+
+extern unsigned ff_write_delay_us;
+
+static inline FRESULT
+f_write(FIL* fp, const void* buff, UINT btw, UINT* bw)
+{
+  if (fp->size + btw > fp->cap) {
+    fp->cap = 2*(fp->size + btw);
+    fp->data = realloc(fp->data, fp->cap);
+  }
+  memcpy(&fp->data[fp->size], buff, btw);
+  fp->size += btw;
+  *bw = btw;
+  if (ff_write_delay_us > 0) {
+    usleep(ff_write_delay_us);
+  }
+  return FR_OK;
+}
+
+static inline FRESULT
+f_sync(FIL* fp)
+{
+  fp->synced = fp->size;
+  fp->syncs++;
+  return FR_OK;
+}
+
+#define f_tell(fp) ((FSIZE_t)(fp)->size)
+
+#endif /* FATFS_TEST_SHIM_FF_H_ */
@@ -0,0 +1,15 @@
+/*
+ * ffconf.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host test shim, the sector sizes of config/ffconf.h.
+ */
+
+#ifndef FATFS_TEST_SHIM_FFCONF_H_
+#define FATFS_TEST_SHIM_FFCONF_H_
+
+#define FF_MIN_SS 2048
+#define FF_MAX_SS 2048
+
+#endif /* FATFS_TEST_SHIM_FFCONF_H_ */
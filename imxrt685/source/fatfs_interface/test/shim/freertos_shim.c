@@ -0,0 +1,208 @@
+/*
+ * freertos_shim.c
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host test shim, see FreeRTOS.h. Every kernel object shares
+ * one mutex and one condition variable; any change wakes all waiters,
+ * which then check their own condition again.
+ */
+
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "stream_buffer.h"
+#include "semphr.h"
+
+struct shim_task
+{
+  uint32_t notify;
+};
+
+static pthread_mutex_t g_critical = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+static pthread_mutex_t g_kernel = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_changed = PTHREAD_COND_INITIALIZER;
+static __thread struct shim_task g_current_task;
+
+void shim_enter_critical(void)
+{
+  pthread_mutex_lock(&g_critical);
+}
+
+void shim_exit_critical(void)
+{
+  pthread_mutex_unlock(&g_critical);
+}
+
+static uint64_t now_ms(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec*1000 + ts.tv_nsec/1000000;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+  static uint64_t start = 0;
+  if (start == 0) {
+    start = now_ms();
+  }
+  return (TickType_t)(now_ms() - start);
+}
+
+// Wait on g_changed, with g_kernel held. False once the deadline passed.
+static int wait_changed(const struct timespec* deadline)
+{
+  if (deadline == NULL) {
+    pthread_cond_wait(&g_changed, &g_kernel);
+    return 1;
+  }
+  return pthread_cond_timedwait(&g_changed, &g_kernel, deadline) == 0;
+}
+
+static struct timespec* deadline_for(TickType_t wait, struct timespec* ts)
+{
+  if (wait == portMAX_DELAY) {
+    return NULL;
+  }
+  clock_gettime(CLOCK_REALTIME, ts);
+  ts->tv_sec += wait/1000;
+  ts->tv_nsec += (long)(wait%1000)*1000000L;
+  if (ts->tv_nsec >= 1000000000L) {
+    ts->tv_sec++;
+    ts->tv_nsec -= 1000000000L;
+  }
+  return ts;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+  return &g_current_task;
+}
+
+void xTaskNotifyGive(TaskHandle_t task)
+{
+  pthread_mutex_lock(&g_kernel);
+  task->notify++;
+  pthread_cond_broadcast(&g_changed);
+  pthread_mutex_unlock(&g_kernel);
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t wait)
+{
+  struct timespec ts;
+  const struct timespec* deadline = deadline_for(wait, &ts);
+  struct shim_task* task = &g_current_task;
+
+  pthread_mutex_lock(&g_kernel);
+  while (task->notify == 0 && wait > 0 && wait_changed(deadline)) {
+  }
+  uint32_t value = task->notify;
+  if (value > 0) {
+    task->notify = clear ? 0 : value - 1;
+  }
+  pthread_mutex_unlock(&g_kernel);
+  return value;
+}
+
+StreamBufferHandle_t xStreamBufferCreateStatic(size_t size, size_t trigger,
+    uint8_t* storage, StaticStreamBuffer_t* buffer)
+{
+  (void)trigger;
+  buffer->storage = storage;
+  buffer->size = size;
+  buffer->head = 0;
+  buffer->count = 0;
+  return buffer;
+}
+
+size_t xStreamBufferSend(StreamBufferHandle_t buffer, const void* data,
+    size_t len, TickType_t wait)
+{
+  struct timespec ts;
+  const struct timespec* deadline = deadline_for(wait, &ts);
+  const uint8_t* src = data;
+
+  pthread_mutex_lock(&g_kernel);
+  while (buffer->size - buffer->count < len && wait > 0 && wait_changed(deadline)) {
+  }
+  size_t space = buffer->size - buffer->count;
+  size_t n = (len < space) ? len : space;
+  for (size_t i = 0; i < n; i++) {
+    buffer->storage[(buffer->head + buffer->count + i) % buffer->size] = src[i];
+  }
+  buffer->count += n;
+  pthread_cond_broadcast(&g_changed);
+  pthread_mutex_unlock(&g_kernel);
+  return n;
+}
+
+size_t xStreamBufferReceive(StreamBufferHandle_t buffer, void* data,
+    size_t len, TickType_t wait)
+{
+  struct timespec ts;
+  const struct timespec* deadline = deadline_for(wait, &ts);
+  uint8_t* dst = data;
+
+  pthread_mutex_lock(&g_kernel);
+  while (buffer->count == 0 && wait > 0 && wait_changed(deadline)) {
+  }
+  size_t n = (len < buffer->count) ? len : buffer->count;
+  for (size_t i = 0; i < n; i++) {
+    dst[i] = buffer->storage[(buffer->head + i) % buffer->size];
+  }
+  buffer->head = (buffer->head + n) % buffer->size;
+  buffer->count -= n;
+  pthread_cond_broadcast(&g_changed);
+  pthread_mutex_unlock(&g_kernel);
+  return n;
+}
+
+size_t xStreamBufferBytesAvailable(StreamBufferHandle_t buffer)
+{
+  pthread_mutex_lock(&g_kernel);
+  size_t n = buffer->count;
+  pthread_mutex_unlock(&g_kernel);
+  return n;
+}
+
+size_t xStreamBufferSpacesAvailable(StreamBufferHandle_t buffer)
+{
+  pthread_mutex_lock(&g_kernel);
+  size_t n = buffer->size - buffer->count;
+  pthread_mutex_unlock(&g_kernel);
+  return n;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t* sem)
+{
+  sem->count = 0;
+  return sem;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t wait)
+{
+  struct timespec ts;
+  const struct timespec* deadline = deadline_for(wait, &ts);
+
+  pthread_mutex_lock(&g_kernel);
+  while (sem->count == 0 && wait > 0 && wait_changed(deadline)) {
+  }
+  BaseType_t taken = (sem->count > 0) ? pdTRUE : pdFALSE;
+  sem->count = 0;
+  pthread_mutex_unlock(&g_kernel);
+  return taken;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+  pthread_mutex_lock(&g_kernel);
+  sem->count = 1;
+  pthread_cond_broadcast(&g_changed);
+  pthread_mutex_unlock(&g_kernel);
+  return pdTRUE;
+}
@@ -0,0 +1,20 @@
+/*
+ * loglevels.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host test shim, warnings and errors go to stdout.
+ */
+
+#ifndef FATFS_TEST_SHIM_LOGLEVELS_H_
+#define FATFS_TEST_SHIM_LOGLEVELS_H_
+
+#include <stdio.h>
+
+#define LOGE(tag, fmt, ...) printf("E %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define LOGW(tag, fmt, ...) printf("W %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define LOGI(tag, fmt, ...)
+#define LOGD(tag, fmt, ...)
+#define LOGV(tag, fmt, ...)
+
+#endif /* FATFS_TEST_SHIM_LOGLEVELS_H_ */
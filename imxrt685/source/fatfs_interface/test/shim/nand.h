@@ -0,0 +1,14 @@
+/*
+ * nand.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host test shim, the page size of the W25N04KW.
+ */
+
+#ifndef FATFS_TEST_SHIM_NAND_H_
+#define FATFS_TEST_SHIM_NAND_H_
+
+#define NAND_PAGE_SIZE 0x800  // 2048 B
+
+#endif /* FATFS_TEST_SHIM_NAND_H_ */
@@ -0,0 +1,25 @@
+/*
+ * semphr.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host test shim, see FreeRTOS.h. Binary semaphores only.
+ */
+
+#ifndef FATFS_TEST_SHIM_SEMPHR_H_
+#define FATFS_TEST_SHIM_SEMPHR_H_
+
+#include "FreeRTOS.h"
+
+typedef struct
+{
+  int count;
+} StaticSemaphore_t;
+
+typedef StaticSemaphore_t* SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t* sem);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t wait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem);
+
+#endif /* FATFS_TEST_SHIM_SEMPHR_H_ */
@@ -0,0 +1,35 @@
+/*
+ * stream_buffer.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host test shim, see FreeRTOS.h. Like FreeRTOS, a blocking
+ * send waits until the whole message fits, and a zero timeout sends what
+ * fits.
+ */
+
+#ifndef FATFS_TEST_SHIM_STREAM_BUFFER_H_
+#define FATFS_TEST_SHIM_STREAM_BUFFER_H_
+
+#include "FreeRTOS.h"
+
+typedef struct
+{
+  uint8_t* storage;
+  size_t size;
+  size_t head;
+  size_t count;
+} StaticStreamBuffer_t;
+
+typedef StaticStreamBuffer_t* StreamBufferHandle_t;
+
+StreamBufferHandle_t xStreamBufferCreateStatic(size_t size, size_t trigger,
+    uint8_t* storage, StaticStreamBuffer_t* buffer);
+size_t xStreamBufferSend(StreamBufferHandle_t buffer, const void* data,
+    size_t len, TickType_t wait);
+size_t xStreamBufferReceive(StreamBufferHandle_t buffer, void* data,
+    size_t len, TickType_t wait);
+size_t xStreamBufferBytesAvailable(StreamBufferHandle_t buffer);
+size_t xStreamBufferSpacesAvailable(StreamBufferHandle_t buffer);
+
+#endif /* FATFS_TEST_SHIM_STREAM_BUFFER_H_ */
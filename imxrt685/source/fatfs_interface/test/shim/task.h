@@ -0,0 +1,21 @@
+/*
+ * task.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host test shim, see FreeRTOS.h.
+ */
+
+#ifndef FATFS_TEST_SHIM_TASK_H_
+#define FATFS_TEST_SHIM_TASK_H_
+
+#include "FreeRTOS.h"
+
+typedef struct shim_task* TaskHandle_t;
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+TickType_t xTaskGetTickCount(void);
+void xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t wait);
+
+#endif /* FATFS_TEST_SHIM_TASK_H_ */
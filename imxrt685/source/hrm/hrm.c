@@ -26,6 +26,7 @@
 #include "hrm.h"
 #include "user_metrics.h"
 #include "ml.h"
+#include "ppg.h"
 
 #if (defined(ENABLE_HRM_TASK) && (ENABLE_HRM_TASK > 0U))
 
@@ -42,6 +43,7 @@ typedef enum
   HRM_EVENT_START,
   HRM_EVENT_ISR,
   HRM_EVENT_STOP,
+  HRM_EVENT_MOTION,
 } hrm_event_type_t;
 
 // Events are passed to the g_event_queue with an optional
@@ -100,6 +102,7 @@ hrm_event_type_name(hrm_event_type_t event_type)
     case HRM_EVENT_START:      	return "HRM_EVENT_START";
     case HRM_EVENT_ISR:      	return "HRM_EVENT_ISR";
     case HRM_EVENT_STOP:     	return "HRM_EVENT_STOP";
+    case HRM_EVENT_MOTION:   	return "HRM_EVENT_MOTION";
     default:
       break;
   }
@@ -120,11 +123,20 @@ hrm_event_turn_on(void)
   xQueueSend(g_event_queue, &event, portMAX_DELAY);
 }
 
+void
+hrm_event_motion(bool in_motion)
+{
+  hrm_event_t event = {.type = HRM_EVENT_MOTION, .user_data = (void*)(uintptr_t) in_motion };
+  // Don't block the accel task, a missed motion edge is recovered on the next batch.
+  xQueueSend(g_event_queue, &event, 0);
+}
+
 static void
 log_event(const hrm_event_t *event)
 {
   switch (event->type) {
   case HRM_EVENT_ISR:
+  case HRM_EVENT_MOTION:
        // squelch this print
        break;
     default:
@@ -163,6 +175,7 @@ handle_state_standby(const hrm_event_t *event)
 		break;
 
 		case HRM_EVENT_START:
+			ppg_reset();
 			max86140_start();
 		break;
 
@@ -174,6 +187,10 @@ handle_state_standby(const hrm_event_t *event)
 			max86140_stop();
 		break;
 
+		case HRM_EVENT_MOTION:
+			ppg_set_motion((bool)(uintptr_t) event->user_data);
+		break;
+
 		default:
 			log_event_ignored(event);
 		break;
@@ -187,10 +204,13 @@ handle_state_read_fifo(const hrm_event_t *event)
 	switch (event->type) {
 		case HRM_EVENT_ENTER_STATE:
 		{
-			uint8_t buff[MAX_FIFO_SAMPLES*3];
+			// the burst read returns the 2 SPI command bytes ahead of the samples
+			uint8_t buff[MAX_FIFO_SAMPLES*PPG_FIFO_SAMPLE_SIZE + 2];
 			uint8_t len = 0;
 			max86140_process_fifo(buff, &len);
 
+			ppg_process_fifo(&buff[2], len);
+
 // Printing of the data, keep for now but eventually remove
 //			printf("read %d samples\r\n", len);
 //			for(uint8_t i=2;i<len;i+=3)
@@ -235,6 +255,10 @@ handle_state_read_fifo(const hrm_event_t *event)
 			set_state(HRM_STATE_STANDBY);
 		break;
 
+		case HRM_EVENT_MOTION:
+			ppg_set_motion((bool)(uintptr_t) event->user_data);
+		break;
+
 		default:
 			log_event_ignored(event);
 		break;
@@ -331,6 +355,7 @@ void hrm_pretask_init(void){}
 void hrm_task(void *ignored){}
 void hrm_event_turn_off(void){}
 void hrm_event_turn_on(void){}
+void hrm_event_motion(bool in_motion){}
 
 void hrm_pint_isr(pint_pin_int_t pintr, uint32_t pmatch_status){}
 
@@ -1,6 +1,7 @@
 #ifndef HRM_H
 #define HRM_H
 
+#include <stdbool.h>
 #include "max86140.h"
 
 // Start: Tell C++ compiler to include this C header.
@@ -15,6 +16,8 @@ void hrm_task(void *ignored);
 // Send various event types to this task:
 void hrm_event_turn_off(void);
 void hrm_event_turn_on(void);
+// Motion state from the accelerometer, gates PPG beat detection
+void hrm_event_motion(bool in_motion);
 
 // End: Tell C++ compiler to include this C header.
 #ifdef __cplusplus
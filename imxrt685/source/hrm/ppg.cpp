@@ -0,0 +1,119 @@
+/*
+ * ppg.cpp
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: PPG heart rate pipeline glue for the HRM task.
+ */
+
+#include "FreeRTOS.h"
+
+#include "config.h"
+#include "loglevels.h"
+#include "ble.h"
+#include "ml.h"
+#include "data_log.h"
+#include "user_metrics.h"
+#include "ppg.h"
+#include "ppg_processing.h"
+
+static const char *TAG = "ppg"; // Logging prefix for this module
+
+typedef struct
+{
+  PPGProcessing ppg;
+  int32_t ambient;              // latest ambient reading, subtracted from the LED
+  uint32_t publish_count;       // samples since the last HR publish
+  uint32_t user_metrics_count;  // HR publishes since the last user metrics input
+  uint8_t heart_rate;
+  float rmssd_ms;
+} ppg_context_t;
+
+static ppg_context_t g_ppg_context;
+
+void
+ppg_reset(void)
+{
+  g_ppg_context.ppg.reset();
+  g_ppg_context.ambient = 0;
+  g_ppg_context.publish_count = 0;
+  g_ppg_context.user_metrics_count = 0;
+  g_ppg_context.heart_rate = 0;
+  g_ppg_context.rmssd_ms = 0;
+}
+
+void
+ppg_set_motion(bool in_motion)
+{
+  g_ppg_context.ppg.set_motion(in_motion);
+}
+
+uint8_t
+ppg_get_heart_rate(void)
+{
+  return g_ppg_context.heart_rate;
+}
+
+float
+ppg_get_rmssd_ms(void)
+{
+  return g_ppg_context.rmssd_ms;
+}
+
+static void
+publish_heart_rate(void)
+{
+  uint8_t heart_rate = g_ppg_context.ppg.heart_rate_bpm();
+  g_ppg_context.rmssd_ms = g_ppg_context.ppg.rmssd_ms();
+
+  // ML expects a continuous 1 Hz stream, 0 means "no valid heart rate"
+  ml_event_hr_input(heart_rate);
+
+  if (heart_rate != g_ppg_context.heart_rate) {
+    ble_heart_rate_update(heart_rate);
+    LOGD(TAG, "hr %u bpm, rmssd %.1f ms", heart_rate, g_ppg_context.rmssd_ms);
+  }
+  g_ppg_context.heart_rate = heart_rate;
+
+  if (++g_ppg_context.user_metrics_count >= PPG_USER_METRICS_PUBLISH_PERIOD_SEC/PPG_HR_PUBLISH_PERIOD_SEC) {
+    g_ppg_context.user_metrics_count = 0;
+    if (heart_rate > 0) {
+      user_metrics_event_input(heart_rate, HRM_DATA);
+    }
+  }
+}
+
+void
+ppg_process_fifo(const uint8_t *fifo, uint8_t num_samples)
+{
+  const uint32_t publish_samples = (uint32_t)(PPG_SAMPLE_FREQ_HZ*PPG_HR_PUBLISH_PERIOD_SEC);
+
+  for (uint8_t i = 0; i < num_samples; i++) {
+    uint8_t tag;
+    int32_t value;
+    ppg_decode_fifo_sample(&fifo[i*PPG_FIFO_SAMPLE_SIZE], &tag, &value);
+
+    switch (tag) {
+      case PPG_FIFO_TAG_AMBIENT:
+        g_ppg_context.ambient = value;
+        break;
+
+      case PPG_FIFO_TAG_HR:
+      {
+        uint16_t ibi_ms;
+        if (g_ppg_context.ppg.process(value - g_ppg_context.ambient, ibi_ms)) {
+          data_log_hr_ibi(g_ppg_context.ppg.last_peak_sample_number(), ibi_ms);
+        }
+        if (++g_ppg_context.publish_count >= publish_samples) {
+          g_ppg_context.publish_count = 0;
+          publish_heart_rate();
+        }
+        break;
+      }
+
+      default:
+        // other LEDs are not used for heart rate
+        break;
+    }
+  }
+}
@@ -0,0 +1,58 @@
+/*
+ * ppg.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: C interface to the PPG heart rate pipeline. Runs in the HRM
+ * task and publishes beat-to-beat intervals to the data log, and heart rate
+ * to ML, BLE and user metrics.
+ */
+
+#ifndef HRM_PPG_H_
+#define HRM_PPG_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// MAX86140 FIFO tags, in LED sequence order (see max86140_start())
+#define PPG_FIFO_TAG_LED1    (0x01)
+#define PPG_FIFO_TAG_LED2    (0x02)
+#define PPG_FIFO_TAG_LED3    (0x03)
+#define PPG_FIFO_TAG_AMBIENT (0x04)
+
+// LED used for heart rate
+#define PPG_FIFO_TAG_HR      PPG_FIFO_TAG_LED1
+
+#define PPG_FIFO_SAMPLE_SIZE (3U)
+
+// Heart rate publish periods, in seconds of PPG data
+#define PPG_HR_PUBLISH_PERIOD_SEC           (1U)  // ML consumes HR at 1 Hz
+#define PPG_USER_METRICS_PUBLISH_PERIOD_SEC (60U)
+
+void ppg_reset(void);
+void ppg_set_motion(bool in_motion);
+
+// Process raw FIFO bytes as read by max86140_process_fifo(), without the two
+// SPI command bytes. num_samples is the FIFO sample count (3 bytes each).
+void ppg_process_fifo(const uint8_t *fifo, uint8_t num_samples);
+
+uint8_t ppg_get_heart_rate(void);
+float ppg_get_rmssd_ms(void);
+
+// Decode one 3-byte FIFO word into its tag and 19-bit value.
+static inline void
+ppg_decode_fifo_sample(const uint8_t *bytes, uint8_t *tag, int32_t *value)
+{
+  *tag = bytes[0] >> 3;
+  *value = ((int32_t)(bytes[0] & 0x07) << 16) | ((int32_t)bytes[1] << 8) | bytes[2];
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HRM_PPG_H_ */
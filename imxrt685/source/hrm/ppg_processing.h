@@ -0,0 +1,240 @@
+/*
+ * ppg_processing.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: PPG heart rate and HRV pipeline.
+ *
+ *   raw counts -> DC removal -> Butterworth bandpass -> peak detection
+ *              -> beat-to-beat interval (IBI) -> HR and RMSSD
+ *
+ * Peaks are gated by motion reported from the accelerometer. This header has
+ * no RTOS dependencies so it can be built on the host (see hrm/test).
+ */
+
+#ifndef HRM_PPG_PROCESSING_H_
+#define HRM_PPG_PROCESSING_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include "ButterworthBandpass.h"
+
+#define PPG_SAMPLE_FREQ_HZ     (200.0f) // MAX86140 PPG_CONFIGURATION_2 = 200 sps
+
+#define PPG_BANDPASS_ORDER     (2)
+#define PPG_BANDPASS_LOW_HZ    (0.5f)   // 30 bpm
+#define PPG_BANDPASS_HIGH_HZ   (4.0f)   // 240 bpm
+#define PPG_DC_REMOVAL_ALPHA   (0.995f)
+
+#define PPG_MIN_IBI_MS         (300U)   // 200 bpm
+#define PPG_MAX_IBI_MS         (2000U)  // 30 bpm
+#define PPG_IBI_MAX_DEVIATION  (0.3f)   // reject intervals >30% from the running mean
+#define PPG_IBI_MAX_REJECTS    (3U)     // consecutive rejects before the history is reset
+#define PPG_IBI_HISTORY        (8U)     // intervals used for HR and RMSSD
+
+#define PPG_ENVELOPE_DECAY     (0.998f) // per sample, halves in ~1.7 s at 200 sps
+#define PPG_PEAK_THRESHOLD     (0.4f)   // fraction of the envelope a peak must reach
+#define PPG_MOTION_HOLDOFF_SEC (2.0f)   // ignore beats for this long after motion stops
+
+class PPGProcessing {
+public:
+
+  PPGProcessing(){
+    init(PPG_SAMPLE_FREQ_HZ);
+  }
+
+  void init(float sample_freq_hz){
+    fs = sample_freq_hz;
+    bandpass.design(PPG_BANDPASS_ORDER, PPG_BANDPASS_LOW_HZ, PPG_BANDPASS_HIGH_HZ, fs, true);
+    refractory_samples = (uint32_t)(fs*PPG_MIN_IBI_MS/1000.0f);
+    holdoff_samples = (uint32_t)(fs*PPG_MOTION_HOLDOFF_SEC);
+    reset();
+  }
+
+  void reset(){
+    bandpass.reset();
+    first_sample = true;
+    dc_x1 = 0;
+    dc_y1 = 0;
+    y1 = 0;
+    y2 = 0;
+    envelope = 0;
+    n = 0;
+    last_peak_valid = false;
+    last_peak_n = 0;
+    in_motion = false;
+    motion_holdoff = 0;
+    reset_ibi_history();
+  }
+
+  // Motion from the accelerometer. Beats are discarded while moving and for
+  // PPG_MOTION_HOLDOFF_SEC afterwards; no interval may span a motion period.
+  void set_motion(bool moving){
+    if(moving){
+      in_motion = true;
+      last_peak_valid = false;
+    }else if(in_motion){
+      in_motion = false;
+      motion_holdoff = holdoff_samples;
+      // motion inflates the envelope, let it re-learn
+      envelope = 0;
+    }
+  }
+
+  // Process one ambient-corrected PPG sample.
+  // Returns true and sets ibi_ms when a new beat-to-beat interval is accepted.
+  bool process(int32_t sample, uint16_t &ibi_ms){
+    float x = (float) sample;
+    if(first_sample){
+      first_sample = false;
+      dc_x1 = x;
+    }
+
+    // DC removal (single-pole high-pass)
+    float dc = x - dc_x1 + PPG_DC_REMOVAL_ALPHA*dc_y1;
+    dc_x1 = x;
+    dc_y1 = dc;
+
+    // Blood volume increase lowers the PPG signal, invert so beats are maxima.
+    float y0 = -bandpass.step(dc);
+
+    bool new_ibi = false;
+    bool gated = in_motion || motion_holdoff > 0;
+    if(motion_holdoff > 0){
+      motion_holdoff--;
+    }
+
+    if(!gated){
+      envelope *= PPG_ENVELOPE_DECAY;
+
+      // local maximum at n-1
+      if(y1 > y2 && y1 >= y0 && y1 > 0 && y1 > PPG_PEAK_THRESHOLD*envelope){
+        uint32_t peak_n = n - 1;
+        if(!last_peak_valid || (peak_n - last_peak_n) >= refractory_samples){
+          if(y1 > envelope){
+            envelope = y1;
+          }
+          if(last_peak_valid){
+            uint32_t ibi = (uint32_t)((peak_n - last_peak_n)*1000.0f/fs + 0.5f);
+            new_ibi = accept_ibi(ibi);
+            if(new_ibi){
+              ibi_ms = (uint16_t) ibi;
+            }
+          }
+          last_peak_n = peak_n;
+          last_peak_valid = true;
+        }
+      }
+    }
+
+    y2 = y1;
+    y1 = y0;
+    n++;
+    return new_ibi;
+  }
+
+  // Mean heart rate over the IBI history, 0 until the history is full.
+  uint8_t heart_rate_bpm(){
+    if(ibi_count < PPG_IBI_HISTORY){
+      return 0;
+    }
+    float bpm = 60000.0f/ibi_mean();
+    return bpm > 255 ? 255 : (uint8_t)(bpm + 0.5f);
+  }
+
+  // Root mean square of successive differences over the IBI history (ms).
+  float rmssd_ms(){
+    if(ibi_count < 2){
+      return 0;
+    }
+    float sum_sq = 0;
+    for(size_t i=1; i<ibi_count; i++){
+      float d = (float)ibi_at(i) - (float)ibi_at(i-1);
+      sum_sq += d*d;
+    }
+    return sqrtf(sum_sq/(ibi_count-1));
+  }
+
+  // Number of samples processed, also the sample number of the next sample.
+  uint32_t sample_number(){
+    return n;
+  }
+
+  uint32_t last_peak_sample_number(){
+    return last_peak_n;
+  }
+
+private:
+  ButterworthBandpass<float, PPG_BANDPASS_ORDER> bandpass;
+
+  float fs;
+  uint32_t refractory_samples;
+  uint32_t holdoff_samples;
+
+  bool first_sample;
+  float dc_x1;
+  float dc_y1;
+
+  float y1;
+  float y2;
+  float envelope;
+  uint32_t n;
+
+  bool last_peak_valid;
+  uint32_t last_peak_n;
+
+  bool in_motion;
+  uint32_t motion_holdoff;
+
+  // IBI history ring, ibi_at(0) is the oldest
+  uint16_t ibis[PPG_IBI_HISTORY];
+  size_t ibi_index;
+  size_t ibi_count;
+  size_t ibi_rejects;
+
+  void reset_ibi_history(){
+    memset(ibis, 0, sizeof(ibis));
+    ibi_index = 0;
+    ibi_count = 0;
+    ibi_rejects = 0;
+  }
+
+  uint16_t ibi_at(size_t i){
+    return ibis[(ibi_index + PPG_IBI_HISTORY - ibi_count + i) % PPG_IBI_HISTORY];
+  }
+
+  float ibi_mean(){
+    float total = 0;
+    for(size_t i=0; i<ibi_count; i++){
+      total += ibi_at(i);
+    }
+    return total/ibi_count;
+  }
+
+  bool accept_ibi(uint32_t ibi){
+    if(ibi < PPG_MIN_IBI_MS || ibi > PPG_MAX_IBI_MS){
+      return false;
+    }
+    if(ibi_count >= 3){
+      float mean = ibi_mean();
+      if(fabsf(ibi - mean) > PPG_IBI_MAX_DEVIATION*mean){
+        // a sustained change in rhythm restarts the history
+        if(++ibi_rejects >= PPG_IBI_MAX_REJECTS){
+          reset_ibi_history();
+        }
+        return false;
+      }
+    }
+    ibi_rejects = 0;
+    ibis[ibi_index] = (uint16_t) ibi;
+    ibi_index = (ibi_index + 1) % PPG_IBI_HISTORY;
+    if(ibi_count < PPG_IBI_HISTORY){
+      ibi_count++;
+    }
+    return true;
+  }
+};
+
+#endif /* HRM_PPG_PROCESSING_H_ */
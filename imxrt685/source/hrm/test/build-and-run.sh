@@ -0,0 +1,18 @@
+set -x
+
+# Runs the PPG pipeline on a synthetic signal.
+# Pass a recorded PPG file (one ambient-corrected LED1 sample per line, 200 sps)
+# to print the beat-to-beat intervals and heart rate for it instead.
+
+g++ -std=c++11 \
+ -I .. \
+ -I ../../signal_processing/ \
+ -I ../../../CMSIS/ \
+ -I ../../../CMSIS/DSP/Include/ \
+ ./ppg_test.cpp \
+ ../../signal_processing/iir.c \
+ -o ppg_test -lm && \
+./ppg_test "$@"
+
+# cleanup
+rm ./ppg_test
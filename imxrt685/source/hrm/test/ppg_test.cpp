@@ -0,0 +1,92 @@
+#include "ppg_processing.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+// Synthetic PPG: DC level, slow baseline drift, one dip per beat and noise.
+static int32_t synth_sample(uint32_t n, float bpm)
+{
+  const float fs = PPG_SAMPLE_FREQ_HZ;
+  float t = n/fs;
+  float beat_period = 60.0f/bpm;
+  float phase = fmodf(t, beat_period)/beat_period;
+  float pulse = expf(-powf((phase-0.2f)/0.06f, 2));
+  float drift = 400*sinf(2*M_PI*0.05f*t);
+  float noise = (rand()%41) - 20;
+  return (int32_t)(100000 + drift - 2000*pulse + noise);
+}
+
+static uint8_t run_synth(PPGProcessing &ppg, float bpm, float seconds, uint32_t &num_ibis)
+{
+  static uint32_t n = 0;
+  uint32_t end = n + (uint32_t)(seconds*PPG_SAMPLE_FREQ_HZ);
+  num_ibis = 0;
+  for(; n<end; n++){
+    uint16_t ibi_ms;
+    if(ppg.process(synth_sample(n, bpm), ibi_ms)){
+      num_ibis++;
+    }
+  }
+  return ppg.heart_rate_bpm();
+}
+
+static void test_synthetic(void)
+{
+  PPGProcessing ppg;
+  uint32_t num_ibis;
+
+  // steady 72 bpm
+  uint8_t hr = run_synth(ppg, 72, 30, num_ibis);
+  printf("72 bpm -> hr %u, %u intervals, rmssd %.1f ms\n", hr, num_ibis, ppg.rmssd_ms());
+  assert(abs(hr - 72) <= 2);
+  assert(num_ibis >= 30);
+  assert(ppg.rmssd_ms() < 20);
+
+  // motion gates beats for the motion period and the hold-off after it
+  ppg.set_motion(true);
+  run_synth(ppg, 72, 5, num_ibis);
+  assert(num_ibis == 0);
+  ppg.set_motion(false);
+  run_synth(ppg, 72, PPG_MOTION_HOLDOFF_SEC - 0.1f, num_ibis);
+  assert(num_ibis == 0);
+  run_synth(ppg, 72, 10, num_ibis);
+  assert(num_ibis > 0);
+
+  // rhythm change is followed after a few rejected beats
+  hr = run_synth(ppg, 50, 40, num_ibis);
+  printf("50 bpm -> hr %u\n", hr);
+  assert(abs(hr - 50) <= 2);
+}
+
+static void run_file(const char *path)
+{
+  FILE *f = fopen(path, "r");
+  assert(f != NULL);
+
+  PPGProcessing ppg;
+  long value;
+  while(fscanf(f, "%ld", &value) == 1){
+    uint16_t ibi_ms;
+    if(ppg.process((int32_t) value, ibi_ms)){
+      printf("%lu %u %u %.1f\n", (unsigned long) ppg.last_peak_sample_number(), ibi_ms,
+          ppg.heart_rate_bpm(), ppg.rmssd_ms());
+    }
+  }
+  fclose(f);
+}
+
+int main(int argc, char **argv)
+{
+  if(argc > 1){
+    // columns: beat sample number, ibi_ms, hr_bpm, rmssd_ms
+    run_file(argv[1]);
+    return 0;
+  }
+
+  srand(1);
+  test_synthetic();
+  printf("ppg tests passed\n");
+  return 0;
+}
@@ -51,6 +51,7 @@
 #include "pmic_pca9420.h"
 
 #include "powerquad_helper.h"
+#include "profiler.h"
 
 #include "fsl_usart_rtos_additional.h"
 
@@ -285,6 +286,9 @@ static void system_boot_up(void)
     // init micro clock
     init_micro_clock(); // TODO: Fix this clock to compensate for the 16Mhz clock input.
 
+    // enable the DWT cycle counter used for stage profiling
+    profiler_init();
+
 }
 
 int main(void)
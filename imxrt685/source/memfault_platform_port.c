@@ -19,6 +19,7 @@
 //! TODO: Fill in FIXMEs below for your platform
 #include "fw_version.h"
 #include "fatfs_utils.h"
+#include "dhara_wear.h"
 #include "rtc.h"
 #include "memfault/metrics/platform/overrides.h"
 
@@ -26,6 +27,7 @@
 #include "memfault/ports/reboot_reason.h"
 #include "memfault/ports/freertos.h"
 #include "nand_W25N04KW.h"
+#include "nand_layout.h"
 #include "fs_commands.h"
 #include "system_watchdog.h"
 
@@ -77,8 +79,8 @@ void memfault_platform_log(eMemfaultPlatformLogLevel level, const char *fmt,
   va_end(args);
 }
 
-#define MEMFAULT_COREDUMP_NVADDR (290800)
-#define MEMFAULT_COREDUMP_NV_BLKADDR (4075)
+// First page of the coredump block, see common/nand/nand_layout.h
+#define MEMFAULT_COREDUMP_NVADDR (NAND_LAYOUT_MEMFAULT_BLOCK * NAND_LAYOUT_PAGES_PER_BLOCK)
 #define MEMFAULT_PLATFORM_COREDUMP_NVSTORAGE_SIZE NAND_BLOCK_SIZE
 
 
@@ -195,6 +197,15 @@ void memfault_metrics_heartbeat_collect_data(void) {
   f_getfreebytes(&fs_free_bytes, NULL);
   memfault_metrics_heartbeat_set_unsigned(MEMFAULT_METRICS_KEY(fatfs_free_bytes), fs_free_bytes);
 
+  // lifetime flash wear, for early warning of worn out parts
+  dhara_wear_stats_t wear;
+  dhara_wear_get_stats(&wear);
+  memfault_metrics_heartbeat_set_unsigned(MEMFAULT_METRICS_KEY(nand_erases), wear.erases);
+  memfault_metrics_heartbeat_set_unsigned(MEMFAULT_METRICS_KEY(nand_max_block_erases), wear.max_block_erases);
+  memfault_metrics_heartbeat_set_unsigned(MEMFAULT_METRICS_KEY(nand_bad_blocks_marked), wear.bad_blocks_marked);
+  memfault_metrics_heartbeat_set_unsigned(MEMFAULT_METRICS_KEY(nand_ecc_warnings), wear.ecc_warnings);
+  memfault_metrics_heartbeat_set_unsigned(MEMFAULT_METRICS_KEY(nand_relocations), wear.relocations);
+
   // FAKE (battery_pct)
   static uint8_t fake_pct = 100;
   memfault_metrics_heartbeat_set_unsigned(MEMFAULT_METRICS_KEY(battery_pct), fake_pct);
@@ -268,7 +279,6 @@ bool memfault_platform_coredump_storage_erase(uint32_t offset, size_t erase_size
     return false;
   }
 
-  // erase block 4075 corresponding to page_addr 260800
   if(nand_erase_block(&g_nand_handle, MEMFAULT_COREDUMP_NVADDR) < 0) {
 	  return false;
   }
@@ -28,6 +28,21 @@ public:
         return eeg_volts;
     }
 
+    // Filter n samples in place, same result as calling filter() on each.
+    // scratch must hold n values.
+    void filter_block(T* eeg_volts, T* scratch, size_t n, bool enable_line, bool enable_az){
+        if(enable_line){
+          lpfilter45.step_block(eeg_volts, n);
+        }
+        if(enable_az){
+          memcpy(scratch, eeg_volts, n*sizeof(T));
+          hpfilter.step_block(scratch, n);
+          for(size_t j=0; j<n; j++){
+            eeg_volts[j] = eeg_volts[j] - scratch[j];
+          }
+        }
+    }
+
     void designLineFilters(int order, double cutoffFreq, double sampleFreq, bool resetCache){
         lpfilter45.design(order, cutoffFreq, sampleFreq, resetCache);
     }
@@ -1,102 +1,135 @@
 #ifndef _MIN_MAX_H_
 #define _MIN_MAX_H_
 
-#include "Deque.h"
+#include <stddef.h>
+#include <stdint.h>
 
 // Implementation of "Ascending Minima"
 // Original implementation:
 // https://stackoverflow.com/questions/14823713/efficient-rolling-max-and-min-window
 // Copied on: October 6th, 2020.
-
-template<class T>
+//
+// Sliding window min/max over the last win_size samples in O(1) amortized
+// time per sample. The candidates are kept in a monotonic queue stored in a
+// fixed-capacity ring, each tagged with the index of the sample it came from.
+// A candidate leaves the window once it is win_size samples older than the
+// newest sample. Ages are unsigned differences of sample indices, so they
+// stay correct when the index wraps around as long as the window is smaller
+// than the index range (IndexT must be unsigned).
+//
+// The window can be resized at runtime without discarding history: shrinking
+// drops the candidates that fall outside the new window, growing keeps the
+// current candidates and the window fills up with new samples.
+
+template<class T, class IndexT>
 struct ExtremeValue
 {
-    unsigned long remove_index;
+    IndexT sample_index;
     T value;
-    ExtremeValue(){ }
-    ExtremeValue(size_t remove_index_, T value_): 
-      remove_index(remove_index_), value(value_){
-    }
 };
 
-template<class T, int MAX_WINDOW_SIZE>
-class MovingMin{
+template<class T, int MAX_WINDOW_SIZE, bool IS_MAX, class IndexT = uint32_t>
+class MovingExtremum{
 private:
-    Deque<ExtremeValue<T>,MAX_WINDOW_SIZE> queue;
+    ExtremeValue<T,IndexT> ring[MAX_WINDOW_SIZE];
+    size_t front_;   // ring slot of the oldest candidate
+    size_t fill_;    // number of candidates, never more than win_size_
     size_t win_size_;
-    unsigned long index_;
-    ExtremeValue<T> errVal;
+    IndexT index_;   // index of the next sample
+
+    size_t slot(size_t i){
+        return (front_ + i) % MAX_WINDOW_SIZE;
+    }
+
+    // true if a candidate with value a can never be the extremum once b is in the window
+    static bool dominated(T a, T b){
+        return IS_MAX ? (a <= b) : (a >= b);
+    }
+
+    // drop the candidates outside the window ending at sample index newest
+    void expire(IndexT newest){
+        while (fill_ > 0 && (IndexT)(newest - ring[front_].sample_index) >= win_size_){
+            front_ = slot(1);
+            fill_--;
+        }
+    }
+
 public:
-    MovingMin(size_t win_size): queue(win_size), win_size_(win_size), index_(0), errVal(0,0){
+    MovingExtremum(size_t win_size): front_(0), fill_(0), win_size_(1), index_(0){
+        setWindowSize(win_size);
+    }
+
+    void reset(){
+        front_ = 0;
+        fill_ = 0;
     }
 
     void setWindowSize(size_t win_size){
-        // TODO: something more clever instead of resetting the queue
-        queue.empty();
-        queue.setSize(win_size);
+        if (win_size < 1){
+            win_size = 1;
+        }
+        if (win_size > MAX_WINDOW_SIZE){
+            win_size = MAX_WINDOW_SIZE;
+        }
         win_size_ = win_size;
-        index_ = 0;
+        expire((IndexT)(index_ - 1));
     }
 
-    T getMin(){
-        return queue.getFront(errVal).value;
+    size_t getWindowSize(){
+        return win_size_;
     }
 
-    T getMin(T val)
-    {
-        while (queue.getFill() > 0 && index_ >= queue.getFront(errVal).remove_index){
-            queue.deleteFront();
-        }
+    // Extremum of the window, 0 before the first sample.
+    T get(){
+        return (fill_ > 0) ? ring[front_].value : T(0);
+    }
 
-        while (queue.getFill() > 0 && queue.getBack(errVal).value >= val){
-            queue.deleteBack();
-        }
+    // Add a sample and return the extremum of the window ending with it.
+    T add(T val){
+        expire(index_);
 
-        ExtremeValue<T> newVal(index_ + win_size_, val);
-        queue.insertBack(newVal);
+        while (fill_ > 0 && dominated(ring[slot(fill_ - 1)].value, val)){
+            fill_--;
+        }
 
+        ExtremeValue<T,IndexT>& e = ring[slot(fill_)];
+        e.sample_index = index_;
+        e.value = val;
+        fill_++;
         index_++;
-        // TODO: something clever when index++ wraps around
-        return queue.getFront(errVal).value;
+
+        return ring[front_].value;
     }
 };
 
-template<class T, int MAX_WINDOW_SIZE>
-class MovingMax{
-private:
-    Deque<ExtremeValue<T>,MAX_WINDOW_SIZE> queue;
-    size_t win_size_;
-    unsigned long index_;
-    ExtremeValue<T> errVal;
+template<class T, int MAX_WINDOW_SIZE, class IndexT = uint32_t>
+class MovingMin : public MovingExtremum<T,MAX_WINDOW_SIZE,false,IndexT>{
 public:
-    MovingMax(size_t win_size): queue(win_size), win_size_(win_size), index_(0), errVal(0,0){
+    MovingMin(size_t win_size): MovingExtremum<T,MAX_WINDOW_SIZE,false,IndexT>(win_size){
     }
 
-    void setWindowSize(size_t win_size){
-        win_size_ = win_size;
+    T getMin(){
+        return this->get();
     }
 
-    T getMax(){
-        return queue.getFront(errVal).value;
+    T getMin(T val){
+        return this->add(val);
     }
+};
 
-    T getMax(T val)
-    {
-        while (queue.getFill() > 0 && index_ >= queue.getFront(errVal).remove_index){
-            queue.deleteFront();
-        }
-
-        while (queue.getFill() > 0 && queue.getBack(errVal).value <= val){
-            queue.deleteBack();
-        }
+template<class T, int MAX_WINDOW_SIZE, class IndexT = uint32_t>
+class MovingMax : public MovingExtremum<T,MAX_WINDOW_SIZE,true,IndexT>{
+public:
+    MovingMax(size_t win_size): MovingExtremum<T,MAX_WINDOW_SIZE,true,IndexT>(win_size){
+    }
 
-        ExtremeValue<T> newVal(index_ + win_size_, val);
-        queue.insertBack(newVal);
+    T getMax(){
+        return this->get();
+    }
 
-        index_++;
-        // TODO: something clever when index++ wraps around
-        return queue.getFront(errVal).value;
+    T getMax(T val){
+        return this->add(val);
     }
 };
 
-#endif //_MIN_MAX_H_
\ No newline at end of file
+#endif //_MIN_MAX_H_
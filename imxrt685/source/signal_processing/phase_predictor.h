@@ -0,0 +1,139 @@
+/*
+ * phase_predictor.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Extrapolates the ECHT instantaneous phase between samples.
+ *
+ * The phase velocity is estimated from successive (timestamp, phase) pairs,
+ * smoothed with an exponential average and kept inside the ECHT passband, so
+ * a phase slip cannot drag the estimate away. Given the latest sample,
+ * phase_predictor_schedule() says how long from "now" until a target phase
+ * is crossed, so a timer can be armed for the crossing instead of waiting for
+ * the first sample past it.
+ *
+ * Timestamps are microseconds in a free running uint32_t (the EEG sample
+ * number is micros() at DRDY), differences stay valid across the wrap.
+ */
+
+#ifndef SIGNAL_PROCESSING_PHASE_PREDICTOR_H_
+#define SIGNAL_PROCESSING_PHASE_PREDICTOR_H_
+
+#include <math.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PHASE_PREDICTOR_2PI (6.28318531f)
+
+// Smoothing of the phase velocity estimate, 1/16 ~ 64 ms at 250 Hz.
+#ifndef PHASE_PREDICTOR_ALPHA
+#define PHASE_PREDICTOR_ALPHA (1.0f/16.0f)
+#endif
+
+// Gaps longer than this (dropped samples, ECHT restarted) restart the estimate.
+#ifndef PHASE_PREDICTOR_MAX_GAP_US
+#define PHASE_PREDICTOR_MAX_GAP_US (20000U)
+#endif
+
+typedef struct
+{
+  float min_rad_per_us;  // passband edges
+  float max_rad_per_us;
+  float default_rad_per_us;  // center frequency
+  float rad_per_us;      // smoothed estimate
+  float last_phs;
+  uint32_t last_us;
+  bool primed;
+} phase_predictor_t;
+
+typedef enum
+{
+  PHASE_PREDICT_WAIT = 0,  // crossing is beyond the horizon, or long gone
+  PHASE_PREDICT_ARM,       // crossing is delay_us from now
+  PHASE_PREDICT_NOW,       // crossing was just missed, act immediately
+} phase_predict_action_t;
+
+// Wrap to [-pi, pi).
+static inline float phase_predictor_wrap_pi(float angle){
+  angle = fmodf(angle + PHASE_PREDICTOR_2PI/2, PHASE_PREDICTOR_2PI);
+  if (angle < 0) {
+    angle += PHASE_PREDICTOR_2PI;
+  }
+  return angle - PHASE_PREDICTOR_2PI/2;
+}
+
+static inline void phase_predictor_reset(phase_predictor_t* p){
+  p->rad_per_us = p->default_rad_per_us;
+  p->primed = false;
+}
+
+static inline void phase_predictor_init(phase_predictor_t* p, float center_hz, float low_hz, float high_hz){
+  p->min_rad_per_us = PHASE_PREDICTOR_2PI * low_hz / 1e6f;
+  p->max_rad_per_us = PHASE_PREDICTOR_2PI * high_hz / 1e6f;
+  p->default_rad_per_us = PHASE_PREDICTOR_2PI * center_hz / 1e6f;
+  phase_predictor_reset(p);
+}
+
+// Add the phase (rad) of the sample taken at t_us.
+static inline void phase_predictor_update(phase_predictor_t* p, uint32_t t_us, float phs){
+  uint32_t dt = t_us - p->last_us;
+  if (p->primed && dt > 0 && dt <= PHASE_PREDICTOR_MAX_GAP_US) {
+    // the phase only moves forward, take the increment in [0, 2pi)
+    float dphs = phase_predictor_wrap_pi(phs - p->last_phs);
+    if (dphs < 0) {
+      dphs += PHASE_PREDICTOR_2PI;
+    }
+    float w = dphs / dt;
+    // more than twice the top of the passband is a phase slip, skip it
+    if (w <= 2 * p->max_rad_per_us) {
+      p->rad_per_us += PHASE_PREDICTOR_ALPHA * (w - p->rad_per_us);
+      if (p->rad_per_us < p->min_rad_per_us) {
+        p->rad_per_us = p->min_rad_per_us;
+      } else if (p->rad_per_us > p->max_rad_per_us) {
+        p->rad_per_us = p->max_rad_per_us;
+      }
+    }
+  } else if (p->primed) {
+    phase_predictor_reset(p);
+  }
+  p->last_phs = phs;
+  p->last_us = t_us;
+  p->primed = true;
+}
+
+// Phase (rad) extrapolated from the last sample to now_us.
+static inline float phase_predictor_phase_at(const phase_predictor_t* p, uint32_t now_us){
+  return p->last_phs + p->rad_per_us * (float)(int32_t)(now_us - p->last_us);
+}
+
+// What to do at now_us about the next crossing of target (rad). A crossing up
+// to horizon_us ahead is ARM with *delay_us set. A crossing missed by less
+// than late_window_rad is NOW, so a late prediction still fires inside the
+// stimulation window, anything older is WAIT for the next cycle.
+static inline phase_predict_action_t phase_predictor_schedule(const phase_predictor_t* p, uint32_t now_us,
+    float target, float late_window_rad, uint32_t horizon_us, uint32_t* delay_us){
+  if (!p->primed) {
+    return PHASE_PREDICT_WAIT;
+  }
+  float d = phase_predictor_wrap_pi(target - phase_predictor_phase_at(p, now_us));
+  if (d >= 0) {
+    float delay = d / p->rad_per_us;
+    if (delay <= (float) horizon_us) {
+      *delay_us = (uint32_t) delay;
+      return PHASE_PREDICT_ARM;
+    }
+  } else if (-d < late_window_rad) {
+    return PHASE_PREDICT_NOW;
+  }
+  return PHASE_PREDICT_WAIT;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIGNAL_PROCESSING_PHASE_PREDICTOR_H_ */
@@ -0,0 +1,21 @@
+set -x
+
+# Property test of the moving min/max against a brute force reference,
+# including sample index wraparound and window resizing.
+
+g++ -std=c++11 \
+ -I .. \
+ ./min_max_test.cpp \
+ -o min_max_test && \
+./min_max_test
+
+# Phase extrapolation and crossing prediction used by the stimulus scheduler.
+
+gcc -I .. \
+ ./phase_predictor_test.c \
+ -lm \
+ -o phase_predictor_test && \
+./phase_predictor_test
+
+# cleanup
+rm ./min_max_test ./phase_predictor_test
@@ -0,0 +1,129 @@
+#include "min_max.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MAX_WIN (64)
+#define HISTORY (4096)
+
+// Brute force reference: extremum of the last win samples of history.
+static int brute(const int* history, size_t count, size_t win, bool is_max)
+{
+  size_t n = (count < win) ? count : win;
+  int ext = history[count - 1];
+  for (size_t i = count - n; i < count; i++) {
+    if (is_max ? (history[i] > ext) : (history[i] < ext)) {
+      ext = history[i];
+    }
+  }
+  return ext;
+}
+
+// Random samples (with plenty of repeats) and random window changes,
+// checked against the brute force reference after every sample. After the
+// window grows it covers only the samples kept so far (covered), until it
+// has refilled.
+template<class IndexT>
+static void test_random(unsigned seed, size_t num_samples)
+{
+  static int history[HISTORY];
+  size_t count = 0;
+  size_t win = 16;
+  size_t covered = 0;
+
+  MovingMin<int,MAX_WIN,IndexT> moving_min(win);
+  MovingMax<int,MAX_WIN,IndexT> moving_max(win);
+
+  srand(seed);
+  for (size_t n = 0; n < num_samples; n++) {
+    if (rand() % 200 == 0) {
+      win = 1 + rand() % MAX_WIN;
+      moving_min.setWindowSize(win);
+      moving_max.setWindowSize(win);
+      // resizing keeps the history that fits in the new window
+      if (covered > win) {
+        covered = win;
+      }
+      if (count > 0) {
+        assert(moving_min.getMin() == brute(history, count, covered, false));
+        assert(moving_max.getMax() == brute(history, count, covered, true));
+      }
+    }
+
+    if (count == HISTORY) {
+      // keep the most recent MAX_WIN samples
+      for (size_t i = 0; i < MAX_WIN; i++) {
+        history[i] = history[HISTORY - MAX_WIN + i];
+      }
+      count = MAX_WIN;
+    }
+    int val = (rand() % 21) - 10;
+    history[count++] = val;
+    if (covered < win) {
+      covered++;
+    }
+
+    int mn = moving_min.getMin(val);
+    int mx = moving_max.getMax(val);
+    assert(mn == moving_min.getMin());
+    assert(mx == moving_max.getMax());
+    assert(mn == brute(history, count, covered, false));
+    assert(mx == brute(history, count, covered, true));
+  }
+}
+
+// Fixed window, exact against the reference on every sample.
+template<class IndexT>
+static void test_exact(size_t win, size_t num_samples)
+{
+  static int history[HISTORY];
+  size_t count = 0;
+
+  MovingMin<int,MAX_WIN,IndexT> moving_min(win);
+  MovingMax<int,MAX_WIN,IndexT> moving_max(win);
+
+  for (size_t n = 0; n < num_samples; n++) {
+    if (count == HISTORY) {
+      for (size_t i = 0; i < MAX_WIN; i++) {
+        history[i] = history[HISTORY - MAX_WIN + i];
+      }
+      count = MAX_WIN;
+    }
+    int val = (rand() % 1001) - 500;
+    history[count++] = val;
+
+    assert(moving_min.getMin(val) == brute(history, count, win, false));
+    assert(moving_max.getMax(val) == brute(history, count, win, true));
+  }
+}
+
+int main(int argc, char** argv)
+{
+  // uint8_t/uint16_t indices wrap every 256/65536 samples
+  for (size_t win = 1; win <= MAX_WIN; win++) {
+    test_exact<uint8_t>(win, 2000);
+  }
+  test_exact<uint16_t>(37, 200000);
+  test_exact<uint32_t>(MAX_WIN, 20000);
+
+  for (unsigned seed = 1; seed <= 50; seed++) {
+    test_random<uint8_t>(seed, 20000);
+    test_random<uint32_t>(seed, 20000);
+  }
+
+  // shrinking the window keeps the newest samples
+  MovingMax<int,MAX_WIN> moving_max(8);
+  for (int i = 0; i < 8; i++) {
+    moving_max.getMax(10 - i);  // 10 9 ... 3
+  }
+  assert(moving_max.getMax() == 10);
+  moving_max.setWindowSize(3);
+  assert(moving_max.getMax() == 5);
+  // growing keeps what is left and fills with new samples
+  moving_max.setWindowSize(8);
+  assert(moving_max.getMax(0) == 5);
+
+  printf("min_max test passed\n");
+  return 0;
+}
@@ -0,0 +1,182 @@
+/*
+ * phase_predictor_test.c
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host test for the phase predictor. A noisy 250 Hz phase
+ * stream is replayed with jittered timestamps and processing latency, the
+ * scheduled crossings must land within a fraction of a millisecond of the
+ * true target crossing.
+ */
+
+#include "phase_predictor.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SAMPLE_US (4000U)
+
+static float noise(float amp)
+{
+  return amp * (2.0f * rand() / RAND_MAX - 1.0f);
+}
+
+static float wrap_2pi(float angle)
+{
+  angle = fmodf(angle, PHASE_PREDICTOR_2PI);
+  return angle < 0 ? angle + PHASE_PREDICTOR_2PI : angle;
+}
+
+static void test_wrap(void)
+{
+  assert(fabsf(phase_predictor_wrap_pi(0.5f) - 0.5f) < 1e-6f);
+  assert(fabsf(phase_predictor_wrap_pi(PHASE_PREDICTOR_2PI - 0.5f) + 0.5f) < 1e-5f);
+  assert(fabsf(phase_predictor_wrap_pi(-PHASE_PREDICTOR_2PI - 0.5f) + 0.5f) < 1e-5f);
+}
+
+// Converges on the true frequency inside the passband, clamps outside it.
+static void test_estimate(float hz, float expect_hz, uint32_t start_us)
+{
+  phase_predictor_t p;
+  phase_predictor_init(&p, 10, 7.5f, 12.5f);
+
+  uint32_t t = start_us;
+  for (int n = 0; n < 500; n++) {
+    float true_phs = PHASE_PREDICTOR_2PI * hz * (float)n * SAMPLE_US / 1e6f;
+    phase_predictor_update(&p, t, wrap_2pi(true_phs + noise(0.05f)));
+    t += SAMPLE_US;
+  }
+  float est_hz = p.rad_per_us * 1e6f / PHASE_PREDICTOR_2PI;
+  assert(fabsf(est_hz - expect_hz) < 0.1f);
+}
+
+// Schedule a crossing of target on every cycle of a hz oscillation, with the
+// decision made latency_us after each sample and a pulse locking out further
+// pulses for PULSE_US, like the stimulus scheduler. Returns the worst onset
+// error after the estimate has settled.
+#define PULSE_US (28000U)
+
+static float run_schedule(float hz, float target, uint32_t latency_us, int* num_pulses, int* num_late)
+{
+  phase_predictor_t p;
+  phase_predictor_init(&p, 10, 7.5f, 12.5f);
+
+  const float late_window = 0.6f;
+  const uint32_t horizon_us = 2 * SAMPLE_US + latency_us;
+  const float true_w = PHASE_PREDICTOR_2PI * hz / 1e6f;
+  const uint32_t t0 = 0xFFF00000U; // wraps part way through
+
+  float worst = 0;
+  *num_pulses = 0;
+  *num_late = 0;
+  bool armed = false;
+  uint32_t armed_at = 0;
+  uint32_t pulse_end = t0;
+
+  uint32_t t = t0;
+  for (int n = 0; n < 5000; n++) {
+    uint32_t t_sample = t + rand() % 50;
+    float true_phs = true_w * (float)(uint32_t)(t_sample - t0);
+    phase_predictor_update(&p, t_sample, wrap_2pi(true_phs + noise(0.02f)));
+    uint32_t now = t_sample + latency_us;
+
+    // the timer armed earlier fires before this decision
+    uint32_t onset = 0;
+    bool pulse = false;
+    if (armed && (int32_t)(now - armed_at) >= 0) {
+      onset = armed_at;
+      pulse = true;
+      armed = false;
+    }
+
+    if (!pulse && (int32_t)(now - pulse_end) >= 0) {
+      uint32_t delay_us = 0;
+      switch (phase_predictor_schedule(&p, now, target, late_window, horizon_us, &delay_us)) {
+        case PHASE_PREDICT_ARM:
+          armed_at = now + delay_us;
+          armed = true;
+          break;
+        case PHASE_PREDICT_NOW:
+          onset = now;
+          pulse = true;
+          armed = false;
+          (*num_late)++;
+          break;
+        case PHASE_PREDICT_WAIT:
+          armed = false;
+          break;
+      }
+    }
+
+    if (pulse) {
+      float onset_phs = true_w * (float)(uint32_t)(onset - t0);
+      float err_us = fabsf(phase_predictor_wrap_pi(onset_phs - target)) / true_w;
+      if (n > 100 && err_us > worst) {
+        worst = err_us;
+      }
+      pulse_end = onset + PULSE_US;
+      (*num_pulses)++;
+    }
+    t += SAMPLE_US;
+  }
+  return worst;
+}
+
+static void test_schedule(float hz, uint32_t latency_us)
+{
+  int num_pulses = 0;
+  int num_late = 0;
+  float worst_us = run_schedule(hz, 2.2f, latency_us, &num_pulses, &num_late);
+  printf("  %.1f Hz, latency %u us: %d pulses (%d fired late), worst onset error %.0f us\n",
+      hz, (unsigned) latency_us, num_pulses, num_late, worst_us);
+  // one pulse per cycle over 20 s
+  assert(abs(num_pulses - (int)(hz * 20)) <= 1);
+  // the sample grid alone would be off by up to 4 ms, what is left is
+  // mostly the 0.02 rad phase noise (400 us at 8 Hz)
+  assert(worst_us < 600);
+}
+
+static void test_late(void)
+{
+  phase_predictor_t p;
+  phase_predictor_init(&p, 10, 7.5f, 12.5f);
+  phase_predictor_update(&p, 0, 1.0f);
+
+  uint32_t delay_us = 0;
+  // target just behind the extrapolated phase: fire now
+  assert(phase_predictor_schedule(&p, 0, 0.9f, 0.6f, 8000, &delay_us) == PHASE_PREDICT_NOW);
+  // target well behind: wait for the next cycle
+  assert(phase_predictor_schedule(&p, 0, 0.2f, 0.6f, 8000, &delay_us) == PHASE_PREDICT_WAIT);
+  // target ahead, 0.2 rad at 10 Hz is ~3.2 ms
+  assert(phase_predictor_schedule(&p, 0, 1.2f, 0.6f, 8000, &delay_us) == PHASE_PREDICT_ARM);
+  assert(delay_us > 3000 && delay_us < 3300);
+  // same target seen 1 ms later
+  assert(phase_predictor_schedule(&p, 1000, 1.2f, 0.6f, 8000, &delay_us) == PHASE_PREDICT_ARM);
+  assert(delay_us > 2000 && delay_us < 2300);
+  // beyond the horizon
+  assert(phase_predictor_schedule(&p, 0, 2.0f, 0.6f, 8000, &delay_us) == PHASE_PREDICT_WAIT);
+
+  // a long gap restarts the estimate
+  p.rad_per_us = p.max_rad_per_us;
+  phase_predictor_update(&p, PHASE_PREDICTOR_MAX_GAP_US + 1, 1.0f);
+  assert(p.rad_per_us == p.default_rad_per_us);
+}
+
+int main(int argc, char** argv)
+{
+  srand(1);
+  test_wrap();
+  test_estimate(10, 10, 0);
+  test_estimate(8, 8, 0xFFFF0000U);
+  test_estimate(12, 12, 0);
+  test_estimate(20, 12.5f, 0);
+  test_late();
+  test_schedule(10, 0);
+  test_schedule(10, 3000);
+  test_schedule(8, 6000);
+  test_schedule(12, 2000);
+
+  printf("phase_predictor test passed\n");
+  return 0;
+}
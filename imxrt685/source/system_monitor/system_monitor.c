@@ -23,6 +23,7 @@
 
 #include "als.h"
 #include "data_log.h"
+#include "fatfs_writer.h"
 #include "pin_mux.h"
 
 // Reduce log level for this module
@@ -473,6 +474,10 @@ handle_battery_event(void)
   }
   prev_status = battery_status;
 
+  // Flash maintenance doesn't have to wait for the device to go idle.
+  fatfs_writer_set_charging(battery_status == BATTERY_CHARGER_STATUS_CHARGING ||
+      battery_status == BATTERY_CHARGER_STATUS_CHARGE_COMPLETE);
+
   switch (battery_status) {
     case BATTERY_CHARGER_STATUS_ON_BATTERY:
       app_event_charger_unplugged();
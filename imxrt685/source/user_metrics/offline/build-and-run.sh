@@ -0,0 +1,10 @@
+set -x
+
+# Builds the user metrics log to JSON converter, usage:
+#   ./build-and-run.sh <usermetrics .bin> [output .json]
+
+gcc -o um2json \
+ main.c \
+ ../user_metrics_record.c \
+ -I .. && \
+./um2json "$@"
@@ -0,0 +1,95 @@
+/*
+ * main.c
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Converts a binary user metrics log (user_metrics_record.h)
+ * to the JSON the firmware used to write:
+ *
+ *   {"log_uuid": 3,"version":1,"user_metrics": [
+ *   {"ts":1650000000,"evt":0,"val":2},
+ *   {"ts":1650000030,"evt":1,"val":61}]}
+ *
+ * Damaged records and sequence gaps are reported on stderr.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "user_metrics_record.h"
+
+typedef struct
+{
+  FILE *out;
+  unsigned count;
+  unsigned gaps;
+  uint8_t next_seq;
+} convert_ctx_t;
+
+static void
+record_cb(const user_metrics_record_t *rec, void *user_data)
+{
+  convert_ctx_t *ctx = (convert_ctx_t *) user_data;
+
+  if (rec->evt == USER_METRICS_RECORD_HEADER) {
+    fprintf(ctx->out, "{\"log_uuid\": %ld,\"version\":%ld,\"user_metrics\": [\n",
+        (long) rec->ts, (long) rec->val);
+    ctx->next_seq = rec->seq + 1;
+    return;
+  }
+
+  if (rec->seq != ctx->next_seq) {
+    ctx->gaps++;
+  }
+  ctx->next_seq = rec->seq + 1;
+
+  fprintf(ctx->out, "%s{\"ts\":%lu,\"evt\":%d,\"val\":%ld}", ctx->count ? ",\n" : "",
+      (unsigned long) rec->ts, rec->evt, (long) rec->val);
+  ctx->count++;
+}
+
+int
+main(int argc, char **argv)
+{
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <usermetrics .bin> [output .json]\n", argv[0]);
+    return 1;
+  }
+
+  FILE *in = fopen(argv[1], "rb");
+  if (!in) {
+    perror(argv[1]);
+    return 1;
+  }
+  fseek(in, 0, SEEK_END);
+  long len = ftell(in);
+  fseek(in, 0, SEEK_SET);
+  uint8_t *buf = malloc(len > 0 ? len : 1);
+  if (!buf || fread(buf, 1, len, in) != (size_t) len) {
+    fprintf(stderr, "failed to read %s\n", argv[1]);
+    return 1;
+  }
+  fclose(in);
+
+  convert_ctx_t ctx = { .out = stdout };
+  if (argc > 2) {
+    ctx.out = fopen(argv[2], "w");
+    if (!ctx.out) {
+      perror(argv[2]);
+      return 1;
+    }
+  }
+
+  size_t skipped = user_metrics_record_parse(buf, len, record_cb, &ctx);
+  fprintf(ctx.out, "]}");
+  if (ctx.out != stdout) {
+    fclose(ctx.out);
+  }
+
+  if (skipped > 0 || ctx.gaps > 0) {
+    fprintf(stderr, "%u records, %lu damaged bytes skipped, %u sequence gaps\n",
+        ctx.count, (unsigned long) skipped, ctx.gaps);
+  }
+  free(buf);
+  return 0;
+}
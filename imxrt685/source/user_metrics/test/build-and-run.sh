@@ -0,0 +1,15 @@
+set -x
+
+# record round trip, corruption and torn tail
+gcc -I .. \
+ ../user_metrics_record.c \
+ ./user_metrics_record_test.c \
+ && ./a.out || exit 1
+
+# the converter turns the test log into the old JSON
+gcc -o um2json -I .. ../offline/main.c ../user_metrics_record.c \
+ && ./um2json usermetrics_test.bin || exit 1
+echo
+
+# cleanup
+rm ./a.out ./um2json usermetrics_test.bin
@@ -0,0 +1,85 @@
+/*
+ * user_metrics_record_test.c
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host test of the binary user metrics records, round trip,
+ * a corrupted record and a torn tail.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "user_metrics_record.h"
+
+#define NUM_RECORDS 10
+
+static user_metrics_record_t g_parsed[NUM_RECORDS + 1];
+static unsigned g_num_parsed = 0;
+
+static void
+record_cb(const user_metrics_record_t *rec, void *user_data)
+{
+  assert(g_num_parsed < NUM_RECORDS + 1);
+  g_parsed[g_num_parsed++] = *rec;
+}
+
+static void
+check_record(const user_metrics_record_t *rec, unsigned i)
+{
+  assert(rec->evt == i % 3);
+  assert(rec->seq == i + 1);
+  assert(rec->ts == 1650000000U + 30*i);
+  assert(rec->val == (int32_t)(i*1000) - 4000);
+}
+
+int main(void)
+{
+  uint8_t buf[(NUM_RECORDS + 1)*USER_METRICS_RECORD_SIZE];
+  user_metrics_record_t rec;
+
+  // header then records with negative and positive values
+  rec = (user_metrics_record_t){ .evt = USER_METRICS_RECORD_HEADER, .seq = 0,
+      .ts = 7, .val = USER_METRICS_RECORD_VERSION };
+  user_metrics_record_encode(&rec, buf);
+  for (unsigned i = 0; i < NUM_RECORDS; i++) {
+    rec = (user_metrics_record_t){ .evt = i % 3, .seq = i + 1,
+        .ts = 1650000000U + 30*i, .val = (int32_t)(i*1000) - 4000 };
+    user_metrics_record_encode(&rec, &buf[(i + 1)*USER_METRICS_RECORD_SIZE]);
+  }
+
+  // round trip
+  size_t skipped = user_metrics_record_parse(buf, sizeof(buf), record_cb, NULL);
+  assert(skipped == 0);
+  assert(g_num_parsed == NUM_RECORDS + 1);
+  assert(g_parsed[0].evt == USER_METRICS_RECORD_HEADER && g_parsed[0].ts == 7);
+  for (unsigned i = 0; i < NUM_RECORDS; i++) {
+    check_record(&g_parsed[i + 1], i);
+  }
+
+  // a flipped bit drops that record only
+  buf[4*USER_METRICS_RECORD_SIZE + 7] ^= 0x10;
+  g_num_parsed = 0;
+  skipped = user_metrics_record_parse(buf, sizeof(buf), record_cb, NULL);
+  assert(skipped == USER_METRICS_RECORD_SIZE);
+  assert(g_num_parsed == NUM_RECORDS);
+  check_record(&g_parsed[3], 2);
+  check_record(&g_parsed[4], 4);
+  buf[4*USER_METRICS_RECORD_SIZE + 7] ^= 0x10;
+
+  // a torn last record is skipped, the rest parse
+  g_num_parsed = 0;
+  skipped = user_metrics_record_parse(buf, sizeof(buf) - 5, record_cb, NULL);
+  assert(skipped == USER_METRICS_RECORD_SIZE - 5);
+  assert(g_num_parsed == NUM_RECORDS);
+
+  // write a file for the converter
+  FILE *f = fopen("usermetrics_test.bin", "wb");
+  assert(f);
+  fwrite(buf, 1, sizeof(buf), f);
+  fclose(f);
+
+  printf("user metrics record test passed\n");
+  return 0;
+}
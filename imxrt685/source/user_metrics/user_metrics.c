@@ -1,22 +1,36 @@
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "FreeRTOS.h"
 #include "task.h"
-#include "timers.h"
 #include "queue.h"
 
 #include "loglevels.h"
 #include "config.h"
 #include "eeg_constants.h"
 #include "user_metrics.h"
+#include "user_metrics_record.h"
+#include "data_log.h"
 #include "data_log_commands.h"
 #include "ff.h"
+#include "fatfs_writer.h"
 
 #define USER_METRICS_EVENT_QUEUE_SIZE 10
 static const char *TAG = "user_metrics";	// Logging prefix for this module
 static FIL user_metrics_log;
-static int sample_count = 0;
+
+// Records go through their own fatfs_writer stream, which writes and syncs
+// a batch at a time, or once the oldest record has waited
+// USER_METRICS_FLUSH_PERIOD_MS. The buffer holds two batches so one can be
+// written while the next fills.
+#define USER_METRICS_BATCH_SIZE (USER_METRICS_BUFFER_RECORDS*USER_METRICS_RECORD_SIZE)
+static fatfs_stream_t user_metrics_stream;
+static uint8_t g_stream_storage[FATFS_STREAM_STORAGE_SIZE(2*USER_METRICS_BATCH_SIZE)];
+static const fatfs_sync_policy_t g_stream_policy = {
+  .sync_bytes = USER_METRICS_BATCH_SIZE,
+  .sync_ms = USER_METRICS_FLUSH_PERIOD_MS,
+};
 //
 // Task events:
 //
@@ -54,7 +68,8 @@ typedef enum
 typedef struct
 {
   user_metrics_state_t state;
-  // TODO: Other "global" vars shared between events or states goes here.
+  bool file_open;
+  uint8_t seq;
 } user_metrics_context_t;
 
 static user_metrics_context_t g_context;
@@ -126,6 +141,57 @@ static void log_event_ignored(user_metrics_event_t *event)
 }
 
 
+//
+// Log file:
+//
+
+static void user_metrics_append(uint8_t evt, uint32_t ts, int32_t val)
+{
+  if (!g_context.file_open) {
+    return;
+  }
+
+  uint8_t buf[USER_METRICS_RECORD_SIZE];
+  user_metrics_record_t rec = { .evt = evt, .seq = g_context.seq++, .ts = ts, .val = val };
+  user_metrics_record_encode(&rec, buf);
+
+  // returns the result of the previous write or sync on the stream
+  UINT written = 0;
+  FRESULT result = fatfs_stream_write(&user_metrics_stream, buf, sizeof(buf), &written);
+  if (result != FR_OK) {
+    LOGE(TAG, "write failed: %u\n\r", result);
+  }
+}
+
+static void user_metrics_close(void)
+{
+  if (g_context.file_open) {
+    FRESULT result = fatfs_stream_close(&user_metrics_stream);
+    if (result != FR_OK) {
+      LOGE(TAG, "sync on close failed: %u\n\r", result);
+    }
+    f_close(&user_metrics_log);
+    g_context.file_open = false;
+  }
+}
+
+static void user_metrics_open(void)
+{
+  uint32_t log_uid = 0;
+
+  user_metrics_close();
+  if (!user_metrics_log_open(&user_metrics_log, &log_uid)) {
+    return;
+  }
+  fatfs_stream_open(&user_metrics_stream, &user_metrics_log, g_stream_storage,
+      2*USER_METRICS_BATCH_SIZE, &g_stream_policy);
+  g_context.file_open = true;
+  g_context.seq = 0;
+  user_metrics_append(USER_METRICS_RECORD_HEADER, log_uid, USER_METRICS_RECORD_VERSION);
+  // the header goes out straight away, so the file is never left empty
+  fatfs_stream_sync(&user_metrics_stream);
+}
+
 //
 // Event handlers for the various application states:
 //
@@ -136,7 +202,7 @@ static void set_state(user_metrics_state_t state, user_metrics_event_t *cur_even
   g_context.state = state;
 
   // process first input
-  if (cur_event->type == USER_METRICS_EVENT_INPUT)
+  if (cur_event != NULL && cur_event->type == USER_METRICS_EVENT_INPUT)
   {
     user_metrics_event_t event = { .type = USER_METRICS_EVENT_ENTER, .data = cur_event->data, .datatype = cur_event->datatype};
     handle_event(&event);
@@ -165,10 +231,7 @@ static void handle_state_standby(user_metrics_event_t *event)
       break;
 
     case USER_METRICS_EVENT_STOP:
-    	f_printf(&user_metrics_log, "]}");
-    	f_sync(&user_metrics_log);
-    	f_close(&user_metrics_log);
-      sample_count = 0;
+      user_metrics_close();
       set_state(USER_METRICS_STATE_STANDBY, event);
     	break;
 
@@ -183,24 +246,11 @@ static void handle_state_input(user_metrics_event_t *event)
   switch (event->type) {
     case USER_METRICS_EVENT_ENTER:
     case USER_METRICS_EVENT_INPUT:
-    	sample_count++;
-    	// dollar tree JSON
-      if (sample_count == 1)
-      {
-    	  f_printf(&user_metrics_log, "{\"ts\":%lu,\"evt\":%d,\"val\":%d}", rtc_get(), event->datatype, event->data);
-      }
-      else
-      {
-    	  f_printf(&user_metrics_log, ",\n{\"ts\":%lu,\"evt\":%d,\"val\":%d}", rtc_get(), event->datatype, event->data);
-      }
-      f_sync(&user_metrics_log);
+      user_metrics_append((uint8_t) event->datatype, rtc_get(), event->data);
       set_state(USER_METRICS_STATE_STANDBY, event);
       break;
     case USER_METRICS_EVENT_STOP:{
-      f_printf(&user_metrics_log, "]}");
-      f_sync(&user_metrics_log);
-      f_close(&user_metrics_log);
-      sample_count = 0;
+      user_metrics_close();
       set_state(USER_METRICS_STATE_STANDBY, event);
       break;
     }
@@ -216,18 +266,11 @@ static void handle_state_open(user_metrics_event_t *event)
   switch (event->type) {
   case USER_METRICS_EVENT_ENTER:
   case USER_METRICS_EVENT_OPEN:
-    f_printf(&user_metrics_log, "]}");
-    f_sync(&user_metrics_log);
-    f_close(&user_metrics_log);
-    sample_count = 0;
-    user_metrics_log_open(&user_metrics_log);
+    user_metrics_open();
     set_state(USER_METRICS_STATE_STANDBY, event);
     break;
   case USER_METRICS_EVENT_STOP:
-    f_printf(&user_metrics_log, "]}");
-    f_sync(&user_metrics_log);
-    f_close(&user_metrics_log);
-    sample_count = 0;
+    user_metrics_close();
     set_state(USER_METRICS_STATE_STANDBY, event);
     break;
   default:
@@ -265,7 +308,6 @@ void user_metrics_pretask_init(void)
   // Create the event queue before the scheduler starts. Avoids race conditions.
   g_event_queue = xQueueCreateStatic(USER_METRICS_EVENT_QUEUE_SIZE,sizeof(user_metrics_event_t),g_event_queue_array,&g_event_queue_struct);
   vQueueAddToRegistry(g_event_queue, "user_metrics_event_queue");
-
 }
 
 
@@ -5,6 +5,20 @@
 extern "C" {
 #endif
 
+// Events are logged as binary records (user_metrics_record.h) through a
+// fatfs_writer stream, written and synced when USER_METRICS_BUFFER_RECORDS
+// have accumulated or the oldest has waited USER_METRICS_FLUSH_PERIOD_MS,
+// and on close. A power loss loses at most the batch. user_metrics/offline converts a log to the
+// JSON the firmware used to write.
+#ifndef USER_METRICS_FLUSH_PERIOD_MS
+#define USER_METRICS_FLUSH_PERIOD_MS (5*60*1000U)
+#endif
+
+// 42 records = 504 bytes, one write within a 512 byte sector.
+#ifndef USER_METRICS_BUFFER_RECORDS
+#define USER_METRICS_BUFFER_RECORDS (42U)
+#endif
+
 typedef enum
 {
 	HYPNOGRAM_DATA,
@@ -0,0 +1,87 @@
+/*
+ * user_metrics_record.c
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Binary user metrics log format, see user_metrics_record.h.
+ */
+
+#include "user_metrics_record.h"
+
+// CRC-8, polynomial 0x07, a record is too short for a table to pay off.
+static uint8_t
+crc8(const uint8_t *buf, size_t len)
+{
+  uint8_t crc = 0;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= buf[i];
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+static void
+put_u32(uint8_t *buf, uint32_t val)
+{
+  buf[0] = (uint8_t) val;
+  buf[1] = (uint8_t)(val >> 8);
+  buf[2] = (uint8_t)(val >> 16);
+  buf[3] = (uint8_t)(val >> 24);
+}
+
+static uint32_t
+get_u32(const uint8_t *buf)
+{
+  return (uint32_t) buf[0] | ((uint32_t) buf[1] << 8) |
+      ((uint32_t) buf[2] << 16) | ((uint32_t) buf[3] << 24);
+}
+
+void
+user_metrics_record_encode(const user_metrics_record_t *rec,
+    uint8_t buf[USER_METRICS_RECORD_SIZE])
+{
+  buf[0] = USER_METRICS_RECORD_MAGIC;
+  buf[1] = rec->evt;
+  put_u32(&buf[2], rec->ts);
+  put_u32(&buf[6], (uint32_t) rec->val);
+  buf[10] = rec->seq;
+  buf[11] = crc8(buf, USER_METRICS_RECORD_SIZE - 1);
+}
+
+bool
+user_metrics_record_decode(const uint8_t buf[USER_METRICS_RECORD_SIZE],
+    user_metrics_record_t *rec)
+{
+  if (buf[0] != USER_METRICS_RECORD_MAGIC ||
+      buf[11] != crc8(buf, USER_METRICS_RECORD_SIZE - 1)) {
+    return false;
+  }
+  rec->evt = buf[1];
+  rec->ts = get_u32(&buf[2]);
+  rec->val = (int32_t) get_u32(&buf[6]);
+  rec->seq = buf[10];
+  return true;
+}
+
+size_t
+user_metrics_record_parse(const uint8_t *buf, size_t len,
+    user_metrics_record_cb_t cb, void *user_data)
+{
+  size_t skipped = 0;
+  size_t pos = 0;
+  user_metrics_record_t rec;
+
+  while (pos + USER_METRICS_RECORD_SIZE <= len) {
+    if (user_metrics_record_decode(&buf[pos], &rec)) {
+      cb(&rec, user_data);
+      pos += USER_METRICS_RECORD_SIZE;
+    } else {
+      pos++;
+      skipped++;
+    }
+  }
+  // a torn record at the end
+  return skipped + (len - pos);
+}
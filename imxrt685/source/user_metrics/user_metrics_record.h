@@ -0,0 +1,65 @@
+/*
+ * user_metrics_record.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Binary user metrics log format.
+ *
+ * A log file is a header record followed by one record per event, all
+ * USER_METRICS_RECORD_SIZE bytes, little endian:
+ *
+ *   [0]     USER_METRICS_RECORD_MAGIC
+ *   [1]     event type (user_metrics_data_t), or USER_METRICS_RECORD_HEADER
+ *   [2..5]  ts, rtc_get() seconds (header: log uuid)
+ *   [6..9]  val (header: format version)
+ *   [10]    sequence number, +1 per record, the header is 0
+ *   [11]    CRC-8 of bytes 0..10
+ *
+ * Records are only ever appended, a record torn by a power loss fails its
+ * CRC and the parser skips ahead to the next magic byte. No RTOS
+ * dependencies, the host tool in user_metrics/offline uses the same code.
+ */
+
+#ifndef USER_METRICS_RECORD_H
+#define USER_METRICS_RECORD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define USER_METRICS_RECORD_SIZE    (12U)
+#define USER_METRICS_RECORD_MAGIC   (0xA5U)
+#define USER_METRICS_RECORD_HEADER  (0xFFU)
+// The JSON log was version 0.
+#define USER_METRICS_RECORD_VERSION (1)
+
+typedef struct
+{
+  uint8_t  evt;
+  uint8_t  seq;
+  uint32_t ts;
+  int32_t  val;
+} user_metrics_record_t;
+
+void user_metrics_record_encode(const user_metrics_record_t *rec,
+    uint8_t buf[USER_METRICS_RECORD_SIZE]);
+
+// False if the magic byte or the CRC do not match.
+bool user_metrics_record_decode(const uint8_t buf[USER_METRICS_RECORD_SIZE],
+    user_metrics_record_t *rec);
+
+// Decodes every valid record in buf, resynchronising on the magic byte after
+// a damaged one. Returns the number of bytes skipped over.
+typedef void (*user_metrics_record_cb_t)(const user_metrics_record_t *rec, void *user_data);
+size_t user_metrics_record_parse(const uint8_t *buf, size_t len,
+    user_metrics_record_cb_t cb, void *user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // USER_METRICS_RECORD_H
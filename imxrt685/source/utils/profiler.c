@@ -0,0 +1,181 @@
+/*
+ * profiler.c
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Cycle-accurate stage profiler built on the DWT cycle counter.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "profiler.h"
+
+#if defined(PROFILER_HOST)
+uint32_t g_profiler_host_cycles = 0;
+#define PROFILER_LOCK()
+#define PROFILER_UNLOCK()
+#else
+#include "FreeRTOS.h"
+#include "task.h"
+// Stages are recorded from several tasks, mask interrupts for the update.
+#define PROFILER_LOCK()   UBaseType_t prof_lock_state = taskENTER_CRITICAL_FROM_ISR()
+#define PROFILER_UNLOCK() taskEXIT_CRITICAL_FROM_ISR(prof_lock_state)
+#endif
+
+static const char* const g_stage_names[PROF_NUM_STAGES] = {
+#define PROFILER_STAGE_NAME(name) #name,
+  PROFILER_STAGES(PROFILER_STAGE_NAME)
+#undef PROFILER_STAGE_NAME
+};
+
+const char*
+profiler_stage_name(profiler_stage_t stage)
+{
+  if (stage >= PROF_NUM_STAGES) {
+    return "INVALID";
+  }
+  return g_stage_names[stage];
+}
+
+uint32_t
+profiler_cycles_to_us(uint32_t cycles)
+{
+  return (uint32_t)(((uint64_t) cycles * 1000000U) / PROFILER_CPU_HZ);
+}
+
+#if (defined(ENABLE_PROFILER) && (ENABLE_PROFILER > 0U))
+
+static profiler_stage_stats_t g_profiler_stats[PROF_NUM_STAGES];
+
+static void
+clear_stage(profiler_stage_stats_t *stats)
+{
+  uint32_t deadline_cycles = stats->deadline_cycles;
+  memset(stats, 0, sizeof(*stats));
+  stats->min_cycles = UINT32_MAX;
+  stats->deadline_cycles = deadline_cycles;
+}
+
+void
+profiler_init(void)
+{
+#if !defined(PROFILER_HOST)
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk; // Enable access to registers for data watchpoint and trace.
+  DWT->CTRL |= (1 << DWT_CTRL_CYCCNTENA_Pos); // Enable cycle counter
+#endif
+
+  memset(g_profiler_stats, 0, sizeof(g_profiler_stats));
+  profiler_reset();
+
+  profiler_set_deadline_us(PROF_EEG_PROCESSOR, PROFILER_EEG_DEADLINE_US);
+  profiler_set_deadline_us(PROF_EEG_PROCESS, PROFILER_EEG_DEADLINE_US);
+}
+
+void
+profiler_reset(void)
+{
+  for (int i = 0; i < PROF_NUM_STAGES; i++) {
+    PROFILER_LOCK();
+    clear_stage(&g_profiler_stats[i]);
+    PROFILER_UNLOCK();
+  }
+}
+
+void
+profiler_set_deadline_us(profiler_stage_t stage, uint32_t deadline_us)
+{
+  if (stage >= PROF_NUM_STAGES) {
+    return;
+  }
+  uint32_t deadline_cycles = (uint32_t)(((uint64_t) deadline_us * PROFILER_CPU_HZ) / 1000000U);
+
+  PROFILER_LOCK();
+  g_profiler_stats[stage].deadline_cycles = deadline_cycles;
+  PROFILER_UNLOCK();
+}
+
+void
+profiler_record(profiler_stage_t stage, uint32_t cycles)
+{
+  if (stage >= PROF_NUM_STAGES) {
+    return;
+  }
+
+  // floor(log2(cycles)), 0 and 1 cycle share the first bucket
+  uint32_t bucket = (cycles > 1) ? (31U - __builtin_clz(cycles)) : 0;
+  if (bucket >= PROFILER_HIST_BUCKETS) {
+    bucket = PROFILER_HIST_BUCKETS - 1;
+  }
+
+  PROFILER_LOCK();
+  profiler_stage_stats_t *stats = &g_profiler_stats[stage];
+  stats->count++;
+  stats->total_cycles += cycles;
+  if (cycles < stats->min_cycles) {
+    stats->min_cycles = cycles;
+  }
+  if (cycles > stats->max_cycles) {
+    stats->max_cycles = cycles;
+  }
+  if (stats->deadline_cycles > 0 && cycles > stats->deadline_cycles) {
+    stats->deadline_misses++;
+  }
+  stats->hist[bucket]++;
+  PROFILER_UNLOCK();
+}
+
+void
+profiler_get_stats(profiler_stage_t stage, profiler_stage_stats_t *stats)
+{
+  if (stage >= PROF_NUM_STAGES) {
+    memset(stats, 0, sizeof(*stats));
+    return;
+  }
+  PROFILER_LOCK();
+  *stats = g_profiler_stats[stage];
+  PROFILER_UNLOCK();
+}
+
+void
+profiler_dump(void)
+{
+  printf("%-20s %9s %10s %10s %10s  %s\n", "stage", "count", "min_us", "mean_us", "max_us", "misses/deadline_us");
+  for (int i = 0; i < PROF_NUM_STAGES; i++) {
+    profiler_stage_stats_t stats;
+    profiler_get_stats((profiler_stage_t) i, &stats);
+    if (stats.count == 0) {
+      continue;
+    }
+
+    uint32_t mean_cycles = (uint32_t)(stats.total_cycles / stats.count);
+    printf("%-20s %9lu %10lu %10lu %10lu  %lu/%lu\n",
+        profiler_stage_name((profiler_stage_t) i),
+        (unsigned long) stats.count,
+        (unsigned long) profiler_cycles_to_us(stats.min_cycles),
+        (unsigned long) profiler_cycles_to_us(mean_cycles),
+        (unsigned long) profiler_cycles_to_us(stats.max_cycles),
+        (unsigned long) stats.deadline_misses,
+        (unsigned long) profiler_cycles_to_us(stats.deadline_cycles));
+
+    // histogram, "log2(cycles):count" for each non-empty bucket
+    printf("  hist");
+    for (uint32_t b = 0; b < PROFILER_HIST_BUCKETS; b++) {
+      if (stats.hist[b] > 0) {
+        printf(" %lu:%lu", (unsigned long) b, (unsigned long) stats.hist[b]);
+      }
+    }
+    printf("\n");
+  }
+}
+
+#else /* (defined(ENABLE_PROFILER) && (ENABLE_PROFILER > 0U)) */
+
+void profiler_init(void){}
+void profiler_reset(void){}
+void profiler_set_deadline_us(profiler_stage_t stage, uint32_t deadline_us){}
+void profiler_record(profiler_stage_t stage, uint32_t cycles){}
+void profiler_get_stats(profiler_stage_t stage, profiler_stage_stats_t *stats){ memset(stats, 0, sizeof(*stats)); }
+void profiler_dump(void){ printf("profiler disabled, set ENABLE_PROFILER in config.h\n"); }
+
+#endif /* (defined(ENABLE_PROFILER) && (ENABLE_PROFILER > 0U)) */
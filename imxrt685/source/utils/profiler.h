@@ -0,0 +1,134 @@
+/*
+ * profiler.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Cycle-accurate stage profiler built on the DWT cycle counter.
+ *
+ * Each stage keeps min/max/mean cycles, a log2 latency histogram and a count
+ * of runs that exceeded the stage deadline. Stages are bracketed with
+ * PROFILER_BEGIN()/PROFILER_END() in C or PROFILER_SCOPE() in C++. Results
+ * are printed and cleared with the "profile_dump" and "profile_reset"
+ * shell commands.
+ *
+ * Define PROFILER_HOST to build on the host against a clock stub (see
+ * utils/test).
+ */
+
+#ifndef UTILS_PROFILER_H_
+#define UTILS_PROFILER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined(PROFILER_HOST)
+#define ENABLE_PROFILER (1U)
+#else
+#include "config.h"
+#include "fsl_common.h" // needed for DWT
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// EEG samples arrive at 250 Hz, all per-sample work must finish within one period.
+#define PROFILER_EEG_DEADLINE_US (4000U)
+
+// Bucket i counts latencies in [2^i, 2^(i+1)) cycles, the last bucket also
+// holds everything longer (2^23 cycles is ~34 ms at 250 MHz).
+#define PROFILER_HIST_BUCKETS (24U)
+
+#define PROFILER_STAGES(X) \
+  X(EEG_PROCESSOR)       /* eeg_processor task, one batch of samples end to end */ \
+  X(EEG_PROCESS)         /* EEGProcessing::process() */ \
+  X(EEG_PROCESS_BLOCK)   /* EEGProcessing::process_block() */ \
+  X(EEG_FILTERS)         \
+  X(EEG_RMS)             \
+  X(EEG_QUALITY)         \
+  X(EEG_ECHT)            \
+  X(DATA_LOG_WRITE)      /* data_log_write() */ \
+  X(DATA_LOG_COBS)       \
+  X(DATA_LOG_HEATSHRINK) \
+  X(DATA_LOG_F_WRITE)    \
+  X(AUDIO_UPDATE)        /* one pass over the audio update() graph */ \
+  X(AUDIO_I2S_FILL)      /* I2S DMA buffer fill and stimulus splice */ \
+  X(NAND_READ)           \
+  X(NAND_PROG)           \
+  X(NAND_ERASE)
+
+typedef enum
+{
+#define PROFILER_STAGE_ENUM(name) PROF_##name,
+  PROFILER_STAGES(PROFILER_STAGE_ENUM)
+#undef PROFILER_STAGE_ENUM
+  PROF_NUM_STAGES
+} profiler_stage_t;
+
+typedef struct
+{
+  uint32_t count;
+  uint32_t min_cycles;
+  uint32_t max_cycles;
+  uint64_t total_cycles;
+  uint32_t deadline_cycles;  // 0 if the stage has no deadline
+  uint32_t deadline_misses;
+  uint32_t hist[PROFILER_HIST_BUCKETS];
+} profiler_stage_stats_t;
+
+#if defined(PROFILER_HOST)
+// Host clock stub, advanced by the test.
+extern uint32_t g_profiler_host_cycles;
+#define PROFILER_CPU_HZ (1000000U)
+static inline uint32_t profiler_cycles(void){
+  return g_profiler_host_cycles;
+}
+#else
+#define PROFILER_CPU_HZ (SystemCoreClock)
+static inline uint32_t profiler_cycles(void){
+  return DWT->CYCCNT;
+}
+#endif
+
+void profiler_init(void);
+void profiler_reset(void);
+void profiler_set_deadline_us(profiler_stage_t stage, uint32_t deadline_us);
+// Safe to call from tasks and ISRs.
+void profiler_record(profiler_stage_t stage, uint32_t cycles);
+void profiler_get_stats(profiler_stage_t stage, profiler_stage_stats_t *stats);
+const char* profiler_stage_name(profiler_stage_t stage);
+uint32_t profiler_cycles_to_us(uint32_t cycles);
+void profiler_dump(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#if (defined(ENABLE_PROFILER) && (ENABLE_PROFILER > 0U))
+
+#define PROFILER_BEGIN(stage) uint32_t prof_start_##stage = profiler_cycles()
+#define PROFILER_END(stage) profiler_record(PROF_##stage, profiler_cycles() - prof_start_##stage)
+
+#ifdef __cplusplus
+class ProfilerScope {
+public:
+  ProfilerScope(profiler_stage_t stage) : stage(stage), start(profiler_cycles()) {}
+  ~ProfilerScope(){
+    profiler_record(stage, profiler_cycles() - start);
+  }
+private:
+  profiler_stage_t stage;
+  uint32_t start;
+};
+#define PROFILER_SCOPE(stage) ProfilerScope prof_scope_##stage(PROF_##stage)
+#endif
+
+#else
+
+#define PROFILER_BEGIN(stage)
+#define PROFILER_END(stage)
+#define PROFILER_SCOPE(stage)
+
+#endif // (defined(ENABLE_PROFILER) && (ENABLE_PROFILER > 0U))
+
+#endif /* UTILS_PROFILER_H_ */
@@ -0,0 +1,102 @@
+/*
+ * spsc_ring.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Lock-free single-producer/single-consumer ring indices.
+ *
+ * The ring only manages indices, the caller owns the slot array. The producer
+ * (typically an ISR) gets a slot with spsc_ring_write_slot(), fills it and
+ * publishes it with spsc_ring_write_commit(). The consumer reads slots with
+ * spsc_ring_read_slot() and hands them back with spsc_ring_read_release().
+ * Only the producer moves head and only the consumer moves tail, so neither
+ * side needs a critical section.
+ *
+ * head and tail run freely and wrap at 2^32, the capacity must be a power
+ * of two so slot = index & (capacity - 1) stays continuous across the wrap.
+ */
+
+#ifndef UTILS_SPSC_RING_H_
+#define UTILS_SPSC_RING_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+  uint32_t mask;               // capacity - 1
+  volatile uint32_t head;      // next slot to write, producer only
+  volatile uint32_t tail;      // next slot to read, consumer only
+  volatile uint32_t overruns;  // writes dropped because the ring was full
+} spsc_ring_t;
+
+// capacity must be a power of two.
+static inline bool spsc_ring_init(spsc_ring_t* ring, uint32_t capacity){
+  if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+    return false;
+  }
+  ring->mask = capacity - 1;
+  ring->head = 0;
+  ring->tail = 0;
+  ring->overruns = 0;
+  return true;
+}
+
+// Number of slots ready to read. Safe to call from either side.
+static inline uint32_t spsc_ring_count(spsc_ring_t* ring){
+  return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+}
+
+// Producer: slot to fill, or -1 (and an overrun is counted) if the ring is full.
+static inline int32_t spsc_ring_write_slot(spsc_ring_t* ring){
+  uint32_t head = ring->head;
+  if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) > ring->mask) {
+    ring->overruns++;
+    return -1;
+  }
+  return (int32_t)(head & ring->mask);
+}
+
+// Producer: publish the slot returned by spsc_ring_write_slot().
+static inline void spsc_ring_write_commit(spsc_ring_t* ring){
+  __atomic_store_n(&ring->head, ring->head + 1, __ATOMIC_RELEASE);
+}
+
+// Consumer: oldest unread slot, or -1 if the ring is empty.
+static inline int32_t spsc_ring_read_slot(spsc_ring_t* ring){
+  uint32_t tail = ring->tail;
+  if (__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == tail) {
+    return -1;
+  }
+  return (int32_t)(tail & ring->mask);
+}
+
+// Consumer: oldest unread slot in *slot and the number of unread slots that
+// follow it without wrapping to the start of the slot array, 0 if empty.
+static inline uint32_t spsc_ring_read_span(spsc_ring_t* ring, int32_t* slot){
+  uint32_t tail = ring->tail;
+  uint32_t count = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - tail;
+  uint32_t to_end = ring->mask + 1 - (tail & ring->mask);
+  *slot = (int32_t)(tail & ring->mask);
+  return (count < to_end) ? count : to_end;
+}
+
+// Consumer: hand back n slots, oldest first.
+static inline void spsc_ring_read_release_n(spsc_ring_t* ring, uint32_t n){
+  __atomic_store_n(&ring->tail, ring->tail + n, __ATOMIC_RELEASE);
+}
+
+// Consumer: hand back the slot returned by spsc_ring_read_slot().
+static inline void spsc_ring_read_release(spsc_ring_t* ring){
+  spsc_ring_read_release_n(ring, 1);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UTILS_SPSC_RING_H_ */
@@ -0,0 +1,13 @@
+# build and run the profiler test against the host clock stub
+gcc -DPROFILER_HOST -I .. \
+../profiler.c \
+./profiler_test.c \
+&& ./a.out
+
+# build and run the SPSC ring test
+gcc -I .. \
+./spsc_ring_test.c \
+&& ./a.out
+
+# cleanup
+rm ./a.out
@@ -0,0 +1,138 @@
+/*
+ * profiler_test.c
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host test for the stage profiler. The cycle counter is
+ * replaced by g_profiler_host_cycles (1 cycle per us).
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include "profiler.h"
+
+static void
+run_stage(profiler_stage_t stage, uint32_t cycles)
+{
+  uint32_t start = profiler_cycles();
+  g_profiler_host_cycles += cycles;
+  profiler_record(stage, profiler_cycles() - start);
+}
+
+static void
+test_stats(void)
+{
+  profiler_stage_stats_t stats;
+
+  run_stage(PROF_EEG_FILTERS, 100);
+  run_stage(PROF_EEG_FILTERS, 300);
+  run_stage(PROF_EEG_FILTERS, 200);
+
+  profiler_get_stats(PROF_EEG_FILTERS, &stats);
+  assert(stats.count == 3);
+  assert(stats.min_cycles == 100);
+  assert(stats.max_cycles == 300);
+  assert(stats.total_cycles / stats.count == 200);
+  assert(stats.deadline_misses == 0);
+
+  // log2 buckets: 100 -> 6, 200 -> 7, 300 -> 8
+  assert(stats.hist[6] == 1);
+  assert(stats.hist[7] == 1);
+  assert(stats.hist[8] == 1);
+
+  // other stages untouched
+  profiler_get_stats(PROF_EEG_ECHT, &stats);
+  assert(stats.count == 0);
+}
+
+static void
+test_deadline(void)
+{
+  profiler_stage_stats_t stats;
+
+  // EEG stages default to the 4 ms sample period
+  run_stage(PROF_EEG_PROCESS, 3999);
+  run_stage(PROF_EEG_PROCESS, 4000);
+  run_stage(PROF_EEG_PROCESS, 4001);
+  run_stage(PROF_EEG_PROCESS, 9000);
+
+  profiler_get_stats(PROF_EEG_PROCESS, &stats);
+  assert(stats.deadline_cycles == PROFILER_EEG_DEADLINE_US);
+  assert(stats.count == 4);
+  assert(stats.deadline_misses == 2);
+
+  // stages without a deadline never miss
+  run_stage(PROF_NAND_ERASE, 5000);
+  profiler_get_stats(PROF_NAND_ERASE, &stats);
+  assert(stats.deadline_misses == 0);
+
+  profiler_set_deadline_us(PROF_NAND_ERASE, 3000);
+  run_stage(PROF_NAND_ERASE, 5000);
+  profiler_get_stats(PROF_NAND_ERASE, &stats);
+  assert(stats.deadline_misses == 1);
+}
+
+static void
+test_histogram_limits(void)
+{
+  profiler_stage_stats_t stats;
+
+  run_stage(PROF_AUDIO_UPDATE, 0);
+  run_stage(PROF_AUDIO_UPDATE, 1);
+  run_stage(PROF_AUDIO_UPDATE, UINT32_MAX);
+
+  profiler_get_stats(PROF_AUDIO_UPDATE, &stats);
+  assert(stats.hist[0] == 2);
+  assert(stats.hist[PROFILER_HIST_BUCKETS-1] == 1);
+  assert(stats.min_cycles == 0);
+  assert(stats.max_cycles == UINT32_MAX);
+}
+
+static void
+test_wraparound(void)
+{
+  profiler_stage_stats_t stats;
+
+  // the DWT counter wraps, the unsigned difference must not
+  g_profiler_host_cycles = UINT32_MAX - 10;
+  PROFILER_BEGIN(DATA_LOG_WRITE);
+  g_profiler_host_cycles += 50;
+  PROFILER_END(DATA_LOG_WRITE);
+
+  profiler_get_stats(PROF_DATA_LOG_WRITE, &stats);
+  assert(stats.count == 1);
+  assert(stats.max_cycles == 50);
+}
+
+static void
+test_reset(void)
+{
+  profiler_stage_stats_t stats;
+
+  profiler_reset();
+  for (int i = 0; i < PROF_NUM_STAGES; i++) {
+    profiler_get_stats((profiler_stage_t) i, &stats);
+    assert(stats.count == 0);
+    assert(stats.deadline_misses == 0);
+  }
+
+  // deadlines survive a reset
+  profiler_get_stats(PROF_EEG_PROCESSOR, &stats);
+  assert(stats.deadline_cycles == PROFILER_EEG_DEADLINE_US);
+}
+
+int main(){
+  profiler_init();
+
+  test_stats();
+  test_deadline();
+  test_histogram_limits();
+  test_wraparound();
+  profiler_dump();
+  test_reset();
+
+  assert(profiler_cycles_to_us(PROFILER_CPU_HZ) == 1000000U);
+
+  printf("profiler tests passed\n");
+  return 0;
+}
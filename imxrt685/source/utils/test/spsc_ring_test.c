@@ -0,0 +1,81 @@
+/*
+ * spsc_ring_test.c
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Host test for the SPSC ring indices (single threaded, checks
+ * ordering, overruns and the index wrap).
+ */
+
+#include "spsc_ring.h"
+
+#include <assert.h>
+#include <stdio.h>
+
+#define RING_SIZE (8)
+
+static void test_init(void)
+{
+  spsc_ring_t ring;
+  assert(!spsc_ring_init(&ring, 0));
+  assert(!spsc_ring_init(&ring, 6));
+  assert(spsc_ring_init(&ring, RING_SIZE));
+  assert(spsc_ring_count(&ring) == 0);
+  assert(spsc_ring_read_slot(&ring) < 0);
+}
+
+// Fill, overrun and drain, then keep going across the 2^32 index wrap.
+static void test_fill_and_wrap(uint32_t start)
+{
+  spsc_ring_t ring;
+  uint32_t data[RING_SIZE];
+  spsc_ring_init(&ring, RING_SIZE);
+  ring.head = start;
+  ring.tail = start;
+
+  uint32_t next_write = 0;
+  uint32_t next_read = 0;
+  for (int round = 0; round < 100; round++) {
+    // producer fills the ring and overruns by one
+    for (int i = 0; i <= RING_SIZE; i++) {
+      int32_t slot = spsc_ring_write_slot(&ring);
+      if (i == RING_SIZE) {
+        assert(slot < 0);
+        break;
+      }
+      assert(slot >= 0 && slot < RING_SIZE);
+      data[slot] = next_write++;
+      spsc_ring_write_commit(&ring);
+    }
+    assert(spsc_ring_count(&ring) == RING_SIZE);
+    assert(ring.overruns == (uint32_t) round + 1);
+
+    // consumer drains a varying amount, samples come out in order
+    uint32_t num_reads = 1 + round % RING_SIZE;
+    for (uint32_t i = 0; i < num_reads; i++) {
+      int32_t slot = spsc_ring_read_slot(&ring);
+      assert(slot >= 0);
+      assert(data[slot] == next_read++);
+      spsc_ring_read_release(&ring);
+    }
+    assert(spsc_ring_count(&ring) == RING_SIZE - num_reads);
+
+    // and the rest
+    int32_t slot;
+    while ((slot = spsc_ring_read_slot(&ring)) >= 0) {
+      assert(data[slot] == next_read++);
+      spsc_ring_read_release(&ring);
+    }
+    assert(spsc_ring_count(&ring) == 0);
+  }
+  assert(next_read == next_write);
+}
+
+int main(void)
+{
+  test_init();
+  test_fill_and_wrap(0);
+  test_fill_and_wrap(UINT32_MAX - 3*RING_SIZE);
+  printf("spsc_ring test passed\n");
+  return 0;
+}
@@ -14,7 +14,6 @@ SRC_FILES += \
   $(SDK_ROOT)/components/libraries/fifo/app_fifo.c \
   $(SDK_ROOT)/components/libraries/scheduler/app_scheduler.c \
   $(SDK_ROOT)/components/libraries/timer/app_timer2.c \
-  $(SDK_ROOT)/components/libraries/uart/app_uart_fifo.c \
   $(SDK_ROOT)/components/libraries/util/app_util_platform.c \
   $(SDK_ROOT)/components/libraries/timer/drv_rtc.c \
   $(SDK_ROOT)/components/libraries/hardfault/hardfault_implementation.c \
@@ -28,19 +27,20 @@ SRC_FILES += \
   $(SDK_ROOT)/components/libraries/memobj/nrf_memobj.c \
   $(SDK_ROOT)/components/libraries/pwr_mgmt/nrf_pwr_mgmt.c \
   $(SDK_ROOT)/components/libraries/ringbuf/nrf_ringbuf.c \
+  $(SDK_ROOT)/components/libraries/queue/nrf_queue.c \
+  $(SDK_ROOT)/components/libraries/libuarte/nrf_libuarte_async.c \
+  $(SDK_ROOT)/components/libraries/libuarte/nrf_libuarte_drv.c \
   $(SDK_ROOT)/components/libraries/experimental_section_vars/nrf_section_iter.c \
   $(SDK_ROOT)/components/libraries/sortlist/nrf_sortlist.c \
   $(SDK_ROOT)/components/libraries/strerror/nrf_strerror.c \
-  $(SDK_ROOT)/components/libraries/uart/retarget.c \
   $(SDK_ROOT)/components/boards/boards.c \
   $(SDK_ROOT)/integration/nrfx/legacy/nrf_drv_clock.c \
-  $(SDK_ROOT)/integration/nrfx/legacy/nrf_drv_uart.c \
   $(SDK_ROOT)/modules/nrfx/soc/nrfx_atomic.c \
   $(SDK_ROOT)/modules/nrfx/drivers/src/nrfx_clock.c \
   $(SDK_ROOT)/modules/nrfx/drivers/src/nrfx_gpiote.c \
   $(SDK_ROOT)/modules/nrfx/drivers/src/prs/nrfx_prs.c \
-  $(SDK_ROOT)/modules/nrfx/drivers/src/nrfx_uart.c \
-  $(SDK_ROOT)/modules/nrfx/drivers/src/nrfx_uarte.c \
+  $(SDK_ROOT)/modules/nrfx/drivers/src/nrfx_ppi.c \
+  $(SDK_ROOT)/modules/nrfx/drivers/src/nrfx_timer.c \
   $(SDK_ROOT)/external/segger_rtt/SEGGER_RTT.c \
   $(SDK_ROOT)/external/segger_rtt/SEGGER_RTT_Syscalls_GCC.c \
   $(SDK_ROOT)/external/segger_rtt/SEGGER_RTT_printf.c \
@@ -67,15 +67,16 @@ SRC_FILES += \
   $(SOURCE_DIR)/main.c \
   $(SOURCE_DIR)/ble_elemind.c \
   $(SOURCE_DIR)/lpc_uart.c \
+  $(SOURCE_DIR)/lpc_serial.c \
   $(SOURCE_DIR)/binary_interface_inst.c \
-  $(SOURCE_DIR)/interface/bit_copy.c \
-  $(SOURCE_DIR)/interface/binary_writer.c \
-  $(SOURCE_DIR)/interface/binary_reader.c \
-  $(SOURCE_DIR)/interface/binary_interface.c \
-  $(SOURCE_DIR)/interface/cobs.c \
-  $(SOURCE_DIR)/interface/slip.c \
-  $(SOURCE_DIR)/interface/packet_serial.c \
-  $(SOURCE_DIR)/utils/endian_util.c \
+  $(INTERFACE_DIR)/bit_copy.c \
+  $(INTERFACE_DIR)/binary_writer.c \
+  $(INTERFACE_DIR)/binary_reader.c \
+  $(INTERFACE_DIR)/binary_interface.c \
+  $(INTERFACE_DIR)/cobs.c \
+  $(INTERFACE_DIR)/slip.c \
+  $(INTERFACE_DIR)/packet_serial.c \
+  $(INTERFACE_DIR)/endian_util.c \
   $(SOURCE_DIR)/../sdk_patched/nrf_ringbuf.c \
 
 # Include folders common to all targets
@@ -84,9 +85,7 @@ INC_FOLDERS += \
   $(SOURCE_DIR)/config \
   $(SOURCE_DIR)/../common \
   $(SOURCE_DIR)/../sdk_patched \
-  $(SOURCE_DIR)/error_handling \
-  $(SOURCE_DIR)/interface \
-  $(SOURCE_DIR)/utils \
+  $(INTERFACE_DIR) \
   $(SDK_ROOT)/components/ble/ble_services/ble_ancs_c \
   $(SDK_ROOT)/components/ble/ble_services/ble_ias_c \
   $(SDK_ROOT)/components/libraries/pwm \
@@ -148,6 +147,7 @@ INC_FOLDERS += \
   $(SDK_ROOT)/components/libraries/hardfault \
   $(SDK_ROOT)/components/ble/ble_services/ble_cscs \
   $(SDK_ROOT)/components/libraries/uart \
+  $(SDK_ROOT)/components/libraries/libuarte \
   $(SDK_ROOT)/components/libraries/hci \
   $(SDK_ROOT)/components/libraries/usbd/class/hid/kbd \
   $(SDK_ROOT)/components/libraries/timer \
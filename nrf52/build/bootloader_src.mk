@@ -81,6 +81,8 @@ SRC_FILES += \
   $(BL_SOURCE_DIR)/ext_fstorage.c \
   $(BL_SOURCE_DIR)/ext_fstorage_test.c \
   $(BL_SOURCE_DIR)/dfu_public_key.c \
+  $(CRC_DIR)/crc16_xmodem.c \
+  $(BL_SOURCE_DIR)/lpc_delta.c \
   $(BL_SOURCE_DIR)/lpc_pkt.c \
   $(BL_SOURCE_DIR)/lpc_protocol.c \
   $(BL_SOURCE_DIR)/lpc_update.c \
@@ -97,6 +99,8 @@ INC_FOLDERS += \
   $(BL_SOURCE_DIR) \
   $(BL_SOURCE_DIR)/config \
   $(BL_SOURCE_DIR)/../common \
+  $(CRC_DIR) \
+  $(NAND_LAYOUT_DIR) \
   $(BL_SOURCE_DIR)/sdk_patched \
   $(SDK_ROOT)/external/fprintf \
   $(SDK_ROOT)/external/segger_rtt \
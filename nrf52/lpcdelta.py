@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+"""Make a delta patch between two LPC application images.
+
+The nRF bootloader rebuilds the new image from the installed one and the
+patch, see source_code/bootloader/lpc_delta.h for the format.
+
+Usage:
+    lpcdelta.py <base.bin> <target.bin> <patch.bin>
+"""
+
+import argparse
+import hashlib
+import struct
+import sys
+
+MAGIC = 0x41544C44  # "DLTA"
+VERSION = 1
+HEADER_FMT = "<IHHII32s32s"
+HEADER_LEN = struct.calcsize(HEADER_FMT)
+
+OP_COPY = 0x01
+OP_DATA = 0x02
+
+# Length of the windows used to find matches in the base image.
+BLOCK_LEN = 16
+# Shortest match worth a copy, a copy op costs 9 bytes and splitting a data
+# run costs another 5.
+MIN_COPY = 24
+# Match candidates kept per window, more finds better matches but is slower.
+MAX_CANDIDATES = 8
+
+
+def index_base(base):
+    # Only block-aligned windows are indexed. Any match of two blocks or
+    # more covers one of them, and matches are extended backwards after.
+    index = {}
+    for pos in range(0, len(base) - BLOCK_LEN + 1, BLOCK_LEN):
+        key = base[pos:pos + BLOCK_LEN]
+        positions = index.setdefault(key, [])
+        if len(positions) < MAX_CANDIDATES:
+            positions.append(pos)
+    return index
+
+
+def match_len(base, bpos, target, tpos):
+    n = 0
+    limit = min(len(base) - bpos, len(target) - tpos)
+    # compare in slices first, then byte by byte
+    step = 256
+    while n + step <= limit and base[bpos + n:bpos + n + step] == target[tpos + n:tpos + n + step]:
+        n += step
+    while n < limit and base[bpos + n] == target[tpos + n]:
+        n += 1
+    return n
+
+
+def make_ops(base, target):
+    """Returns a list of ("copy", offset, length) and ("data", bytes)."""
+    index = index_base(base)
+    ops = []
+    data_start = 0
+    tpos = 0
+    # Where the next copy would continue from, tried first because changes
+    # usually leave the rest of the image in place.
+    next_bpos = None
+
+    while tpos <= len(target) - BLOCK_LEN:
+        best_bpos, best_len = None, 0
+        candidates = index.get(target[tpos:tpos + BLOCK_LEN], [])
+        if next_bpos is not None:
+            candidates = [next_bpos] + candidates
+        for bpos in candidates:
+            n = match_len(base, bpos, target, tpos)
+            if n > best_len:
+                best_bpos, best_len = bpos, n
+
+        if best_len < MIN_COPY:
+            tpos += 1
+            continue
+
+        # extend the match backwards into the pending data
+        while (tpos > data_start and best_bpos > 0 and
+               base[best_bpos - 1] == target[tpos - 1]):
+            tpos -= 1
+            best_bpos -= 1
+            best_len += 1
+
+        if tpos > data_start:
+            ops.append(("data", target[data_start:tpos]))
+        ops.append(("copy", best_bpos, best_len))
+        tpos += best_len
+        data_start = tpos
+        next_bpos = best_bpos + best_len
+
+    if data_start < len(target):
+        ops.append(("data", target[data_start:]))
+    return ops
+
+
+def make_patch(base, target):
+    header = struct.pack(HEADER_FMT, MAGIC, VERSION, HEADER_LEN,
+                         len(base), len(target),
+                         hashlib.sha256(base).digest(),
+                         hashlib.sha256(target).digest())
+    out = [header]
+    for op in make_ops(base, target):
+        if op[0] == "copy":
+            out.append(struct.pack("<BII", OP_COPY, op[1], op[2]))
+        else:
+            out.append(struct.pack("<BI", OP_DATA, len(op[1])))
+            out.append(op[1])
+    return b"".join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("base", help="installed image (.bin)")
+    parser.add_argument("target", help="new image (.bin)")
+    parser.add_argument("patch", help="output patch")
+    args = parser.parse_args()
+
+    with open(args.base, "rb") as f:
+        base = f.read()
+    with open(args.target, "rb") as f:
+        target = f.read()
+
+    patch = make_patch(base, target)
+    with open(args.patch, "wb") as f:
+        f.write(patch)
+
+    print("%s: %d bytes (%.1f%% of %d)" %
+          (args.patch, len(patch), 100.0 * len(patch) / max(len(target), 1),
+           len(target)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -3,13 +3,17 @@
 # This helper script is used to generate an OTA file for the LPC image.
 # It requires that the python modules for nrfutil and intelhex be installed.
 # Usage:
-# lpcpkg.sh -f <path/to/lpc/firmware.hex>
+# lpcpkg.sh -f <path/to/lpc/firmware.hex> [-b <path/to/installed/firmware.hex>]
+#
+# With -b, the package holds a delta patch from the installed firmware
+# instead of the full image (see lpcdelta.py).
 
 # process args
-while getopts f: flag
+while getopts f:b: flag
 do
     case "${flag}" in
         f) hexfile=${OPTARG};;
+        b) basefile=${OPTARG};;
     esac
 done
 
@@ -18,12 +22,19 @@ if [ ! -f "$hexfile" ]; then
     exit 1;
 fi
 
+if [ -n "$basefile" ] && [ ! -f "$basefile" ]; then
+    echo "error: base file does not exist."
+    exit 1;
+fi
+
 # setup file names
 file_base="${hexfile%.*}"
 file_ext="${hexfile##*.}"
 file_bin="$file_base.bin"
 file_offset4kb="$file_base.offset4kb.$file_ext"
 file_otazip="$file_base.ota.zip"
+file_basebin="$file_base.base.bin"
+file_patch="$file_base.patch.bin"
 
 # check the extension
 if [ "$file_ext" != "hex" ]; then
@@ -40,6 +51,15 @@ set -x
 # convert to bin, so that we can use bin2hex to apply the offset for us
 hex2bin.py "$hexfile" "$file_bin"
 
+# for a delta package, the patch takes the place of the image
+if [ -n "$basefile" ]; then
+    hex2bin.py "$basefile" "$file_basebin"
+    "$(dirname "$0")/lpcdelta.py" "$file_basebin" "$file_bin" "$file_patch"
+    mv "$file_patch" "$file_bin"
+    rm "$file_basebin"
+    file_otazip="$file_base.delta.ota.zip"
+fi
+
 # convert back to hex, with offset
 # the offset is required because nrfutil ignores the first 4kb of the hex file
 # see ticket filed on the nordic developer forums here:
@@ -1,5 +1,6 @@
 
 #include "binary_interface_inst.h"
+#include "lpc_serial.h"
 
 BinaryInterface bin_itf;
 
@@ -78,36 +79,18 @@ bool bin_itf_send_file_command(const uint8_t *buf, size_t buf_size)
 
 size_t serial_write(uint8_t val)
 {
-    // TODO: Error handling
-    ret_code_t err_code;
-    // Send the data one byte at a time.
-    err_code = app_uart_put(val);
-    // Return success
-    if (err_code != NRF_SUCCESS)
-    {
-        return 0;
-    }
-    else
-    {
-        return 1;
-    }
+    return lpc_serial_write(&val, 1);
 }
 
 size_t serial_write_buffer(const char *buffer, size_t size)
 {
-    // TODO: Error handling
-    ret_code_t err_code;
-    // Next, send the data one byte at a time.
-    int index;
-    for (index = 0; index < size; index++)
-    {
-        do
-        {
-        	//break; // TODO: yield for buffer space
-        	err_code = app_uart_put(buffer[index]);
-        }while(err_code != NRF_SUCCESS);
-    }
-    return index;
+    return lpc_serial_write((const uint8_t *)buffer, size);
+}
+
+static void handle_packet_error(void *context, PacketSerialError error)
+{
+    NRF_LOG_WARNING("Dropped packet longer than %d bytes (error %d)",
+                    PACKET_SERIAL_RX_BUFFER_SIZE, error);
 }
 
 Command bin_itf_commands[] = {
@@ -125,13 +108,17 @@ void bin_itf_init()
 
     bin_itf.pSerial.serial_write_f = serial_write;
     bin_itf.pSerial.serial_write_buffer_f = serial_write_buffer;
-    
-    bin_itf.on_packet_f = NULL;
 
     bi_init(&bin_itf, bin_itf_commands, ARRAY_SIZE(bin_itf_commands));
+    bin_itf.pSerial.on_error_f = handle_packet_error;
 }
 
 bool bin_itf_handle_messages(uint8_t data)
 {
     return handleMessages(&bin_itf, data);
 }
+
+size_t bin_itf_handle_buffer(const uint8_t *data, size_t size)
+{
+    return handleMessagesBuffer(&bin_itf, data, size);
+}
@@ -5,7 +5,6 @@
 #include "lpc_uart.h"
 #include "packet_serial.h"
 #include "nrf_log.h"
-#include "app_uart.h"
 
 extern BinaryInterface bin_itf;
 
@@ -20,6 +19,7 @@ typedef enum COMMAND_CODES
 
 void bin_itf_init();
 bool bin_itf_handle_messages(uint8_t data);
+size_t bin_itf_handle_buffer(const uint8_t *data, size_t size);
 bool bin_itf_send_command(char* buf, size_t size);
 bool bin_itf_send_file_command(const uint8_t *buf, size_t buf_size);
 
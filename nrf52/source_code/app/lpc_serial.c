@@ -0,0 +1,235 @@
+/*
+ * lpc_serial.c
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: LPC serial link for Elemind Morpheus, see lpc_serial.h.
+ *
+ */
+
+// nRF5 SDK
+#include "sdk_common.h"
+#include "app_util_platform.h"
+#include "boards.h"
+#include "nrf_libuarte_async.h"
+#include "nrf_log.h"
+#include "nrf_ringbuf.h"
+
+// Morpheus
+#include "lpc_serial.h"
+
+/** Size of each RX buffer. This is also the longest chunk handed to the
+    parser at once. */
+#define LPC_SERIAL_RX_BUF_SIZE 128
+
+/** Number of RX buffers. libuarte needs at least 3: one being filled, one
+    queued behind it, and the rest waiting to be consumed. */
+#define LPC_SERIAL_RX_BUF_COUNT 4
+
+/** Idle time on the RX line (in microseconds) after which the data received
+    so far is reported, about three characters at 115200 baud. */
+#define LPC_SERIAL_RX_TIMEOUT_US 300
+
+/** TX buffer size (power of two). */
+#define LPC_SERIAL_TX_BUF_SIZE 512
+
+/** libuarte on UARTE0, counting received bytes with TIMER1 and timing out
+    the RX line with TIMER2 (the SoftDevice owns TIMER0 and RTC0, app_timer
+    owns RTC1). */
+NRF_LIBUARTE_ASYNC_DEFINE(m_lpc_uarte, 0, 1, NRF_LIBUARTE_PERIPHERAL_NOT_USED, 2,
+  LPC_SERIAL_RX_BUF_SIZE, LPC_SERIAL_RX_BUF_COUNT);
+
+NRF_RINGBUF_DEF(m_lpc_tx_ringbuf, LPC_SERIAL_TX_BUF_SIZE);
+
+/** Received data waiting to be consumed. */
+typedef struct {
+  uint8_t *p_data;
+  size_t length;
+} rx_chunk_t;
+
+/** Received chunks, oldest first. Consecutive chunks from the same RX buffer
+    are merged, so there is never more than one per RX buffer. */
+static rx_chunk_t g_rx_chunks[LPC_SERIAL_RX_BUF_COUNT];
+static uint8_t g_rx_head = 0;
+static uint8_t g_rx_count = 0;
+
+/** Bytes received so far into the RX buffer being filled. */
+static size_t g_rx_buf_fill = 0;
+
+static lpc_serial_rx_handler_t g_rx_handler = NULL;
+
+/** Start sending the next contiguous block of the TX buffer, unless a
+    transfer is already in progress. */
+static void
+tx_start(void)
+{
+  uint8_t *p_data;
+  size_t length = LPC_SERIAL_TX_BUF_SIZE;
+
+  // The ringbuf read stays claimed until the transfer completes, so this
+  // fails with NRF_ERROR_BUSY while one is in progress.
+  if (nrf_ringbuf_get(&m_lpc_tx_ringbuf, &p_data, &length, true) != NRF_SUCCESS) {
+    return;
+  }
+  if (length == 0) {
+    return;
+  }
+
+  ret_code_t err_code = nrf_libuarte_async_tx(&m_lpc_uarte, p_data, length);
+  APP_ERROR_CHECK(err_code);
+}
+
+/** Add received data to the chunk list (interrupt context). */
+static void
+rx_push(uint8_t *p_data, size_t length)
+{
+  bool same_buffer = (g_rx_buf_fill != 0);
+  g_rx_buf_fill = (g_rx_buf_fill + length) % LPC_SERIAL_RX_BUF_SIZE;
+
+  if (same_buffer && (g_rx_count > 0)) {
+    rx_chunk_t *p_tail =
+      &g_rx_chunks[(g_rx_head + g_rx_count - 1) % LPC_SERIAL_RX_BUF_COUNT];
+    if ((p_tail->p_data + p_tail->length) == p_data) {
+      p_tail->length += length;
+      return;
+    }
+  }
+
+  if (g_rx_count >= LPC_SERIAL_RX_BUF_COUNT) {
+    // Can't happen, every chunk holds an RX buffer.
+    NRF_LOG_ERROR("lpc rx: no room for %d bytes", length);
+    nrf_libuarte_async_rx_free(&m_lpc_uarte, p_data, length);
+    return;
+  }
+
+  rx_chunk_t *p_chunk =
+    &g_rx_chunks[(g_rx_head + g_rx_count) % LPC_SERIAL_RX_BUF_COUNT];
+  p_chunk->p_data = p_data;
+  p_chunk->length = length;
+  g_rx_count++;
+}
+
+/** Handle libuarte events (interrupt context). */
+static void
+uarte_evt_handler(void *context, nrf_libuarte_async_evt_t *p_evt)
+{
+  switch (p_evt->type) {
+    case NRF_LIBUARTE_ASYNC_EVT_RX_DATA:
+      rx_push(p_evt->data.rxtx.p_data, p_evt->data.rxtx.length);
+      if (g_rx_handler) {
+        g_rx_handler();
+      }
+      break;
+
+    case NRF_LIBUARTE_ASYNC_EVT_TX_DONE:
+      (void)nrf_ringbuf_free(&m_lpc_tx_ringbuf, p_evt->data.rxtx.length);
+      tx_start();
+      break;
+
+    case NRF_LIBUARTE_ASYNC_EVT_ERROR:
+      APP_ERROR_HANDLER(p_evt->data.errorsrc);
+      break;
+
+    case NRF_LIBUARTE_ASYNC_EVT_OVERRUN_ERROR:
+      APP_ERROR_HANDLER(p_evt->data.overrun_err.overrun_length);
+      break;
+
+    default:
+      break;
+  }
+}
+
+ret_code_t
+lpc_serial_init(lpc_serial_rx_handler_t rx_handler)
+{
+  ret_code_t err_code;
+  nrf_libuarte_async_config_t const config =
+    {
+      .rx_pin = RX_PIN_NUMBER,
+      .tx_pin = TX_PIN_NUMBER,
+      .rts_pin = RTS_PIN_NUMBER,
+      .cts_pin = CTS_PIN_NUMBER,
+      .timeout_us = LPC_SERIAL_RX_TIMEOUT_US,
+      .hwfc = NRF_UARTE_HWFC_ENABLED,
+      .parity = NRF_UARTE_PARITY_EXCLUDED,
+      .baudrate = NRF_UARTE_BAUDRATE_115200,
+      .pullup_rx = false,
+      // libuarte needs a level below it for its timer
+      .int_prio = APP_IRQ_PRIORITY_LOW,
+    };
+
+  g_rx_handler = rx_handler;
+  nrf_ringbuf_init(&m_lpc_tx_ringbuf);
+
+  err_code = nrf_libuarte_async_init(&m_lpc_uarte, &config, uarte_evt_handler, NULL);
+  VERIFY_SUCCESS(err_code);
+
+  nrf_libuarte_async_enable(&m_lpc_uarte);
+  return NRF_SUCCESS;
+}
+
+size_t
+lpc_serial_write(const uint8_t *p_data, size_t length)
+{
+  size_t remaining = length;
+
+  while (remaining > 0) {
+    size_t sz = remaining;
+    ret_code_t err_code = nrf_ringbuf_cpy_put(&m_lpc_tx_ringbuf, p_data, &sz);
+    if (err_code != NRF_SUCCESS) {
+      // NRF_ERROR_BUSY: this call interrupted another put, which can't
+      // finish until it returns. Report a short write, as app_uart did.
+      NRF_LOG_WARNING("lpc tx: put failed (%d)", err_code);
+      break;
+    }
+    p_data += sz;
+    remaining -= sz;
+
+    // When the buffer is full this waits for the TX interrupt to drain it.
+    tx_start();
+  }
+
+  return length - remaining;
+}
+
+bool
+lpc_serial_rx_peek(const uint8_t **pp_data, size_t *p_length)
+{
+  bool available = false;
+
+  CRITICAL_REGION_ENTER();
+  if (g_rx_count > 0) {
+    *pp_data = g_rx_chunks[g_rx_head].p_data;
+    *p_length = g_rx_chunks[g_rx_head].length;
+    available = true;
+  }
+  CRITICAL_REGION_EXIT();
+
+  return available;
+}
+
+void
+lpc_serial_rx_consume(size_t length)
+{
+  if (length == 0) {
+    return;
+  }
+
+  CRITICAL_REGION_ENTER();
+  if (g_rx_count > 0) {
+    rx_chunk_t *p_head = &g_rx_chunks[g_rx_head];
+    if (length > p_head->length) {
+      length = p_head->length;
+    }
+    // Gives the RX buffer back once all of it has been freed, which also
+    // restarts reception if it was held off for lack of buffers.
+    nrf_libuarte_async_rx_free(&m_lpc_uarte, p_head->p_data, length);
+    p_head->p_data += length;
+    p_head->length -= length;
+    if (p_head->length == 0) {
+      g_rx_head = (g_rx_head + 1) % LPC_SERIAL_RX_BUF_COUNT;
+      g_rx_count--;
+    }
+  }
+  CRITICAL_REGION_EXIT();
+}
@@ -0,0 +1,63 @@
+/*
+ * lpc_serial.h
+ *
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: LPC serial link for Elemind Morpheus.
+ *
+ * Receives through libuarte (UARTE EasyDMA with a pool of RX buffers and an
+ * idle-line timeout), so data arrives in chunks rather than one interrupt
+ * per byte. Flow control holds the LPC off while every RX buffer is still
+ * waiting to be consumed.
+ *
+ */
+#ifndef __LPC_SERIAL_H__
+#define __LPC_SERIAL_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "sdk_errors.h"
+
+/** Called from the UARTE interrupt when received data is ready. */
+typedef void (*lpc_serial_rx_handler_t)(void);
+
+/** Initialize the LPC serial link and start receiving.
+
+    @param rx_handler Called (in interrupt context) when data arrives.
+
+    @return NRF_SUCCESS on successful initialization, error code otherwise.
+*/
+ret_code_t lpc_serial_init(lpc_serial_rx_handler_t rx_handler);
+
+/** Queue data to send to the LPC.
+
+    Waits for room in the TX buffer, so must not be called from an
+    interrupt handler.
+
+    @return Number of bytes queued. Less than length if the call
+            interrupted another write in progress.
+*/
+size_t lpc_serial_write(const uint8_t *p_data, size_t length);
+
+/** Get the oldest received data that hasn't been consumed yet.
+
+    @param[out] pp_data Receives a pointer to the data
+    @param[out] p_length Receives the number of bytes available at pp_data
+
+    @return true if there is received data, false otherwise.
+*/
+bool lpc_serial_rx_peek(const uint8_t **pp_data, size_t *p_length);
+
+/** Release bytes returned by lpc_serial_rx_peek().
+
+    The RX buffer is given back to the UARTE once all of it has been
+    consumed.
+
+    @param length Number of bytes consumed, at most the length returned
+    by the last lpc_serial_rx_peek().
+*/
+void lpc_serial_rx_consume(size_t length);
+
+#endif // __LPC_SERIAL_H__
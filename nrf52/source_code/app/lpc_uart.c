@@ -17,7 +17,6 @@
 
 // nRF5 SDK
 #include "app_timer.h"
-#include "app_uart.h"
 #include "nrf_log.h"
 #include "nrf_pwr_mgmt.h"
 #include "sdk_common.h"
@@ -55,7 +55,6 @@
 #include <string.h>
 
 #include "app_timer.h"
-#include "app_uart.h"
 #include "app_util_platform.h"
 #include "app_scheduler.h"
 #include "ble_advdata.h"
@@ -106,6 +105,7 @@
 // Morpheus
 #include "ble_elemind.h"
 #include "lpc_uart.h"
+#include "lpc_serial.h"
 #include "version.h"
 #include "binary_interface_inst.h"
 
@@ -180,6 +180,37 @@
 /** Number of attempts before giving up the connection parameter negotiation. */
 #define MAX_CONN_PARAMS_UPDATE_COUNT 3
 
+/** Bulk transfer mode connection interval range (in units of 1.25ms). */
+#define BULK_MIN_CONN_INTERVAL MSEC_TO_UNITS(7.5, UNIT_1_25_MS)
+#define BULK_MAX_CONN_INTERVAL MSEC_TO_UNITS(15, UNIT_1_25_MS)
+
+/** Bulk transfer mode slave latency, so that no connection event is
+    skipped while there is data to send. */
+#define BULK_SLAVE_LATENCY 0
+
+/** NUS ringbuf backlog (in bytes) that switches to bulk transfer mode. */
+#define BULK_ENTER_BACKLOG 256
+
+/** Link throughput measurement period. */
+#define BULK_RATE_PERIOD_MS 250
+
+/** Number of measurement periods without any NUS data before going back
+    to the low-power connection parameters (2 seconds). */
+#define BULK_IDLE_PERIODS 8
+
+/** Thresholds (free bytes in the NUS ringbuf) for pausing and unpausing the
+    UART reads. The pause functionality ensures the UART buffer is not
+    drained if the outbound ring buffer does not have room. These numbers
+    are experimentally determined, in bulk mode the unpause threshold grows
+    with the measured link throughput. */
+#define NUS_RINGBUF_PAUSE_THRESHOLD 32
+#define NUS_RINGBUF_UNPAUSE_THRESHOLD 64
+
+/** Time (in milliseconds) worth of link throughput to make room for before
+    unpausing the UART, so that each UART batch fills several connection
+    events instead of a single notification. */
+#define NUS_RINGBUF_UNPAUSE_WINDOW_MS 30
+
 /**< Scheduler queue entry size */
 #define SCHED_MAX_EVENT_DATA_SIZE      APP_TIMER_SCHED_EVENT_DATA_SIZE
 /**< Scheduler queue number of entries */
@@ -194,12 +225,6 @@
     stack location on stack unwind. */
 #define DEAD_BEEF 0xDEADBEEF
 
-/** UART TX buffer size. */
-#define UART_TX_BUF_SIZE 512
-
-/** UART RX buffer size. */
-#define UART_RX_BUF_SIZE 512
-
 
 /** BLE NUS service instance. */
 BLE_NUS_DEF(m_nus, NRF_SDH_BLE_TOTAL_LINK_COUNT);
@@ -222,7 +247,15 @@ BLE_ADVERTISING_DEF(m_advertising);
 /** Delayed advertising start timer. */
 APP_TIMER_DEF(m_delayed_advertising_timer_id);
 
-NRF_RINGBUF_DEF(m_nus_ringbuf, 1024);
+/** Bulk transfer mode throughput measurement timer. */
+APP_TIMER_DEF(m_bulk_timer_id);
+
+#define NUS_RINGBUF_SIZE 1024
+NRF_RINGBUF_DEF(m_nus_ringbuf, NUS_RINGBUF_SIZE);
+
+/** Notification payload gathered across the end of the NUS ringbuf, so
+    that every notification is as long as the MTU allows. */
+static uint8_t m_nus_tx_buf[BLE_NUS_MAX_DATA_LEN];
 
 /*** Time to delay advertising start by (in milliseconds). */
 #define ADVERTISING_DELAY_MS APP_TIMER_TICKS(200)
@@ -249,9 +282,25 @@ static nrf_atflags_t g_uart_data_flag;
 /** Flag to suspend UART reception */
 static bool g_uart_pause = false;
 
+/** Free NUS ringbuf bytes needed to unpause the UART. */
+static uint32_t g_uart_unpause_threshold = NUS_RINGBUF_UNPAUSE_THRESHOLD;
+
+/** Bulk transfer mode (2M PHY, maximum data length, no slave latency). */
+static bool m_bulk_mode = false;
+
+/** Bytes handed to the SoftDevice during the current measurement period. */
+static uint32_t m_bulk_period_bytes = 0;
+
+/** Smoothed link throughput (bytes per second). */
+static uint32_t m_bulk_rate = 0;
+
+/** Measurement periods in a row without NUS data. */
+static uint8_t m_bulk_idle_periods = 0;
+
 /** Forward declaration */
 void ble_nus_send_data_wrapper(uint8_t *buf, size_t buf_size);
 static void uart_event_handle_sched(void* p_unused, uint16_t unused);
+static void bulk_mode_exit(void);
 
 /** Assert macro callback.
 
@@ -691,6 +740,7 @@ ble_evt_handler(ble_evt_t const * p_ble_evt, void * p_context)
       case BLE_GAP_EVT_DISCONNECTED:
         NRF_LOG_INFO("Disconnected");
         m_conn_handle = BLE_CONN_HANDLE_INVALID;
+        bulk_mode_exit();
         break;
 
       case BLE_GAP_EVT_PHY_UPDATE_REQUEST:
@@ -799,6 +849,14 @@ ble_stack_init(void)
   err_code = nrf_sdh_ble_enable(&ram_start);
   APP_ERROR_CHECK(err_code);
 
+  // Let connection events run past the event length while there is
+  // data to send, rather than waiting for the next interval.
+  ble_opt_t opt;
+  memset(&opt, 0, sizeof(opt));
+  opt.common_opt.conn_evt_ext.enable = 1;
+  err_code = sd_ble_opt_set(BLE_COMMON_OPT_CONN_EVT_EXT, &opt);
+  APP_ERROR_CHECK(err_code);
+
   // Register a handler for BLE events.
   NRF_SDH_BLE_OBSERVER(m_ble_observer, APP_BLE_OBSERVER_PRIO,
     ble_evt_handler, NULL);
@@ -853,35 +911,174 @@ gatt_init(void)
   APP_ERROR_CHECK(err_code);
 }
 
-/** Handle received serial data from the LPC.
+/** Switch to bulk transfer mode.
 
-    We handle serial data for LPC command parsing separately from the
-    NUS handler, since the NUS handler can only handle ~20 bytes at a
-    time (depending on the MTU)--some command lines are significantly
-    longer than that.
+    Requests the 2M PHY, the maximum data length and a short connection
+    interval without slave latency, and starts measuring the link
+    throughput. The central may refuse any of these, in which case the
+    link just carries on with what it has.
+*/
+static void
+bulk_mode_enter(void)
+{
+  ret_code_t err_code;
 
-    Receives a single character from the app_uart module and appends it
-    to a string. The string will be be processed as a command at the
-    end of line.
+  if (m_bulk_mode || m_conn_handle == BLE_CONN_HANDLE_INVALID) {
+    return;
+  }
+  m_bulk_mode = true;
+  m_bulk_period_bytes = 0;
+  m_bulk_idle_periods = 0;
+  NRF_LOG_INFO("bulk mode on");
+
+  ble_gap_phys_t const phys =
+    {
+      .rx_phys = BLE_GAP_PHY_2MBPS,
+      .tx_phys = BLE_GAP_PHY_2MBPS,
+    };
+  err_code = sd_ble_gap_phy_update(m_conn_handle, &phys);
+  if (err_code != NRF_SUCCESS) {
+    NRF_LOG_WARNING("bulk: PHY update failed. code=0x%x", err_code);
+  }
+
+#if !defined(S112)
+  // DLE not supported on S112 (Morpheus ff1/ff2)
+  err_code = nrf_ble_gatt_data_length_set(&m_gatt, m_conn_handle,
+    NRF_SDH_BLE_GAP_DATA_LENGTH);
+  if (err_code != NRF_SUCCESS) {
+    NRF_LOG_WARNING("bulk: data length update failed. code=0x%x", err_code);
+  }
+#endif
+
+  ble_gap_conn_params_t bulk_conn_params =
+    {
+      .min_conn_interval = BULK_MIN_CONN_INTERVAL,
+      .max_conn_interval = BULK_MAX_CONN_INTERVAL,
+      .slave_latency = BULK_SLAVE_LATENCY,
+      .conn_sup_timeout = CONN_SUP_TIMEOUT,
+    };
+  err_code = ble_conn_params_change_conn_params(m_conn_handle, &bulk_conn_params);
+  if (err_code != NRF_SUCCESS) {
+    NRF_LOG_WARNING("bulk: conn params update failed. code=0x%x", err_code);
+  }
+
+  err_code = app_timer_start(m_bulk_timer_id,
+    APP_TIMER_TICKS(BULK_RATE_PERIOD_MS), NULL);
+  APP_ERROR_CHECK(err_code);
+}
+
+/** Go back to the low-power connection parameters. */
+static void
+bulk_mode_exit(void)
+{
+  ret_code_t err_code;
+
+  if (!m_bulk_mode) {
+    return;
+  }
+  m_bulk_mode = false;
+  m_bulk_rate = 0;
+  g_uart_unpause_threshold = NUS_RINGBUF_UNPAUSE_THRESHOLD;
+  NRF_LOG_INFO("bulk mode off");
+
+  err_code = app_timer_stop(m_bulk_timer_id);
+  APP_ERROR_CHECK(err_code);
+
+  if (m_conn_handle != BLE_CONN_HANDLE_INVALID) {
+    // NULL restores the preferred (PPCP) parameters.
+    err_code = ble_conn_params_change_conn_params(m_conn_handle, NULL);
+    if (err_code != NRF_SUCCESS) {
+      NRF_LOG_WARNING("bulk: conn params update failed. code=0x%x", err_code);
+    }
+  }
+}
+
+/** Handle the bulk transfer mode timer.
+
+    Updates the measured link throughput and the UART unpause threshold
+    that follows from it, and leaves bulk mode once no NUS data has been
+    sent for a while.
 */
 static void
-lpc_data_handle(uint8_t data)
+bulk_timer_handler(void* p_context)
 {
-  // Process all data via the binary interface.
-  bin_itf_handle_messages(data);
+  uint32_t sample = m_bulk_period_bytes * (1000 / BULK_RATE_PERIOD_MS);
+  m_bulk_period_bytes = 0;
+
+  if (sample == 0 && nrf_ringbuf_is_empty(&m_nus_ringbuf)) {
+    if (++m_bulk_idle_periods >= BULK_IDLE_PERIODS) {
+      bulk_mode_exit();
+      return;
+    }
+  }
+  else {
+    m_bulk_idle_periods = 0;
+  }
+
+  // Smooth over a few periods, connection events are bursty.
+  m_bulk_rate = (m_bulk_rate * 3 + sample) / 4;
+
+  uint32_t threshold = NUS_RINGBUF_PAUSE_THRESHOLD +
+    (m_bulk_rate * NUS_RINGBUF_UNPAUSE_WINDOW_MS) / 1000;
+  g_uart_unpause_threshold =
+    MIN(MAX(threshold, NUS_RINGBUF_UNPAUSE_THRESHOLD), NUS_RINGBUF_SIZE / 2);
+}
+
+/** Initialize bulk transfer mode. */
+static void
+bulk_mode_init(void)
+{
+  ret_code_t err_code;
+
+  err_code = app_timer_create(&m_bulk_timer_id, APP_TIMER_MODE_REPEATED,
+    bulk_timer_handler);
+  APP_ERROR_CHECK(err_code);
+}
+
+/** Get the next notification payload from the NUS ringbuf.
+
+    Joins the data at the end of the ringbuf with the data at the start
+    when it wraps, so that notifications are only shorter than the MTU
+    allows when the ringbuf holds less than that. The data stays in the
+    ringbuf until nrf_ringbuf_free() (or nrf_ringbuf_get_undo()).
+
+    @param[out] pp_data Receives a pointer to the payload
+    @param[out] p_size Receives the payload length, 0 if there is no data
+
+    @return NRF_SUCCESS, or the nrf_ringbuf_get() error.
+*/
+static ret_code_t
+nus_ringbuf_get(uint8_t **pp_data, size_t *p_size)
+{
+  size_t max = MIN(m_ble_nus_max_data_len, sizeof(m_nus_tx_buf));
+  size_t sz = max;
+
+  ret_code_t err_code = nrf_ringbuf_get(&m_nus_ringbuf, pp_data, &sz, false);
+  if (err_code != NRF_SUCCESS || sz == 0 || sz == max) {
+    *p_size = sz;
+    return err_code;
+  }
+
+  // Short read, check for more data past the wrap.
+  uint8_t *p_rest;
+  size_t rest = max - sz;
+  err_code = nrf_ringbuf_get(&m_nus_ringbuf, &p_rest, &rest, false);
+  if (err_code != NRF_SUCCESS || rest == 0) {
+    *p_size = sz;
+    return NRF_SUCCESS;
+  }
+
+  memcpy(m_nus_tx_buf, *pp_data, sz);
+  memcpy(&m_nus_tx_buf[sz], p_rest, rest);
+  *pp_data = m_nus_tx_buf;
+  *p_size = sz + rest;
+  return NRF_SUCCESS;
 }
 
 void ble_nus_send_data_wrapper(uint8_t *buf, size_t buf_size)
 {
   uint32_t err_code;
 
-  // Thresholds for pausing and unpausing the UART reads.
-  // The pause functionality ensures the UART buffer is not drained if the 
-  // outbound ring buffer does not have room.
-  // These numbers are experimentally determined.
-  static const uint32_t NUS_RINGBUF_PAUSE_THRESHOLD = 32;
-  static const uint32_t NUS_RINGBUF_UNPAUSE_THRESHOLD = 64;
-
   if (buf && buf_size)
   {
     // The caller provided a valid buffer. 
@@ -912,14 +1109,22 @@ void ble_nus_send_data_wrapper(uint8_t *buf, size_t buf_size)
       g_uart_pause = true;
       NRF_LOG_DEBUG("pause");
     }
+
+    // A backlog means the link can't keep up at the low-power parameters.
+    if (!m_bulk_mode &&
+        (NUS_RINGBUF_SIZE - nrf_ringbuf_free_get(&m_nus_ringbuf)) >= BULK_ENTER_BACKLOG)
+    {
+      bulk_mode_enter();
+    }
   }
 
+  // Keep going until the SoftDevice has no more TX buffers, so that every
+  // one of them is filled for the next connection event.
   while (1)
   {
-    // Ensure we are asking for a size that we can actually send
-    size_t sz = m_ble_nus_max_data_len;
+    size_t sz;
     // Get data from the ringbuf
-    err_code = nrf_ringbuf_get(&m_nus_ringbuf, &buf, &sz, false);
+    err_code = nus_ringbuf_get(&buf, &sz);
     if (NRF_SUCCESS == err_code)
     {
       if (sz == 0) 
@@ -930,9 +1135,6 @@ void ble_nus_send_data_wrapper(uint8_t *buf, size_t buf_size)
       else
       {
         NRF_LOG_DEBUG("got %d bytes from ringbuf", sz);
-        // TODO: optimization:
-        // If we've got less than BLE_NUS_MAX_DATA_LEN, and more data in the
-        // ringbuf, read more bytes into a working buffer
       }
     }
     else
@@ -957,12 +1159,17 @@ void ble_nus_send_data_wrapper(uint8_t *buf, size_t buf_size)
         NRF_LOG_ERROR("sent less than expected. sent=%d, exp=%d", curr_buf_size, sz);
       }
 
+      if (err_code == NRF_SUCCESS)
+      {
+        m_bulk_period_bytes += sz;
+      }
+
       // We can free up the buffer now.
       // And carry on through the loop
       (void)nrf_ringbuf_free(&m_nus_ringbuf, sz);
 
       // Check if we can unpause the UART
-      if (g_uart_pause && nrf_ringbuf_free_get(&m_nus_ringbuf) >= NUS_RINGBUF_UNPAUSE_THRESHOLD) 
+      if (g_uart_pause && nrf_ringbuf_free_get(&m_nus_ringbuf) >= g_uart_unpause_threshold) 
       {
         NRF_LOG_DEBUG("unpause");
         g_uart_pause = false;
@@ -992,61 +1199,44 @@ void ble_nus_send_data_wrapper(uint8_t *buf, size_t buf_size)
   }
 }
 
-/** Handle app_uart events.
+/** Handle received serial data from the LPC.
+
+    We handle serial data for LPC command parsing separately from the
+    NUS handler, since the NUS handler can only handle ~20 bytes at a
+    time (depending on the MTU)--some command lines are significantly
+    longer than that.
 
-    Receives a single character from the app_uart module and pass it
-    to the Nordic UART Service (NUS) and Elemind LPC data handlers.
+    Hands each chunk received by lpc_serial to the binary interface,
+    one packet at a time so that a pause takes effect at the next
+    packet boundary. Data left over stays in the RX buffers, and once
+    they are all in use flow control holds the LPC off.
 */
 static void
 uart_event_handle_sched(void* p_unused, uint16_t unused)
 {
-  uint8_t data;
+  const uint8_t *p_data;
+  size_t length;
 
   // Clear the flag before starting any work.
-  // Doing this here prevents a boundary case where a new byte arrives between 
-  // the last app_uart_get() and clearing the flag.
+  // Doing this here prevents a boundary case where new data arrives between
+  // the last lpc_serial_rx_peek() and clearing the flag.
   nrf_atflags_clear(&g_uart_data_flag, 0);
 
-  if (g_uart_pause) {
-    return;
-  }
-
-  uint32_t status = app_uart_get(&data);
-  while (NRF_SUCCESS == status) {
-    lpc_data_handle(data);
-
-    if (g_uart_pause) {
-      return;
-    }
-
-    status = app_uart_get(&data);
+  while (!g_uart_pause && lpc_serial_rx_peek(&p_data, &length)) {
+    lpc_serial_rx_consume(bin_itf_handle_buffer(p_data, length));
   }
 }
 
 static void
-uart_event_handle(app_uart_evt_t * p_event)
+uart_event_handle(void)
 {
   // Handler called in interrupt context
-  switch (p_event->evt_type) {
-    case APP_UART_COMMUNICATION_ERROR:
-      APP_ERROR_HANDLER(p_event->data.error_communication);
-      break;
-
-    case APP_UART_FIFO_ERROR:
-      APP_ERROR_HANDLER(p_event->data.error_code);
-      break;
-
-    case APP_UART_DATA_READY:
-      if (nrf_atflags_fetch_set(&g_uart_data_flag, 0)) {
-        // Flag was already set. Prevent filling the buffer on every byte.
-        break;
-      }
-      // Defer event through scheduler
-      app_sched_event_put(NULL, 0, uart_event_handle_sched);
-      break;
-    default:
-      break;
+  if (nrf_atflags_fetch_set(&g_uart_data_flag, 0)) {
+    // Flag was already set. Prevent filling the queue on every chunk.
+    return;
   }
+  // Defer event through scheduler
+  app_sched_event_put(NULL, 0, uart_event_handle_sched);
 }
 
 /** Initialize the UART module.
@@ -1055,27 +1245,8 @@ static void
 uart_init(void)
 {
   uint32_t err_code;
-  app_uart_comm_params_t const comm_params =
-    {
-      .rx_pin_no = RX_PIN_NUMBER,
-      .tx_pin_no = TX_PIN_NUMBER,
-      .rts_pin_no = RTS_PIN_NUMBER,
-      .cts_pin_no = CTS_PIN_NUMBER,
-      .flow_control = APP_UART_FLOW_CONTROL_ENABLED,
-      .use_parity = false,
-#if defined (UART_PRESENT)
-      .baud_rate = NRF_UART_BAUDRATE_115200
-#else
-      .baud_rate = NRF_UARTE_BAUDRATE_115200
-#endif
-    };
 
-  APP_UART_FIFO_INIT(&comm_params,
-    UART_RX_BUF_SIZE,
-    UART_TX_BUF_SIZE,
-    uart_event_handle,
-    APP_IRQ_PRIORITY_LOWEST,
-    err_code);
+  err_code = lpc_serial_init(uart_event_handle);
   APP_ERROR_CHECK(err_code);
 }
 
@@ -1237,6 +1408,9 @@ main(void)
   conn_params_init();
   NRF_LOG_INFO("conn_params_init.");
 
+  bulk_mode_init();
+  NRF_LOG_INFO("bulk_mode_init.");
+
   nrf_atflags_init(&g_uart_data_flag, 1, 1);
   NRF_LOG_INFO("atflags_init.");
 
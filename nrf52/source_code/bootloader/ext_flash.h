@@ -13,14 +13,17 @@
 #include <stdint.h>
 #include "sdk_errors.h" // for ret_code_t
 #include "app_util.h" // for STATIC_ASSERT()
+#include "nand_layout.h"
 
 // Define the page size in bytes.
 #define SPI_FLASH_PAGE_LEN      (2048)
 // Define the block size in bytes. This is the smallest erasable chunk.
 #define SPI_FLASH_PAGES_IN_BLOCK  (64)
 #define SPI_FLASH_BLOCK_LEN    (SPI_FLASH_PAGES_IN_BLOCK * SPI_FLASH_PAGE_LEN)
-#define SPI_FLASH_OTA_START_ADDR (260864)
-#define SPI_FLASH_OTA_NUM_BLOCKS (20) //this should match with NXP fatfs file config 
+// The OTA area of the NAND shared with the LPC, see common/nand/nand_layout.h
+#define SPI_FLASH_OTA_START_ADDR (NAND_LAYOUT_OTA_FIRST_BLOCK * SPI_FLASH_PAGES_IN_BLOCK)
+#define SPI_FLASH_OTA_NUM_BLOCKS (NAND_LAYOUT_OTA_NUM_BLOCKS)
+STATIC_ASSERT(SPI_FLASH_PAGES_IN_BLOCK == NAND_LAYOUT_PAGES_PER_BLOCK);
 
 // Define status register addresses
 #define status_protection_reg_addr 0xA0
@@ -13,13 +13,20 @@
 
 // Reuse the fstorage callback for compatibility with fstorage.
 #include "nrf_fstorage.h"
+#include "ext_flash.h"
 
 // Define the virtual start address of external flash
 // Bits [23:0] are assumed to be 0.
 #define EXT_STORAGE_ADDR_BASE       (0xC0000000)
-#define EXT_STORAGE_ADDR_NEW_BASE   (0x0003FB00)
+#define EXT_STORAGE_ADDR_NEW_BASE   (SPI_FLASH_OTA_START_ADDR)
 // Size of external flash, in bytes
 #define EXT_STORAGE_SIZE (SPI_FLASH_OTA_NUM_BLOCKS*SPI_FLASH_BLOCK_LEN)
+// A copy of the installed LPC image is kept in the upper half of the OTA
+// area, as the base for delta updates. Downloads land at the start of the
+// area and only overwrite it when they don't fit the lower half.
+#define EXT_STORAGE_IMAGE_NUM_BLOCKS (SPI_FLASH_OTA_NUM_BLOCKS/2)
+#define EXT_STORAGE_ADDR_IMAGE_BASE  (EXT_STORAGE_ADDR_NEW_BASE + \
+    (SPI_FLASH_OTA_NUM_BLOCKS-EXT_STORAGE_IMAGE_NUM_BLOCKS)*SPI_FLASH_PAGES_IN_BLOCK)
 // Returns true if address is in external flash range
 #define EXT_STORAGE_IS_ADDR(addr)   ((addr) >= EXT_STORAGE_ADDR_BASE && \
                                      (addr) < (EXT_STORAGE_ADDR_BASE + EXT_STORAGE_SIZE))
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Delta (patch) updates for the LPC application image.
+ *              See lpc_delta.h for the patch format.
+ */
+
+#include "lpc_delta.h"
+#include <string.h> // for memcpy()
+
+// Bytes moved per read/write call
+#define CHUNK_LEN   (256)
+
+static uint32_t get_le32(const uint8_t* p)
+{
+    return (uint32_t)p[0] |
+           ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+}
+
+int lpc_delta_header_read(const lpc_delta_io_t* p_io,
+                          uint32_t patch_size,
+                          lpc_delta_header_t* p_header)
+{
+    uint8_t magic[sizeof(p_header->magic)];
+
+    // Only the magic tells a full image from a patch. Anything else wrong
+    // with a patch must fail the update, not flash the patch as an image.
+    if (patch_size < sizeof(magic))
+    {
+        return LPC_DELTA_NOT_PATCH;
+    }
+    if (p_io->read_patch(0, magic, sizeof(magic)))
+    {
+        return LPC_DELTA_ERR_IO;
+    }
+    if (get_le32(magic) != LPC_DELTA_MAGIC)
+    {
+        return LPC_DELTA_NOT_PATCH;
+    }
+
+    if (patch_size < sizeof(*p_header))
+    {
+        return LPC_DELTA_ERR_FORMAT;
+    }
+    if (p_io->read_patch(0, (uint8_t*)p_header, sizeof(*p_header)))
+    {
+        return LPC_DELTA_ERR_IO;
+    }
+    if (p_header->version != LPC_DELTA_VERSION ||
+        p_header->header_len != sizeof(*p_header))
+    {
+        return LPC_DELTA_ERR_FORMAT;
+    }
+
+    return 0;
+}
+
+int lpc_delta_apply(const lpc_delta_io_t* p_io,
+                    const lpc_delta_header_t* p_header,
+                    uint32_t patch_size)
+{
+    uint8_t buf[CHUNK_LEN];
+    uint32_t patch_offset = p_header->header_len;
+    uint32_t written = 0;
+
+    while (written < p_header->target_size)
+    {
+        uint8_t op[9];
+        uint32_t len;
+        uint32_t src_offset;
+        bool from_base;
+
+        // Read the op code and its arguments
+        if (patch_offset + 5 > patch_size)
+        {
+            return LPC_DELTA_ERR_FORMAT;
+        }
+        if (p_io->read_patch(patch_offset, op, 5))
+        {
+            return LPC_DELTA_ERR_IO;
+        }
+
+        if (LPC_DELTA_OP_COPY == op[0])
+        {
+            if (patch_offset + 9 > patch_size)
+            {
+                return LPC_DELTA_ERR_FORMAT;
+            }
+            if (p_io->read_patch(patch_offset + 5, &op[5], 4))
+            {
+                return LPC_DELTA_ERR_IO;
+            }
+            src_offset = get_le32(&op[1]);
+            len = get_le32(&op[5]);
+            patch_offset += 9;
+            from_base = true;
+
+            if (src_offset > p_header->base_size ||
+                len > p_header->base_size - src_offset)
+            {
+                return LPC_DELTA_ERR_RANGE;
+            }
+        }
+        else if (LPC_DELTA_OP_DATA == op[0])
+        {
+            len = get_le32(&op[1]);
+            patch_offset += 5;
+            src_offset = patch_offset;
+            from_base = false;
+
+            if (len > patch_size - patch_offset)
+            {
+                return LPC_DELTA_ERR_FORMAT;
+            }
+            patch_offset += len;
+        }
+        else
+        {
+            return LPC_DELTA_ERR_FORMAT;
+        }
+
+        if (len > p_header->target_size - written)
+        {
+            return LPC_DELTA_ERR_RANGE;
+        }
+
+        while (len > 0)
+        {
+            uint32_t chunk = (len < sizeof(buf)) ? len : sizeof(buf);
+            int err = from_base ?
+                p_io->read_base(src_offset, buf, chunk) :
+                p_io->read_patch(src_offset, buf, chunk);
+
+            if (err || p_io->write_target(buf, chunk))
+            {
+                return LPC_DELTA_ERR_IO;
+            }
+
+            src_offset += chunk;
+            written += chunk;
+            len -= chunk;
+        }
+    }
+
+    // Trailing bytes mean the patch doesn't match its header.
+    if (patch_offset != patch_size)
+    {
+        return LPC_DELTA_ERR_FORMAT;
+    }
+
+    return 0;
+}
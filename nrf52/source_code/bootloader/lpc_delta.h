@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2022 Elemind Technologies, Inc.
+ *
+ * Description: Delta (patch) updates for the LPC application image.
+ *
+ * A patch rebuilds a new image from the currently installed one. It starts
+ * with an lpc_delta_header_t, followed by a list of operations which
+ * produce the new image front to back:
+ *
+ *   LPC_DELTA_OP_COPY   u32 offset, u32 length
+ *                       Copy length bytes of the installed image starting
+ *                       at offset.
+ *   LPC_DELTA_OP_DATA   u32 length, then length bytes
+ *                       Copy length bytes from the patch itself.
+ *
+ * All values are little-endian. Patches are made by lpcdelta.py.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define LPC_DELTA_MAGIC         (0x41544C44UL) // "DLTA"
+#define LPC_DELTA_VERSION       (1)
+#define LPC_DELTA_HASH_LEN      (32)
+
+#define LPC_DELTA_OP_COPY       (0x01)
+#define LPC_DELTA_OP_DATA       (0x02)
+
+// Return codes
+#define LPC_DELTA_NOT_PATCH     (1)     // no LPC_DELTA_MAGIC, a full image
+#define LPC_DELTA_ERR_IO        (-1)    // read or write callback failed
+#define LPC_DELTA_ERR_FORMAT    (-2)    // malformed or unsupported patch
+#define LPC_DELTA_ERR_RANGE     (-3)    // operation outside the images
+
+typedef struct
+{
+    uint32_t magic;                             // LPC_DELTA_MAGIC
+    uint16_t version;                           // LPC_DELTA_VERSION
+    uint16_t header_len;                        // sizeof(lpc_delta_header_t)
+    uint32_t base_size;                         // installed image size
+    uint32_t target_size;                       // new image size
+    uint8_t  base_sha256[LPC_DELTA_HASH_LEN];   // installed image hash
+    uint8_t  target_sha256[LPC_DELTA_HASH_LEN]; // new image hash
+} lpc_delta_header_t;
+
+/**@brief   Caller-provided functions to access the images and the patch.
+ *
+ * Each returns 0 on success, nonzero on failure.
+ */
+typedef struct
+{
+    // Read len bytes of the installed image at offset
+    int (*read_base)(uint32_t offset, uint8_t* p_buf, uint32_t len);
+    // Read len bytes of the patch at offset
+    int (*read_patch)(uint32_t offset, uint8_t* p_buf, uint32_t len);
+    // Append len bytes to the new image
+    int (*write_target)(const uint8_t* p_buf, uint32_t len);
+} lpc_delta_io_t;
+
+/**@brief   Read and check the patch header.
+ *
+ * @param[in]   p_io        Access functions
+ * @param[in]   patch_size  Number of bytes in the patch
+ * @param[out]  p_header    Receives the header
+ *
+ * @retval  0 if the file is a patch, LPC_DELTA_NOT_PATCH if it doesn't
+ *          start with LPC_DELTA_MAGIC, or an LPC_DELTA_ERR code on failure.
+ *          A patch with an unknown version or header length, or too short
+ *          for its header, is LPC_DELTA_ERR_FORMAT.
+ */
+int lpc_delta_header_read(const lpc_delta_io_t* p_io,
+                          uint32_t patch_size,
+                          lpc_delta_header_t* p_header);
+
+/**@brief   Rebuild the new image.
+ *
+ * Writes exactly p_header->target_size bytes through write_target. The
+ * hashes in the header are left to the caller to check.
+ *
+ * @param[in]   p_io        Access functions
+ * @param[in]   p_header    Header from lpc_delta_header_read()
+ * @param[in]   patch_size  Number of bytes in the patch
+ *
+ * @retval  0 on success, an LPC_DELTA_ERR code on failure.
+ */
+int lpc_delta_apply(const lpc_delta_io_t* p_io,
+                    const lpc_delta_header_t* p_header,
+                    uint32_t patch_size);
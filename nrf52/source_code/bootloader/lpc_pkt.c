@@ -9,6 +9,7 @@
  */
 
 #include "lpc_pkt.h"
+#include "crc16_xmodem.h"
 #include <string.h> // for memset()
 
 // nordic log
@@ -129,35 +130,6 @@ static const char* get_cmdrsp_type_string(uint8_t type)
     return "UNKNOWN";
 }
 
-static uint16_t crc16_update(const uint8_t * src, uint32_t lengthInBytes, const uint16_t* crc_init)
-{
-    uint32_t crc = 0;
-    uint32_t j;
-
-    // Are we continuing a previous calculation?
-    if (NULL != crc_init)
-    {
-        crc = *crc_init;
-    }
-
-    for (j=0; j < lengthInBytes; ++j)
-    {
-        uint32_t i;
-        uint32_t byte = src[j];
-        crc ^= byte << 8;
-        for (i = 0; i < 8; ++i)
-        {
-            uint32_t temp = crc << 1;
-            if (crc & 0x8000)
-            {
-                temp ^= 0x1021;
-            }
-            crc = temp;
-        }
-    }
-    return crc;
-}
-
 static uint16_t pkt_crc(const pkt_t* pkt)
 {
     uint16_t crc_calc;
@@ -165,42 +137,42 @@ static uint16_t pkt_crc(const pkt_t* pkt)
     if (PKT_TYPE_CMD == pkt->hdr.type)
     {
         // Init CRC with the header bytes, including start byte
-        crc_calc = crc16_update(
-            (uint8_t*)&pkt->hdr, sizeof(pkt->hdr), NULL);
+        crc_calc = crc16_xmodem_update(
+            CRC16_XMODEM_INIT, (uint8_t*)&pkt->hdr, sizeof(pkt->hdr));
 
-        crc_calc = crc16_update(
+        crc_calc = crc16_xmodem_update(
+            crc_calc,
             (uint8_t*)&pkt->u.cmdrsp.framing,
-            sizeof(pkt->u.cmdrsp.framing) - sizeof(pkt->u.cmdrsp.framing.crc16),
-            &crc_calc);
+            sizeof(pkt->u.cmdrsp.framing) - sizeof(pkt->u.cmdrsp.framing.crc16));
 
-        crc_calc = crc16_update(
+        crc_calc = crc16_xmodem_update(
+            crc_calc,
             (uint8_t*)&pkt->u.cmdrsp.info,
-            pkt->u.cmdrsp.framing.len,
-            &crc_calc);
+            pkt->u.cmdrsp.framing.len);
     }
     else if (PKT_TYPE_DATA == pkt->hdr.type)
     {
         // Init CRC with the header bytes, including start byte
-        crc_calc = crc16_update(
-            (uint8_t*)&pkt->hdr, sizeof(pkt->hdr), NULL);
+        crc_calc = crc16_xmodem_update(
+            CRC16_XMODEM_INIT, (uint8_t*)&pkt->hdr, sizeof(pkt->hdr));
 
-        crc_calc = crc16_update(
+        crc_calc = crc16_xmodem_update(
+            crc_calc,
             (uint8_t*)&pkt->u.data.framing,
-            sizeof(pkt->u.data.framing) - sizeof(pkt->u.data.framing.crc16),
-            &crc_calc);
+            sizeof(pkt->u.data.framing) - sizeof(pkt->u.data.framing.crc16));
 
-        crc_calc = crc16_update(
+        crc_calc = crc16_xmodem_update(
+            crc_calc,
             (uint8_t*)&pkt->u.data.payload,
-            pkt->u.data.framing.len,
-            &crc_calc);
+            pkt->u.data.framing.len);
     }
     else if (PKT_TYPE_PING_RSP == pkt->hdr.type)
     {
         // Pingrsp CRC includes everything but the 2 trailing CRC bytes.
-        crc_calc = crc16_update(
+        crc_calc = crc16_xmodem_update(
+            CRC16_XMODEM_INIT,
             (uint8_t*)pkt,
-            sizeof(pkt->hdr) + sizeof(pkt->u.pingrsp) - 2,
-            NULL);
+            sizeof(pkt->hdr) + sizeof(pkt->u.pingrsp) - 2);
     }
     else 
     {
@@ -594,17 +566,17 @@ int lpc_send_data(const uint8_t* p_data, uint32_t len)
     pkt->u.data.framing.len     = len;
 
     // Init CRC with the header bytes, including start byte
-    crc_calc = crc16_update(
-        (uint8_t*)&pkt->hdr, sizeof(pkt->hdr), NULL);
+    crc_calc = crc16_xmodem_update(
+        CRC16_XMODEM_INIT, (uint8_t*)&pkt->hdr, sizeof(pkt->hdr));
 
     // Add the framing
-    crc_calc = crc16_update(
+    crc_calc = crc16_xmodem_update(
+        crc_calc,
         (uint8_t*)&pkt->u.data.framing,
-        sizeof(pkt->u.data.framing) - sizeof(pkt->u.data.framing.crc16),
-        &crc_calc);
+        sizeof(pkt->u.data.framing) - sizeof(pkt->u.data.framing.crc16));
 
     // And finally, the data buffer
-    crc_calc = crc16_update(p_data, len, &crc_calc);
+    crc_calc = crc16_xmodem_update(crc_calc, p_data, len);
 
     pkt->u.data.framing.crc16 = crc_calc;
     NRF_LOG_INFO("TX DATA: type=%s (0x%02X), len=0x%04X, crc=0x%04X (0x%04X)", 
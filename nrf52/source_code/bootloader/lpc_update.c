@@ -10,9 +10,12 @@
  */
 
 #include "lpc_protocol.h"
+#include "lpc_delta.h"
 #include "ext_fstorage.h"
 #include "lpc_reset_timing.h"
 #include "ext_flash.h"
+#include "sha256.h"
+#include <string.h> // for memcpy()
 
 // nordic sdk
 #include "nrf_dfu_validation.h"
@@ -32,9 +35,25 @@
 #include "nrf_log.h"
 NRF_LOG_MODULE_REGISTER();
 
+// Delta updates need 4kB more RAM than the nRF52810 bootloader has to spare,
+// the build turns them off there.
+#ifndef LPC_DELTA_ENABLED
+#define LPC_DELTA_ENABLED 1
+#endif
+
 // UART instance which is connected to the LPC
 static const nrfx_uart_t m_uart_instance = NRFX_UART_INSTANCE(0);
 
+// External flash page where the image to apply starts
+static uint32_t m_fw_page_base = EXT_STORAGE_ADDR_NEW_BASE;
+
+// Page buffer, shared by the steps of an update which run one after another.
+static uint8_t m_page_buf[SPI_FLASH_PAGE_LEN];
+
+// Number of external flash pages (or blocks) needed for len bytes
+#define PAGES_FOR(len)  (((len) + SPI_FLASH_PAGE_LEN - 1) / SPI_FLASH_PAGE_LEN)
+#define BLOCKS_FOR(len) ((PAGES_FOR(len) + SPI_FLASH_PAGES_IN_BLOCK - 1) / SPI_FLASH_PAGES_IN_BLOCK)
+
 // Reset the LPC, and optionally enter in-system programming mode (ISP). 
 // This routine mirrors on_write_lpc_reset() in ble_elemind.c. 
 // Any updates here should be considered for that function as well.
@@ -65,10 +84,250 @@ static void lpc_reset_isp(bool isp)
     }
 }
 
+// Hash len bytes of external flash, starting at a page, and compare with
+// p_hash (SHA-256, big-endian).
+static bool ext_image_hash_ok(uint32_t page_base, uint32_t len, const uint8_t* p_hash)
+{
+    static sha256_context_t shactx;
+    uint8_t hash[LPC_DELTA_HASH_LEN];
+
+    if (NRF_SUCCESS != sha256_init(&shactx))
+    {
+        return false;
+    }
+
+    for (uint32_t page = page_base; len > 0; page++)
+    {
+        uint32_t page_len = MIN(len, SPI_FLASH_PAGE_LEN);
+        if (NRF_SUCCESS != ext_fstorage_read(page, m_page_buf, page_len) ||
+            NRF_SUCCESS != sha256_update(&shactx, m_page_buf, page_len))
+        {
+            return false;
+        }
+        len -= page_len;
+    }
+
+    if (NRF_SUCCESS != sha256_final(&shactx, hash, 0))
+    {
+        return false;
+    }
+    return (0 == memcmp(hash, p_hash, sizeof(hash)));
+}
+
+// Keep a copy of the image just applied, as the base for the next delta.
+static void ext_image_save(uint32_t page_base, uint32_t len)
+{
+    if (page_base == EXT_STORAGE_ADDR_IMAGE_BASE)
+    {
+        return;
+    }
+    if (BLOCKS_FOR(len) > EXT_STORAGE_IMAGE_NUM_BLOCKS ||
+        page_base + PAGES_FOR(len) > EXT_STORAGE_ADDR_IMAGE_BASE)
+    {
+        // The download already overwrote the copy. The next update must
+        // be a full image.
+        NRF_LOG_WARNING("image too large to keep a copy. size=%d", len);
+        return;
+    }
+
+    NRF_LOG_INFO("saving image copy. size=%d", len);
+    if (NRF_SUCCESS != ext_fstorage_erase(EXT_STORAGE_ADDR_IMAGE_BASE, BLOCKS_FOR(len), NULL, false))
+    {
+        NRF_LOG_WARNING("failed to erase image copy");
+        return;
+    }
+    for (uint32_t i = 0; i < PAGES_FOR(len); i++)
+    {
+        if (NRF_SUCCESS != ext_fstorage_read(page_base + i, m_page_buf, SPI_FLASH_PAGE_LEN) ||
+            NRF_SUCCESS != ext_fstorage_write(EXT_STORAGE_ADDR_IMAGE_BASE + i, m_page_buf, SPI_FLASH_PAGE_LEN, NULL, false))
+        {
+            NRF_LOG_WARNING("failed to save image copy. page=%d", i);
+            return;
+        }
+    }
+}
+
+#if LPC_DELTA_ENABLED
+// Page caches for the delta reads. The base is read at random, the patch
+// front to back.
+typedef struct
+{
+    uint32_t page_base;
+    uint32_t page;
+    uint8_t  data[SPI_FLASH_PAGE_LEN];
+} page_cache_t;
+
+static page_cache_t m_base_cache = { .page_base = EXT_STORAGE_ADDR_IMAGE_BASE };
+static page_cache_t m_patch_cache = { .page_base = EXT_STORAGE_ADDR_NEW_BASE };
+
+// Delta target: first page, and the number of bytes written so far (the
+// partial page is in m_page_buf).
+static uint32_t m_target_page_base;
+static uint32_t m_target_len;
+
+static int page_cache_read(page_cache_t* p_cache, uint32_t offset, uint8_t* p_buf, uint32_t len)
+{
+    while (len > 0)
+    {
+        uint32_t page = p_cache->page_base + offset / SPI_FLASH_PAGE_LEN;
+        uint32_t col = offset % SPI_FLASH_PAGE_LEN;
+        uint32_t chunk = MIN(len, SPI_FLASH_PAGE_LEN - col);
+
+        if (page != p_cache->page)
+        {
+            if (NRF_SUCCESS != ext_fstorage_read(page, p_cache->data, SPI_FLASH_PAGE_LEN))
+            {
+                p_cache->page = 0;
+                return -1;
+            }
+            p_cache->page = page;
+        }
+
+        memcpy(p_buf, &p_cache->data[col], chunk);
+        p_buf += chunk;
+        offset += chunk;
+        len -= chunk;
+    }
+    return 0;
+}
+
+static int delta_read_base(uint32_t offset, uint8_t* p_buf, uint32_t len)
+{
+    return page_cache_read(&m_base_cache, offset, p_buf, len);
+}
+
+static int delta_read_patch(uint32_t offset, uint8_t* p_buf, uint32_t len)
+{
+    return page_cache_read(&m_patch_cache, offset, p_buf, len);
+}
+
+static int delta_write_target(const uint8_t* p_buf, uint32_t len)
+{
+    while (len > 0)
+    {
+        uint32_t col = m_target_len % SPI_FLASH_PAGE_LEN;
+        uint32_t chunk = MIN(len, SPI_FLASH_PAGE_LEN - col);
+
+        memcpy(&m_page_buf[col], p_buf, chunk);
+        p_buf += chunk;
+        len -= chunk;
+        m_target_len += chunk;
+
+        if (col + chunk == SPI_FLASH_PAGE_LEN)
+        {
+            uint32_t page = m_target_page_base + (m_target_len - 1) / SPI_FLASH_PAGE_LEN;
+            if (NRF_SUCCESS != ext_fstorage_write(page, m_page_buf, SPI_FLASH_PAGE_LEN, NULL, false))
+            {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+static const lpc_delta_io_t m_delta_io = {
+    .read_base      = delta_read_base,
+    .read_patch     = delta_read_patch,
+    .write_target   = delta_write_target,
+};
+
+// If the download is a delta patch, rebuild the new image behind it and
+// point *p_page_base and *p_size at that. Full images are left alone.
+//
+// Returns 0 when there is an image to apply, nonzero on failure.
+static int delta_reconstruct(uint32_t* p_page_base, uint32_t* p_size)
+{
+    lpc_delta_header_t header;
+    uint32_t patch_size = *p_size;
+    int err;
+
+    m_base_cache.page = 0;
+    m_patch_cache.page = 0;
+
+    err = lpc_delta_header_read(&m_delta_io, patch_size, &header);
+    if (LPC_DELTA_NOT_PATCH == err)
+    {
+        return 0;
+    }
+    if (err)
+    {
+        NRF_LOG_WARNING("lpc delta: bad patch header (%d)", err);
+        return err;
+    }
+
+    NRF_LOG_WARNING("lpc delta. patch=%d, base=%d, target=%d",
+        patch_size, header.base_size, header.target_size);
+
+    // The new image goes in the blocks after the patch, and must not reach
+    // into the installed image copy it's built from.
+    m_target_page_base = *p_page_base + BLOCKS_FOR(patch_size) * SPI_FLASH_PAGES_IN_BLOCK;
+    m_target_len = 0;
+    if (m_target_page_base + PAGES_FOR(header.target_size) > EXT_STORAGE_ADDR_IMAGE_BASE ||
+        BLOCKS_FOR(header.base_size) > EXT_STORAGE_IMAGE_NUM_BLOCKS)
+    {
+        NRF_LOG_WARNING("lpc delta: no room for the new image");
+        return -1;
+    }
+
+    if (!ext_image_hash_ok(EXT_STORAGE_ADDR_IMAGE_BASE, header.base_size, header.base_sha256))
+    {
+        NRF_LOG_WARNING("lpc delta: installed image doesn't match the patch");
+        return -1;
+    }
+
+    if (NRF_SUCCESS != ext_fstorage_erase(m_target_page_base, BLOCKS_FOR(header.target_size), NULL, false))
+    {
+        NRF_LOG_WARNING("lpc delta: erase failed");
+        return -1;
+    }
+
+    err = lpc_delta_apply(&m_delta_io, &header, patch_size);
+    if (0 == err && (m_target_len % SPI_FLASH_PAGE_LEN))
+    {
+        // Write out the last partial page
+        uint32_t col = m_target_len % SPI_FLASH_PAGE_LEN;
+        memset(&m_page_buf[col], 0xFF, SPI_FLASH_PAGE_LEN - col);
+        if (NRF_SUCCESS != ext_fstorage_write(m_target_page_base + m_target_len / SPI_FLASH_PAGE_LEN,
+                m_page_buf, SPI_FLASH_PAGE_LEN, NULL, false))
+        {
+            err = LPC_DELTA_ERR_IO;
+        }
+    }
+    if (err)
+    {
+        NRF_LOG_WARNING("lpc delta: apply failed. err=%d", err);
+        return err;
+    }
+
+    // Check what actually landed in flash
+    if (!ext_image_hash_ok(m_target_page_base, header.target_size, header.target_sha256))
+    {
+        NRF_LOG_WARNING("lpc delta: new image hash mismatch");
+        return -1;
+    }
+
+    *p_page_base = m_target_page_base;
+    *p_size = header.target_size;
+    return 0;
+}
+#endif // LPC_DELTA_ENABLED
+
 // This function is invoked by the NRF bootloader following successful download
 // of the 'external' applcation file.
 nrf_dfu_result_t nrf_dfu_validation_post_external_app_execute(dfu_init_command_t const * p_init, bool is_trusted)
 {
+    uint32_t fw_page_base = EXT_STORAGE_ADDR_NEW_BASE;
+    uint32_t fw_size = p_init->app_size;
+
+#if LPC_DELTA_ENABLED
+    // Rebuild the image first, so a bad patch leaves the LPC untouched.
+    if (0 != delta_reconstruct(&fw_page_base, &fw_size))
+    {
+        return NRF_DFU_RES_CODE_OPERATION_FAILED;
+    }
+#endif
+    m_fw_page_base = fw_page_base;
+
     // Init UART
     static const nrfx_uart_config_t uart_cfg = {
         .pseltxd    = TX_PIN_NUMBER,
@@ -105,11 +364,12 @@ nrf_dfu_result_t nrf_dfu_validation_post_external_app_execute(dfu_init_command_t
             // lpc_property_read();
 
             // Finally, apply the update to the LPC
-            NRF_LOG_WARNING("apply lpc app. size=%d", p_init->app_size);
-            if (0 == lpc_protocol_apply_fw(p_init->app_size))
+            NRF_LOG_WARNING("apply lpc app. size=%d", fw_size);
+            if (0 == lpc_protocol_apply_fw(fw_size))
             {
                 // Success! LPC reboot initiated.
                 NRF_LOG_WARNING("lpc firmware applied successfully!");
+                ext_image_save(fw_page_base, fw_size);
                 //lpc_reset_isp(false);
                 return NRF_DFU_RES_CODE_SUCCESS;
             }
@@ -135,22 +395,21 @@ int lpc_fw_file_read(uint32_t offset, uint8_t* p_buf, uint32_t len)
 {
     ret_code_t err_code;
     // TODO: NEED TO ADJUST FOR PAGE READS....
-    static uint8_t read_buf[SPI_FLASH_PAGE_LEN];
-    static uint8_t *read_ptr = read_buf;
+    static uint8_t *read_ptr = m_page_buf;
     static uint8_t running_read = 0;
 
     uint32_t num_pages = offset / SPI_FLASH_PAGE_LEN;
-    uint32_t adjusted_dest = EXT_STORAGE_ADDR_NEW_BASE + num_pages;
+    uint32_t adjusted_dest = m_fw_page_base + num_pages;
 
     // 4 chunks in page
     if (((offset % SPI_FLASH_PAGE_LEN) == 0) || (offset == 0))
     {
-        err_code = ext_fstorage_read(adjusted_dest, read_buf, SPI_FLASH_PAGE_LEN);
+        err_code = ext_fstorage_read(adjusted_dest, m_page_buf, SPI_FLASH_PAGE_LEN);
         if (NRF_SUCCESS != err_code)
         {
             return -1;
         }
-        read_ptr = &read_buf[0];
+        read_ptr = &m_page_buf[0];
         running_read = 0;      
     }
 
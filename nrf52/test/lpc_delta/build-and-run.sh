@@ -0,0 +1,17 @@
+set -x
+
+# patches made by lpcdelta.py, rebuilt by lpc_delta.c
+cases=$(python3 ./make_images.py) || exit 1
+args=""
+for i in $(seq 0 $((cases - 1))); do
+  python3 ../../lpcdelta.py case${i}_base.bin case${i}_target.bin case${i}_patch.bin || exit 1
+  args="$args case${i}_base.bin case${i}_target.bin case${i}_patch.bin"
+done
+
+gcc -O2 -Wall -I ../../source_code/bootloader \
+ ../../source_code/bootloader/lpc_delta.c \
+ ./lpc_delta_test.c \
+ && ./a.out $args || exit 1
+
+# cleanup
+rm ./a.out case*.bin
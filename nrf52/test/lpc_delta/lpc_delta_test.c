@@ -0,0 +1,195 @@
+// Host test for LPC delta updates: patches made by lpcdelta.py must rebuild
+// their target image exactly, and malformed patches must be rejected
+// without writing past the target size or reading outside the base.
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lpc_delta.h"
+
+typedef struct {
+  uint8_t *data;
+  uint32_t len;
+} blob_t;
+
+static blob_t base;
+static blob_t patch;
+static uint8_t *target;
+static uint32_t target_len;
+static uint32_t target_max;
+
+static blob_t load(const char *path)
+{
+  blob_t b = { NULL, 0 };
+  FILE *f = fopen(path, "rb");
+  assert(f);
+  fseek(f, 0, SEEK_END);
+  b.len = (uint32_t) ftell(f);
+  fseek(f, 0, SEEK_SET);
+  b.data = malloc(b.len + 1);
+  assert(fread(b.data, 1, b.len, f) == b.len);
+  fclose(f);
+  return b;
+}
+
+static int read_base(uint32_t offset, uint8_t *p_buf, uint32_t len)
+{
+  assert(offset + len <= base.len);
+  memcpy(p_buf, &base.data[offset], len);
+  return 0;
+}
+
+static int read_patch(uint32_t offset, uint8_t *p_buf, uint32_t len)
+{
+  assert(offset + len <= patch.len);
+  memcpy(p_buf, &patch.data[offset], len);
+  return 0;
+}
+
+static int write_target(const uint8_t *p_buf, uint32_t len)
+{
+  assert(target_len + len <= target_max);
+  memcpy(&target[target_len], p_buf, len);
+  target_len += len;
+  return 0;
+}
+
+static const lpc_delta_io_t io = { read_base, read_patch, write_target };
+
+static int run(void)
+{
+  lpc_delta_header_t header;
+  int err = lpc_delta_header_read(&io, patch.len, &header);
+  if (err) {
+    return err;
+  }
+  free(target);
+  target = malloc(header.target_size + 1);
+  target_max = header.target_size;
+  target_len = 0;
+  return lpc_delta_apply(&io, &header, patch.len);
+}
+
+static void put_le32(uint8_t *p, uint32_t v)
+{
+  p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+}
+
+// Builds a patch from a header and raw op bytes.
+static void make_patch(uint32_t base_size, uint32_t target_size,
+    const uint8_t *ops, uint32_t ops_len)
+{
+  lpc_delta_header_t header;
+  memset(&header, 0, sizeof(header));
+  header.magic = LPC_DELTA_MAGIC;
+  header.version = LPC_DELTA_VERSION;
+  header.header_len = sizeof(header);
+  header.base_size = base_size;
+  header.target_size = target_size;
+  free(patch.data);
+  patch.len = sizeof(header) + ops_len;
+  patch.data = malloc(patch.len);
+  memcpy(patch.data, &header, sizeof(header));
+  memcpy(&patch.data[sizeof(header)], ops, ops_len);
+}
+
+static void malformed(void)
+{
+  static uint8_t base_data[100];
+  uint8_t ops[32];
+
+  base.data = base_data;
+  base.len = sizeof(base_data);
+
+  // well-formed: copy 10 bytes from 90, then 2 data bytes
+  ops[0] = LPC_DELTA_OP_COPY; put_le32(&ops[1], 90); put_le32(&ops[5], 10);
+  ops[9] = LPC_DELTA_OP_DATA; put_le32(&ops[10], 2); ops[14] = 1; ops[15] = 2;
+  make_patch(100, 12, ops, 16);
+  assert(run() == 0 && target_len == 12);
+
+  // copy past the end of the base
+  put_le32(&ops[5], 11);
+  make_patch(100, 13, ops, 16);
+  assert(run() == LPC_DELTA_ERR_RANGE);
+  put_le32(&ops[1], 0xFFFFFFF8);
+  assert(run() == LPC_DELTA_ERR_RANGE);
+  put_le32(&ops[1], 90); put_le32(&ops[5], 10);
+
+  // ops produce more than the target size
+  make_patch(100, 11, ops, 16);
+  assert(run() == LPC_DELTA_ERR_RANGE);
+
+  // ops produce less than the target size
+  make_patch(100, 13, ops, 16);
+  assert(run() == LPC_DELTA_ERR_FORMAT);
+
+  // data longer than the patch
+  put_le32(&ops[10], 3);
+  make_patch(100, 13, ops, 16);
+  assert(run() == LPC_DELTA_ERR_FORMAT);
+  put_le32(&ops[10], 2);
+
+  // truncated op
+  make_patch(100, 12, ops, 7);
+  assert(run() == LPC_DELTA_ERR_FORMAT);
+
+  // unknown op
+  ops[9] = 0x7F;
+  make_patch(100, 12, ops, 16);
+  assert(run() == LPC_DELTA_ERR_FORMAT);
+  ops[9] = LPC_DELTA_OP_DATA;
+
+  // trailing bytes
+  make_patch(100, 12, ops, 17);
+  assert(run() == LPC_DELTA_ERR_FORMAT);
+
+  // not a patch, applied as a full image: wrong magic, too short for one
+  make_patch(100, 12, ops, 16);
+  patch.data[0] ^= 1;
+  assert(run() == LPC_DELTA_NOT_PATCH);
+  patch.len = 3;
+  assert(run() == LPC_DELTA_NOT_PATCH);
+
+  // a patch that must fail the update: truncated header, unknown version,
+  // unknown header length
+  make_patch(100, 12, ops, 16);
+  patch.len = sizeof(lpc_delta_header_t) - 1;
+  assert(run() == LPC_DELTA_ERR_FORMAT);
+  make_patch(100, 12, ops, 16);
+  patch.data[4] ^= 1;
+  assert(run() == LPC_DELTA_ERR_FORMAT);
+  make_patch(100, 12, ops, 16);
+  patch.data[6] ^= 1;
+  assert(run() == LPC_DELTA_ERR_FORMAT);
+
+  printf("malformed patches: ok\n");
+}
+
+int main(int argc, char **argv)
+{
+  assert(sizeof(lpc_delta_header_t) == 80);
+
+  // argument triples: base, target, patch
+  for (int i = 1; i + 2 < argc; i += 3) {
+    base = load(argv[i]);
+    blob_t expected = load(argv[i + 1]);
+    patch = load(argv[i + 2]);
+
+    assert(run() == 0);
+    assert(target_len == expected.len);
+    assert(memcmp(target, expected.data, expected.len) == 0);
+    printf("%s: ok\n", argv[i + 2]);
+
+    free(base.data);
+    free(expected.data);
+    free(patch.data);
+    patch.data = NULL;
+  }
+
+  malformed();
+
+  printf("lpc_delta_test passed\n");
+  return 0;
+}
@@ -0,0 +1,58 @@
+#!/usr/bin/env python3
+# Writes pairs of test images, case<N>_base.bin and case<N>_target.bin.
+
+import random
+
+random.seed(1)
+
+
+def rand_bytes(n):
+    return bytes(random.getrandbits(8) for _ in range(n))
+
+
+def firmware_like(n):
+    # runs of repeated words and padding, like a real image
+    out = bytearray()
+    while len(out) < n:
+        kind = random.randrange(4)
+        if kind == 0:
+            out += b"\xff" * random.randrange(16, 512)
+        elif kind == 1:
+            out += rand_bytes(4) * random.randrange(2, 32)
+        else:
+            out += rand_bytes(random.randrange(16, 2048))
+    return bytes(out[:n])
+
+
+def patch_words(img, count):
+    # changed pointers/constants
+    img = bytearray(img)
+    for _ in range(count):
+        pos = random.randrange(0, len(img) - 4) & ~3
+        img[pos:pos + 4] = rand_bytes(4)
+    return bytes(img)
+
+
+def insert(img, pos, data):
+    return img[:pos] + data + img[pos:]
+
+
+base = firmware_like(300 * 1024)
+cases = [
+    (base, base),
+    (base, patch_words(base, 50)),
+    (base, insert(base, 100000, rand_bytes(3000))),
+    (base, insert(patch_words(base, 200), 5000, rand_bytes(77))[:-20000] + rand_bytes(9000)),
+    (base, base[150000:] + base[:150000]),
+    (base, rand_bytes(50000)),
+    (b"", firmware_like(10000)),
+    (base, b""),
+    (firmware_like(2049), firmware_like(2047)),
+]
+
+for i, (b, t) in enumerate(cases):
+    with open("case%d_base.bin" % i, "wb") as f:
+        f.write(b)
+    with open("case%d_target.bin" % i, "wb") as f:
+        f.write(t)
+print(len(cases))